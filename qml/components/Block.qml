@@ -9,6 +9,8 @@ Item {
     objectName: "blockDelegate_" + blockIndex
 
     property int blockIndex: 0
+    readonly property int pageBlockIndex: blockIndex + ((editor && editor.blockWindowStart) ? editor.blockWindowStart : 0)
+    property string blockId: ""
     property string blockType: "paragraph"
     property string content: ""
     property int depth: 0
@@ -19,13 +21,12 @@ Item {
     property var editor: null
     property var textControl: (blockLoader.item && blockLoader.item.textControl) ? blockLoader.item.textControl : null
     property var blockControl: blockLoader.item
-    property var inlineRuns: (blockLoader.item && ("inlineRuns" in blockLoader.item)) ? blockLoader.item.inlineRuns : []
-    property var typingAttrs: (blockLoader.item && ("typingAttrs" in blockLoader.item)) ? blockLoader.item.typingAttrs : ({})
+    property string runKey: (blockLoader.item && ("runKey" in blockLoader.item)) ? blockLoader.item.runKey : ""
     readonly property bool rangeSelected: editor &&
         editor.selectionStartBlockIndex >= 0 &&
         blockIndex >= editor.selectionStartBlockIndex &&
         blockIndex <= editor.selectionEndBlockIndex
-    readonly property bool searchHighlighted: editor && editor.searchHighlightBlockIndex === blockIndex
+    readonly property bool searchHighlighted: editor && editor.searchHighlightBlockIndex === pageBlockIndex
 
     signal contentEdited(string newContent)
     signal blockEnterPressed()
@@ -122,7 +123,7 @@ Item {
             for (let i = 0; i < root.editor.remoteCursors.length; i++) {
                 const c = root.editor.remoteCursors[i] || {}
                 if ((c.pageId || "") !== (root.editor.pageId || "")) continue
-                if ((c.blockIndex === undefined ? -1 : c.blockIndex) !== root.blockIndex) continue
+                if ((c.blockIndex === undefined ? -1 : c.blockIndex) !== root.pageBlockIndex) continue
                 addEntry(c.cursorPos === undefined ? -1 : c.cursorPos, slot)
                 slot++
             }
@@ -135,7 +136,7 @@ Item {
             return
         }
         if (root.editor.remoteCursorPageId !== root.editor.pageId ||
-            root.editor.remoteCursorBlockIndex !== root.blockIndex) {
+            root.editor.remoteCursorBlockIndex !== root.pageBlockIndex) {
             root.activeRemoteCursors = []
             return
         }
@@ -355,6 +356,7 @@ Item {
         id: paragraphComponent
         ParagraphBlock {
             content: root.content
+            blockId: root.blockId
             editor: root.editor
             blockIndex: root.blockIndex
             multiBlockSelectionActive: root.editor ? root.editor.hasCrossBlockSelection : false
@@ -374,6 +376,7 @@ Item {
         HeadingBlock {
             level: root.headingLevel
             content: root.content
+            blockId: root.blockId
             editor: root.editor
             blockIndex: root.blockIndex
             multiBlockSelectionActive: root.editor ? root.editor.hasCrossBlockSelection : false
@@ -388,6 +391,7 @@ Item {
         id: todoComponent
         TodoBlock {
             content: root.content
+            blockId: root.blockId
             isChecked: root.checked
             editor: root.editor
             blockIndex: root.blockIndex
@@ -444,6 +448,7 @@ Item {
         id: quoteComponent
         QuoteBlock {
             content: root.content
+            blockId: root.blockId
             editor: root.editor
             blockIndex: root.blockIndex
             multiBlockSelectionActive: root.editor ? root.editor.hasCrossBlockSelection : false
@@ -463,6 +468,7 @@ Item {
         id: toggleComponent
         ToggleBlock {
             content: root.content
+            blockId: root.blockId
             isCollapsed: root.collapsed
             editor: root.editor
             blockIndex: root.blockIndex
@@ -142,6 +142,8 @@ FocusScope {
     property int remoteCursorBlockIndex: -1
     property int remoteCursorPos: -1
     property var remoteCursors: []
+    // Offset of blockModel's rows in the page; remote cursor block indices are page-wide.
+    readonly property int blockWindowStart: blockModel.windowStart
 
     function remoteTitleCursorPos() {
         if (!remoteCursors || remoteCursors.length === 0 || !pageId || pageId === "") return -1
@@ -827,7 +829,10 @@ FocusScope {
                     restorePos = -1
                 }
             }
-            loadFromMarkdown(markdown)
+            // Diff into the existing rows so untouched blocks keep their delegates.
+            if (!blockModel.mergeFromMarkdown(markdown)) {
+                loadFromMarkdown(markdown)
+            }
             if (restoreFocus && restorePos >= 0) {
                 const idx = Math.max(0, Math.min(restoreIndex, blockModel.count - 1))
                 const pos = restorePos
@@ -897,12 +902,7 @@ FocusScope {
     
     function scrollToBlock(blockId) {
         if (!blockId || blockId === "") return
-        for (let i = 0; i < blockModel.count; i++) {
-            if (blockModel.get(i).blockId === blockId) {
-                revealSearchBlockIndex(i)
-                break
-            }
-        }
+        revealSearchBlockIndex(blockModel.pageIndexForBlockId(blockId))
     }
     
     BlockModel {
@@ -912,6 +912,7 @@ FocusScope {
 
     property alias blocksModel: blockModel
 
+    // Page-wide, like the indices search results report.
     property int searchHighlightBlockIndex: -1
 
     Timer {
@@ -967,6 +968,78 @@ FocusScope {
         return Math.max(0, Math.min(y, flickable.contentHeight - flickable.height))
     }
 
+    // Very large pages only materialize a window of blocks in blockModel; slide it by a
+    // third once the viewport gets within a screen of either end of the window.
+    property bool slidingBlockWindow: false
+
+    function maybeSlideBlockWindow() {
+        if (!blockModel.windowed || slidingBlockWindow) return
+        if (root.selectionDragging || root.blockRangeSelecting || root.reorderDragging) return
+        const step = Math.floor(blockModel.windowSize / 3)
+        const margin = flickable.height
+        if (flickable.contentY + flickable.height > contentColumn.height - margin &&
+            blockModel.windowStart + blockModel.count < blockModel.totalCount) {
+            slideBlockWindow(step)
+        } else if (flickable.contentY < margin && blockModel.windowStart > 0) {
+            slideBlockWindow(-step)
+        }
+    }
+
+    function slideBlockWindow(delta) {
+        if (blockRepeater.count <= 0) return
+        slidingBlockWindow = true
+
+        // Pin a block that stays in the window so the viewport doesn't jump.
+        const anchorIndex = delta > 0 ? Math.min(delta, blockRepeater.count - 1) : 0
+        const anchorItem = blockRepeater.itemAt(anchorIndex)
+        const anchorY = anchorItem ? anchorItem.y : 0
+        const anchorId = blockModel.blockId(anchorIndex)
+
+        const shift = moveBlockWindow(blockModel.windowStart + delta)
+
+        const movedIndex = anchorIndex + shift
+        if (blockModel.blockId(movedIndex) === anchorId) {
+            const movedItem = blockRepeater.itemAt(movedIndex)
+            if (movedItem) flickable.contentY = clampContentY(flickable.contentY + movedItem.y - anchorY)
+        }
+        slidingBlockWindow = false
+    }
+
+    // Materializes the window starting at page-wide block `start` and returns how far the
+    // surviving rows moved.
+    function moveBlockWindow(start) {
+        finalizeTypingMacro()
+        if (selectionAnchorBlockIndex >= 0) clearCrossBlockSelection()
+
+        const oldStart = blockModel.windowStart
+        blockModel.windowStart = Math.max(0, start)
+        const shift = oldStart - blockModel.windowStart
+        if (shift === 0) return 0
+        cursorUndoStack = []
+        cursorRedoStack = []
+        contentColumn.forceLayout()
+
+        if (currentBlockIndex >= 0) {
+            const shifted = currentBlockIndex + shift
+            currentBlockIndex = (shifted >= 0 && shifted < blockModel.count) ? shifted : -1
+        }
+        return shift
+    }
+
+    // Row of page-wide block `pageIndex`, moving the window to center it if it is not
+    // materialized; -1 if the page has no such block.
+    function blockRowForPageIndex(pageIndex) {
+        if (pageIndex < 0 || pageIndex >= blockModel.totalCount) return -1
+        const start = blockModel.windowStart
+        if (pageIndex < start || pageIndex >= start + blockModel.count) {
+            slidingBlockWindow = true
+            moveBlockWindow(pageIndex - Math.floor(blockModel.windowSize / 2))
+            slidingBlockWindow = false
+        }
+        const row = pageIndex - blockModel.windowStart
+        return (row >= 0 && row < blockRepeater.count) ? row : -1
+    }
+
     function ensureFocusedCursorVisible() {
         if (root.selectionDragging || root.blockRangeSelecting || root.reorderDragging) return
         if (flickable.dragging || flickable.flicking) return
@@ -1063,54 +1136,57 @@ FocusScope {
         flickable.contentY = clampContentY(desiredVisibleTopY - cutTop)
     }
 
-    function scrollToBlockIndex(idx) {
-        if (idx < 0 || idx >= blockRepeater.count) return
-        const item = blockRepeater.itemAt(idx)
+    function scrollToBlockRow(row) {
+        if (row < 0 || row >= blockRepeater.count) return
+        const item = blockRepeater.itemAt(row)
         if (!item) return
         const y = item.mapToItem(flickable.contentItem, 0, 0).y
         const desired = y - (flickable.height - item.height) * 0.5
         flickable.contentY = clampContentY(desired)
     }
 
+    // The *BlockIndex functions below take page-wide indices and return the block's row.
+    function scrollToBlockIndex(idx) {
+        const row = blockRowForPageIndex(idx)
+        scrollToBlockRow(row)
+        return row
+    }
+
     function revealSearchBlockIndex(idx) {
-        if (idx < 0) return
-        scrollToBlockIndex(idx)
+        const row = scrollToBlockIndex(idx)
+        if (row < 0) return -1
         root.searchHighlightBlockIndex = idx
         searchHighlightClearTimer.restart()
+        return row
     }
 
     function focusSearchResult(blockId, blockIndex) {
         let idx = blockIndex === undefined ? -1 : blockIndex
         if (idx < 0 && blockId && blockId !== "") {
-            for (let i = 0; i < blockModel.count; i++) {
-                if (blockModel.get(i).blockId === blockId) {
-                    idx = i
-                    break
-                }
-            }
+            idx = blockModel.pageIndexForBlockId(blockId)
         }
-        if (idx < 0) {
+        const row = revealSearchBlockIndex(idx)
+        if (row < 0) {
             focusContent()
             scheduleEnsureFocusedCursorVisible()
             return
         }
-        revealSearchBlockIndex(idx)
-        focusBlockAtDeferred(idx, 0)
+        focusBlockAtDeferred(row, 0)
         scheduleEnsureFocusedCursorVisible()
     }
 
     function focusDocumentEnd() {
-        if (blockRepeater.count <= 0) return
-        const idx = blockRepeater.count - 1
-        scrollToBlockIndex(idx)
-        focusBlockAtDeferred(idx, -1)
+        const row = scrollToBlockIndex(blockModel.totalCount - 1)
+        if (row < 0) return
+        focusBlockAtDeferred(row, -1)
         scheduleEnsureFocusedCursorVisible()
     }
 
     function focusDocumentStart() {
-        if (blockRepeater.count <= 0) return
+        const row = blockRowForPageIndex(0)
+        if (row < 0) return
         flickable.contentY = 0
-        focusBlockAtDeferred(0, 0)
+        focusBlockAtDeferred(row, 0)
         scheduleEnsureFocusedCursorVisible()
     }
 
@@ -1416,8 +1492,8 @@ FocusScope {
 	                        selectionStart: ("selectionStart" in tc) ? tc.selectionStart : -1,
 	                        selectionEnd: ("selectionEnd" in tc) ? tc.selectionEnd : -1,
 	                        cursorPosition: ("cursorPosition" in tc) ? tc.cursorPosition : 0,
-	                        runs: (bc && ("inlineRuns" in bc)) ? (bc.inlineRuns || []) : [],
-	                        typingAttrs: (bc && ("typingAttrs" in bc)) ? (bc.typingAttrs || ({})) : ({})
+	                        runs: (bc && bc.runKey) ? InlineRunStore.runs(bc.runKey) : [],
+	                        typingAttrs: (bc && bc.runKey) ? InlineRunStore.typingAttrs(bc.runKey) : ({})
 	                    }
 	                }
 
@@ -1428,34 +1504,34 @@ FocusScope {
 	                    const bcNow = itemNow && itemNow.blockControl ? itemNow.blockControl : null
 	                    const tcNow = itemNow && itemNow.textControl ? itemNow.textControl : null
 
+	                    const runKey = (bcNow && bcNow.runKey) ? bcNow.runKey : ""
 	                    const beforeText = tcNow ? (tcNow.text || "") : ""
-	                    const beforeRuns = (bcNow && ("inlineRuns" in bcNow)) ? (bcNow.inlineRuns || []) : []
-	                    const beforeTyping = (bcNow && ("typingAttrs" in bcNow)) ? (bcNow.typingAttrs || ({})) : ({})
 
 	                    const nextText = (result && ("text" in result)) ? (result.text || "") : beforeText
 	                    const focusTarget = (result && ("focusTarget" in result)) ? (result.focusTarget || "") : ""
-	                    const nextTyping = (result && ("typingAttrs" in result)) ? (result.typingAttrs || ({})) : beforeTyping
-	                    let nextRuns = (result && ("runs" in result)) ? (result.runs || []) : null
-
-	                    if (!nextRuns) {
-	                        const cursorForReconcile = (result && ("cursorPosition" in result)) ? result.cursorPosition : (tcNow && ("cursorPosition" in tcNow) ? tcNow.cursorPosition : 0)
-	                        const reconciled = InlineRichText.reconcileTextChange(beforeText,
-	                                                                             nextText,
-	                                                                             beforeRuns,
-	                                                                             beforeTyping,
-	                                                                             cursorForReconcile)
-	                        nextRuns = reconciled && ("runs" in reconciled) ? (reconciled.runs || []) : beforeRuns
+	                    const nextTyping = (result && ("typingAttrs" in result)) ? (result.typingAttrs || ({})) : InlineRunStore.typingAttrs(runKey)
+	                    const nextRuns = (result && ("runs" in result)) ? (result.runs || []) : null
+
+	                    let markup = ""
+	                    if (runKey === "") {
+	                        // Blocks without inline formatting state take the runs as given.
+	                        markup = InlineRichText.serialize(nextText, nextRuns || [])
+	                    } else {
+	                        if (nextRuns) {
+	                            InlineRunStore.setRuns(runKey, nextText, nextRuns)
+	                        } else {
+	                            const cursorForReconcile = (result && ("cursorPosition" in result)) ? result.cursorPosition : (tcNow && ("cursorPosition" in tcNow) ? tcNow.cursorPosition : 0)
+	                            InlineRunStore.reconcile(runKey, nextText, cursorForReconcile)
+	                        }
+	                        markup = InlineRunStore.markup(runKey)
 	                    }
-
-	                    const markup = InlineRichText.serialize(nextText, nextRuns)
 	
 	                    blockModel.beginUndoMacro("Format")
 	                    blockModel.setProperty(idx, "content", markup)
 	                    blockModel.endUndoMacro()
 	                    root.scheduleAutosave()
 
-	                    if (bcNow && ("inlineRuns" in bcNow)) bcNow.inlineRuns = nextRuns
-	                    if (bcNow && ("typingAttrs" in bcNow)) bcNow.typingAttrs = nextTyping
+	                    if (runKey !== "") InlineRunStore.setTypingAttrs(runKey, nextTyping)
 	
 	                    Qt.callLater(() => {
 	                        const item = blockRepeater.itemAt(idx)
@@ -1487,6 +1563,7 @@ FocusScope {
         contentHeight: contentColumn.height + 200
         clip: true
         interactive: !(root.selectionDragging || root.reorderDragging)
+        onContentYChanged: root.maybeSlideBlockWindow()
         
         ScrollBar.vertical: ScrollBar {
             policy: ScrollBar.AsNeeded
@@ -1627,6 +1704,7 @@ FocusScope {
                     
             blockIndex: index
             editor: root
+            blockId: model.blockId
             blockType: model.blockType
             content: model.content
             depth: model.depth
@@ -1749,7 +1827,8 @@ FocusScope {
                     }
 
                     onCursorMoved: function(pos) {
-                        root.cursorMoved(index, pos)
+                        // Peers address blocks by their index in the whole page.
+                        root.cursorMoved(index + blockModel.windowStart, pos)
                     }
                     
                     onLinkClicked: function(linkedPageId) {
@@ -20,8 +20,9 @@ Item {
     signal blockFocused()
     
     readonly property bool showRendered: root.editor && root.editor.renderBlocksWhenNotFocused && !textEdit.activeFocus
-    property var inlineRuns: []
-    property var typingAttrs: ({})
+    property string blockId: ""
+    // Key of this block's entry in InlineRunStore, which owns the inline runs and typing attrs.
+    property string runKey: ""
 
     property string _lastAppliedMarkup: ""
     property string _lastPlainText: ""
@@ -35,21 +36,30 @@ Item {
     implicitHeight: Math.max((showRendered ? rendered.implicitHeight : textEdit.contentHeight) + ThemeManager.spacingSmall * 2, 32)
 
     function _syncFromMarkup() {
-        if (root._syncingFromModel) return
+        if (root._syncingFromModel || root.runKey === "") return
         const markup = root.content || ""
         if (markup === root._lastAppliedMarkup) return
         root._syncingFromModel = true
-        const parsed = InlineRichText.parse(markup)
-        const plain = parsed && ("text" in parsed) ? (parsed.text || "") : ""
-        root.inlineRuns = parsed && ("runs" in parsed) ? (parsed.runs || []) : []
+        const plain = InlineRunStore.load(root.runKey, markup)
         root._lastAppliedMarkup = markup
         root._lastPlainText = plain
         if (textEdit.text !== plain) textEdit.text = plain
         root._syncingFromModel = false
     }
 
+    function _retainRunKey() {
+        if (root.runKey !== "" && (root.blockId === "" || root.blockId === root.runKey)) return
+        const key = InlineRunStore.retain(root.blockId)
+        InlineRunStore.release(root.runKey)
+        root.runKey = key
+        root._lastAppliedMarkup = ""
+        _syncFromMarkup()
+    }
+
     onContentChanged: _syncFromMarkup()
-    Component.onCompleted: _syncFromMarkup()
+    onBlockIdChanged: _retainRunKey()
+    Component.onCompleted: _retainRunKey()
+    Component.onDestruction: InlineRunStore.release(root.runKey)
     
     TextEdit {
         id: rendered
@@ -164,7 +174,7 @@ Item {
 
         InlineRichTextHighlighter {
             document: textEdit.textDocument
-            runs: root.inlineRuns
+            runKey: root.runKey
         }
         
         // Placeholder
@@ -181,15 +191,9 @@ Item {
             const before = root._lastPlainText
             const after = text
             if (before !== after) {
-                const reconciled = InlineRichText.reconcileTextChange(before,
-                                                                     after,
-                                                                     root.inlineRuns || [],
-                                                                     root.typingAttrs || ({}),
-                                                                     cursorPosition)
-                root.inlineRuns = reconciled && ("runs" in reconciled) ? (reconciled.runs || []) : (root.inlineRuns || [])
-                root.typingAttrs = reconciled && ("typingAttrs" in reconciled) ? (reconciled.typingAttrs || ({})) : (root.typingAttrs || ({}))
+                InlineRunStore.reconcile(root.runKey, after, cursorPosition)
                 root._lastPlainText = after
-                const markup = InlineRichText.serialize(after, root.inlineRuns || [])
+                const markup = InlineRunStore.markup(root.runKey)
                 root._lastAppliedMarkup = markup
                 root.contentEdited(markup)
             }
@@ -204,7 +208,7 @@ Item {
 
         onCursorPositionChanged: {
             if (root._syncingFromModel) return
-            root.typingAttrs = InlineRichText.attrsAt(root.inlineRuns || [], cursorPosition)
+            InlineRunStore.moveCursor(root.runKey, cursorPosition)
         }
 
         Keys.onShortcutOverride: function(event) {
@@ -17,29 +17,39 @@ Item {
     signal collapseToggled()
     signal blockFocused()
 
-    property var inlineRuns: []
-    property var typingAttrs: ({})
+    property string blockId: ""
+    // Key of this block's entry in InlineRunStore, which owns the inline runs and typing attrs.
+    property string runKey: ""
 
     property string _lastAppliedMarkup: ""
     property string _lastPlainText: ""
     property bool _syncingFromModel: false
 
     function _syncFromMarkup() {
-        if (root._syncingFromModel) return
+        if (root._syncingFromModel || root.runKey === "") return
         const markup = root.content || ""
         if (markup === root._lastAppliedMarkup) return
         root._syncingFromModel = true
-        const parsed = InlineRichText.parse(markup)
-        const plain = parsed && ("text" in parsed) ? (parsed.text || "") : ""
-        root.inlineRuns = parsed && ("runs" in parsed) ? (parsed.runs || []) : []
+        const plain = InlineRunStore.load(root.runKey, markup)
         root._lastAppliedMarkup = markup
         root._lastPlainText = plain
         if (textEdit.text !== plain) textEdit.text = plain
         root._syncingFromModel = false
     }
 
+    function _retainRunKey() {
+        if (root.runKey !== "" && (root.blockId === "" || root.blockId === root.runKey)) return
+        const key = InlineRunStore.retain(root.blockId)
+        InlineRunStore.release(root.runKey)
+        root.runKey = key
+        root._lastAppliedMarkup = ""
+        _syncFromMarkup()
+    }
+
     onContentChanged: _syncFromMarkup()
-    Component.onCompleted: _syncFromMarkup()
+    onBlockIdChanged: _retainRunKey()
+    Component.onCompleted: _retainRunKey()
+    Component.onDestruction: InlineRunStore.release(root.runKey)
     
     implicitHeight: Math.max(rowLayout.height + ThemeManager.spacingSmall * 2, 32)
     
@@ -81,7 +91,7 @@ Item {
 
                 InlineRichTextHighlighter {
                     document: textEdit.textDocument
-                    runs: root.inlineRuns
+                    runKey: root.runKey
                 }
             
             // Placeholder
@@ -98,15 +108,9 @@ Item {
 	                const before = root._lastPlainText
 	                const after = text
 	                if (before !== after) {
-	                    const reconciled = InlineRichText.reconcileTextChange(before,
-	                                                                         after,
-	                                                                         root.inlineRuns || [],
-	                                                                         root.typingAttrs || ({}),
-	                                                                         cursorPosition)
-	                    root.inlineRuns = reconciled && ("runs" in reconciled) ? (reconciled.runs || []) : (root.inlineRuns || [])
-	                    root.typingAttrs = reconciled && ("typingAttrs" in reconciled) ? (reconciled.typingAttrs || ({})) : (root.typingAttrs || ({}))
+	                    InlineRunStore.reconcile(root.runKey, after, cursorPosition)
 	                    root._lastPlainText = after
-	                    const markup = InlineRichText.serialize(after, root.inlineRuns || [])
+	                    const markup = InlineRunStore.markup(root.runKey)
 	                    root._lastAppliedMarkup = markup
 	                    root.contentEdited(markup)
 	                }
@@ -120,7 +124,7 @@ Item {
 
                 onCursorPositionChanged: {
                     if (root._syncingFromModel) return
-                    root.typingAttrs = InlineRichText.attrsAt(root.inlineRuns || [], cursorPosition)
+                    InlineRunStore.moveCursor(root.runKey, cursorPosition)
                 }
 
             Keys.onShortcutOverride: function(event) {
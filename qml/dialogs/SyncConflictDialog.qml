@@ -13,6 +13,17 @@ Dialog {
 
     property var mergePreview: ({})
 
+    Connections {
+        target: DataStore
+        enabled: root.visible
+
+        function onPageConflictMergeReady(readyPageId) {
+            if (readyPageId === root.pageId) {
+                root.mergePreview = DataStore.previewMergeForPageConflict(root.pageId)
+            }
+        }
+    }
+
     function cssColor(c) {
         return "rgba(" +
             Math.round(c.r * 255) + ", " +
@@ -13,7 +13,7 @@ SettingsPage {
     property bool exportAllNotebooks: true
     property bool exportIncludeAttachments: true
     property url exportDestinationFolder: ""
-    property int exportFormatIndex: 0 // 0=markdown, 1=html
+    property int exportFormatIndex: 0 // 0=markdown, 1=html, 2=archive
     property string exportStatus: ""
     property bool exportSucceeded: false
     property string exportFolderPickerStatus: ""
@@ -21,7 +21,7 @@ SettingsPage {
     property url folderPickerSelectedFolder: ""
     property string exportFolderPickerPathText: ""
     property url importSourceFolder: ""
-    property int importFormatIndex: 0 // 0=auto, 1=markdown, 2=html
+    property int importFormatIndex: 0 // 0=auto, 1=markdown, 2=html, 3=archive
     property bool importReplaceExisting: false
     property string importStatus: ""
     property bool importSucceeded: false
@@ -184,6 +184,22 @@ SettingsPage {
     property Connections _dataStoreConnections: Connections {
         target: DataStore
         function onNotebooksChanged() { refreshNotebooks() }
+        function onExportProgress(done, total) {
+            exportSucceeded = true
+            exportStatus = "Exporting… " + done + " / " + total
+        }
+        function onExportFinished(ok, message) {
+            exportSucceeded = ok
+            exportStatus = ok ? "Export complete." : message
+        }
+        function onImportProgress(done, total) {
+            importSucceeded = true
+            importStatus = "Importing… " + done + " / " + total
+        }
+        function onImportFinished(ok, message) {
+            importSucceeded = ok
+            importStatus = ok ? "Import complete." : message
+        }
         function onError(message) {
             if (newFolderDialog && newFolderDialog.visible) {
                 if (newFolderTarget === "import") {
@@ -514,7 +530,7 @@ SettingsPage {
                 label: "Format"
                 SettingsComboBox {
                     width: parent.width
-                    model: ["Markdown (.md)", "HTML (.html)"]
+                    model: ["Markdown (.md)", "HTML (.html)", "Single file (.zincpack)"]
                     currentIndex: exportFormatIndex
                     onCurrentIndexChanged: exportFormatIndex = currentIndex
                 }
@@ -599,25 +615,28 @@ SettingsPage {
                 Item { Layout.fillWidth: true }
 
                 SettingsButton {
-                    text: "Cancel"
-                    onClicked: exportDialog.close()
+                    text: DataStore && DataStore.exporting ? "Stop" : "Cancel"
+                    onClicked: {
+                        if (DataStore && DataStore.exporting) {
+                            DataStore.cancelExport()
+                        } else {
+                            exportDialog.close()
+                        }
+                    }
                 }
 
                 SettingsButton {
                     text: "Export"
-                    enabled: canExport()
+                    enabled: canExport() && !(DataStore && DataStore.exporting)
                     onClicked: {
                         if (!DataStore) return
                         exportStatus = ""
                         exportSucceeded = false
                         const ids = exportAllNotebooks ? [] : selectedNotebookIds()
-                        const fmt = exportFormatIndex === 0 ? "markdown" : "html"
+                        const fmt = ["markdown", "html", "archive"][exportFormatIndex]
                         DataStore.setExportLastFolder(exportDestinationFolder)
-                        const ok = DataStore.exportNotebooks(ids, exportDestinationFolder, fmt, exportIncludeAttachments)
-                        if (ok) {
-                            exportSucceeded = true
-                            exportStatus = "Export complete."
-                        }
+                        // Runs in the background; progress and the result arrive via DataStore signals.
+                        DataStore.startExportNotebooks(ids, exportDestinationFolder, fmt, exportIncludeAttachments)
                     }
                 }
             }
@@ -648,7 +667,7 @@ SettingsPage {
                 label: "Format"
                 SettingsComboBox {
                     width: parent.width
-                    model: ["Auto", "Markdown (.md)", "HTML (.html)"]
+                    model: ["Auto", "Markdown (.md)", "HTML (.html)", "Single file (.zincpack)"]
                     currentIndex: importFormatIndex
                     onCurrentIndexChanged: importFormatIndex = currentIndex
                 }
@@ -712,23 +731,26 @@ SettingsPage {
                 Item { Layout.fillWidth: true }
 
                 SettingsButton {
-                    text: "Cancel"
-                    onClicked: importDialog.close()
+                    text: DataStore && DataStore.importing ? "Stop" : "Cancel"
+                    onClicked: {
+                        if (DataStore && DataStore.importing) {
+                            DataStore.cancelImport()
+                        } else {
+                            importDialog.close()
+                        }
+                    }
                 }
 
                 SettingsButton {
                     text: "Import"
-                    enabled: importSourceFolder && importSourceFolder !== ""
+                    enabled: importSourceFolder && importSourceFolder !== "" && !(DataStore && DataStore.importing)
                     onClicked: {
                         if (!DataStore) return
                         importStatus = ""
                         importSucceeded = false
-                        const fmt = importFormatIndex === 0 ? "auto" : (importFormatIndex === 1 ? "markdown" : "html")
-                        const ok = DataStore.importNotebooks(importSourceFolder, fmt, importReplaceExisting)
-                        if (ok) {
-                            importSucceeded = true
-                            importStatus = "Import complete."
-                        }
+                        const fmt = ["auto", "markdown", "html", "archive"][importFormatIndex]
+                        // Pages are written in the background; progress and the result arrive via DataStore signals.
+                        DataStore.startImportNotebooks(importSourceFolder, fmt, importReplaceExisting)
                     }
                 }
             }
@@ -0,0 +1,92 @@
+#!/usr/bin/env python3
+"""Compare two zinc_benchmarks runs and flag regressions.
+
+Both inputs are Catch2 XML reports, e.g.:
+
+    zinc_benchmarks --reporter xml::out=base.xml
+    zinc_benchmarks --reporter xml::out=head.xml
+    scripts/compare_benchmarks.py base.xml head.xml --threshold 10
+
+A benchmark regresses when its mean grows by more than --threshold percent and,
+unless --ignore-noise is given, the new lower bound is above the old upper bound
+(Catch2's bootstrapped confidence interval), so noisy runs don't fail the check.
+Exit status is 1 when any benchmark regressed, 0 otherwise.
+"""
+
+import argparse
+import json
+import sys
+import xml.etree.ElementTree as ET
+
+
+def load(path):
+    results = {}
+    root = ET.parse(path).getroot()
+    for case in root.iter("TestCase"):
+        case_name = case.get("name", "")
+        for bench in case.iter("BenchmarkResults"):
+            mean = bench.find("mean")
+            if mean is None:
+                continue
+            key = f"{case_name} / {bench.get('name', '')}"
+            results[key] = {
+                "mean": float(mean.get("value")),
+                "low": float(mean.get("lowerBound", mean.get("value"))),
+                "high": float(mean.get("upperBound", mean.get("value"))),
+            }
+    return results
+
+
+def format_ns(ns):
+    for unit, scale in (("s", 1e9), ("ms", 1e6), ("us", 1e3)):
+        if ns >= scale:
+            return f"{ns / scale:.2f} {unit}"
+    return f"{ns:.0f} ns"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("base", help="baseline Catch2 XML report")
+    parser.add_argument("head", help="candidate Catch2 XML report")
+    parser.add_argument("--threshold", type=float, default=10.0, help="allowed slowdown in percent (default 10)")
+    parser.add_argument("--ignore-noise", action="store_true", help="flag on mean alone, ignoring confidence intervals")
+    parser.add_argument("--json", action="store_true", help="print machine-readable results")
+    args = parser.parse_args()
+
+    base = load(args.base)
+    head = load(args.head)
+    rows = []
+    for key in sorted(set(base) | set(head)):
+        b = base.get(key)
+        h = head.get(key)
+        row = {"benchmark": key, "status": "ok"}
+        if b is None or h is None:
+            row["status"] = "added" if b is None else "removed"
+        else:
+            change = (h["mean"] - b["mean"]) / b["mean"] * 100.0 if b["mean"] > 0 else 0.0
+            row.update(base_ns=b["mean"], head_ns=h["mean"], change_pct=change)
+            significant = args.ignore_noise or h["low"] > b["high"]
+            if change > args.threshold and significant:
+                row["status"] = "regression"
+            elif change < -args.threshold and (args.ignore_noise or h["high"] < b["low"]):
+                row["status"] = "improvement"
+        rows.append(row)
+
+    regressions = [r for r in rows if r["status"] == "regression"]
+    if args.json:
+        json.dump({"threshold_pct": args.threshold, "results": rows, "regressions": len(regressions)}, sys.stdout, indent=2)
+        print()
+    else:
+        width = max((len(r["benchmark"]) for r in rows), default=10)
+        for r in rows:
+            if "change_pct" in r:
+                print(f"{r['benchmark']:<{width}}  {format_ns(r['base_ns']):>10} -> {format_ns(r['head_ns']):>10}"
+                      f"  {r['change_pct']:+7.1f}%  {r['status']}")
+            else:
+                print(f"{r['benchmark']:<{width}}  {r['status']}")
+        print(f"\n{len(regressions)} regression(s) above {args.threshold:g}%")
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -1,9 +1,14 @@
 #pragma once
 
-#include <string>
+#include <algorithm>
+#include <array>
 #include <compare>
+#include <cstdint>
 #include <optional>
 #include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
 
 namespace zinc {
 
@@ -33,6 +38,16 @@ public:
     static constexpr char SMALLEST = '0';
     static constexpr char LARGEST = 'z';
     static constexpr char MIDPOINT = 'V'; // Approximately middle of base-62
+
+    // Digit value per byte, -1 for characters outside DIGITS.
+    static constexpr std::array<int8_t, 256> DIGIT_VALUES = [] {
+        std::array<int8_t, 256> table{};
+        table.fill(-1);
+        for (size_t i = 0; i < DIGITS.size(); ++i) {
+            table[static_cast<unsigned char>(DIGITS[i])] = static_cast<int8_t>(i);
+        }
+        return table;
+    }();
     
     /**
      * Create an empty (smallest possible) index.
@@ -45,12 +60,22 @@ public:
     explicit FractionalIndex(std::string value) : value_(std::move(value)) {
         validate();
     }
+
+    /**
+     * Create an index from a value that was already validated (e.g. read back
+     * from storage or produced by this class). Skips the per-character check.
+     */
+    [[nodiscard]] static FractionalIndex from_trusted(std::string value) noexcept {
+        FractionalIndex idx;
+        idx.value_ = std::move(value);
+        return idx;
+    }
     
     /**
      * Generate the first index (for an empty list).
      */
     [[nodiscard]] static FractionalIndex first() {
-        return FractionalIndex(std::string(1, MIDPOINT));
+        return from_trusted(std::string(1, MIDPOINT));
     }
     
     /**
@@ -90,6 +115,131 @@ public:
         return generate_between(a, b);
     }
     
+    /**
+     * Generate n ascending indices between two existing indices, spread evenly
+     * over the gap using the shortest key length that fits them all.
+     *
+     * Unlike chaining between() n times (keys grow by one digit every few
+     * inserts), key length grows with log62(n), so bulk pastes and imports
+     * stay compact.
+     *
+     * @param before The index that should come before the new ones (empty = start)
+     * @param after The index that should come after the new ones (empty = end)
+     * @param n Number of indices to generate
+     */
+    [[nodiscard]] static std::vector<FractionalIndex> between_n(
+        const FractionalIndex& before,
+        const FractionalIndex& after,
+        size_t n
+    ) {
+        const auto& a = before.value_;
+        const auto& b = after.value_;
+        if (!a.empty() && !b.empty() && a >= b) {
+            throw std::invalid_argument("FractionalIndex::between_n requires before < after");
+        }
+
+        std::vector<FractionalIndex> out;
+        if (n == 0) {
+            return out;
+        }
+        if (n > (UINT64_MAX / BASE) / 4) {
+            throw std::invalid_argument("FractionalIndex::between_n: n too large");
+        }
+        out.reserve(n);
+
+        // Work on keys of exactly `len` digits as base-62 integers (with one extra
+        // leading digit so "end of list" = 62^len fits). The gap has to leave room
+        // for two slots per key so a key ending in '0' can be bumped by one.
+        const size_t max_len = std::max(a.size(), b.size()) + 12;
+        for (size_t len = 1; len <= max_len; ++len) {
+            const auto lo = digits_at_length(a, len, false);
+            const auto hi = digits_at_length(b, len, b.empty());
+            const auto gap = subtract_digits(hi, lo);
+            const uint64_t slots = static_cast<uint64_t>(n) + 1;
+            if (!digits_at_least(gap, 2 * slots)) {
+                continue;
+            }
+
+            // key_i = lo + floor(gap * (i + 1) / slots): step by q, and spread the
+            // remainder r one unit at a time (Bresenham) so nothing overflows.
+            uint64_t r = 0;
+            const auto q = divide_digits(gap, slots, r);
+            auto key = lo;
+            uint64_t spread = 0;
+            for (size_t i = 0; i < n; ++i) {
+                add_digits(key, q);
+                spread += r;
+                if (spread >= slots) {
+                    spread -= slots;
+                    add_small(key, 1);
+                }
+
+                auto digits = key;
+                if (digits.back() == 0) {
+                    // Trailing '0' would leave no room before the key; q >= 2 keeps this unique.
+                    add_small(digits, 1);
+                }
+                std::string value;
+                value.reserve(len);
+                for (size_t d = 1; d < digits.size(); ++d) {
+                    value += DIGITS[digits[d]];
+                }
+                out.push_back(from_trusted(std::move(value)));
+            }
+            return out;
+        }
+        throw std::invalid_argument("FractionalIndex::between_n: no room between indices");
+    }
+
+    /**
+     * Rewrite over-long keys in an ascending sibling list to short, evenly
+     * spaced ones, preserving order.
+     *
+     * Each maximal run of keys longer than max_length (or repeating the
+     * previous key) is replaced with between_n() of its unchanged neighbours;
+     * if a run does not fit, the whole list is renumbered. Returns a list of
+     * the same size; keys that did not need rewriting are kept as-is.
+     */
+    [[nodiscard]] static std::vector<FractionalIndex> rebalance(
+        const std::vector<FractionalIndex>& keys,
+        size_t max_length
+    ) {
+        std::vector<FractionalIndex> out = keys;
+        const auto needs_rewrite = [&](size_t i) {
+            return keys[i].value_.size() > max_length || (i > 0 && keys[i] == keys[i - 1]);
+        };
+
+        for (size_t start = 0; start < keys.size();) {
+            if (!needs_rewrite(start)) {
+                ++start;
+                continue;
+            }
+            size_t end = start + 1;
+            while (end < keys.size() && needs_rewrite(end)) {
+                ++end;
+            }
+
+            const auto lo = start > 0 ? keys[start - 1] : FractionalIndex{};
+            const auto hi = end < keys.size() ? keys[end] : FractionalIndex{};
+            std::vector<FractionalIndex> run;
+            try {
+                run = between_n(lo, hi, end - start);
+            } catch (const std::invalid_argument&) {
+                run.clear();
+            }
+            const bool fits = !run.empty() &&
+                std::all_of(run.begin(), run.end(), [&](const FractionalIndex& k) {
+                    return k.value_.size() <= max_length;
+                });
+            if (!fits) {
+                return between_n(FractionalIndex{}, FractionalIndex{}, keys.size());
+            }
+            std::move(run.begin(), run.end(), out.begin() + static_cast<std::ptrdiff_t>(start));
+            start = end;
+        }
+        return out;
+    }
+
     /**
      * Generate an index before this one.
      */
@@ -132,7 +282,7 @@ private:
     
     void validate() const {
         for (char c : value_) {
-            if (DIGITS.find(c) == std::string_view::npos) {
+            if (DIGIT_VALUES[static_cast<unsigned char>(c)] < 0) {
                 throw std::invalid_argument(
                     "FractionalIndex contains invalid character: " + std::string(1, c));
             }
@@ -140,11 +290,82 @@ private:
     }
     
     [[nodiscard]] static size_t digit_value(char c) {
-        auto pos = DIGITS.find(c);
-        if (pos == std::string_view::npos) {
+        const auto v = DIGIT_VALUES[static_cast<unsigned char>(c)];
+        if (v < 0) {
             throw std::invalid_argument("Invalid digit: " + std::string(1, c));
         }
-        return pos;
+        return static_cast<size_t>(v);
+    }
+
+    // Fixed-width base-62 integers for between_n, most significant digit first.
+    using Digits = std::vector<uint8_t>;
+
+    // `value` truncated or zero-padded to len digits, or 62^len when `end` is set.
+    [[nodiscard]] static Digits digits_at_length(const std::string& value, size_t len, bool end) {
+        Digits out(len + 1, 0);
+        if (end) {
+            out[0] = 1;
+            return out;
+        }
+        for (size_t i = 0; i < len && i < value.size(); ++i) {
+            out[i + 1] = static_cast<uint8_t>(digit_value(value[i]));
+        }
+        return out;
+    }
+
+    // hi - lo, clamped to zero when lo > hi.
+    [[nodiscard]] static Digits subtract_digits(const Digits& hi, const Digits& lo) {
+        Digits out(hi.size(), 0);
+        int borrow = 0;
+        for (size_t i = hi.size(); i > 0; --i) {
+            int d = static_cast<int>(hi[i - 1]) - static_cast<int>(lo[i - 1]) - borrow;
+            borrow = d < 0 ? 1 : 0;
+            out[i - 1] = static_cast<uint8_t>(d + borrow * static_cast<int>(BASE));
+        }
+        if (borrow != 0) {
+            out.assign(hi.size(), 0);
+        }
+        return out;
+    }
+
+    [[nodiscard]] static bool digits_at_least(const Digits& value, uint64_t threshold) {
+        uint64_t acc = 0;
+        for (const auto d : value) {
+            if (acc >= threshold) {
+                return true; // remaining digits only make it larger
+            }
+            acc = acc * BASE + d;
+        }
+        return acc >= threshold;
+    }
+
+    [[nodiscard]] static Digits divide_digits(const Digits& value, uint64_t divisor, uint64_t& remainder) {
+        Digits out(value.size(), 0);
+        uint64_t rem = 0;
+        for (size_t i = 0; i < value.size(); ++i) {
+            rem = rem * BASE + value[i];
+            out[i] = static_cast<uint8_t>(rem / divisor);
+            rem %= divisor;
+        }
+        remainder = rem;
+        return out;
+    }
+
+    static void add_digits(Digits& value, const Digits& addend) {
+        unsigned carry = 0;
+        for (size_t i = value.size(); i > 0; --i) {
+            const unsigned d = value[i - 1] + addend[i - 1] + carry;
+            value[i - 1] = static_cast<uint8_t>(d % BASE);
+            carry = d / BASE;
+        }
+    }
+
+    static void add_small(Digits& value, uint64_t addend) {
+        for (size_t i = value.size(); i > 0 && addend > 0; --i) {
+            const uint64_t d = value[i - 1] + addend;
+            value[i - 1] = static_cast<uint8_t>(d % BASE);
+            addend = d / BASE;
+        }
     }
     
     [[nodiscard]] static char value_digit(size_t v) {
@@ -166,12 +387,12 @@ private:
                 if (bv > 1) {
                     // Simple case: just use midpoint between 0 and b[i]
                     result += value_digit(bv / 2);
-                    return FractionalIndex(result);
+                    return from_trusted(std::move(result));
                 } else {
                     // b[i] is '1', use '0' and continue with midpoint
                     result += SMALLEST;
                     result += MIDPOINT;
-                    return FractionalIndex(result);
+                    return from_trusted(std::move(result));
                 }
             }
             
@@ -180,7 +401,7 @@ private:
         
         // All zeros - append midpoint
         result += MIDPOINT;
-        return FractionalIndex(result);
+        return from_trusted(std::move(result));
     }
     
     [[nodiscard]] static FractionalIndex generate_after(const std::string& a) {
@@ -193,13 +414,13 @@ private:
             if (av < BASE - 1) {
                 // We can increment here
                 result[i - 1] = value_digit(av + (BASE - 1 - av) / 2 + 1);
-                return FractionalIndex(result);
+                return from_trusted(std::move(result));
             }
         }
         
         // All at max - append midpoint
         result += MIDPOINT;
-        return FractionalIndex(result);
+        return from_trusted(std::move(result));
     }
     
     [[nodiscard]] static FractionalIndex generate_between(
@@ -222,7 +443,7 @@ private:
             if (bv - av > 1) {
                 // Room to insert between these digits
                 result += value_digit(av + (bv - av) / 2);
-                return FractionalIndex(result);
+                return from_trusted(std::move(result));
             }
             
             // Difference is 1, need to go deeper
@@ -234,7 +455,7 @@ private:
             
             if (a_suffix.empty()) {
                 result += MIDPOINT;
-                return FractionalIndex(result);
+                return from_trusted(std::move(result));
             }
             
             // Generate between a_suffix and "end"
@@ -243,12 +464,12 @@ private:
             // But we need to make sure it's still less than b's suffix
             // Since b[i] is av+1 > av, anything we append will be < b
             result += suffix_result.value();
-            return FractionalIndex(result);
+            return from_trusted(std::move(result));
         }
         
         // Should not reach here if a < b
         result += MIDPOINT;
-        return FractionalIndex(result);
+        return from_trusted(std::move(result));
     }
 };
 
@@ -2,6 +2,10 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace zinc {
@@ -45,14 +49,170 @@ std::string join_lines(const Lines& lines) {
     return out;
 }
 
+using LineIds = std::vector<uint32_t>;
+
+// Maps each distinct line to a small integer so the diff compares ids, not strings.
+// Views point into the split Lines, which outlive the interner.
+class LineInterner {
+public:
+    LineIds intern(const Lines& lines) {
+        LineIds ids;
+        ids.reserve(lines.size());
+        for (const auto& line : lines) {
+            const auto [it, inserted] = ids_.try_emplace(std::string_view(line), static_cast<uint32_t>(ids_.size()));
+            ids.push_back(it->second);
+        }
+        return ids;
+    }
+
+private:
+    std::unordered_map<std::string_view, uint32_t> ids_;
+};
+
+// Myers' O((N+M)D) diff with the linear-space middle-snake split. Produces the
+// matched (base, other) index pairs in increasing order, or nothing once the
+// search has taken more than `budget` diagonal steps.
+class MyersDiff {
+public:
+    MyersDiff(const LineIds& a, const LineIds& b, size_t budget) : a_(a), b_(b), budget_(budget) {}
+
+    std::optional<std::vector<std::pair<size_t, size_t>>> matches() {
+        matches_.clear();
+        diff(0, a_.size(), 0, b_.size());
+        if (budget_ == 0) return std::nullopt;
+        return std::move(matches_);
+    }
+
+private:
+    const LineIds& a_;
+    const LineIds& b_;
+    size_t budget_;
+    std::vector<std::pair<size_t, size_t>> matches_;
+    std::vector<std::ptrdiff_t> forward_;
+    std::vector<std::ptrdiff_t> backward_;
+
+    void diff(size_t a0, size_t a1, size_t b0, size_t b1) {
+        // Trim the common prefix and suffix; edits are usually small and local.
+        while (a0 < a1 && b0 < b1 && a_[a0] == b_[b0]) {
+            matches_.emplace_back(a0++, b0++);
+        }
+        size_t suffix = 0;
+        while (a0 < a1 - suffix && b0 < b1 - suffix && a_[a1 - suffix - 1] == b_[b1 - suffix - 1]) {
+            ++suffix;
+        }
+        a1 -= suffix;
+        b1 -= suffix;
+
+        if (a0 < a1 && b0 < b1 && budget_ > 0) {
+            const auto [x, y] = middle_snake(a0, a1, b0, b1);
+            if (x == 0 && y == 0) {
+                // No common line in this range: all of it is delete + insert.
+            } else {
+                diff(a0, a0 + x, b0, b0 + y);
+                diff(a0 + x, a1, b0 + y, b1);
+            }
+        }
+
+        for (size_t s = 0; s < suffix; ++s) {
+            matches_.emplace_back(a1 + s, b1 + s);
+        }
+    }
+
+    // Returns the split point (relative to a0/b0) where the forward and reverse
+    // D-paths overlap, or (0, 0) when the ranges share nothing or the budget runs
+    // out. Callers trim the prefix/suffix first, so a found split always makes
+    // progress on both sides.
+    std::pair<size_t, size_t> middle_snake(size_t a0, size_t a1, size_t b0, size_t b1) {
+        const auto n = static_cast<std::ptrdiff_t>(a1 - a0);
+        const auto m = static_cast<std::ptrdiff_t>(b1 - b0);
+        const std::ptrdiff_t max_d = (n + m + 1) / 2;
+        const std::ptrdiff_t offset = max_d + 1;
+        const auto width = static_cast<size_t>(2 * max_d + 3);
+        forward_.assign(width, -1);
+        backward_.assign(width, -1);
+        forward_[offset + 1] = 0;
+        backward_[offset + 1] = 0;
+
+        const std::ptrdiff_t delta = n - m;
+        const bool odd = (delta & 1) != 0;
+        std::ptrdiff_t k1_start = 0, k1_end = 0, k2_start = 0, k2_end = 0;
+
+        for (std::ptrdiff_t d = 0; d < max_d; ++d) {
+            // Round d visits d + 1 diagonals in each direction.
+            const auto cost = static_cast<size_t>(2 * d + 2);
+            if (budget_ <= cost) {
+                budget_ = 0;
+                return {0, 0};
+            }
+            budget_ -= cost;
+
+            for (std::ptrdiff_t k1 = -d + k1_start; k1 <= d - k1_end; k1 += 2) {
+                const auto i1 = offset + k1;
+                std::ptrdiff_t x1 = (k1 == -d || (k1 != d && forward_[i1 - 1] < forward_[i1 + 1]))
+                    ? forward_[i1 + 1]
+                    : forward_[i1 - 1] + 1;
+                std::ptrdiff_t y1 = x1 - k1;
+                while (x1 < n && y1 < m && a_[a0 + x1] == b_[b0 + y1]) {
+                    ++x1;
+                    ++y1;
+                }
+                forward_[i1] = x1;
+                if (x1 > n) {
+                    k1_end += 2;
+                } else if (y1 > m) {
+                    k1_start += 2;
+                } else if (odd) {
+                    const auto i2 = offset + delta - k1;
+                    if (i2 >= 0 && i2 < static_cast<std::ptrdiff_t>(width) && backward_[i2] != -1 &&
+                        x1 >= n - backward_[i2]) {
+                        return {static_cast<size_t>(x1), static_cast<size_t>(y1)};
+                    }
+                }
+            }
+
+            for (std::ptrdiff_t k2 = -d + k2_start; k2 <= d - k2_end; k2 += 2) {
+                const auto i2 = offset + k2;
+                std::ptrdiff_t x2 = (k2 == -d || (k2 != d && backward_[i2 - 1] < backward_[i2 + 1]))
+                    ? backward_[i2 + 1]
+                    : backward_[i2 - 1] + 1;
+                std::ptrdiff_t y2 = x2 - k2;
+                while (x2 < n && y2 < m && a_[a0 + n - x2 - 1] == b_[b0 + m - y2 - 1]) {
+                    ++x2;
+                    ++y2;
+                }
+                backward_[i2] = x2;
+                if (x2 > n) {
+                    k2_end += 2;
+                } else if (y2 > m) {
+                    k2_start += 2;
+                } else if (!odd) {
+                    const auto i1 = offset + delta - k2;
+                    if (i1 >= 0 && i1 < static_cast<std::ptrdiff_t>(width) && forward_[i1] != -1) {
+                        const auto x1 = forward_[i1];
+                        const auto y1 = x1 - (i1 - offset);
+                        if (x1 >= n - x2) {
+                            return {static_cast<size_t>(x1), static_cast<size_t>(y1)};
+                        }
+                    }
+                }
+            }
+        }
+        return {0, 0};
+    }
+};
+
 struct DiffEdits {
     std::vector<Lines> inserts_before; // size = base.size() + 1
     std::vector<bool> deletes;         // size = base.size()
 };
 
-DiffEdits diff_edits_from_base(const Lines& base, const Lines& other, size_t cell_limit) {
-    const auto n = base.size();
-    const auto m = other.size();
+// Returns nothing when the diff exceeds `budget`.
+std::optional<DiffEdits> diff_edits_from_base(const LineIds& base_ids,
+                                              const Lines& other,
+                                              const LineIds& other_ids,
+                                              size_t budget) {
+    const auto n = base_ids.size();
+    const auto m = other_ids.size();
 
     DiffEdits edits{
         .inserts_before = std::vector<Lines>(n + 1),
@@ -64,52 +224,26 @@ DiffEdits diff_edits_from_base(const Lines& base, const Lines& other, size_t cel
         return edits;
     }
 
-    // LCS DP table (n+1)*(m+1) - ok for small-ish notes.
-    if ((n + 1) * (m + 1) > cell_limit) {
-        // Best-effort fallback: treat as all replaced at start.
-        edits.deletes.assign(n, true);
-        edits.inserts_before[0] = other;
-        return edits;
-    }
-
-    std::vector<int> dp((n + 1) * (m + 1), 0);
-    const auto at = [&](size_t i, size_t j) -> int& { return dp[i * (m + 1) + j]; };
-
-    for (size_t i = 0; i < n; ++i) {
-        for (size_t j = 0; j < m; ++j) {
-            if (base[i] == other[j]) {
-                at(i + 1, j + 1) = at(i, j) + 1;
-            } else {
-                at(i + 1, j + 1) = std::max(at(i, j + 1), at(i + 1, j));
-            }
-        }
-    }
-
-    // Backtrack to build edits (inserts_before + deletes).
-    size_t i = n;
-    size_t j = m;
-    while (i > 0 || j > 0) {
-        if (i > 0 && j > 0 && base[i - 1] == other[j - 1]) {
-            --i;
-            --j;
-            continue;
+    // Lines between two matches are deleted from base and inserted before the
+    // next matched base line, i.e. a replacement lands after its deletions.
+    const auto matches = MyersDiff(base_ids, other_ids, budget).matches();
+    if (!matches) return std::nullopt;
+    size_t i = 0;
+    size_t j = 0;
+    const auto fill_gap = [&](size_t next_i, size_t next_j) {
+        for (; i < next_i; ++i) {
+            edits.deletes[i] = true;
         }
-        if (j > 0 && (i == 0 || at(i, j - 1) >= at(i - 1, j))) {
-            // Insert other[j-1] before base[i]
-            edits.inserts_before[i].push_back(other[j - 1]);
-            --j;
-            continue;
+        for (; j < next_j; ++j) {
+            edits.inserts_before[next_i].push_back(other[j]);
         }
-        if (i > 0) {
-            edits.deletes[i - 1] = true;
-            --i;
-            continue;
-        }
-    }
-
-    for (auto& bucket : edits.inserts_before) {
-        std::reverse(bucket.begin(), bucket.end());
+    };
+    for (const auto& [mi, mj] : *matches) {
+        fill_gap(mi, mj);
+        ++i;
+        ++j;
     }
+    fill_gap(n, m);
     return edits;
 }
 
@@ -136,7 +270,8 @@ Lines conflict_chunk(const Lines& ours, const Lines& theirs) {
 
 ThreeWayMergeResult three_way_merge_text(std::string_view base_text,
                                         std::string_view ours_text,
-                                        std::string_view theirs_text) {
+                                        std::string_view theirs_text,
+                                        size_t diff_budget) {
     if (ours_text == theirs_text) {
         return ThreeWayMergeResult{ThreeWayMergeResult::Kind::Clean, std::string(ours_text)};
     }
@@ -151,17 +286,27 @@ ThreeWayMergeResult three_way_merge_text(std::string_view base_text,
     const auto ours = split_lines(ours_text);
     const auto theirs = split_lines(theirs_text);
 
-    // Keep this small: we want deterministic behavior and bounded memory.
-    static constexpr size_t cell_limit = 2'000'000; // ~8MB ints worst case
-
-    const auto ours_edits = diff_edits_from_base(base, ours, cell_limit);
-    const auto theirs_edits = diff_edits_from_base(base, theirs, cell_limit);
+    // One interner for all three sides so equal lines share an id across diffs.
+    LineInterner interner;
+    const auto base_ids = interner.intern(base);
+    auto ours_edits = diff_edits_from_base(base_ids, ours, interner.intern(ours), diff_budget);
+    std::optional<DiffEdits> theirs_edits;
+    if (ours_edits) {
+        theirs_edits = diff_edits_from_base(base_ids, theirs, interner.intern(theirs), diff_budget);
+    }
+    if (!ours_edits || !theirs_edits) {
+        // Too far apart to line up cheaply: one conflict over the whole document.
+        return ThreeWayMergeResult{
+            ThreeWayMergeResult::Kind::Conflict,
+            join_lines(conflict_chunk(ours, theirs)),
+            {MergeConflictHunk{0, std::string(ours_text), std::string(theirs_text)}},
+        };
+    }
 
     bool clean = true;
-    bool too_large = ((base.size() + 1) * (ours.size() + 1) > cell_limit) ||
-                     ((base.size() + 1) * (theirs.size() + 1) > cell_limit);
 
     Lines merged;
+    std::vector<MergeConflictHunk> conflicts;
     merged.reserve(std::max({base.size(), ours.size(), theirs.size()}) + 16);
 
     const auto emit_inserts = [&](const Lines& a, const Lines& b) {
@@ -179,15 +324,16 @@ ThreeWayMergeResult three_way_merge_text(std::string_view base_text,
             return;
         }
         clean = false;
+        conflicts.push_back(MergeConflictHunk{merged.size(), join_lines(a), join_lines(b)});
         const auto chunk = conflict_chunk(a, b);
         merged.insert(merged.end(), chunk.begin(), chunk.end());
     };
 
     for (size_t i = 0; i < base.size(); ++i) {
-        emit_inserts(ours_edits.inserts_before[i], theirs_edits.inserts_before[i]);
+        emit_inserts(ours_edits->inserts_before[i], theirs_edits->inserts_before[i]);
 
-        const bool ours_deleted = ours_edits.deletes[i];
-        const bool theirs_deleted = theirs_edits.deletes[i];
+        const bool ours_deleted = ours_edits->deletes[i];
+        const bool theirs_deleted = theirs_edits->deletes[i];
         if (ours_deleted || theirs_deleted) {
             // If either side deleted the base line and the other side did not change it,
             // deletion is safe to apply. Overlaps are handled via inserts conflicts.
@@ -195,14 +341,12 @@ ThreeWayMergeResult three_way_merge_text(std::string_view base_text,
         }
         merged.push_back(base[i]);
     }
-    emit_inserts(ours_edits.inserts_before[base.size()], theirs_edits.inserts_before[base.size()]);
+    emit_inserts(ours_edits->inserts_before[base.size()], theirs_edits->inserts_before[base.size()]);
 
-    if (too_large) {
-        return ThreeWayMergeResult{ThreeWayMergeResult::Kind::TooLargeFallback, join_lines(merged)};
-    }
     return ThreeWayMergeResult{
         clean ? ThreeWayMergeResult::Kind::Clean : ThreeWayMergeResult::Kind::Conflict,
         join_lines(merged),
+        std::move(conflicts),
     };
 }
 
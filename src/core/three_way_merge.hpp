@@ -1,30 +1,47 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
 #include <string_view>
+#include <vector>
 
 namespace zinc {
 
+// One overlapping edit in a merge result; lets callers offer per-hunk choices.
+struct MergeConflictHunk {
+    size_t line{0};      // index of the "<<<<<<< ours" marker line in merged
+    std::string ours;    // ours side, lines joined with '\n'
+    std::string theirs;  // theirs side, lines joined with '\n'
+};
+
 struct ThreeWayMergeResult {
     enum class Kind {
         Clean,
         Conflict,
-        TooLargeFallback
+        TooLargeFallback // no longer produced; kept for callers that still map it
     };
 
     Kind kind{Kind::Clean};
     std::string merged;
+    std::vector<MergeConflictHunk> conflicts;
 
     [[nodiscard]] bool clean() const { return kind == Kind::Clean; }
 };
 
+// How many diagonal steps one side's diff may take. Past it the sides are not lined up at all:
+// the result is a single conflict of all of ours against all of theirs, so a wholesale rewrite
+// costs milliseconds instead of seconds.
+inline constexpr size_t kMergeDiffBudget = size_t{1} << 22;
+
 // A small, deterministic, line-based 3-way merge:
 // - If changes are non-overlapping, returns Kind::Clean.
 // - If overlapping edits occur, returns Kind::Conflict and embeds diff3-style markers.
-// - If inputs are too large for the DP diff, returns Kind::TooLargeFallback and a marker-based merge.
+// Diffs run in O((N+M)D) time, capped by `diff_budget`, and linear space, so large documents
+// with small edits stay cheap.
 [[nodiscard]] ThreeWayMergeResult three_way_merge_text(std::string_view base,
                                                        std::string_view ours,
-                                                       std::string_view theirs);
+                                                       std::string_view theirs,
+                                                       size_t diff_budget = kMergeDiffBudget);
 
 } // namespace zinc
 
@@ -1,9 +1,12 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+#include <optional>
 #include <chrono>
 #include <array>
 #include <cstdint>
+#include <cstring>
 #include <compare>
 #include <random>
 #include <sstream>
@@ -53,48 +56,66 @@ public:
         return Uuid(bytes);
     }
     
+    static constexpr size_t STRING_SIZE = 36;
+    using Chars = std::array<char, STRING_SIZE>;
+
     /**
      * Parse a UUID from a string (accepts both hyphenated and non-hyphenated).
+     * Hex digits may be upper or lower case; hyphens are ignored wherever they
+     * appear. Never allocates or throws.
      */
-    [[nodiscard]] static std::optional<Uuid> parse(std::string_view str) {
-        // Remove hyphens
-        std::string clean;
-        clean.reserve(32);
-        for (char c : str) {
-            if (c != '-') clean += c;
-        }
-        
-        if (clean.size() != 32) return std::nullopt;
-        
-        Bytes bytes;
-        for (size_t i = 0; i < 16; ++i) {
-            auto hex = clean.substr(i * 2, 2);
-            try {
-                bytes[i] = static_cast<uint8_t>(std::stoul(std::string(hex), nullptr, 16));
-            } catch (...) {
-                return std::nullopt;
+    [[nodiscard]] static constexpr std::optional<Uuid> parse(std::string_view str) noexcept {
+        Bytes bytes{};
+        if (str.size() == STRING_SIZE && str[8] == '-' && str[13] == '-' &&
+            str[18] == '-' && str[23] == '-') {
+            // Canonical form: decode fixed offsets, checking validity once at the end.
+            uint8_t invalid = 0;
+            for (size_t i = 0; i < BYTE_SIZE; ++i) {
+                const auto pos = HEX_OFFSETS[i];
+                const auto hi = HEX_VALUES[static_cast<uint8_t>(str[pos])];
+                const auto lo = HEX_VALUES[static_cast<uint8_t>(str[pos + 1])];
+                invalid |= static_cast<uint8_t>(hi | lo);
+                bytes[i] = static_cast<uint8_t>((hi << 4) | (lo & 0x0F));
             }
+            if (invalid & 0x80) return std::nullopt;
+            return Uuid(bytes);
         }
-        
+
+        size_t digits = 0;
+        for (char c : str) {
+            if (c == '-') continue;
+            const auto value = HEX_VALUES[static_cast<uint8_t>(c)];
+            if ((value & 0x80) || digits == 2 * BYTE_SIZE) return std::nullopt;
+            bytes[digits / 2] = static_cast<uint8_t>(bytes[digits / 2] | (value << (digits % 2 ? 0 : 4)));
+            ++digits;
+        }
+        if (digits != 2 * BYTE_SIZE) return std::nullopt;
         return Uuid(bytes);
     }
-    
+
     /**
-     * Convert to string representation (hyphenated, lowercase).
+     * Write the hyphenated, lowercase form into a fixed buffer.
      * Format: xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx
      */
-    [[nodiscard]] std::string to_string() const {
-        std::ostringstream oss;
-        oss << std::hex << std::setfill('0');
-        
+    [[nodiscard]] constexpr Chars to_chars() const noexcept {
+        constexpr std::string_view hex = "0123456789abcdef";
+        Chars out{};
+        out[8] = out[13] = out[18] = out[23] = '-';
         for (size_t i = 0; i < BYTE_SIZE; ++i) {
-            if (i == 4 || i == 6 || i == 8 || i == 10) {
-                oss << '-';
-            }
-            oss << std::setw(2) << static_cast<int>(bytes_[i]);
+            const auto pos = HEX_OFFSETS[i];
+            out[pos] = hex[bytes_[i] >> 4];
+            out[pos + 1] = hex[bytes_[i] & 0x0F];
         }
-        
-        return oss.str();
+        return out;
+    }
+
+    /**
+     * Convert to string representation (hyphenated, lowercase).
+     * Format: xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx
+     */
+    [[nodiscard]] std::string to_string() const {
+        const auto chars = to_chars();
+        return std::string(chars.data(), chars.size());
     }
     
     /**
@@ -118,6 +139,23 @@ public:
     bool operator==(const Uuid&) const = default;
     
 private:
+    // Position of each byte's first hex digit in the hyphenated form.
+    static constexpr std::array<uint8_t, BYTE_SIZE> HEX_OFFSETS = {
+        0, 2, 4, 6, 9, 11, 14, 16, 19, 21, 24, 26, 28, 30, 32, 34,
+    };
+
+    // Hex digit value per byte; 0xFF marks characters that are not hex digits.
+    static constexpr std::array<uint8_t, 256> HEX_VALUES = [] {
+        std::array<uint8_t, 256> table{};
+        for (auto& v : table) v = 0xFF;
+        for (int i = 0; i < 10; ++i) table['0' + i] = static_cast<uint8_t>(i);
+        for (int i = 0; i < 6; ++i) {
+            table['a' + i] = static_cast<uint8_t>(10 + i);
+            table['A' + i] = static_cast<uint8_t>(10 + i);
+        }
+        return table;
+    }();
+
     Bytes bytes_;
 };
 
@@ -211,16 +249,16 @@ namespace std {
     template<>
     struct hash<zinc::Uuid> {
         size_t operator()(const zinc::Uuid& uuid) const noexcept {
-            const auto& bytes = uuid.bytes();
-            size_t h = 0;
-            for (size_t i = 0; i < bytes.size(); i += sizeof(size_t)) {
-                size_t chunk = 0;
-                for (size_t j = 0; j < sizeof(size_t) && i + j < bytes.size(); ++j) {
-                    chunk |= static_cast<size_t>(bytes[i + j]) << (j * 8);
-                }
-                h ^= chunk + 0x9e3779b9 + (h << 6) + (h >> 2);
-            }
-            return h;
+            uint64_t lo = 0;
+            uint64_t hi = 0;
+            std::memcpy(&lo, uuid.bytes().data(), sizeof(lo));
+            std::memcpy(&hi, uuid.bytes().data() + sizeof(lo), sizeof(hi));
+            // Mix both halves so ids that differ only in one half still spread.
+            uint64_t h = (lo * 0x9e3779b97f4a7c15ULL) ^ hi;
+            h ^= h >> 32;
+            h *= 0xd6e8feb86659fd93ULL;
+            h ^= h >> 32;
+            return static_cast<size_t>(h);
         }
     };
 }
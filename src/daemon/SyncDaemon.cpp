@@ -0,0 +1,425 @@
+#include "daemon/SyncDaemon.hpp"
+
+#include "ui/DataStore.hpp"
+#include "ui/controllers/SyncController.hpp"
+
+#include <QDateTime>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <QSet>
+#include <QtGlobal>
+
+namespace zinc::daemon {
+
+namespace {
+
+// Matches Main.qml: coalesce bursts of local changes into one outgoing snapshot.
+constexpr int kOutgoingSnapshotDelayMs = 200;
+constexpr int kReconnectIntervalMs = 5000;
+constexpr qint64 kMismatchBackoffMs = 60 * 1000;
+
+bool sync_debug_enabled() {
+    static const bool enabled = qEnvironmentVariableIntValue("ZINC_DEBUG_SYNC") != 0;
+    return enabled;
+}
+
+qint64 now_ms() {
+    return QDateTime::currentMSecsSinceEpoch();
+}
+
+void advance_cursor(const QVariantList& items,
+                    QString& cursorAt,
+                    QString& cursorId,
+                    const QString& atField,
+                    const QString& idField) {
+    for (const auto& item : items) {
+        const auto entry = item.toMap();
+        const auto updatedAt = entry.value(atField).toString();
+        const auto entryId = entry.value(idField).toString();
+        if (cursorAt.isEmpty() || updatedAt > cursorAt || (updatedAt == cursorAt && entryId > cursorId)) {
+            cursorAt = updatedAt;
+            cursorId = entryId;
+        }
+    }
+}
+
+QVariantList attachment_ids_from_pages(const QVariantList& pages) {
+    static const QRegularExpression re(QStringLiteral("image://attachments/([0-9a-fA-F-]{36})"));
+    QSet<QString> seen;
+    QVariantList out;
+    for (const auto& page : pages) {
+        const auto markdown = page.toMap().value(QStringLiteral("contentMarkdown")).toString();
+        auto it = re.globalMatch(markdown);
+        while (it.hasNext()) {
+            const auto id = it.next().captured(1);
+            if (!id.isEmpty() && !seen.contains(id)) {
+                seen.insert(id);
+                out.append(id);
+            }
+        }
+    }
+    return out;
+}
+
+QVariantList merge_attachments(const QVariantList& primary, const QVariantList& extra) {
+    QSet<QString> seen;
+    QVariantList out;
+    const auto add = [&](const QVariantList& list) {
+        for (const auto& value : list) {
+            const auto entry = value.toMap();
+            auto id = entry.value(QStringLiteral("attachmentId")).toString();
+            if (id.isEmpty()) id = entry.value(QStringLiteral("id")).toString();
+            if (id.isEmpty() || seen.contains(id)) continue;
+            seen.insert(id);
+            out.append(value);
+        }
+    };
+    add(primary);
+    add(extra);
+    return out;
+}
+
+} // namespace
+
+SyncDaemon::SyncDaemon(ui::DataStore* store, SyncDaemonOptions options, QObject* parent)
+    : QObject(parent)
+    , store_(store)
+    , options_(std::move(options))
+    , sync_(std::make_unique<ui::SyncController>(this))
+    , outgoing_timer_(std::make_unique<QTimer>(this))
+    , reconnect_timer_(std::make_unique<QTimer>(this))
+{
+    outgoing_timer_->setSingleShot(true);
+    outgoing_timer_->setInterval(kOutgoingSnapshotDelayMs);
+    connect(outgoing_timer_.get(), &QTimer::timeout, this, [this]() {
+        sendLocalSnapshot(false);
+    });
+
+    reconnect_timer_->setInterval(kReconnectIntervalMs);
+    connect(reconnect_timer_.get(), &QTimer::timeout, this, [this]() {
+        tryStartSync();
+        reconnectPairedDevices();
+    });
+
+    // Local edits (e.g. a CLI mutation against the same database) and applied remote
+    // changes both surface here; the cursors keep relays to true deltas.
+    connect(store_, &ui::DataStore::pagesChanged, this, &SyncDaemon::scheduleOutgoingSnapshot);
+    connect(store_, &ui::DataStore::notebooksChanged, this, &SyncDaemon::scheduleOutgoingSnapshot);
+    connect(store_, &ui::DataStore::attachmentsChanged, this, &SyncDaemon::scheduleOutgoingSnapshot);
+
+    connect(sync_.get(), &ui::SyncController::peerCountChanged, this, &SyncDaemon::peerCountChanged);
+    connect(sync_.get(), &ui::SyncController::peerConnected, this, [this](const QString& deviceId) {
+        qInfo() << "zincd: peer connected" << deviceId;
+        resetCursors();
+        sendLocalSnapshot(true);
+    });
+    connect(sync_.get(), &ui::SyncController::peerDisconnected, this, [](const QString& deviceId) {
+        qInfo() << "zincd: peer disconnected" << deviceId;
+    });
+    connect(sync_.get(), &ui::SyncController::peerDiscovered, this,
+            [this](const QString& deviceId, const QString&, const QString& workspaceId,
+                   const QString& host, int port) {
+                if (deviceId.isEmpty() || workspaceId.isEmpty()) return;
+                if (!host.isEmpty() && port > 0) {
+                    store_->updatePairedDeviceEndpoint(deviceId, host, port);
+                }
+            });
+    connect(sync_.get(), &ui::SyncController::peerHelloReceived, this,
+            [this](const QString& deviceId, const QString&, const QString& host, int port) {
+                if (!deviceId.isEmpty() && !host.isEmpty() && port > 0) {
+                    store_->updatePairedDeviceEndpoint(deviceId, host, port);
+                }
+            });
+    connect(sync_.get(), &ui::SyncController::peerIdentityMismatch, this,
+            [this](const QString& expectedDeviceId, const QString& actualDeviceId,
+                   const QString&, const QString& host, int port) {
+                if (expectedDeviceId.isEmpty()) return;
+                qWarning() << "zincd: paired device" << expectedDeviceId << "now reports" << actualDeviceId
+                           << "at" << host << port << "- re-pair it";
+                blocked_reconnect_until_[expectedDeviceId] = now_ms() + kMismatchBackoffMs;
+            });
+    connect(sync_.get(), &ui::SyncController::peerWorkspaceMismatch, this,
+            [this](const QString& deviceId, const QString& remoteWorkspaceId,
+                   const QString& localWorkspaceId, const QString&, const QString&, int) {
+                if (deviceId.isEmpty()) return;
+                qWarning() << "zincd: peer" << deviceId << "is in workspace" << remoteWorkspaceId
+                           << "but this relay serves" << localWorkspaceId;
+                blocked_reconnect_until_[deviceId] = now_ms() + kMismatchBackoffMs;
+            });
+    connect(sync_.get(), &ui::SyncController::peerApprovalRequired,
+            this, &SyncDaemon::onPeerApprovalRequired);
+    connect(sync_.get(), &ui::SyncController::pairingRequestReceived,
+            this, &SyncDaemon::onPairingRequestReceived);
+    connect(sync_.get(), &ui::SyncController::error, this, [](const QString& message) {
+        qWarning() << "zincd:" << message;
+    });
+
+    // Same apply order as Main.qml; each apply is followed by a relay so peers that
+    // are never online together still converge through this process.
+    connect(sync_.get(), &ui::SyncController::attachmentSnapshotReceivedAttachments, this,
+            [this](const QVariantList& attachments) {
+                qInfo() << "SYNC: received attachments" << attachments.size();
+                store_->applyAttachmentUpdates(attachments);
+                scheduleOutgoingSnapshot();
+            });
+    connect(sync_.get(), &ui::SyncController::pageSnapshotReceivedPages, this,
+            [this](const QVariantList& pages) {
+                qInfo() << "SYNC: received pages" << pages.size();
+                store_->applyPageUpdates(pages);
+                scheduleOutgoingSnapshot();
+            });
+    connect(sync_.get(), &ui::SyncController::deletedPageSnapshotReceivedPages, this,
+            [this](const QVariantList& deletedPages) {
+                qInfo() << "SYNC: received deleted pages" << deletedPages.size();
+                store_->applyDeletedPageUpdates(deletedPages);
+                scheduleOutgoingSnapshot();
+            });
+    connect(sync_.get(), &ui::SyncController::notebookSnapshotReceivedNotebooks, this,
+            [this](const QVariantList& notebooks) {
+                qInfo() << "SYNC: received notebooks" << notebooks.size();
+                store_->applyNotebookUpdates(notebooks);
+                scheduleOutgoingSnapshot();
+            });
+    connect(sync_.get(), &ui::SyncController::deletedNotebookSnapshotReceivedNotebooks, this,
+            [this](const QVariantList& deletedNotebooks) {
+                qInfo() << "SYNC: received deleted notebooks" << deletedNotebooks.size();
+                store_->applyDeletedNotebookUpdates(deletedNotebooks);
+                scheduleOutgoingSnapshot();
+            });
+    connect(sync_.get(), &ui::SyncController::blockSnapshotReceivedBlocks, this,
+            [this](const QVariantList& blocks) {
+                qInfo() << "SYNC: received blocks" << blocks.size();
+                store_->applyBlockUpdates(blocks);
+                scheduleOutgoingSnapshot();
+            });
+}
+
+SyncDaemon::~SyncDaemon() {
+    stop();
+}
+
+bool SyncDaemon::start() {
+    const bool started = tryStartSync();
+    reconnect_timer_->start();
+    if (started) {
+        reconnectPairedDevices();
+    }
+    return started;
+}
+
+void SyncDaemon::stop() {
+    reconnect_timer_->stop();
+    if (outgoing_timer_->isActive()) {
+        outgoing_timer_->stop();
+        sendLocalSnapshot(false);
+    }
+    sync_->stopSync();
+}
+
+int SyncDaemon::peerCount() const {
+    return sync_->peerCount();
+}
+
+int SyncDaemon::listeningPort() const {
+    return sync_->listeningPort();
+}
+
+QVariantMap SyncDaemon::trafficStats() const {
+    return sync_->trafficStats();
+}
+
+bool SyncDaemon::tryStartSync() {
+    if (sync_->isSyncing()) {
+        return true;
+    }
+
+    if (!options_.workspaceId.isEmpty()) {
+        if (sync_->configure(options_.workspaceId, options_.deviceName) && sync_->startSync()) {
+            qInfo() << "zincd: serving workspace" << options_.workspaceId << "on port" << sync_->listeningPort();
+            return true;
+        }
+        return false;
+    }
+
+    // Prefer the persisted workspace id, then infer one from paired devices.
+    if (sync_->tryAutoStart(options_.deviceName)) {
+        qInfo() << "zincd: serving workspace" << sync_->workspaceId() << "on port" << sync_->listeningPort();
+        return true;
+    }
+    const auto devices = store_->getPairedDevices();
+    if (!devices.isEmpty()) {
+        const auto wsId = devices.first().toMap().value(QStringLiteral("workspaceId")).toString();
+        if (!wsId.isEmpty() && sync_->configure(wsId, options_.deviceName) && sync_->startSync()) {
+            qInfo() << "zincd: serving workspace" << wsId << "from paired devices on port" << sync_->listeningPort();
+            return true;
+        }
+    }
+
+    // Not configured yet: a passive listener lets a device pair this relay into its workspace.
+    if (options_.allowPairing && sync_->startPairingListener(options_.deviceName)) {
+        qInfo() << "zincd: no workspace yet, waiting for pairing on port" << sync_->listeningPort();
+    }
+    return false;
+}
+
+void SyncDaemon::reconnectPairedDevices() {
+    if (!sync_->isSyncing() || !sync_->isConfigured()) {
+        return;
+    }
+    const auto workspaceId = sync_->workspaceId();
+    const auto now = now_ms();
+    const auto devices = store_->getPairedDevices();
+    for (const auto& value : devices) {
+        const auto d = value.toMap();
+        const auto deviceId = d.value(QStringLiteral("deviceId")).toString();
+        const auto host = d.value(QStringLiteral("host")).toString();
+        const int port = d.value(QStringLiteral("port")).toInt();
+        const auto ws = d.value(QStringLiteral("workspaceId")).toString();
+        if (deviceId.isEmpty() || host.isEmpty() || port <= 0) continue;
+        if (!ws.isEmpty() && ws != workspaceId) continue;
+        if (sync_->isPeerConnected(deviceId)) continue;
+        const auto blocked = blocked_reconnect_until_.find(deviceId);
+        if (blocked != blocked_reconnect_until_.end()) {
+            if (now < blocked->second) continue;
+            blocked_reconnect_until_.erase(blocked);
+        }
+        sync_->connectToPeer(deviceId, host, port);
+    }
+}
+
+void SyncDaemon::scheduleOutgoingSnapshot() {
+    if (sync_debug_enabled()) qInfo() << "SYNC: zincd scheduleOutgoingSnapshot";
+    outgoing_timer_->start();
+}
+
+void SyncDaemon::resetCursors() {
+    pages_cursor_ = {};
+    deleted_pages_cursor_ = {};
+    notebooks_cursor_ = {};
+    deleted_notebooks_cursor_ = {};
+    attachments_cursor_ = {};
+}
+
+void SyncDaemon::sendLocalSnapshot(bool full) {
+    if (!sync_->isSyncing() || sync_->peerCount() <= 0) {
+        if (sync_debug_enabled()) qInfo() << "SYNC: zincd sendLocalSnapshot skip (no peers)";
+        return;
+    }
+
+    const auto pages = full ? store_->getPagesForSync()
+                            : store_->getPagesForSyncSince(pages_cursor_.at, pages_cursor_.id);
+    const auto deletedPages = full ? store_->getDeletedPagesForSync()
+                                   : store_->getDeletedPagesForSyncSince(deleted_pages_cursor_.at,
+                                                                         deleted_pages_cursor_.id);
+    const auto notebooks = full ? store_->getNotebooksForSync()
+                                : store_->getNotebooksForSyncSince(notebooks_cursor_.at, notebooks_cursor_.id);
+    const auto deletedNotebooks = full ? store_->getDeletedNotebooksForSync()
+                                       : store_->getDeletedNotebooksForSyncSince(deleted_notebooks_cursor_.at,
+                                                                                 deleted_notebooks_cursor_.id);
+    auto attachments = full ? store_->getAttachmentsForSync()
+                            : store_->getAttachmentsForSyncSince(attachments_cursor_.at, attachments_cursor_.id);
+    if (!full) {
+        const auto neededIds = attachment_ids_from_pages(pages);
+        if (!neededIds.isEmpty()) {
+            attachments = merge_attachments(attachments, store_->getAttachmentsByIds(neededIds));
+        }
+    }
+    if (!full && pages.isEmpty() && deletedPages.isEmpty() && notebooks.isEmpty() &&
+        deletedNotebooks.isEmpty() && attachments.isEmpty()) {
+        if (sync_debug_enabled()) qInfo() << "SYNC: zincd sendLocalSnapshot noop (no deltas)";
+        return;
+    }
+
+    QJsonObject payload;
+    payload["v"] = 3;
+    payload["workspaceId"] = sync_->workspaceId();
+    payload["full"] = full;
+    payload["pages"] = QJsonValue::fromVariant(pages);
+    payload["deletedPages"] = QJsonValue::fromVariant(deletedPages);
+    payload["notebooks"] = QJsonValue::fromVariant(notebooks);
+    payload["deletedNotebooks"] = QJsonValue::fromVariant(deletedNotebooks);
+    payload["attachments"] = QJsonValue::fromVariant(attachments);
+    qInfo() << "SYNC: sending snapshot full=" << full << "pages" << pages.size()
+            << "deleted" << deletedPages.size() << "notebooks" << notebooks.size()
+            << "deletedNotebooks" << deletedNotebooks.size() << "attachments" << attachments.size();
+    sync_->sendPageSnapshot(QString::fromUtf8(QJsonDocument(payload).toJson(QJsonDocument::Compact)));
+
+    const auto updatedAt = QStringLiteral("updatedAt");
+    const auto deletedAt = QStringLiteral("deletedAt");
+    advance_cursor(pages, pages_cursor_.at, pages_cursor_.id, updatedAt, QStringLiteral("pageId"));
+    advance_cursor(deletedPages, deleted_pages_cursor_.at, deleted_pages_cursor_.id, deletedAt, QStringLiteral("pageId"));
+    advance_cursor(notebooks, notebooks_cursor_.at, notebooks_cursor_.id, updatedAt, QStringLiteral("notebookId"));
+    advance_cursor(deletedNotebooks, deleted_notebooks_cursor_.at, deleted_notebooks_cursor_.id, deletedAt,
+                   QStringLiteral("notebookId"));
+    advance_cursor(attachments, attachments_cursor_.at, attachments_cursor_.id, updatedAt,
+                   QStringLiteral("attachmentId"));
+}
+
+bool SyncDaemon::isPairedDevice(const QString& deviceId) const {
+    const auto devices = store_->getPairedDevices();
+    for (const auto& value : devices) {
+        if (value.toMap().value(QStringLiteral("deviceId")).toString() == deviceId) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void SyncDaemon::onPeerApprovalRequired(const QString& deviceId, const QString& deviceName,
+                                        const QString& host, int port) {
+    if (deviceId.isEmpty()) return;
+
+    if (isPairedDevice(deviceId)) {
+        if (!host.isEmpty() && port > 0) {
+            store_->updatePairedDeviceEndpoint(deviceId, host, port);
+        }
+        sync_->approvePeer(deviceId, true);
+        return;
+    }
+    if (!options_.allowPairing) {
+        qInfo() << "zincd: rejecting unpaired device" << deviceId << deviceName << "(start with --allow-pairing)";
+        sync_->approvePeer(deviceId, false);
+        return;
+    }
+
+    const auto ws = sync_->workspaceId();
+    if (!ws.isEmpty()) {
+        store_->savePairedDevice(deviceId, deviceName.isEmpty() ? QStringLiteral("Paired device") : deviceName, ws);
+    }
+    if (!host.isEmpty() && port > 0) {
+        store_->updatePairedDeviceEndpoint(deviceId, host, port);
+    }
+    qInfo() << "zincd: paired new device" << deviceId << deviceName;
+    sync_->approvePeer(deviceId, true);
+}
+
+void SyncDaemon::onPairingRequestReceived(const QString& deviceId, const QString& deviceName,
+                                          const QString& host, int port, const QString& workspaceId) {
+    if (deviceId.isEmpty() || workspaceId.isEmpty()) return;
+
+    const bool servingOtherWorkspace = sync_->isConfigured() && sync_->workspaceId() != workspaceId;
+    if (!options_.allowPairing || servingOtherWorkspace) {
+        qInfo() << "zincd: rejecting pairing request from" << deviceId << "for workspace" << workspaceId;
+        sync_->sendPairingResponse(deviceId, false, QStringLiteral("Rejected"), workspaceId);
+        return;
+    }
+
+    sync_->sendPairingResponse(deviceId, true, QString(), workspaceId);
+    store_->savePairedDevice(deviceId, deviceName.isEmpty() ? QStringLiteral("Paired device") : deviceName,
+                             workspaceId);
+    if (!host.isEmpty() && port > 0) {
+        store_->updatePairedDeviceEndpoint(deviceId, host, port);
+    }
+    qInfo() << "zincd: paired into workspace" << workspaceId << "by" << deviceId << deviceName;
+
+    if (!sync_->isConfigured()) {
+        // Same as accepting in the app: restart the listener as a member of the requested workspace.
+        sync_->stopSync();
+        if (sync_->configure(workspaceId, options_.deviceName)) {
+            sync_->startSync();
+        }
+    }
+}
+
+} // namespace zinc::daemon
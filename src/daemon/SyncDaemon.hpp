@@ -0,0 +1,84 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QVariantList>
+#include <QVariantMap>
+#include <map>
+#include <memory>
+
+namespace zinc::ui {
+class DataStore;
+class SyncController;
+}
+
+namespace zinc::daemon {
+
+struct SyncDaemonOptions {
+    // Workspace to serve; empty falls back to the persisted sync settings or paired devices.
+    QString workspaceId;
+    QString deviceName = QStringLiteral("Zinc Relay");
+    // Accept hostname pairing requests and approvals from unknown devices without prompting.
+    bool allowPairing = false;
+};
+
+/**
+ * SyncDaemon - Headless port of the snapshot orchestration in Main.qml.
+ *
+ * Owns no UI: it starts sync, approves paired devices, applies incoming
+ * snapshots to the DataStore and relays local deltas to every connected peer,
+ * so a machine without a display can act as an always-on hub.
+ */
+class SyncDaemon : public QObject {
+    Q_OBJECT
+
+public:
+    SyncDaemon(ui::DataStore* store, SyncDaemonOptions options, QObject* parent = nullptr);
+    ~SyncDaemon() override;
+
+    bool start();
+    void stop();
+
+    // Dial paired devices that are not connected (also runs every few seconds).
+    void reconnectPairedDevices();
+
+    [[nodiscard]] int peerCount() const;
+    [[nodiscard]] int listeningPort() const;
+    [[nodiscard]] QVariantMap trafficStats() const;
+
+signals:
+    void peerCountChanged();
+
+private:
+    struct Cursor {
+        QString at;
+        QString id;
+    };
+
+    ui::DataStore* store_;
+    SyncDaemonOptions options_;
+    std::unique_ptr<ui::SyncController> sync_;
+    std::unique_ptr<QTimer> outgoing_timer_;
+    std::unique_ptr<QTimer> reconnect_timer_;
+    std::map<QString, qint64> blocked_reconnect_until_;
+
+    Cursor pages_cursor_;
+    Cursor deleted_pages_cursor_;
+    Cursor notebooks_cursor_;
+    Cursor deleted_notebooks_cursor_;
+    Cursor attachments_cursor_;
+
+    bool tryStartSync();
+    void scheduleOutgoingSnapshot();
+    void sendLocalSnapshot(bool full);
+    void resetCursors();
+    [[nodiscard]] bool isPairedDevice(const QString& deviceId) const;
+
+    void onPeerApprovalRequired(const QString& deviceId, const QString& deviceName,
+                                const QString& host, int port);
+    void onPairingRequestReceived(const QString& deviceId, const QString& deviceName,
+                                  const QString& host, int port, const QString& workspaceId);
+};
+
+} // namespace zinc::daemon
@@ -0,0 +1,139 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QSocketNotifier>
+
+#include <csignal>
+
+#ifdef Q_OS_UNIX
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "crypto/keys.hpp"
+#include "daemon/SyncDaemon.hpp"
+#include "ui/DataStore.hpp"
+
+// zincd - headless sync relay. Runs the same snapshot sync as the app on a
+// QCoreApplication loop (no QML engine, no GUI) so an always-on machine can
+// keep laptops converging even when they are never online at the same time.
+
+namespace {
+
+#ifdef Q_OS_UNIX
+int g_signal_fds[2] = {-1, -1};
+
+void on_terminate_signal(int) {
+    const char byte = 1;
+    [[maybe_unused]] const auto written = ::write(g_signal_fds[0], &byte, sizeof(byte));
+}
+
+// Routes SIGINT/SIGTERM through a socket pair so shutdown runs on the event loop
+// and pending snapshots/peer cache writes are flushed.
+void install_quit_on_signals(QCoreApplication& app) {
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, g_signal_fds) != 0) {
+        return;
+    }
+    auto* notifier = new QSocketNotifier(g_signal_fds[1], QSocketNotifier::Read, &app);
+    QObject::connect(notifier, &QSocketNotifier::activated, &app, [notifier]() {
+        notifier->setEnabled(false);
+        char byte = 0;
+        [[maybe_unused]] const auto got = ::read(g_signal_fds[1], &byte, sizeof(byte));
+        qInfo() << "zincd: shutting down";
+        QCoreApplication::quit();
+    });
+    std::signal(SIGINT, on_terminate_signal);
+    std::signal(SIGTERM, on_terminate_signal);
+}
+#else
+void install_quit_on_signals(QCoreApplication&) {}
+#endif
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    // Distinct application name: the relay keeps its own device id, settings and
+    // database even when the app runs on the same machine.
+    app.setApplicationName("zincd");
+    app.setApplicationVersion("0.1.0");
+    app.setOrganizationName("Zinc");
+    app.setOrganizationDomain("zinc.local");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Zinc headless sync relay"));
+    parser.addHelpOption();
+    parser.addVersionOption();
+
+    const QCommandLineOption dbPathOption(
+        QStringList{QStringLiteral("db")},
+        QStringLiteral("Override database path (sets ZINC_DB_PATH for this run)."),
+        QStringLiteral("path"));
+    parser.addOption(dbPathOption);
+
+    const QCommandLineOption workspaceOption(
+        QStringList{QStringLiteral("workspace")},
+        QStringLiteral("Workspace id to serve (default: saved sync settings or paired devices)."),
+        QStringLiteral("workspaceId"));
+    parser.addOption(workspaceOption);
+
+    const QCommandLineOption nameOption(
+        QStringList{QStringLiteral("name")},
+        QStringLiteral("Device name announced to peers."),
+        QStringLiteral("name"),
+        QStringLiteral("Zinc Relay"));
+    parser.addOption(nameOption);
+
+    const QCommandLineOption allowPairingOption(
+        QStringList{QStringLiteral("allow-pairing")},
+        QStringLiteral("Accept pairing requests and unknown devices without confirmation."));
+    parser.addOption(allowPairingOption);
+
+    const QCommandLineOption debugSyncOption(
+        QStringList{QStringLiteral("debug-sync")},
+        QStringLiteral("Enable sync debug logging (also sets ZINC_DEBUG_SYNC=1)."));
+    parser.addOption(debugSyncOption);
+
+    parser.process(app);
+
+    if (parser.isSet(dbPathOption)) {
+        qputenv("ZINC_DB_PATH", parser.value(dbPathOption).toUtf8());
+    }
+    if (parser.isSet(debugSyncOption)) {
+        qputenv("ZINC_DEBUG_SYNC", "1");
+    }
+
+    // A relay must not inject the app's welcome pages into the team's workspace.
+    qputenv("ZINC_DISABLE_DEFAULT_PAGES", "1");
+
+    auto crypto_result = zinc::crypto::init();
+    if (crypto_result.is_err()) {
+        qCritical() << "Failed to initialize crypto:"
+                    << crypto_result.unwrap_err().message.c_str();
+        return 1;
+    }
+
+    zinc::ui::DataStore store;
+    if (!store.initialize()) {
+        return 1;
+    }
+    qInfo() << "zincd: database" << store.databasePath();
+
+    zinc::daemon::SyncDaemonOptions options;
+    options.workspaceId = parser.value(workspaceOption);
+    options.deviceName = parser.value(nameOption);
+    options.allowPairing = parser.isSet(allowPairingOption);
+
+    zinc::daemon::SyncDaemon daemon(&store, options);
+    if (!daemon.start()) {
+        if (!options.allowPairing) {
+            qCritical() << "zincd: no workspace configured; pass --workspace or --allow-pairing";
+            return 1;
+        }
+    }
+
+    install_quit_on_signals(app);
+    QObject::connect(&app, &QCoreApplication::aboutToQuit, &daemon, &zinc::daemon::SyncDaemon::stop);
+    return app.exec();
+}
@@ -0,0 +1,101 @@
+#include "network/keepalive.hpp"
+
+#include <cmath>
+
+namespace zinc::network {
+
+KeepaliveTracker::KeepaliveTracker(KeepaliveConfig config)
+    : config_(config)
+{
+}
+
+void KeepaliveTracker::reset(int64_t now_ms) {
+    last_activity_ms_ = now_ms;
+    ping_sent_ms_ = 0;
+    outstanding_nonce_.reset();
+    missed_pongs_ = 0;
+    srtt_ms_.reset();
+    rttvar_ms_.reset();
+    last_rtt_ms_.reset();
+}
+
+void KeepaliveTracker::on_activity(int64_t now_ms) {
+    last_activity_ms_ = now_ms;
+    // Any inbound frame proves the path is alive, even if it raced a Ping.
+    missed_pongs_ = 0;
+}
+
+bool KeepaliveTracker::should_ping(int64_t now_ms) const {
+    if (outstanding_nonce_ || is_dead()) {
+        return false;
+    }
+    // After a miss, probe again right away instead of waiting for another idle interval.
+    if (missed_pongs_ > 0) {
+        return true;
+    }
+    return now_ms - last_activity_ms_ >= config_.idle_interval_ms;
+}
+
+uint64_t KeepaliveTracker::on_ping_sent(int64_t now_ms) {
+    const auto nonce = next_nonce_++;
+    outstanding_nonce_ = nonce;
+    ping_sent_ms_ = now_ms;
+    return nonce;
+}
+
+bool KeepaliveTracker::on_pong(std::optional<uint64_t> nonce, int64_t now_ms) {
+    on_activity(now_ms);
+    if (!outstanding_nonce_) {
+        return false;
+    }
+    if (nonce && *nonce != *outstanding_nonce_) {
+        // Late Pong for an already expired Ping; liveness only.
+        return false;
+    }
+    outstanding_nonce_.reset();
+
+    const auto sample = static_cast<double>(now_ms - ping_sent_ms_);
+    last_rtt_ms_ = sample;
+    if (!srtt_ms_) {
+        srtt_ms_ = sample;
+        rttvar_ms_ = sample / 2.0;
+    } else {
+        rttvar_ms_ = 0.75 * *rttvar_ms_ + 0.25 * std::abs(*srtt_ms_ - sample);
+        srtt_ms_ = 0.875 * *srtt_ms_ + 0.125 * sample;
+    }
+    return true;
+}
+
+bool KeepaliveTracker::check_timeout(int64_t now_ms) {
+    if (!outstanding_nonce_) {
+        return false;
+    }
+    if (now_ms - ping_sent_ms_ < config_.pong_timeout_ms) {
+        return false;
+    }
+    outstanding_nonce_.reset();
+    ++missed_pongs_;
+    return true;
+}
+
+std::vector<uint8_t> encode_keepalive_nonce(uint64_t nonce) {
+    std::vector<uint8_t> payload(8);
+    for (int i = 7; i >= 0; --i) {
+        payload[static_cast<size_t>(i)] = static_cast<uint8_t>(nonce & 0xFF);
+        nonce >>= 8;
+    }
+    return payload;
+}
+
+std::optional<uint64_t> decode_keepalive_nonce(const std::vector<uint8_t>& payload) {
+    if (payload.size() != 8) {
+        return std::nullopt;
+    }
+    uint64_t nonce = 0;
+    for (const auto byte : payload) {
+        nonce = (nonce << 8) | byte;
+    }
+    return nonce;
+}
+
+} // namespace zinc::network
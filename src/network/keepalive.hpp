@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace zinc::network {
+
+// Per-connection keepalive bookkeeping (used by SyncManager).
+// Kept free of sockets/timers so liveness and RTT estimation can be tested with a fake clock.
+
+struct KeepaliveConfig {
+    // Only ping after this long without any inbound traffic; regular sync messages
+    // count as liveness, so busy connections never need a ping.
+    int64_t idle_interval_ms = 5000;
+    // How long to wait for a Pong before counting the Ping as missed.
+    int64_t pong_timeout_ms = 3000;
+    // Declare the peer dead after this many consecutive missed Pongs.
+    int max_missed_pongs = 3;
+};
+
+/**
+ * KeepaliveTracker - Liveness and RTT estimate for a single peer connection.
+ *
+ * RTT smoothing follows RFC 6298 (SRTT / RTTVAR with alpha = 1/8, beta = 1/4).
+ * All timestamps are caller-supplied monotonic milliseconds.
+ */
+class KeepaliveTracker {
+public:
+    explicit KeepaliveTracker(KeepaliveConfig config = {});
+
+    /**
+     * Start tracking a freshly established connection.
+     */
+    void reset(int64_t now_ms);
+
+    /**
+     * Record inbound traffic of any kind (including Pong).
+     */
+    void on_activity(int64_t now_ms);
+
+    /**
+     * Whether a Ping should be sent now.
+     */
+    [[nodiscard]] bool should_ping(int64_t now_ms) const;
+
+    /**
+     * Record an outgoing Ping; returns the nonce to put in its payload.
+     */
+    uint64_t on_ping_sent(int64_t now_ms);
+
+    /**
+     * Record a Pong. A missing nonce (legacy peers echo an empty payload) matches the
+     * outstanding Ping. Returns true when the Pong produced an RTT sample.
+     */
+    bool on_pong(std::optional<uint64_t> nonce, int64_t now_ms);
+
+    /**
+     * Expire the outstanding Ping if it is overdue. Returns true when a Pong was missed.
+     */
+    bool check_timeout(int64_t now_ms);
+
+    [[nodiscard]] bool is_dead() const { return missed_pongs_ >= config_.max_missed_pongs; }
+    [[nodiscard]] int missed_pongs() const { return missed_pongs_; }
+    [[nodiscard]] bool ping_outstanding() const { return outstanding_nonce_.has_value(); }
+    [[nodiscard]] int64_t last_activity_ms() const { return last_activity_ms_; }
+    [[nodiscard]] std::optional<double> smoothed_rtt_ms() const { return srtt_ms_; }
+    [[nodiscard]] std::optional<double> rtt_jitter_ms() const { return rttvar_ms_; }
+    [[nodiscard]] std::optional<double> last_rtt_ms() const { return last_rtt_ms_; }
+    [[nodiscard]] const KeepaliveConfig& config() const { return config_; }
+
+private:
+    KeepaliveConfig config_;
+    int64_t last_activity_ms_ = 0;
+    int64_t ping_sent_ms_ = 0;
+    std::optional<uint64_t> outstanding_nonce_;
+    uint64_t next_nonce_ = 1;
+    int missed_pongs_ = 0;
+    std::optional<double> srtt_ms_;
+    std::optional<double> rttvar_ms_;
+    std::optional<double> last_rtt_ms_;
+};
+
+std::vector<uint8_t> encode_keepalive_nonce(uint64_t nonce);
+std::optional<uint64_t> decode_keepalive_nonce(const std::vector<uint8_t>& payload);
+
+} // namespace zinc::network
@@ -0,0 +1,246 @@
+#include "network/peer_cache.hpp"
+
+#include "crypto/keys.hpp"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <algorithm>
+
+namespace zinc::network {
+namespace {
+
+QJsonObject to_json(const CachedPeer& entry) {
+    QJsonObject obj;
+    obj["id"] = QString::fromStdString(entry.info.device_id.to_string());
+    obj["ws"] = QString::fromStdString(entry.info.workspace_id.to_string());
+    obj["name"] = entry.info.device_name;
+    obj["v"] = entry.info.protocol_version;
+    obj["pk"] = QString::fromStdString(crypto::to_base64(entry.info.public_key_fingerprint));
+    obj["lastSeen"] = static_cast<qint64>(entry.info.last_seen.millis());
+
+    QJsonArray endpoints;
+    for (const auto& endpoint : entry.endpoints) {
+        QJsonObject ep;
+        ep["host"] = endpoint.host.toString();
+        ep["port"] = static_cast<int>(endpoint.port);
+        endpoints.append(ep);
+    }
+    obj["endpoints"] = endpoints;
+    return obj;
+}
+
+std::optional<CachedPeer> from_json(const QJsonObject& obj) {
+    const auto id = Uuid::parse(obj["id"].toString().toStdString());
+    const auto ws = Uuid::parse(obj["ws"].toString().toStdString());
+    if (!id || !ws) {
+        return std::nullopt;
+    }
+
+    CachedPeer entry;
+    for (const auto& value : obj["endpoints"].toArray()) {
+        const auto ep = value.toObject();
+        const QHostAddress host(ep["host"].toString());
+        const int port = ep["port"].toInt();
+        if (host.isNull() || port <= 0 || port > 65535) {
+            continue;
+        }
+        entry.endpoints.push_back(PeerEndpoint{host, static_cast<uint16_t>(port)});
+        if (entry.endpoints.size() >= PeerCache::kMaxEndpointsPerPeer) {
+            break;
+        }
+    }
+    if (entry.endpoints.empty()) {
+        return std::nullopt;
+    }
+
+    entry.info.device_id = *id;
+    entry.info.workspace_id = *ws;
+    entry.info.device_name = obj["name"].toString();
+    entry.info.protocol_version = obj["v"].toInt();
+    entry.info.last_seen = Timestamp(obj["lastSeen"].toInteger());
+    entry.info.host = entry.endpoints.front().host;
+    entry.info.port = entry.endpoints.front().port;
+
+    const auto pk_b64 = obj["pk"].toString().toStdString();
+    if (!pk_b64.empty()) {
+        auto decoded = crypto::from_base64(pk_b64);
+        if (decoded.is_ok()) {
+            entry.info.public_key_fingerprint = decoded.unwrap();
+        }
+    }
+    return entry;
+}
+
+} // namespace
+
+bool PeerCache::upsert(const PeerInfo& peer) {
+    if (peer.device_id.is_nil() || peer.host.isNull() || peer.port == 0) {
+        return false;
+    }
+
+    const PeerEndpoint endpoint{peer.host, peer.port};
+    auto it = peers_.find(peer.device_id);
+    if (it == peers_.end()) {
+        CachedPeer entry;
+        entry.info = peer;
+        entry.endpoints.push_back(endpoint);
+        peers_.emplace(peer.device_id, std::move(entry));
+        if (peers_.size() > kMaxPeers) {
+            evictOldest();
+        }
+        return true;
+    }
+
+    auto& entry = it->second;
+    bool dirty = false;
+
+    const auto epIt = std::find(entry.endpoints.begin(), entry.endpoints.end(), endpoint);
+    if (epIt != entry.endpoints.begin()) {
+        if (epIt != entry.endpoints.end()) {
+            entry.endpoints.erase(epIt);
+        }
+        entry.endpoints.insert(entry.endpoints.begin(), endpoint);
+        if (entry.endpoints.size() > kMaxEndpointsPerPeer) {
+            entry.endpoints.resize(kMaxEndpointsPerPeer);
+        }
+        dirty = true;
+    }
+
+    if (entry.info.workspace_id != peer.workspace_id ||
+        entry.info.device_name != peer.device_name ||
+        entry.info.protocol_version != peer.protocol_version) {
+        dirty = true;
+    }
+    if (!peer.public_key_fingerprint.empty() &&
+        entry.info.public_key_fingerprint != peer.public_key_fingerprint) {
+        dirty = true;
+    }
+    if (peer.last_seen.millis() - entry.info.last_seen.millis() >= kLastSeenPersistGranularityMs) {
+        dirty = true;
+    }
+
+    auto fingerprint = peer.public_key_fingerprint.empty()
+        ? entry.info.public_key_fingerprint
+        : peer.public_key_fingerprint;
+    const auto last_seen = std::max(entry.info.last_seen, peer.last_seen);
+    entry.info = peer;
+    entry.info.public_key_fingerprint = std::move(fingerprint);
+    entry.info.last_seen = last_seen;
+    return dirty;
+}
+
+bool PeerCache::remove(const Uuid& device_id) {
+    return peers_.erase(device_id) > 0;
+}
+
+std::optional<CachedPeer> PeerCache::peer(const Uuid& device_id) const {
+    const auto it = peers_.find(device_id);
+    if (it == peers_.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+std::vector<CachedPeer> PeerCache::peers_for_workspace(const Uuid& workspace_id,
+                                                       Timestamp now,
+                                                       int64_t max_age_ms) const {
+    std::vector<CachedPeer> out;
+    for (const auto& [id, entry] : peers_) {
+        if (entry.info.workspace_id != workspace_id) {
+            continue;
+        }
+        if (now.millis() - entry.info.last_seen.millis() > max_age_ms) {
+            continue;
+        }
+        out.push_back(entry);
+    }
+    std::sort(out.begin(), out.end(), [](const CachedPeer& a, const CachedPeer& b) {
+        if (a.info.last_seen != b.info.last_seen) {
+            return a.info.last_seen > b.info.last_seen;
+        }
+        return a.info.device_id < b.info.device_id;
+    });
+    return out;
+}
+
+void PeerCache::evictOldest() {
+    const auto oldest = std::min_element(peers_.begin(), peers_.end(), [](const auto& a, const auto& b) {
+        return a.second.info.last_seen < b.second.info.last_seen;
+    });
+    if (oldest != peers_.end()) {
+        peers_.erase(oldest);
+    }
+}
+
+QByteArray PeerCache::serialize() const {
+    QJsonArray peers;
+    for (const auto& [id, entry] : peers_) {
+        peers.append(to_json(entry));
+    }
+    QJsonObject root;
+    root["v"] = FORMAT_VERSION;
+    root["peers"] = peers;
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+Result<PeerCache, Error> PeerCache::deserialize(const QByteArray& bytes) {
+    const auto doc = QJsonDocument::fromJson(bytes);
+    if (doc.isNull() || !doc.isObject()) {
+        return Result<PeerCache, Error>::err(Error{"invalid peer cache json"});
+    }
+    const auto root = doc.object();
+    if (root["v"].toInt() != FORMAT_VERSION) {
+        return Result<PeerCache, Error>::err(Error{"unsupported peer cache version"});
+    }
+
+    PeerCache cache;
+    for (const auto& value : root["peers"].toArray()) {
+        auto entry = from_json(value.toObject());
+        if (!entry) {
+            continue;
+        }
+        const auto id = entry->info.device_id;
+        cache.peers_[id] = std::move(*entry);
+    }
+    while (cache.peers_.size() > kMaxPeers) {
+        cache.evictOldest();
+    }
+    return Result<PeerCache, Error>::ok(std::move(cache));
+}
+
+Result<PeerCache, Error> PeerCache::load(const QString& path) {
+    QFile file(path);
+    if (!file.exists()) {
+        return Result<PeerCache, Error>::ok(PeerCache{});
+    }
+    if (!file.open(QIODevice::ReadOnly)) {
+        return Result<PeerCache, Error>::err(Error{file.errorString().toStdString()});
+    }
+    return deserialize(file.readAll());
+}
+
+Result<void, Error> PeerCache::save(const QString& path) const {
+    const QFileInfo info(path);
+    QDir().mkpath(info.absolutePath());
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return Result<void, Error>::err(Error{file.errorString().toStdString()});
+    }
+    const auto bytes = serialize();
+    if (file.write(bytes) != bytes.size()) {
+        file.cancelWriting();
+        return Result<void, Error>::err(Error{file.errorString().toStdString()});
+    }
+    if (!file.commit()) {
+        return Result<void, Error>::err(Error{file.errorString().toStdString()});
+    }
+    return Result<void, Error>::ok();
+}
+
+} // namespace zinc::network
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "core/result.hpp"
+#include "core/types.hpp"
+#include "network/discovery.hpp"
+
+#include <QByteArray>
+#include <QHostAddress>
+#include <QString>
+#include <map>
+#include <optional>
+#include <vector>
+
+namespace zinc::network {
+
+// Persisted discovery results (used by SyncManager) so startup can dial known peers
+// before UDP/Avahi discovery produces its first announcement.
+// Kept separate from SyncManager so the format can be tested without sockets.
+
+struct PeerEndpoint {
+    QHostAddress host;
+    uint16_t port = 0;
+
+    bool operator==(const PeerEndpoint& other) const {
+        return port == other.port && host == other.host;
+    }
+};
+
+struct CachedPeer {
+    // Most recently seen endpoint is mirrored in info.host/info.port.
+    PeerInfo info;
+    // Most recent first, bounded by PeerCache::kMaxEndpointsPerPeer.
+    std::vector<PeerEndpoint> endpoints;
+};
+
+/**
+ * PeerCache - Last known endpoints of peers in our workspace.
+ */
+class PeerCache {
+public:
+    static constexpr int FORMAT_VERSION = 1;
+    static constexpr size_t kMaxEndpointsPerPeer = 4;
+    static constexpr size_t kMaxPeers = 64;
+    // last_seen refreshes finer than this are kept in memory but not worth a disk write.
+    static constexpr int64_t kLastSeenPersistGranularityMs = 60 * 1000;
+
+    /**
+     * Insert or refresh a peer. Returns true when the change should be persisted
+     * (new peer, endpoint, identity or a materially newer last_seen).
+     */
+    bool upsert(const PeerInfo& peer);
+
+    bool remove(const Uuid& device_id);
+
+    [[nodiscard]] std::optional<CachedPeer> peer(const Uuid& device_id) const;
+
+    /**
+     * Peers in `workspace_id` seen within `max_age_ms` of `now`, most recent first.
+     */
+    [[nodiscard]] std::vector<CachedPeer> peers_for_workspace(const Uuid& workspace_id,
+                                                              Timestamp now,
+                                                              int64_t max_age_ms) const;
+
+    [[nodiscard]] size_t size() const { return peers_.size(); }
+    [[nodiscard]] bool empty() const { return peers_.empty(); }
+
+    [[nodiscard]] QByteArray serialize() const;
+    static Result<PeerCache, Error> deserialize(const QByteArray& bytes);
+
+    /**
+     * Load from disk. A missing file yields an empty cache.
+     */
+    static Result<PeerCache, Error> load(const QString& path);
+    Result<void, Error> save(const QString& path) const;
+
+private:
+    std::map<Uuid, CachedPeer> peers_;
+
+    void evictOldest();
+};
+
+} // namespace zinc::network
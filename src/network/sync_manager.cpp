@@ -5,6 +5,7 @@
 #include <QJsonObject>
 #include <QMetaObject>
 #include <QPointer>
+#include <QTimer>
 #include <algorithm>
 
 namespace zinc::network {
@@ -18,6 +19,17 @@ bool sync_discovery_disabled() {
     return qEnvironmentVariableIsSet("ZINC_SYNC_DISABLE_DISCOVERY");
 }
 
+bool sync_peer_cache_disabled() {
+    return qEnvironmentVariableIsSet("ZINC_SYNC_DISABLE_PEER_CACHE");
+}
+
+constexpr int kKeepaliveTickMs = 1000;
+constexpr int kPeerCacheSaveDelayMs = 2000;
+// Cached endpoints are often stale (DHCP, roaming); give up on a silent SYN quickly
+// and move on to the next endpoint instead of waiting for the OS connect timeout.
+constexpr int kPeerCacheDialTimeoutMs = 3000;
+constexpr int64_t kPeerCacheMaxAgeMs = 30LL * 24 * 60 * 60 * 1000;
+
 QByteArray to_bytes(const QJsonObject& obj) {
     return QJsonDocument(obj).toJson(QJsonDocument::Compact);
 }
@@ -50,7 +62,18 @@ SyncManager::SyncManager(QObject* parent)
     : QObject(parent)
     , discovery_(std::make_unique<DiscoveryService>(this))
     , server_(std::make_unique<TransportServer>(this))
+    , keepalive_timer_(std::make_unique<QTimer>(this))
+    , peer_cache_save_timer_(std::make_unique<QTimer>(this))
 {
+    keepalive_clock_.start();
+    keepalive_timer_->setInterval(kKeepaliveTickMs);
+    connect(keepalive_timer_.get(), &QTimer::timeout,
+            this, &SyncManager::onKeepaliveTick);
+    peer_cache_save_timer_->setSingleShot(true);
+    peer_cache_save_timer_->setInterval(kPeerCacheSaveDelayMs);
+    connect(peer_cache_save_timer_.get(), &QTimer::timeout,
+            this, &SyncManager::flushPeerCache);
+
     connect(discovery_.get(), &DiscoveryService::peerDiscovered,
             this, &SyncManager::onPeerDiscovered);
     // Treat periodic "peer updated" events as presence refresh so that
@@ -66,6 +89,7 @@ SyncManager::SyncManager(QObject* parent)
 
 SyncManager::~SyncManager() {
     stop();
+    flushPeerCache();
 }
 
 void SyncManager::initialize(const crypto::KeyPair& identity,
@@ -102,7 +126,9 @@ bool SyncManager::start(uint16_t port) {
     if (sync_discovery_disabled() || workspace_id_.is_nil()) {
         started_ = true;
         syncing_ = true;
+        keepalive_timer_->start();
         emit syncingChanged();
+        dialCachedPeers();
         return true;
     }
     
@@ -130,7 +156,11 @@ bool SyncManager::start(uint16_t port) {
     
     started_ = true;
     syncing_ = true;
+    keepalive_timer_->start();
     emit syncingChanged();
+
+    // Dial last known endpoints right away; live discovery runs in parallel and wins if it differs.
+    dialCachedPeers();
     
     return true;
 }
@@ -150,6 +180,9 @@ void SyncManager::stop() {
     }
     peers_.clear();
     autoconnect_attempted_.clear();
+    pending_cache_dials_.clear();
+    keepalive_timer_->stop();
+    flushPeerCache();
     
     discovery_->stopBrowsing();
     discovery_->stopAdvertising();
@@ -189,6 +222,7 @@ void SyncManager::connectToPeer(const Uuid& device_id) {
     auto peer = std::make_unique<PeerConnection>();
     peer->device_id = device_id;
     peer->connection = std::make_unique<Connection>(this);
+    peer->connection->setTrafficCounters(traffic_);
     peer->sync_state = SyncState::Connecting;
     peer->initiated_by_us = true;
     peer->allow_rekey_on_hello = false;
@@ -230,6 +264,7 @@ void SyncManager::connectToEndpoint(const Uuid& device_id,
     auto peer = std::make_unique<PeerConnection>();
     peer->device_id = device_id;
     peer->connection = std::make_unique<Connection>(this);
+    peer->connection->setTrafficCounters(traffic_);
     peer->sync_state = SyncState::Connecting;
     peer->initiated_by_us = true;
     peer->approved = true;
@@ -276,6 +311,7 @@ void SyncManager::connectToEndpoint(const Uuid& device_id,
     auto peer = std::make_unique<PeerConnection>();
     peer->device_id = device_id;
     peer->connection = std::make_unique<Connection>(this);
+    peer->connection->setTrafficCounters(traffic_);
     peer->sync_state = SyncState::Connecting;
     peer->initiated_by_us = true;
     peer->approved = true;
@@ -304,6 +340,7 @@ void SyncManager::approvePeer(const Uuid& device_id, bool approved) {
             qInfo() << "SYNC: peer approved device_id=" << QString::fromStdString(device_id.to_string());
         }
         peer.approved = true;
+        rememberConnectedPeer(device_id, peer);
         emit peerConnected(device_id);
         emit peersChanged();
         return;
@@ -429,6 +466,175 @@ void SyncManager::requestSync(const Uuid& device_id, const std::string& doc_id)
     it->second->sync_state = SyncState::Syncing;
 }
 
+void SyncManager::setKeepaliveConfig(const KeepaliveConfig& config) {
+    keepalive_config_ = config;
+}
+
+std::vector<PeerLinkStats> SyncManager::peerLinkStats() const {
+    const auto now = keepalive_clock_.elapsed();
+    std::vector<PeerLinkStats> out;
+    out.reserve(peers_.size());
+    for (const auto& [id, peer] : peers_) {
+        if (!peer || !peer->approved || !peer->connection || !peer->connection->isConnected()) {
+            continue;
+        }
+        out.push_back(PeerLinkStats{
+            .device_id = id,
+            .device_name = peer->device_name,
+            .rtt_ms = peer->keepalive.smoothed_rtt_ms(),
+            .jitter_ms = peer->keepalive.rtt_jitter_ms(),
+            .idle_ms = std::max<int64_t>(0, now - peer->keepalive.last_activity_ms()),
+            .missed_pongs = peer->keepalive.missed_pongs(),
+        });
+    }
+    return out;
+}
+
+void SyncManager::setPeerCachePath(const QString& path) {
+    if (sync_peer_cache_disabled()) {
+        peer_cache_path_.clear();
+        return;
+    }
+    if (path == peer_cache_path_) {
+        return;
+    }
+    flushPeerCache();
+    peer_cache_path_ = path;
+    peer_cache_ = PeerCache{};
+    if (path.isEmpty()) {
+        return;
+    }
+    auto loaded = PeerCache::load(path);
+    if (loaded.is_err()) {
+        qWarning() << "SYNC: failed to load peer cache" << path
+                   << QString::fromStdString(loaded.unwrap_err().message);
+        return;
+    }
+    peer_cache_ = loaded.unwrap();
+    if (sync_debug_enabled()) {
+        qInfo() << "SYNC: loaded peer cache path=" << path << "peers=" << peer_cache_.size();
+    }
+}
+
+void SyncManager::rememberPeer(const PeerInfo& peer) {
+    if (!peer_cache_.upsert(peer)) {
+        return;
+    }
+    peer_cache_dirty_ = true;
+    if (!peer_cache_path_.isEmpty() && !peer_cache_save_timer_->isActive()) {
+        peer_cache_save_timer_->start();
+    }
+}
+
+void SyncManager::rememberConnectedPeer(const Uuid& device_id, const PeerConnection& peer) {
+    pending_cache_dials_.erase(device_id);
+    if (workspace_id_.is_nil() || peer.host.isNull() || peer.port == 0) {
+        return;
+    }
+    PeerInfo info{};
+    info.device_id = device_id;
+    info.device_name = peer.device_name;
+    info.host = peer.host;
+    info.port = peer.port;
+    if (peer.connection) {
+        info.public_key_fingerprint = crypto::fingerprint(peer.connection->remotePeerKey());
+    }
+    info.last_seen = Timestamp::now();
+    info.workspace_id = workspace_id_;
+    info.protocol_version = DiscoveryService::PROTOCOL_VERSION;
+    rememberPeer(info);
+}
+
+void SyncManager::flushPeerCache() {
+    peer_cache_save_timer_->stop();
+    if (!peer_cache_dirty_ || peer_cache_path_.isEmpty()) {
+        return;
+    }
+    auto saved = peer_cache_.save(peer_cache_path_);
+    if (saved.is_err()) {
+        qWarning() << "SYNC: failed to save peer cache" << peer_cache_path_
+                   << QString::fromStdString(saved.unwrap_err().message);
+        return;
+    }
+    peer_cache_dirty_ = false;
+}
+
+void SyncManager::dialCachedPeers() {
+    if (workspace_id_.is_nil() || peer_cache_.empty()) {
+        return;
+    }
+    const auto cached = peer_cache_.peers_for_workspace(workspace_id_, Timestamp::now(), kPeerCacheMaxAgeMs);
+    for (const auto& entry : cached) {
+        const auto& id = entry.info.device_id;
+        if (id == device_id_) {
+            continue;
+        }
+        if (sync_debug_enabled()) {
+            qInfo() << "SYNC: dialing cached peer device_id=" << QString::fromStdString(id.to_string())
+                    << "endpoints=" << entry.endpoints.size();
+        }
+        pending_cache_dials_[id] = entry.endpoints;
+        dialNextCachedEndpoint(id);
+    }
+}
+
+void SyncManager::dialNextCachedEndpoint(const Uuid& device_id) {
+    auto it = pending_cache_dials_.find(device_id);
+    if (it == pending_cache_dials_.end()) {
+        return;
+    }
+    if (!started_ || it->second.empty() || peers_.count(device_id) > 0) {
+        // Out of endpoints, or discovery / an inbound connection got there first.
+        pending_cache_dials_.erase(it);
+        return;
+    }
+    const auto endpoint = it->second.front();
+    it->second.erase(it->second.begin());
+
+    connectToEndpoint(device_id, endpoint.host, endpoint.port, false);
+    auto peerIt = peers_.find(device_id);
+    if (peerIt == peers_.end() || !peerIt->second) {
+        return;
+    }
+    auto& peer = *peerIt->second;
+    peer.from_peer_cache = true;
+    peer.host = endpoint.host;
+    peer.port = endpoint.port;
+
+    QTimer::singleShot(kPeerCacheDialTimeoutMs, this,
+                       [this, device_id, conn = QPointer<Connection>(peer.connection.get())]() {
+        if (!conn || conn->state() != Connection::State::Connecting) {
+            return;
+        }
+        const auto current = peers_.find(device_id);
+        if (current == peers_.end() || !current->second || current->second->connection.get() != conn) {
+            return;
+        }
+        if (sync_debug_enabled()) {
+            qInfo() << "SYNC: cached endpoint timed out device_id=" << QString::fromStdString(device_id.to_string())
+                    << "host=" << current->second->host.toString()
+                    << "port=" << current->second->port;
+        }
+        discardPendingPeer(device_id);
+        dialNextCachedEndpoint(device_id);
+    });
+}
+
+void SyncManager::discardPendingPeer(const Uuid& device_id) {
+    // Only used for connections that never completed, so no peerDisconnected is emitted.
+    auto it = peers_.find(device_id);
+    if (it == peers_.end()) {
+        return;
+    }
+    auto peer = std::move(it->second);
+    peers_.erase(it);
+    if (peer && peer->connection) {
+        peer->connection->disconnect();
+        auto* raw = peer->connection.release();
+        if (raw) raw->deleteLater();
+    }
+}
+
 int SyncManager::connectedPeerCount() const {
     int count = 0;
     for (const auto& [id, peer] : peers_) {
@@ -478,6 +684,19 @@ void SyncManager::onPeerDiscovered(const PeerInfo& peer) {
     }
     // Auto-connect to peers in same workspace
     if (peer.workspace_id == workspace_id_) {
+        // Discovery is unauthenticated, so it does not feed the peer cache; the Hello of the
+        // connection we dial below does, once the peer has proven its key.
+        // Live discovery supersedes a cached endpoint that is still waiting on its SYN.
+        pending_cache_dials_.erase(peer.device_id);
+        const auto existing = peers_.find(peer.device_id);
+        if (existing != peers_.end() && existing->second && existing->second->from_peer_cache &&
+            existing->second->connection &&
+            existing->second->connection->state() == Connection::State::Connecting &&
+            (existing->second->host != peer.host || existing->second->port != peer.port)) {
+            discardPendingPeer(peer.device_id);
+            autoconnect_attempted_.erase(peer.device_id);
+        }
+
         if (autoconnect_attempted_.insert(peer.device_id).second) {
             connectToPeer(peer.device_id);
         }
@@ -502,6 +721,7 @@ void SyncManager::onNewConnection(QTcpSocket* socket) {
     auto peer = std::make_unique<PeerConnection>();
     peer->device_id = Uuid::generate();  // Will be updated after handshake
     peer->connection = std::make_unique<Connection>(this);
+    peer->connection->setTrafficCounters(traffic_);
     peer->sync_state = SyncState::Connecting;
     peer->initiated_by_us = false;
     peer->approved = false;
@@ -522,6 +742,8 @@ void SyncManager::onConnectionConnected() {
     for (auto& [id, peer] : peers_) {
         if (peer->connection.get() == conn) {
             peer->sync_state = SyncState::Streaming;
+            peer->keepalive = KeepaliveTracker(keepalive_config_);
+            peer->keepalive.reset(keepalive_clock_.elapsed());
             sendHello(*conn);
             qInfo() << "SYNC: connection established"
                     << "peer_id=" << QString::fromStdString(id.to_string())
@@ -589,6 +811,11 @@ void SyncManager::onConnectionStateChanged(Connection::State state) {
             autoconnect_attempted_.erase(id);
             emit peerDisconnected(id);
             emit peersChanged();
+            if (pending_cache_dials_.count(id) > 0) {
+                QMetaObject::invokeMethod(this, [this, id]() {
+                    dialNextCachedEndpoint(id);
+                }, Qt::QueuedConnection);
+            }
             break;
         }
     }
@@ -610,13 +837,20 @@ void SyncManager::onMessageReceived(MessageType type,
         }
     }
 
+    const auto now = keepalive_clock_.elapsed();
+    if (peer_ptr) {
+        peer_ptr->keepalive.on_activity(now);
+    }
+
     if (peer_ptr && !peer_ptr->approved &&
         type != MessageType::Hello &&
+        type != MessageType::Ping &&
+        type != MessageType::Pong &&
         type != MessageType::PairingRequest &&
         type != MessageType::PairingResponse &&
         type != MessageType::PairingComplete &&
         type != MessageType::PairingReject) {
-        // Ignore all non-Hello traffic until the user confirms the pairing.
+        // Ignore all non-Hello traffic (except keepalive) until the user confirms the pairing.
         return;
     }
     
@@ -764,9 +998,19 @@ void SyncManager::onMessageReceived(MessageType type,
             handleChangeNotify(peer_id, payload);
             break;
         case MessageType::Ping:
-            // Respond with pong
+            // Respond with pong, echoing the nonce so the sender can match its RTT sample.
             if (auto it = peers_.find(peer_id); it != peers_.end()) {
-                it->second->connection->send(MessageType::Pong, {});
+                it->second->connection->send(MessageType::Pong, payload);
+            }
+            break;
+        case MessageType::Pong:
+            if (peer_ptr && peer_ptr->keepalive.on_pong(decode_keepalive_nonce(payload), now)) {
+                if (sync_debug_enabled()) {
+                    qInfo() << "SYNC: Pong peer_id=" << QString::fromStdString(peer_id.to_string())
+                            << "rtt_ms=" << peer_ptr->keepalive.last_rtt_ms().value_or(-1.0)
+                            << "srtt_ms=" << peer_ptr->keepalive.smoothed_rtt_ms().value_or(-1.0);
+                }
+                emit peerLinkStatsChanged();
             }
             break;
         default:
@@ -774,6 +1018,68 @@ void SyncManager::onMessageReceived(MessageType type,
     }
 }
 
+void SyncManager::onKeepaliveTick() {
+    if (stopping_) return;
+
+    const auto now = keepalive_clock_.elapsed();
+    std::vector<Uuid> dead;
+    bool stats_changed = false;
+    for (auto& [id, peer] : peers_) {
+        // Only keep established sessions alive; connects in progress have their own socket timeouts.
+        if (!peer || !peer->hello_received || !peer->connection || !peer->connection->isConnected()) {
+            continue;
+        }
+        auto& keepalive = peer->keepalive;
+        if (keepalive.check_timeout(now)) {
+            stats_changed = true;
+            if (sync_debug_enabled()) {
+                qInfo() << "SYNC: keepalive missed pong peer_id=" << QString::fromStdString(id.to_string())
+                        << "missed=" << keepalive.missed_pongs();
+            }
+            if (keepalive.is_dead()) {
+                dead.push_back(id);
+                continue;
+            }
+        }
+        if (keepalive.should_ping(now)) {
+            const auto nonce = keepalive.on_ping_sent(now);
+            peer->connection->send(MessageType::Ping, encode_keepalive_nonce(nonce));
+        }
+    }
+
+    for (const auto& id : dead) {
+        handlePeerTimeout(id);
+    }
+    if (stats_changed) {
+        emit peerLinkStatsChanged();
+    }
+}
+
+void SyncManager::handlePeerTimeout(const Uuid& device_id) {
+    auto it = peers_.find(device_id);
+    if (it == peers_.end() || !it->second) {
+        return;
+    }
+    // Hello carries the peer's listening port, so this endpoint is reconnectable for inbound peers too.
+    const auto host = it->second->host;
+    const auto port = it->second->port;
+    const auto idle_ms = keepalive_clock_.elapsed() - it->second->keepalive.last_activity_ms();
+
+    qInfo() << "SYNC: peer keepalive timeout; reconnecting"
+            << "peer_id=" << QString::fromStdString(device_id.to_string())
+            << "peer_name=" << debug_peer_name(it->second.get())
+            << "endpoint=" << host.toString()
+            << "port=" << port
+            << "idle_ms=" << idle_ms;
+
+    emit peerTimedOut(device_id);
+    disconnectFromPeer(device_id);
+
+    if (started_ && !host.isNull() && port != 0) {
+        connectToEndpoint(device_id, host, port, false);
+    }
+}
+
 void SyncManager::sendHello(Connection& conn) const {
     QJsonObject obj;
     obj["id"] = QString::fromStdString(device_id_.to_string());
@@ -977,9 +1283,16 @@ void SyncManager::handleHello(Connection& conn, const std::vector<uint8_t>& payl
 
     // For inbound connections that were not discovered locally (e.g. manual/Tailscale), require
     // an explicit confirmation from the user before treating the peer as connected.
+    // Peers in the cache were dialed by us or approved before, so they skip the prompt even when
+    // they dial us before our own discovery has seen them, but only with the key they had then.
     const bool discovered =
         discovery_ && discovery_->peer(remoteId).has_value();
-    if (!initiatedByUs && !discovered) {
+    const auto cached = peer_cache_.peer(remoteId);
+    const bool cachedKeyMatches = cached && cached->info.workspace_id == workspace_id_ &&
+        !cached->info.public_key_fingerprint.empty() && updatedPeer.connection &&
+        cached->info.public_key_fingerprint == crypto::fingerprint(updatedPeer.connection->remotePeerKey());
+    const bool known = discovered || cachedKeyMatches;
+    if (!initiatedByUs && !known) {
         qInfo() << "SYNC: peer approval required"
                 << "remote_id=" << QString::fromStdString(remoteId.to_string())
                 << "remote_name=" << name
@@ -991,6 +1304,9 @@ void SyncManager::handleHello(Connection& conn, const std::vector<uint8_t>& payl
     }
 
     updatedPeer.approved = true;
+    if (initiatedByUs || cachedKeyMatches) {
+        rememberConnectedPeer(remoteId, updatedPeer);
+    }
     emit peerConnected(remoteId);
     emit peersChanged();
 }
@@ -3,13 +3,20 @@
 #include "core/types.hpp"
 #include "core/result.hpp"
 #include "network/discovery.hpp"
+#include "network/keepalive.hpp"
+#include "network/peer_cache.hpp"
 #include "network/transport.hpp"
 #include "crypto/keys.hpp"
 #include <QObject>
 #include <QByteArray>
+#include <QElapsedTimer>
 #include <map>
 #include <memory>
+#include <optional>
 #include <set>
+#include <vector>
+
+class QTimer;
 
 namespace zinc::network {
 
@@ -39,9 +46,24 @@ struct PeerConnection {
     // When true, the peers_ map key is a temporary placeholder and may be rekeyed
     // to the real remoteId after Hello (e.g. inbound connections or manual hostname connect).
     bool allow_rekey_on_hello = false;
+    // Dialed from the persisted peer cache at startup; live discovery may supersede it.
+    bool from_peer_cache = false;
     QString device_name;
     QHostAddress host;
     uint16_t port = 0;
+    KeepaliveTracker keepalive;
+};
+
+/**
+ * PeerLinkStats - Keepalive-derived link quality for a connected peer.
+ */
+struct PeerLinkStats {
+    Uuid device_id;
+    QString device_name;
+    std::optional<double> rtt_ms;
+    std::optional<double> jitter_ms;
+    int64_t idle_ms = 0;
+    int missed_pongs = 0;
 };
 
 /**
@@ -133,6 +155,28 @@ public:
      * Request full sync with a peer.
      */
     void requestSync(const Uuid& device_id, const std::string& doc_id);
+
+    /**
+     * Override keepalive timing (applies to connections established afterwards).
+     */
+    void setKeepaliveConfig(const KeepaliveConfig& config);
+
+    /**
+     * RTT / liveness snapshot for all approved, connected peers.
+     */
+    [[nodiscard]] std::vector<PeerLinkStats> peerLinkStats() const;
+
+    /**
+     * Persist discovered peers at `path` and dial them immediately on start().
+     * An empty path keeps the cache in memory only.
+     */
+    void setPeerCachePath(const QString& path);
+    [[nodiscard]] const PeerCache& peerCache() const { return peer_cache_; }
+
+    /**
+     * Cumulative wire traffic over all connections since construction.
+     */
+    [[nodiscard]] TrafficCounters trafficCounters() const { return *traffic_; }
     
     [[nodiscard]] bool isSyncing() const { return syncing_; }
     [[nodiscard]] int connectedPeerCount() const;
@@ -178,6 +222,8 @@ signals:
     void presenceReceived(const Uuid& peer_id, const QByteArray& payload);
     void changeReceived(const QString& doc_id, const QByteArray& change_bytes);
     void syncRequested(const Uuid& device_id, const QString& doc_id);
+    void peerLinkStatsChanged();
+    void peerTimedOut(const Uuid& device_id);
     void error(const QString& message);
 
 private slots:
@@ -188,10 +234,21 @@ private slots:
     void onConnectionDisconnected();
     void onConnectionStateChanged(Connection::State state);
     void onMessageReceived(MessageType type, const std::vector<uint8_t>& payload);
+    void onKeepaliveTick();
 
 private:
     std::unique_ptr<DiscoveryService> discovery_;
     std::unique_ptr<TransportServer> server_;
+    std::unique_ptr<QTimer> keepalive_timer_;
+    QElapsedTimer keepalive_clock_;
+    KeepaliveConfig keepalive_config_;
+    std::shared_ptr<TrafficCounters> traffic_ = std::make_shared<TrafficCounters>();
+    PeerCache peer_cache_;
+    QString peer_cache_path_;
+    bool peer_cache_dirty_ = false;
+    std::unique_ptr<QTimer> peer_cache_save_timer_;
+    // Remaining cached endpoints to try per peer while startup dials are in flight.
+    std::map<Uuid, std::vector<PeerEndpoint>> pending_cache_dials_;
     std::map<Uuid, std::unique_ptr<PeerConnection>> peers_;
     
     crypto::KeyPair identity_;
@@ -212,6 +269,13 @@ private:
     void handleSyncRequest(const Uuid& peer_id, const std::vector<uint8_t>& payload);
     void handleSyncResponse(const Uuid& peer_id, const std::vector<uint8_t>& payload);
     void handleChangeNotify(const Uuid& peer_id, const std::vector<uint8_t>& payload);
+    void handlePeerTimeout(const Uuid& device_id);
+    void dialCachedPeers();
+    void dialNextCachedEndpoint(const Uuid& device_id);
+    void discardPendingPeer(const Uuid& device_id);
+    void rememberPeer(const PeerInfo& peer);
+    void rememberConnectedPeer(const Uuid& device_id, const PeerConnection& peer);
+    void flushPeerCache();
 
 public:
     void sendPageSnapshot(const std::vector<uint8_t>& payload);
@@ -289,6 +289,10 @@ void Connection::onReadyRead() {
         );
         
         read_buffer_.remove(0, static_cast<int>(total_size));
+        if (traffic_) {
+            traffic_->bytes_received += total_size;
+            ++traffic_->messages_received;
+        }
         
         // Process based on state
         if (state_ == State::Handshaking) {
@@ -417,6 +421,10 @@ Result<void, Error> Connection::sendRaw(MessageType type,
                    header_bytes.size());
     socket_->write(reinterpret_cast<const char*>(data.data()), data.size());
     socket_->flush();
+    if (traffic_) {
+        traffic_->bytes_sent += header_bytes.size() + data.size();
+        ++traffic_->messages_sent;
+    }
     
     return Result<void, Error>::ok();
 }
@@ -62,6 +62,16 @@ struct MessageHeader {
     uint32_t length;
 };
 
+/**
+ * Wire-level totals (framed bytes incl. headers), shared by all connections of a SyncManager.
+ */
+struct TrafficCounters {
+    uint64_t bytes_sent = 0;
+    uint64_t bytes_received = 0;
+    uint64_t messages_sent = 0;
+    uint64_t messages_received = 0;
+};
+
 /**
  * Connection - A secure connection to a peer.
  */
@@ -127,6 +137,11 @@ public:
     [[nodiscard]] QHostAddress peerAddress() const;
     [[nodiscard]] uint16_t peerPort() const;
 
+    /**
+     * Accumulate sent/received frames into `counters` (may be shared across connections).
+     */
+    void setTrafficCounters(std::shared_ptr<TrafficCounters> counters) { traffic_ = std::move(counters); }
+
 signals:
     void connected();
     void disconnected();
@@ -150,6 +165,7 @@ private:
     QHostAddress connect_host_;
     QString connect_host_name_;
     uint16_t connect_port_ = 0;
+    std::shared_ptr<TrafficCounters> traffic_;
     
     void setState(State state);
     void processHandshake(MessageType type, const std::vector<uint8_t>& payload);
@@ -84,7 +84,7 @@ blocks::Block BlockRepository::row_to_block(Statement& stmt) {
     auto type = stmt.column_text(3);
     auto markdown = stmt.column_text(4);
     auto props_json = stmt.column_text(5);
-    auto sort_order = FractionalIndex(stmt.column_text(6));
+    auto sort_order = FractionalIndex::from_trusted(stmt.column_text(6));
     auto created_at = Timestamp(stmt.column_int64(7));
     auto updated_at = Timestamp(stmt.column_int64(8));
     
@@ -375,5 +375,210 @@ Result<int, Error> BlockRepository::count_by_page(const Uuid& page_id) {
     return Result<int, Error>::ok(stmt.column_int(0));
 }
 
+Result<std::vector<SortOrderRebalance>, Error> BlockRepository::rebalance_sort_orders(
+    const std::string& actor_id,
+    size_t max_key_length,
+    size_t max_groups
+) {
+    using R = Result<std::vector<SortOrderRebalance>, Error>;
+
+    // Groups with over-long keys, plus groups where concurrent inserts landed on the same key
+    // (short, but their order depends on the tie-break until renumbered).
+    auto stmt_result = db_.prepare(R"SQL(
+        SELECT page_id, parent_block_id
+        FROM blocks WHERE length(sort_order) > ?
+        UNION
+        SELECT page_id, parent_block_id
+        FROM blocks GROUP BY page_id, parent_block_id, sort_order HAVING count(*) > 1
+        LIMIT ?;
+    )SQL");
+    if (stmt_result.is_err()) {
+        return R::err(stmt_result.unwrap_err());
+    }
+
+    auto stmt = std::move(stmt_result).unwrap();
+    stmt.bind_int64(1, static_cast<int64_t>(max_key_length));
+    stmt.bind_int64(2, static_cast<int64_t>(max_groups));
+
+    std::vector<std::pair<Uuid, std::optional<Uuid>>> groups;
+    while (true) {
+        auto step_result = stmt.step();
+        if (step_result.is_err()) {
+            return R::err(step_result.unwrap_err());
+        }
+        if (!step_result.unwrap()) break;
+
+        auto page_id = Uuid::parse(stmt.column_text(0));
+        if (!page_id) continue;
+        std::optional<Uuid> parent_id;
+        if (!stmt.column_is_null(1)) {
+            parent_id = Uuid::parse(stmt.column_text(1));
+        }
+        groups.emplace_back(*page_id, parent_id);
+    }
+
+    std::vector<SortOrderRebalance> rebalances;
+    for (const auto& [page_id, parent_id] : groups) {
+        auto result = rebalance_siblings(page_id, parent_id, actor_id, max_key_length);
+        if (result.is_err()) {
+            return R::err(result.unwrap_err());
+        }
+        if (auto rebalance = std::move(result).unwrap()) {
+            rebalances.push_back(std::move(*rebalance));
+        }
+    }
+    return R::ok(std::move(rebalances));
+}
+
+Result<std::optional<SortOrderRebalance>, Error> BlockRepository::rebalance_siblings(
+    const Uuid& page_id,
+    const std::optional<Uuid>& parent_id,
+    const std::string& actor_id,
+    size_t max_key_length
+) {
+    using R = Result<std::optional<SortOrderRebalance>, Error>;
+
+    return db_.transaction([&]() -> R {
+        // Ties on sort_order are broken by id so every device renumbers them the same way.
+        auto stmt_result = db_.prepare(R"SQL(
+            SELECT id, sort_order FROM blocks
+            WHERE page_id = ? AND parent_block_id IS ?
+            ORDER BY sort_order, id;
+        )SQL");
+        if (stmt_result.is_err()) {
+            return R::err(stmt_result.unwrap_err());
+        }
+
+        auto stmt = std::move(stmt_result).unwrap();
+        stmt.bind_text(1, page_id.to_string());
+        if (parent_id) {
+            stmt.bind_text(2, parent_id->to_string());
+        } else {
+            stmt.bind_null(2);
+        }
+
+        std::vector<Uuid> ids;
+        std::vector<FractionalIndex> keys;
+        while (true) {
+            auto step_result = stmt.step();
+            if (step_result.is_err()) {
+                return R::err(step_result.unwrap_err());
+            }
+            if (!step_result.unwrap()) break;
+
+            auto id = Uuid::parse(stmt.column_text(0));
+            if (!id) continue;
+            ids.push_back(*id);
+            keys.push_back(FractionalIndex::from_trusted(stmt.column_text(1)));
+        }
+
+        const auto rebalanced = FractionalIndex::rebalance(keys, max_key_length);
+
+        SortOrderRebalance rebalance{
+            .page_id = page_id,
+            .parent_id = parent_id,
+            .rebalanced_at = Timestamp::now(),
+            .actor_id = actor_id,
+            .sort_orders = {},
+        };
+        for (size_t i = 0; i < keys.size(); ++i) {
+            if (rebalanced[i] != keys[i]) {
+                rebalance.sort_orders.emplace_back(ids[i], rebalanced[i]);
+            }
+        }
+        if (rebalance.sort_orders.empty()) {
+            return R::ok(std::nullopt);
+        }
+
+        auto applied = apply_rebalance_in_transaction(rebalance);
+        if (applied.is_err()) {
+            return R::err(applied.unwrap_err());
+        }
+        return R::ok(std::move(rebalance));
+    });
+}
+
+Result<bool, Error> BlockRepository::apply_sort_order_rebalance(const SortOrderRebalance& rebalance) {
+    return db_.transaction([&]() -> Result<bool, Error> {
+        return apply_rebalance_in_transaction(rebalance);
+    });
+}
+
+Result<bool, Error> BlockRepository::apply_rebalance_in_transaction(const SortOrderRebalance& rebalance) {
+    using R = Result<bool, Error>;
+    const auto page_key = rebalance.page_id.to_string();
+    const auto parent_key = rebalance.parent_id ? rebalance.parent_id->to_string() : std::string();
+
+    auto marker_result = db_.prepare(R"SQL(
+        SELECT rebalanced_at, actor_id FROM sort_order_rebalances
+        WHERE page_id = ? AND parent_block_id = ?;
+    )SQL");
+    if (marker_result.is_err()) {
+        return R::err(marker_result.unwrap_err());
+    }
+    auto marker = std::move(marker_result).unwrap();
+    marker.bind_text(1, page_key);
+    marker.bind_text(2, parent_key);
+    auto marker_step = marker.step();
+    if (marker_step.is_err()) {
+        return R::err(marker_step.unwrap_err());
+    }
+    if (marker_step.unwrap()) {
+        // Newest rebalance wins; ties are broken by actor id so peers agree.
+        const auto applied_at = marker.column_int64(0);
+        const auto applied_actor = marker.column_text(1);
+        const auto at = rebalance.rebalanced_at.millis();
+        if (at < applied_at || (at == applied_at && rebalance.actor_id <= applied_actor)) {
+            return R::ok(false);
+        }
+    }
+
+    // Only blocks still in this sibling group are renumbered; moved blocks keep their keys.
+    auto update_result = db_.prepare(R"SQL(
+        UPDATE blocks SET sort_order = ?
+        WHERE id = ? AND page_id = ? AND parent_block_id IS ?;
+    )SQL");
+    if (update_result.is_err()) {
+        return R::err(update_result.unwrap_err());
+    }
+    auto update = std::move(update_result).unwrap();
+    for (const auto& [id, key] : rebalance.sort_orders) {
+        update.reset();
+        update.bind_text(1, key.value());
+        update.bind_text(2, id.to_string());
+        update.bind_text(3, page_key);
+        if (rebalance.parent_id) {
+            update.bind_text(4, parent_key);
+        } else {
+            update.bind_null(4);
+        }
+        auto step_result = update.step();
+        if (step_result.is_err()) {
+            return R::err(step_result.unwrap_err());
+        }
+    }
+
+    auto upsert_result = db_.prepare(R"SQL(
+        INSERT INTO sort_order_rebalances (page_id, parent_block_id, rebalanced_at, actor_id)
+        VALUES (?, ?, ?, ?)
+        ON CONFLICT(page_id, parent_block_id) DO UPDATE SET
+            rebalanced_at = excluded.rebalanced_at,
+            actor_id = excluded.actor_id;
+    )SQL");
+    if (upsert_result.is_err()) {
+        return R::err(upsert_result.unwrap_err());
+    }
+    auto upsert = std::move(upsert_result).unwrap();
+    upsert.bind_text(1, page_key);
+    upsert.bind_text(2, parent_key);
+    upsert.bind_int64(3, rebalance.rebalanced_at.millis());
+    upsert.bind_text(4, rebalance.actor_id);
+    auto upsert_step = upsert.step();
+    if (upsert_step.is_err()) {
+        return R::err(upsert_step.unwrap_err());
+    }
+    return R::ok(true);
+}
+
 } // namespace zinc::storage
 
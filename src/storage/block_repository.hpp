@@ -8,6 +8,22 @@
 
 namespace zinc::storage {
 
+/**
+ * SortOrderRebalance - New sort orders for one sibling group.
+ *
+ * Returned by BlockRepository::rebalance_siblings. It is not replicated by
+ * itself: whoever syncs this database has to carry it to other devices and
+ * call apply_sort_order_rebalance there. The newest rebalance per group wins
+ * (rebalanced_at, then actor_id).
+ */
+struct SortOrderRebalance {
+    Uuid page_id;
+    std::optional<Uuid> parent_id;
+    Timestamp rebalanced_at;
+    std::string actor_id;
+    std::vector<std::pair<Uuid, FractionalIndex>> sort_orders;
+};
+
 /**
  * BlockRepository - Data access layer for blocks.
  * 
@@ -65,6 +81,37 @@ public:
      */
     [[nodiscard]] Result<int, Error> count_by_page(const Uuid& page_id);
 
+    // Keys longer than this are rewritten by the rebalancing pass.
+    static constexpr size_t DEFAULT_MAX_SORT_KEY_LENGTH = 8;
+
+    /**
+     * One bounded rebalancing pass: rewrites up to max_groups sibling groups
+     * that contain sort orders longer than max_key_length or shared by two
+     * siblings. Each group is its own transaction; the caller decides when to
+     * run it.
+     */
+    [[nodiscard]] Result<std::vector<SortOrderRebalance>, Error> rebalance_sort_orders(
+        const std::string& actor_id,
+        size_t max_key_length = DEFAULT_MAX_SORT_KEY_LENGTH,
+        size_t max_groups = 32);
+
+    /**
+     * Rewrite over-long (or duplicate) sort orders of one sibling group to
+     * short, evenly spaced keys in a single transaction. Returns nullopt when
+     * nothing needed rewriting.
+     */
+    [[nodiscard]] Result<std::optional<SortOrderRebalance>, Error> rebalance_siblings(
+        const Uuid& page_id,
+        const std::optional<Uuid>& parent_id,
+        const std::string& actor_id,
+        size_t max_key_length = DEFAULT_MAX_SORT_KEY_LENGTH);
+
+    /**
+     * Apply a rebalance (local or from a peer). Returns false when a newer
+     * rebalance of the same group was already applied.
+     */
+    [[nodiscard]] Result<bool, Error> apply_sort_order_rebalance(const SortOrderRebalance& rebalance);
+
 private:
     Database& db_;
     
@@ -72,6 +119,12 @@ private:
      * Convert a database row to a Block.
      */
     [[nodiscard]] blocks::Block row_to_block(Statement& stmt);
+
+    /**
+     * Apply a rebalance inside an already open transaction.
+     */
+    [[nodiscard]] Result<bool, Error> apply_rebalance_in_transaction(
+        const SortOrderRebalance& rebalance);
     
     /**
      * Convert BlockContent to type string and JSON properties.
@@ -216,6 +216,24 @@ inline const std::vector<Migration> ALL_MIGRATIONS = {
         .down_sql = R"SQL(
             DROP TABLE IF EXISTS attachments;
         )SQL"
+    },
+    {
+        .version = 6,
+        .name = "sort_order_rebalances",
+        .up_sql = R"SQL(
+            -- Last sort-order rebalance applied per sibling group (parent '' = page root).
+            -- Older rebalances arriving from peers are ignored so all devices keep the newest keys.
+            CREATE TABLE IF NOT EXISTS sort_order_rebalances (
+                page_id TEXT NOT NULL REFERENCES pages(id) ON DELETE CASCADE,
+                parent_block_id TEXT NOT NULL DEFAULT '',
+                rebalanced_at INTEGER NOT NULL,
+                actor_id TEXT NOT NULL,
+                PRIMARY KEY (page_id, parent_block_id)
+            );
+        )SQL",
+        .down_sql = R"SQL(
+            DROP TABLE IF EXISTS sort_order_rebalances;
+        )SQL"
     }
 };
 
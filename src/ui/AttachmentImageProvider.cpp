@@ -1,22 +1,27 @@
 #include "ui/AttachmentImageProvider.hpp"
 
+#include "ui/AttachmentThumbnailCache.hpp"
+
 #include <QImage>
 #include <QImageReader>
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
+#include <QHash>
+#include <QList>
 #include <QLoggingCategory>
+#include <QMutex>
 #include <QStandardPaths>
+#include <QThread>
 #include <QDebug>
 
+#include <algorithm>
+#include <atomic>
+
 namespace zinc::ui {
 
 Q_LOGGING_CATEGORY(zincAttachmentsLog, "zinc.attachments")
 
-AttachmentImageProvider::AttachmentImageProvider()
-    : QQuickImageProvider(QQuickImageProvider::Image) {
-}
-
 namespace {
 
 QString resolve_attachments_dir() {
@@ -60,11 +65,9 @@ bool is_safe_attachment_id(const QString& id) {
     return true;
 }
 
-} // namespace
-
-QImage AttachmentImageProvider::requestImage(const QString& id,
-                                             QSize* size,
-                                             const QSize& requestedSize) {
+// Reads the attachment `id`, scaled to fit `requestedSize` when that is valid. On failure
+// returns a null image and sets `error`.
+QImage decode_attachment(const QString& id, const QSize& requestedSize, QString& error) {
     QImage out;
 
     if (qEnvironmentVariableIsSet("ZINC_DEBUG_ATTACHMENTS")) {
@@ -76,15 +79,26 @@ QImage AttachmentImageProvider::requestImage(const QString& id,
     const auto normalizedId = normalize_attachment_id(id);
     if (!is_safe_attachment_id(normalizedId)) {
         qWarning() << "AttachmentImageProvider: Unsafe attachment id=" << id;
-        if (size) *size = out.size();
+        error = QStringLiteral("Unsafe attachment id");
         return out;
     }
 
-    const auto path = resolve_attachments_dir() + "/" + normalizedId;
+    const auto attachmentsDir = resolve_attachments_dir();
+    const AttachmentThumbnailCache thumbnails(attachmentsDir);
+    if (auto thumbnail = thumbnails.lookup(normalizedId, requestedSize); !thumbnail.isNull()) {
+        const auto target = thumbnail.size().scaled(requestedSize, Qt::KeepAspectRatio);
+        if (target.isValid() && target != thumbnail.size()) {
+            thumbnail = thumbnail.scaled(target, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        }
+        qCDebug(zincAttachmentsLog) << "requestImage thumbnailSize=" << thumbnail.size() << "id=" << id;
+        return thumbnail;
+    }
+
+    const auto path = attachmentsDir + "/" + normalizedId;
     QFile f(path);
     if (!f.exists() || !f.open(QIODevice::ReadOnly)) {
         qWarning() << "AttachmentImageProvider: Missing attachment file id=" << normalizedId << "path=" << path;
-        if (size) *size = out.size();
+        error = QStringLiteral("Missing attachment file");
         return out;
     }
 
@@ -115,6 +129,7 @@ QImage AttachmentImageProvider::requestImage(const QString& id,
         qWarning() << "AttachmentImageProvider: Failed to decode image id=" << id
                    << "error=" << reader.errorString()
                    << "path=" << path;
+        error = reader.errorString();
     } else {
         if (qEnvironmentVariableIsSet("ZINC_DEBUG_ATTACHMENTS")) {
             qInfo() << "AttachmentImageProvider: decodedSize=" << out.size() << "id=" << id;
@@ -123,8 +138,138 @@ QImage AttachmentImageProvider::requestImage(const QString& id,
         }
     }
 
-    if (size) *size = out.size();
+    // The original was decoded because no thumbnail covered the request; have one next time.
+    if (!out.isNull() && AttachmentThumbnailCache::bucketFor(requestedSize) >= 0) {
+        AttachmentThumbnailCache::generateInBackground(attachmentsDir, {normalizedId});
+    }
+
     return out;
 }
 
+class AttachmentImageResponse;
+
+// One decode, shared by every response that asked for the same id and size while it was
+// pending or running.
+struct DecodeJob {
+    QString key;
+    QString id;
+    QSize requestedSize;
+    QList<AttachmentImageResponse*> waiting; // guarded by DecodeQueue::mutex
+};
+
+} // namespace
+
+struct AttachmentImageProvider::DecodeQueue {
+    QMutex mutex;
+    QHash<QString, std::shared_ptr<DecodeJob>> jobs; // by key, until their image is delivered
+    std::atomic<quint64> decodes{0};
+};
+
+namespace {
+
+class AttachmentImageResponse : public QQuickImageResponse {
+public:
+    AttachmentImageResponse(std::shared_ptr<AttachmentImageProvider::DecodeQueue> queue,
+                            std::shared_ptr<DecodeJob> job)
+        : m_queue(std::move(queue)), m_job(std::move(job)) {}
+    ~AttachmentImageResponse() override { detach(); }
+
+    QQuickTextureFactory* textureFactory() const override {
+        return QQuickTextureFactory::textureFactoryForImage(m_image);
+    }
+    QString errorString() const override { return m_error; }
+    // The pixmap reader deletes a response only once it has finished, cancelled or not.
+    void cancel() override {
+        if (!detach()) return; // already delivered
+        m_error = QStringLiteral("cancelled");
+        emit finished();
+    }
+
+    // Called by the decoding thread with the queue locked, which keeps this response alive.
+    void deliver(const QImage& image, const QString& error) {
+        m_image = image;
+        m_error = error;
+        m_job.reset();
+        emit finished();
+    }
+
+private:
+    // Returns true if this response was still waiting for its decode.
+    bool detach() {
+        QMutexLocker lock(&m_queue->mutex);
+        if (!m_job) return false;
+        m_job->waiting.removeOne(this);
+        m_job.reset();
+        return true;
+    }
+
+    std::shared_ptr<AttachmentImageProvider::DecodeQueue> m_queue;
+    std::shared_ptr<DecodeJob> m_job; // null once delivered or cancelled
+    QImage m_image;
+    QString m_error;
+};
+
+} // namespace
+
+AttachmentImageProvider::AttachmentImageProvider(int decodeThreads)
+    : m_queue(std::make_shared<DecodeQueue>()) {
+    // Decoding is memory-bound as much as CPU-bound; a few threads keep a page responsive
+    // without holding many full-size originals at once.
+    m_pool.setMaxThreadCount(decodeThreads > 0 ? decodeThreads
+                                               : std::clamp(QThread::idealThreadCount() / 2, 1, 4));
+    m_pool.setObjectName(QStringLiteral("AttachmentImageDecode"));
+}
+
+AttachmentImageProvider::~AttachmentImageProvider() {
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+QQuickImageResponse* AttachmentImageProvider::requestImageResponse(const QString& id,
+                                                                   const QSize& requestedSize) {
+    const auto normalizedId = normalize_attachment_id(id);
+    const auto key = QStringLiteral("%1@%2x%3").arg(normalizedId).arg(requestedSize.width()).arg(requestedSize.height());
+
+    QMutexLocker lock(&m_queue->mutex);
+    auto& job = m_queue->jobs[key];
+    const bool start = !job;
+    if (start) {
+        job = std::make_shared<DecodeJob>();
+        job->key = key;
+        job->id = id;
+        job->requestedSize = requestedSize;
+    }
+    auto* response = new AttachmentImageResponse(m_queue, job);
+    job->waiting.append(response);
+    lock.unlock();
+
+    if (start) {
+        m_pool.start([queue = m_queue, job] {
+            {
+                // Every request for it was cancelled while it was queued.
+                QMutexLocker lock(&queue->mutex);
+                if (job->waiting.isEmpty()) {
+                    queue->jobs.remove(job->key);
+                    return;
+                }
+            }
+            queue->decodes.fetch_add(1, std::memory_order_relaxed);
+            QString error;
+            const auto image = decode_attachment(job->id, job->requestedSize, error);
+
+            QMutexLocker lock(&queue->mutex);
+            queue->jobs.remove(job->key);
+            for (auto* waiting : std::as_const(job->waiting)) {
+                waiting->deliver(image, error);
+            }
+            job->waiting.clear();
+        });
+    }
+    return response;
+}
+
+quint64 AttachmentImageProvider::decodeCount() const {
+    return m_queue->decodes.load(std::memory_order_relaxed);
+}
+
 } // namespace zinc::ui
@@ -1,15 +1,38 @@
 #pragma once
 
-#include <QQuickImageProvider>
+#include <QQuickAsyncImageProvider>
+#include <QThreadPool>
+
+#include <memory>
 
 namespace zinc::ui {
 
-class AttachmentImageProvider : public QQuickImageProvider {
+/**
+ * AttachmentImageProvider - serves `image://attachments/<id>` from the attachments folder.
+ *
+ * Images decode (scaled to the requested size) on the provider's own bounded pool, so a page
+ * full of photos neither decodes serially nor takes over the global pool. Requests for the same
+ * id and size that overlap share one decode, and a request the engine cancels (its Image was
+ * destroyed or changed source, e.g. scrolled out of a view) is dropped unless another request
+ * still waits for the same decode.
+ */
+class AttachmentImageProvider : public QQuickAsyncImageProvider {
 public:
-    AttachmentImageProvider();
+    // 0 picks a default from QThread::idealThreadCount().
+    explicit AttachmentImageProvider(int decodeThreads = 0);
+    ~AttachmentImageProvider() override;
+
+    QQuickImageResponse* requestImageResponse(const QString& id, const QSize& requestedSize) override;
+
+    // Decodes started so far; requests that were deduplicated or cancelled do not count.
+    [[nodiscard]] quint64 decodeCount() const;
 
-    QImage requestImage(const QString& id, QSize* size, const QSize& requestedSize) override;
+    // Decodes in flight and the responses waiting for them; shared with both, defined in the .cpp.
+    struct DecodeQueue;
+
+private:
+    std::shared_ptr<DecodeQueue> m_queue;
+    QThreadPool m_pool;
 };
 
 } // namespace zinc::ui
-
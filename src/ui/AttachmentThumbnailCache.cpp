@@ -0,0 +1,314 @@
+#include "ui/AttachmentThumbnailCache.hpp"
+
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QList>
+#include <QMutex>
+#include <QSaveFile>
+#include <QSet>
+#include <QThreadPool>
+
+#include <algorithm>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace zinc::ui {
+namespace {
+
+const QString kIndexFileName = QStringLiteral("index.json");
+
+bool is_safe_attachment_id(const QString& id) {
+    return !id.isEmpty() && id != QStringLiteral(".") && id != QStringLiteral("..") &&
+        !id.contains('/') && !id.contains('\\');
+}
+
+int longest_side(const QSize& size) {
+    return std::max(size.width(), size.height());
+}
+
+// "<bytes>|<mtimeMs>" of the original; cheap to compare on every lookup.
+QString source_fingerprint(const QFileInfo& original) {
+    return QStringLiteral("%1|%2").arg(original.size()).arg(original.lastModified().toMSecsSinceEpoch());
+}
+
+struct ThumbnailIndex {
+    QString hash;        // SHA-256 of the original, hex
+    QString source;      // source_fingerprint() when written
+    QString format;      // "jpg", "png", or "none" if the original is not an image
+    int side = 0;        // longest side of the original
+    QList<int> buckets;  // ascending; empty if the original is not an image
+};
+
+QString thumbnail_file_name(const ThumbnailIndex& index, int bucket) {
+    return QStringLiteral("%1-%2.%3").arg(index.hash.left(16)).arg(bucket).arg(index.format);
+}
+
+std::optional<ThumbnailIndex> read_index(const QString& dir) {
+    QFile file(QDir(dir).filePath(kIndexFileName));
+    if (!file.open(QIODevice::ReadOnly)) return std::nullopt;
+    const auto doc = QJsonDocument::fromJson(file.readAll());
+    if (!doc.isObject()) return std::nullopt;
+    const auto obj = doc.object();
+    ThumbnailIndex index;
+    index.hash = obj.value(QStringLiteral("hash")).toString();
+    index.source = obj.value(QStringLiteral("source")).toString();
+    index.format = obj.value(QStringLiteral("format")).toString();
+    index.side = obj.value(QStringLiteral("side")).toInt();
+    for (const auto& v : obj.value(QStringLiteral("buckets")).toArray()) {
+        index.buckets.append(v.toInt());
+    }
+    if (index.hash.isEmpty() || index.source.isEmpty()) return std::nullopt;
+    return index;
+}
+
+bool write_index(const QString& dir, const ThumbnailIndex& index) {
+    QJsonArray buckets;
+    for (const int bucket : index.buckets) {
+        buckets.append(bucket);
+    }
+    const QJsonObject obj{
+        {QStringLiteral("hash"), index.hash},
+        {QStringLiteral("source"), index.source},
+        {QStringLiteral("format"), index.format},
+        {QStringLiteral("side"), index.side},
+        {QStringLiteral("buckets"), buckets},
+    };
+    QSaveFile file(QDir(dir).filePath(kIndexFileName));
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    file.write(QJsonDocument(obj).toJson(QJsonDocument::Compact));
+    return file.commit();
+}
+
+bool thumbnails_exist(const QString& dir, const ThumbnailIndex& index) {
+    return std::all_of(index.buckets.cbegin(), index.buckets.cend(), [&](int bucket) {
+        return QFileInfo::exists(QDir(dir).filePath(thumbnail_file_name(index, bucket)));
+    });
+}
+
+// Deletes everything in `dir` other than the index and the thumbnails it lists.
+void remove_other_files(const QString& dir, const ThumbnailIndex& index) {
+    QSet<QString> keep{kIndexFileName};
+    for (const int bucket : index.buckets) {
+        keep.insert(thumbnail_file_name(index, bucket));
+    }
+    const QDir d(dir);
+    for (const auto& name : d.entryList(QDir::Files | QDir::NoDotAndDotDot)) {
+        if (!keep.contains(name)) QFile::remove(d.filePath(name));
+    }
+}
+
+bool save_image(const QImage& image, const QString& path, const QString& format) {
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    const bool png = format == QStringLiteral("png");
+    if (!image.save(&file, png ? "PNG" : "JPG", png ? -1 : 85)) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+// Attachments waiting for generateInBackground(), drained by a single pool task at a time.
+struct BackgroundQueue {
+    QMutex mutex;
+    QList<std::pair<QString, QString>> pending; // attachments dir, id
+    QSet<QString> queued;                       // dir + '/' + id of everything in `pending`
+    bool running = false;
+};
+
+BackgroundQueue& background_queue() {
+    static BackgroundQueue queue;
+    return queue;
+}
+
+} // namespace
+
+AttachmentThumbnailCache::AttachmentThumbnailCache(const QString& attachmentsDir, qint64 capacityBytes)
+    : m_attachmentsDir(attachmentsDir),
+      m_dir(QDir(attachmentsDir).filePath(QStringLiteral(".thumbnails"))),
+      m_capacity(capacityBytes) {}
+
+int AttachmentThumbnailCache::bucketFor(const QSize& requestedSize) {
+    if (!requestedSize.isValid() || requestedSize.isEmpty()) return -1;
+    const auto side = longest_side(requestedSize);
+    for (const int bucket : kBuckets) {
+        if (bucket >= side) return bucket;
+    }
+    return -1;
+}
+
+QImage AttachmentThumbnailCache::lookup(const QString& id, const QSize& requestedSize) const {
+    const auto bucket = bucketFor(requestedSize);
+    if (bucket < 0 || !is_safe_attachment_id(id)) return {};
+
+    const QFileInfo original(QDir(m_attachmentsDir).filePath(id));
+    if (!original.isFile()) return {};
+    const auto dir = QDir(m_dir).filePath(id);
+    const auto index = read_index(dir);
+    if (!index || index->source != source_fingerprint(original)) return {};
+
+    // A bucket at or above the original's size holds the original at its own size.
+    const auto wanted = std::min(bucket, index->side);
+    for (const int stored : index->buckets) {
+        if (stored < wanted) continue;
+        QFile file(QDir(dir).filePath(thumbnail_file_name(*index, stored)));
+        if (!file.open(QIODevice::ReadOnly)) continue;
+        QImageReader reader(&file);
+        const auto image = reader.read();
+        if (image.isNull()) continue;
+        file.setFileTime(QDateTime::currentDateTimeUtc(), QFileDevice::FileModificationTime);
+        return image;
+    }
+    return {};
+}
+
+bool AttachmentThumbnailCache::generate(const QString& id) const {
+    if (!is_safe_attachment_id(id)) return false;
+    const QFileInfo original(QDir(m_attachmentsDir).filePath(id));
+    if (!original.isFile()) return false;
+
+    const auto dir = QDir(m_dir).filePath(id);
+    const auto source = source_fingerprint(original);
+    auto previous = read_index(dir);
+    if (previous && previous->source == source && thumbnails_exist(dir, *previous)) {
+        return !previous->buckets.isEmpty();
+    }
+
+    QFile file(original.absoluteFilePath());
+    if (!file.open(QIODevice::ReadOnly)) return false;
+    const auto bytes = file.readAll();
+    file.close();
+    const auto hash = QString::fromLatin1(QCryptographicHash::hash(bytes, QCryptographicHash::Sha256).toHex());
+    if (!QDir().mkpath(dir)) return false;
+
+    // Written again with the same content (e.g. by sync): only the fingerprint moved.
+    if (previous && previous->hash == hash && thumbnails_exist(dir, *previous)) {
+        previous->source = source;
+        return write_index(dir, *previous) && !previous->buckets.isEmpty();
+    }
+
+    ThumbnailIndex index;
+    index.hash = hash;
+    index.source = source;
+
+    QBuffer buffer;
+    buffer.setData(bytes);
+    buffer.open(QIODevice::ReadOnly);
+    QImageReader reader(&buffer);
+    reader.setAutoTransform(true);
+    const auto originalSize = reader.size();
+    const int largest = kBuckets.back();
+    if (originalSize.isValid() && longest_side(originalSize) > largest) {
+        // Decode straight to the largest bucket; JPEG scales while decoding.
+        reader.setScaledSize(originalSize.scaled(largest, largest, Qt::KeepAspectRatio));
+    }
+    auto image = reader.read();
+    if (image.isNull()) {
+        // Not an image: remember that, so lookups stop asking.
+        index.format = QStringLiteral("none");
+        remove_other_files(dir, index);
+        write_index(dir, index);
+        return false;
+    }
+
+    index.side = originalSize.isValid() ? longest_side(originalSize) : longest_side(image.size());
+    index.format = image.hasAlphaChannel() ? QStringLiteral("png") : QStringLiteral("jpg");
+    for (const int bucket : kBuckets) {
+        index.buckets.append(bucket);
+        if (bucket >= index.side) break;
+    }
+
+    // Largest first, each scaled from the one before.
+    for (auto it = index.buckets.crbegin(); it != index.buckets.crend(); ++it) {
+        const auto side = std::min(*it, index.side);
+        if (longest_side(image.size()) > side) {
+            image = image.scaled(side, side, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        }
+        if (!save_image(image, QDir(dir).filePath(thumbnail_file_name(index, *it)), index.format)) {
+            return false;
+        }
+    }
+    if (!write_index(dir, index)) return false;
+    remove_other_files(dir, index);
+    return true;
+}
+
+void AttachmentThumbnailCache::evict() const {
+    // Thumbnails of attachments that no longer exist go first.
+    const QDir root(m_dir);
+    for (const auto& id : root.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+        if (!QFileInfo::exists(QDir(m_attachmentsDir).filePath(id))) {
+            QDir(root.filePath(id)).removeRecursively();
+        }
+    }
+
+    struct Entry {
+        QString path;
+        qint64 size = 0;
+        qint64 usedAt = 0;
+    };
+    std::vector<Entry> entries;
+    qint64 total = 0;
+    QDirIterator it(m_dir, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        const auto info = it.fileInfo();
+        if (info.fileName() == kIndexFileName) continue;
+        entries.push_back({info.absoluteFilePath(), info.size(), info.lastModified().toMSecsSinceEpoch()});
+        total += info.size();
+    }
+    if (total <= m_capacity) return;
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.usedAt < b.usedAt; });
+    for (const auto& entry : entries) {
+        if (total <= m_capacity) break;
+        if (QFile::remove(entry.path)) total -= entry.size;
+    }
+}
+
+void AttachmentThumbnailCache::generateInBackground(const QString& attachmentsDir, const QStringList& ids) {
+    auto& queue = background_queue();
+    QMutexLocker lock(&queue.mutex);
+    for (const auto& id : ids) {
+        const auto key = attachmentsDir + '/' + id;
+        if (queue.queued.contains(key)) continue;
+        queue.queued.insert(key);
+        queue.pending.append({attachmentsDir, id});
+    }
+    if (queue.running || queue.pending.isEmpty()) return;
+    queue.running = true;
+
+    QThreadPool::globalInstance()->start([&queue] {
+        QSet<QString> touched;
+        for (;;) {
+            std::pair<QString, QString> next;
+            {
+                QMutexLocker lock(&queue.mutex);
+                if (queue.pending.isEmpty()) {
+                    queue.running = false;
+                    break;
+                }
+                next = queue.pending.takeFirst();
+            }
+            AttachmentThumbnailCache(next.first).generate(next.second);
+            touched.insert(next.first);
+            QMutexLocker lock(&queue.mutex);
+            queue.queued.remove(next.first + '/' + next.second);
+        }
+        for (const auto& dir : std::as_const(touched)) {
+            AttachmentThumbnailCache(dir).evict();
+        }
+    });
+}
+
+} // namespace zinc::ui
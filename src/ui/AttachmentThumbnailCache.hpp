@@ -0,0 +1,59 @@
+#pragma once
+
+#include <QImage>
+#include <QSize>
+#include <QString>
+#include <QStringList>
+
+#include <array>
+
+namespace zinc::ui {
+
+/**
+ * AttachmentThumbnailCache - downscaled copies of image attachments, kept on disk.
+ *
+ * Thumbnails live in `<attachments>/.thumbnails/<id>/`, one per size bucket (the longest side),
+ * named by the SHA-256 of the original and the bucket. `index.json` next to them records that
+ * hash with the original's size and modification time, so a lookup only has to stat the
+ * original. An original that changes gets new thumbnails; one rewritten with the same content
+ * keeps them.
+ *
+ * A request is served from the bucket that covers it or the next larger one that exists;
+ * originals smaller than a bucket are stored at their own size in it. Lookups refresh a
+ * thumbnail's modification time, and evict() removes the least recently used ones once the
+ * cache outgrows its capacity.
+ */
+class AttachmentThumbnailCache {
+public:
+    static constexpr std::array<int, 4> kBuckets{256, 512, 1024, 2048};
+    static constexpr qint64 kDefaultCapacityBytes = qint64{256} << 20;
+
+    explicit AttachmentThumbnailCache(const QString& attachmentsDir,
+                                      qint64 capacityBytes = kDefaultCapacityBytes);
+
+    // The smallest bucket covering `requestedSize`, or -1 if the size is invalid or larger than
+    // every bucket.
+    static int bucketFor(const QSize& requestedSize);
+
+    // A thumbnail of attachment `id` for `requestedSize` (not scaled to it), or a null image if
+    // none is cached for the original as it is now.
+    QImage lookup(const QString& id, const QSize& requestedSize) const;
+    // Writes the thumbnails of attachment `id` unless they are current. Returns false if the
+    // original is missing or not a readable image.
+    bool generate(const QString& id) const;
+    // Removes the least recently used thumbnails until the cache fits its capacity.
+    void evict() const;
+
+    // Runs generate() for `ids` on the global thread pool, one at a time, then evict(). Ids
+    // that are already waiting are not queued twice.
+    static void generateInBackground(const QString& attachmentsDir, const QStringList& ids);
+
+    [[nodiscard]] const QString& directory() const { return m_dir; }
+
+private:
+    QString m_attachmentsDir;
+    QString m_dir;
+    qint64 m_capacity;
+};
+
+} // namespace zinc::ui
@@ -1,9 +1,15 @@
 #include "ui/Cmark.hpp"
 
 #include <cmark.h>
-#include <QRegularExpression>
-#include <QStringBuilder>
 #include <QHash>
+#include <QMutexLocker>
+#include <QSemaphore>
+#include <QThreadPool>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <utility>
 
 namespace zinc::ui {
 
@@ -14,32 +20,31 @@ bool startsWithInsensitive(const QStringView s, const QStringView prefix) {
     return QStringView(s.data(), prefix.size()).compare(prefix, Qt::CaseInsensitive) == 0;
 }
 
-QString lower(const QStringView s) {
-    QString out;
-    out.reserve(s.size());
-    for (const auto ch : s) {
-        out.append(ch.toLower());
+// Canonical (lowercase) names; lookups compare case-insensitively so no lowered copy is made.
+constexpr std::array kAllowedTags{
+    QLatin1String("p"),    QLatin1String("br"),  QLatin1String("em"), QLatin1String("strong"),
+    QLatin1String("code"), QLatin1String("pre"), QLatin1String("blockquote"),
+    QLatin1String("ul"),   QLatin1String("ol"),  QLatin1String("li"),
+    QLatin1String("h1"),   QLatin1String("h2"),  QLatin1String("h3"),
+    QLatin1String("hr"),
+    QLatin1String("a"),    QLatin1String("img"),
+    QLatin1String("span"), QLatin1String("u"),   QLatin1String("s"),  QLatin1String("del"),
+};
+
+constexpr std::array kStripElements{QLatin1String("script"), QLatin1String("style")};
+
+constexpr std::array kAllowedStyleProps{
+    QLatin1String("color"),      QLatin1String("background-color"), QLatin1String("font-family"),
+    QLatin1String("font-size"),  QLatin1String("font-style"),       QLatin1String("font-weight"),
+    QLatin1String("text-decoration"),
+};
+
+template <size_t N>
+QLatin1String lookup(const std::array<QLatin1String, N>& names, const QStringView name) {
+    for (const auto candidate : names) {
+        if (name.compare(candidate, Qt::CaseInsensitive) == 0) return candidate;
     }
-    return out;
-}
-
-bool isAllowedTagName(const QStringView name) {
-    const auto n = lower(name);
-    static const QSet<QString> allowed = {
-        QStringLiteral("p"),  QStringLiteral("br"),   QStringLiteral("em"),  QStringLiteral("strong"),
-        QStringLiteral("code"), QStringLiteral("pre"), QStringLiteral("blockquote"),
-        QStringLiteral("ul"), QStringLiteral("ol"),   QStringLiteral("li"),
-        QStringLiteral("h1"), QStringLiteral("h2"),   QStringLiteral("h3"),
-        QStringLiteral("hr"),
-        QStringLiteral("a"),  QStringLiteral("img"),
-        QStringLiteral("span"), QStringLiteral("u"), QStringLiteral("s"), QStringLiteral("del"),
-    };
-    return allowed.contains(n);
-}
-
-bool isStripElement(const QStringView name) {
-    const auto n = lower(name);
-    return n == QStringLiteral("script") || n == QStringLiteral("style");
+    return {};
 }
 
 bool isSafeHref(const QStringView href) {
@@ -62,56 +67,89 @@ bool isSafeImgSrc(const QStringView src) {
            startsWithInsensitive(s, QStringView(u"data:image/"));
 }
 
-QString sanitizeStyleValue(const QStringView value) {
-    // Drop anything that could reference external resources.
-    if (value.contains(QStringLiteral("url("), Qt::CaseInsensitive)) return QString();
-    return value.toString().trimmed();
+// Same escaping as QString::toHtmlEscaped, written straight into `out`.
+void appendEscaped(QString& out, const QStringView value) {
+    for (const auto ch : value) {
+        switch (ch.unicode()) {
+        case u'<': out += QLatin1String("&lt;"); break;
+        case u'>': out += QLatin1String("&gt;"); break;
+        case u'&': out += QLatin1String("&amp;"); break;
+        case u'"': out += QLatin1String("&quot;"); break;
+        default: out += ch; break;
+        }
+    }
 }
 
-QString sanitizeStyle(const QStringView styleText) {
-    // Whitelist a small CSS subset used by our inline formatting features.
-    static const QSet<QString> allowedProps = {
-        QStringLiteral("color"),
-        QStringLiteral("background-color"),
-        QStringLiteral("font-family"),
-        QStringLiteral("font-size"),
-        QStringLiteral("font-style"),
-        QStringLiteral("font-weight"),
-        QStringLiteral("text-decoration"),
-    };
-
-    const auto raw = styleText.toString();
-    const auto decls = raw.split(QLatin1Char(';'), Qt::SkipEmptyParts);
-    QStringList kept;
-    kept.reserve(decls.size());
+void appendAttr(QString& out, const QLatin1String name, const QStringView value) {
+    out += QLatin1Char(' ');
+    out += name;
+    out += QLatin1String("=\"");
+    appendEscaped(out, value);
+    out += QLatin1Char('"');
+}
 
-    for (const auto& decl : decls) {
-        const int colon = decl.indexOf(QLatin1Char(':'));
+// Whitelists a small CSS subset used by our inline formatting features, dropping anything that
+// could reference external resources. Writes nothing if no declaration survives.
+void appendStyleAttr(QString& out, const QStringView style) {
+    const qsizetype mark = out.size();
+    out += QLatin1String(" style=\"");
+    bool kept = false;
+    for (const auto decl : style.tokenize(u';', Qt::SkipEmptyParts)) {
+        const qsizetype colon = decl.indexOf(QLatin1Char(':'));
         if (colon <= 0) continue;
-        const auto prop = decl.left(colon).trimmed().toLower();
-        if (!allowedProps.contains(prop)) continue;
-        const auto val = sanitizeStyleValue(QStringView(decl).mid(colon + 1));
-        if (val.isEmpty()) continue;
-        kept.append(prop + QStringLiteral(":") + val);
+        const auto prop = lookup(kAllowedStyleProps, decl.left(colon).trimmed());
+        if (prop.isEmpty()) continue;
+        const auto raw = decl.mid(colon + 1);
+        if (raw.contains(QLatin1String("url("), Qt::CaseInsensitive)) continue;
+        const auto value = raw.trimmed();
+        if (value.isEmpty()) continue;
+        out += prop;
+        out += QLatin1Char(':');
+        appendEscaped(out, value);
+        out += QLatin1Char(';');
+        kept = true;
+    }
+    if (kept) {
+        out += QLatin1Char('"');
+    } else {
+        out.truncate(mark);
     }
-
-    if (kept.isEmpty()) return QString();
-    return kept.join(QStringLiteral(";")) + QLatin1Char(';');
 }
 
-QHash<QString, QString> parseAttributes(const QStringView attrs) {
-    QHash<QString, QString> out;
-    int i = 0;
-    const int n = attrs.size();
+// The attributes any allowed tag keeps. Views into the source HTML; later duplicates win.
+struct TagAttrs {
+    QStringView href;
+    QStringView title;
+    QStringView style;
+    QStringView src;
+    QStringView alt;
+    QStringView width;
+    QStringView height;
+
+    QStringView* slot(const QStringView key) {
+        if (key.compare(QLatin1String("href"), Qt::CaseInsensitive) == 0) return &href;
+        if (key.compare(QLatin1String("title"), Qt::CaseInsensitive) == 0) return &title;
+        if (key.compare(QLatin1String("style"), Qt::CaseInsensitive) == 0) return &style;
+        if (key.compare(QLatin1String("src"), Qt::CaseInsensitive) == 0) return &src;
+        if (key.compare(QLatin1String("alt"), Qt::CaseInsensitive) == 0) return &alt;
+        if (key.compare(QLatin1String("width"), Qt::CaseInsensitive) == 0) return &width;
+        if (key.compare(QLatin1String("height"), Qt::CaseInsensitive) == 0) return &height;
+        return nullptr;
+    }
+};
+
+TagAttrs parseAttributes(const QStringView attrs) {
+    TagAttrs out;
+    qsizetype i = 0;
+    const qsizetype n = attrs.size();
     while (i < n) {
         while (i < n && attrs[i].isSpace()) i++;
         if (i >= n) break;
 
-        int keyStart = i;
+        const qsizetype keyStart = i;
         while (i < n && !attrs[i].isSpace() && attrs[i] != QLatin1Char('=') && attrs[i] != QLatin1Char('>')) i++;
-        const auto keyView = attrs.mid(keyStart, i - keyStart).trimmed();
-        if (keyView.isEmpty()) break;
-        const auto key = lower(keyView);
+        const auto key = attrs.mid(keyStart, i - keyStart).trimmed();
+        if (key.isEmpty()) break;
 
         while (i < n && attrs[i].isSpace()) i++;
         if (i >= n || attrs[i] != QLatin1Char('=')) {
@@ -122,142 +160,240 @@ QHash<QString, QString> parseAttributes(const QStringView attrs) {
         while (i < n && attrs[i].isSpace()) i++;
         if (i >= n) break;
 
-        QString value;
+        QStringView value;
         const QChar quote = attrs[i];
         if (quote == QLatin1Char('"') || quote == QLatin1Char('\'')) {
             i++;
-            const int valStart = i;
+            const qsizetype valStart = i;
             while (i < n && attrs[i] != quote) i++;
-            value = attrs.mid(valStart, i - valStart).toString();
+            value = attrs.mid(valStart, i - valStart);
             if (i < n && attrs[i] == quote) i++;
         } else {
-            const int valStart = i;
+            const qsizetype valStart = i;
             while (i < n && !attrs[i].isSpace() && attrs[i] != QLatin1Char('>')) i++;
-            value = attrs.mid(valStart, i - valStart).toString();
+            value = attrs.mid(valStart, i - valStart);
         }
 
-        out.insert(key, value);
+        if (auto* slot = out.slot(key)) *slot = value;
     }
     return out;
 }
 
-QString buildAllowedTag(const QStringView tagName, const QHash<QString, QString>& attrs, bool closing, bool selfClosing) {
-    const auto nameLower = lower(tagName);
-    if (!isAllowedTagName(nameLower)) return QString();
+// Writes the allowlisted form of an opening tag, or nothing if the tag is dropped.
+void appendOpeningTag(QString& out, const QLatin1String name, const TagAttrs& attrs, bool selfClosing) {
+    if (name == QLatin1String("img") && (attrs.src.isEmpty() || !isSafeImgSrc(attrs.src))) {
+        return; // drop unsafe images entirely
+    }
 
-    if (closing) {
-        return QStringLiteral("</") + nameLower + QLatin1Char('>');
+    out += QLatin1Char('<');
+    out += name;
+    if (name == QLatin1String("a")) {
+        if (!attrs.href.isEmpty() && isSafeHref(attrs.href)) appendAttr(out, QLatin1String("href"), attrs.href);
+        if (!attrs.title.isEmpty()) appendAttr(out, QLatin1String("title"), attrs.title);
+        appendStyleAttr(out, attrs.style);
+    } else if (name == QLatin1String("img")) {
+        appendAttr(out, QLatin1String("src"), attrs.src);
+        if (!attrs.alt.isEmpty()) appendAttr(out, QLatin1String("alt"), attrs.alt);
+        if (!attrs.title.isEmpty()) appendAttr(out, QLatin1String("title"), attrs.title);
+        if (!attrs.width.isEmpty()) appendAttr(out, QLatin1String("width"), attrs.width);
+        if (!attrs.height.isEmpty()) appendAttr(out, QLatin1String("height"), attrs.height);
+    } else if (name == QLatin1String("span")) {
+        appendStyleAttr(out, attrs.style);
     }
+    out += selfClosing ? QLatin1String("/>") : QLatin1String(">");
+}
 
-    QString out = QStringLiteral("<") + nameLower;
+// ASCII classes, matching QRegularExpression's default \d and \b.
+bool isAsciiDigit(const QChar ch) {
+    return ch >= QLatin1Char('0') && ch <= QLatin1Char('9');
+}
 
-    auto addAttr = [&out](const QString& k, const QString& v) {
-        out += QLatin1Char(' ');
-        out += k;
-        out += QStringLiteral("=\"");
-        out += v.toHtmlEscaped();
-        out += QLatin1Char('"');
-    };
+bool isAsciiWord(const QChar ch) {
+    return isAsciiDigit(ch) || (ch >= QLatin1Char('a') && ch <= QLatin1Char('z')) ||
+           (ch >= QLatin1Char('A') && ch <= QLatin1Char('Z')) || ch == QLatin1Char('_');
+}
 
-    if (nameLower == QStringLiteral("a")) {
-        const auto href = attrs.value(QStringLiteral("href"));
-        if (!href.isEmpty() && isSafeHref(QStringView(href))) addAttr(QStringLiteral("href"), href);
-        const auto title = attrs.value(QStringLiteral("title"));
-        if (!title.isEmpty()) addAttr(QStringLiteral("title"), title);
-        const auto style = sanitizeStyle(QStringView(attrs.value(QStringLiteral("style"))));
-        if (!style.isEmpty()) addAttr(QStringLiteral("style"), style);
-    } else if (nameLower == QStringLiteral("img")) {
-        const auto src = attrs.value(QStringLiteral("src"));
-        if (src.isEmpty() || !isSafeImgSrc(QStringView(src))) {
-            return QString(); // drop unsafe images entirely
+bool digitsAt(const QStringView s, qsizetype at, qsizetype count) {
+    if (at + count > s.size()) return false;
+    for (qsizetype k = at; k < at + count; ++k) {
+        if (!isAsciiDigit(s[k])) return false;
+    }
+    return true;
+}
+
+// Length of an ISO date or date-time (`YYYY-MM-DD`, optionally followed by ` HH:MM[:SS]` or
+// `THH:MM[:SS]`) starting at `at` and ending on a word boundary, or 0.
+qsizetype isoDateLengthAt(const QStringView s, qsizetype at) {
+    if (!(digitsAt(s, at, 4) && at + 10 <= s.size() && s[at + 4] == QLatin1Char('-') && digitsAt(s, at + 5, 2) &&
+          s[at + 7] == QLatin1Char('-') && digitsAt(s, at + 8, 2))) {
+        return 0;
+    }
+    const auto boundaryAt = [&](qsizetype end) { return end == s.size() || !isAsciiWord(s[end]); };
+
+    const qsizetype date = at + 10;
+    if (date + 6 <= s.size() && (s[date] == QLatin1Char(' ') || s[date] == QLatin1Char('T')) &&
+        digitsAt(s, date + 1, 2) && s[date + 3] == QLatin1Char(':') && digitsAt(s, date + 4, 2)) {
+        const qsizetype minutes = date + 6;
+        if (minutes + 3 <= s.size() && s[minutes] == QLatin1Char(':') && digitsAt(s, minutes + 1, 2) &&
+            boundaryAt(minutes + 3)) {
+            return minutes + 3 - at;
         }
-        addAttr(QStringLiteral("src"), src);
-        const auto alt = attrs.value(QStringLiteral("alt"));
-        if (!alt.isEmpty()) addAttr(QStringLiteral("alt"), alt);
-        const auto title = attrs.value(QStringLiteral("title"));
-        if (!title.isEmpty()) addAttr(QStringLiteral("title"), title);
-        const auto width = attrs.value(QStringLiteral("width"));
-        if (!width.isEmpty()) addAttr(QStringLiteral("width"), width);
-        const auto height = attrs.value(QStringLiteral("height"));
-        if (!height.isEmpty()) addAttr(QStringLiteral("height"), height);
-    } else if (nameLower == QStringLiteral("span")) {
-        const auto style = sanitizeStyle(QStringView(attrs.value(QStringLiteral("style"))));
-        if (!style.isEmpty()) addAttr(QStringLiteral("style"), style);
+        if (boundaryAt(minutes)) return minutes - at;
     }
+    return boundaryAt(date) ? date - at : 0;
+}
 
-    out += selfClosing ? QStringLiteral("/>") : QStringLiteral(">");
-    return out;
+// Copies text between tags, turning ISO dates into muted zinc://date links.
+void appendTextWithDates(QString& out, const QStringView text) {
+    qsizetype last = 0;
+    qsizetype i = 0;
+    while (i + 10 <= text.size()) {
+        if (!isAsciiDigit(text[i]) || (i > 0 && isAsciiWord(text[i - 1]))) {
+            ++i;
+            continue;
+        }
+        const qsizetype length = isoDateLengthAt(text, i);
+        if (length == 0) {
+            ++i;
+            continue;
+        }
+        out += text.mid(last, i - last);
+        const auto date = text.mid(i, 10);
+        const auto time = length > 10 ? text.mid(i + 11, length - 11) : QStringView();
+        out += QLatin1String("<a href=\"zinc://date/");
+        out += date;
+        if (!time.isEmpty()) {
+            out += QLatin1Char('T');
+            out += time;
+        }
+        out += QLatin1String("\" style=\"color:#888888;text-decoration:none;\">");
+        out += date;
+        if (!time.isEmpty()) {
+            out += QLatin1Char(' ');
+            out += time;
+        }
+        out += QLatin1String("</a>");
+        i += length;
+        last = i;
+    }
+    out += text.mid(last);
 }
 
-QString sanitizeHtmlForNotes(const QString& html) {
-    QString out;
-    out.reserve(html.size());
+// One pass over libcmark's output: text is copied with date links added, tags are rebuilt from
+// the allowlist, and <script>/<style> elements are dropped with their contents.
+void appendSanitizedHtml(QString& out, const QStringView src) {
+    out.reserve(out.size() + src.size() + src.size() / 8);
 
-    int i = 0;
-    while (i < html.size()) {
-        const int tagStart = html.indexOf(QLatin1Char('<'), i);
+    qsizetype i = 0;
+    while (i < src.size()) {
+        const qsizetype tagStart = src.indexOf(QLatin1Char('<'), i);
         if (tagStart < 0) {
-            out += html.mid(i);
+            appendTextWithDates(out, src.mid(i));
             break;
         }
+        appendTextWithDates(out, src.mid(i, tagStart - i));
 
-        out += html.mid(i, tagStart - i);
-
-        const int tagEnd = html.indexOf(QLatin1Char('>'), tagStart);
+        const qsizetype tagEnd = src.indexOf(QLatin1Char('>'), tagStart);
         if (tagEnd < 0) {
-            out += html.mid(tagStart);
+            out += src.mid(tagStart);
             break;
         }
+        i = tagEnd + 1;
 
-        const auto tagInner = QStringView(html).mid(tagStart + 1, tagEnd - tagStart - 1).trimmed();
+        const auto tagInner = src.mid(tagStart + 1, tagEnd - tagStart - 1).trimmed();
         if (tagInner.startsWith(QLatin1Char('!')) || tagInner.startsWith(QLatin1Char('?'))) {
-            i = tagEnd + 1;
             continue;
         }
 
         bool closing = false;
-        int p = 0;
+        qsizetype p = 0;
         if (p < tagInner.size() && tagInner[p] == QLatin1Char('/')) {
             closing = true;
             p++;
         }
         while (p < tagInner.size() && tagInner[p].isSpace()) p++;
-        const int nameStart = p;
+        const qsizetype nameStart = p;
         while (p < tagInner.size() && (tagInner[p].isLetterOrNumber() || tagInner[p] == QLatin1Char('-'))) p++;
-        const auto nameView = tagInner.mid(nameStart, p - nameStart);
-        const auto nameLower = lower(nameView);
+        const auto name = tagInner.mid(nameStart, p - nameStart);
 
         // Strip <script>/<style> blocks entirely (including contents).
-        if (!closing && isStripElement(nameLower)) {
-            const QString closeNeedle = QStringLiteral("</") + nameLower + QLatin1Char('>');
-            const int closePos = html.indexOf(closeNeedle, tagEnd + 1, Qt::CaseInsensitive);
-            if (closePos < 0) {
-                i = tagEnd + 1;
-                continue;
+        if (const auto strip = lookup(kStripElements, name); !closing && !strip.isEmpty()) {
+            for (qsizetype at = src.indexOf(QLatin1String("</"), i); at >= 0; at = src.indexOf(QLatin1String("</"), at + 1)) {
+                const qsizetype gt = at + 2 + strip.size();
+                if (gt < src.size() && src[gt] == QLatin1Char('>') &&
+                    src.mid(at + 2, strip.size()).compare(strip, Qt::CaseInsensitive) == 0) {
+                    i = gt + 1;
+                    break;
+                }
             }
-            i = closePos + closeNeedle.size();
             continue;
         }
 
-        const bool selfClosing = (!closing && tagInner.endsWith(QLatin1Char('/')));
-        const auto attrsView = (!closing && p < tagInner.size()) ? tagInner.mid(p) : QStringView();
+        const auto allowed = lookup(kAllowedTags, name);
+        if (allowed.isEmpty()) continue;
 
-        const auto attrs = closing ? QHash<QString, QString>() : parseAttributes(attrsView);
-        const auto rebuilt = buildAllowedTag(nameLower, attrs, closing, selfClosing);
-        if (!rebuilt.isEmpty()) {
-            out += rebuilt;
+        if (closing) {
+            out += QLatin1String("</");
+            out += allowed;
+            out += QLatin1Char('>');
+            continue;
         }
+        const bool selfClosing = tagInner.endsWith(QLatin1Char('/'));
+        appendOpeningTag(out, allowed, parseAttributes(tagInner.mid(p)), selfClosing);
+    }
+}
 
-        i = tagEnd + 1;
+constexpr int kCmarkOptions = CMARK_OPT_DEFAULT | CMARK_OPT_HARDBREAKS | CMARK_OPT_UNSAFE;
+
+// One cmark parser plus scratch buffers, reused across documents rendered on the same thread.
+// cmark_parser_finish() resets the parser, so it is ready for the next document.
+class Renderer {
+public:
+    Renderer()
+        : parser_(cmark_parser_new(kCmarkOptions)) {}
+    ~Renderer() { cmark_parser_free(parser_); }
+    Renderer(const Renderer&) = delete;
+    Renderer& operator=(const Renderer&) = delete;
+
+    // Valid until the next call.
+    QStringView render(const QString& markdown) {
+        html_.resize(0);
+        if (markdown.isEmpty() || !parser_) {
+            return {};
+        }
+
+        utf8_ = markdown.toUtf8();
+        cmark_parser_feed(parser_, utf8_.constData(), static_cast<size_t>(utf8_.size()));
+        cmark_node* document = cmark_parser_finish(parser_);
+        if (!document) {
+            return {};
+        }
+        char* raw = cmark_render_html(document, kCmarkOptions);
+        cmark_node_free(document);
+        if (!raw) {
+            return {};
+        }
+
+        raw_ = QString::fromUtf8(raw);
+        free(raw);
+        appendSanitizedHtml(html_, raw_);
+        return html_;
     }
 
-    return out;
-}
+    QString take() { return std::exchange(html_, QString()); }
+
+private:
+    cmark_parser* parser_;
+    QByteArray utf8_;
+    QString raw_;
+    QString html_;
+};
 
 } // namespace
 
 Cmark::Cmark(QObject* parent)
-    : QObject(parent) {
+    : QObject(parent)
+    , cache_(kDefaultCacheBytes) {
 }
 
 QString Cmark::toHtml(const QString& markdown) const {
@@ -265,62 +401,89 @@ QString Cmark::toHtml(const QString& markdown) const {
         return QString();
     }
 
-    const auto utf8 = markdown.toUtf8();
-    char* html = cmark_markdown_to_html(utf8.constData(),
-                                        static_cast<size_t>(utf8.size()),
-                                        CMARK_OPT_DEFAULT | CMARK_OPT_HARDBREAKS | CMARK_OPT_UNSAFE);
-    if (!html) {
-        return QString();
+    const size_t key = qHash(markdown);
+    {
+        QMutexLocker lock(&cache_mutex_);
+        if (const auto* cached = cache_.object(key); cached && cached->markdown == markdown) {
+            ++hits_;
+            return cached->html;
+        }
+        ++misses_;
     }
 
-    QString out = QString::fromUtf8(html);
-    free(html);
-
-    static const QRegularExpression isoDateOrDateTime(
-        QStringLiteral(R"(\b(\d{4}-\d{2}-\d{2})(?:[ T](\d{2}:\d{2}(?::\d{2})?))?\b)"));
-
-    const auto transformText = [](const QString& text) -> QString {
-        QString outText;
-        outText.reserve(text.size());
-        int last = 0;
-
-        auto it = isoDateOrDateTime.globalMatch(text);
-        while (it.hasNext()) {
-            const auto m = it.next();
-            outText += text.mid(last, m.capturedStart(0) - last);
-            const auto date = m.captured(1);
-            const auto time = m.captured(2);
-            const auto value = time.isEmpty() ? date : (date % QLatin1Char('T') % time);
-            const auto label = time.isEmpty() ? date : (date % QLatin1Char(' ') % time);
-            outText += QStringLiteral("<a href=\"zinc://date/%1\" style=\"color:#888888; text-decoration:none;\">%2</a>")
-                           .arg(value.toHtmlEscaped(), label.toHtmlEscaped());
-            last = m.capturedEnd(0);
+    QString html = render(markdown);
+    const qsizetype cost = (markdown.size() + html.size()) * qsizetype{sizeof(QChar)};
+    QMutexLocker lock(&cache_mutex_);
+    cache_.insert(key, new CachedHtml{markdown, html}, cost);
+    return html;
+}
+
+quint64 Cmark::cacheHits() const {
+    QMutexLocker lock(&cache_mutex_);
+    return hits_;
+}
+
+quint64 Cmark::cacheMisses() const {
+    QMutexLocker lock(&cache_mutex_);
+    return misses_;
+}
+
+qsizetype Cmark::cacheBytes() const {
+    QMutexLocker lock(&cache_mutex_);
+    return cache_.totalCost();
+}
+
+void Cmark::setCacheCapacity(qsizetype bytes) {
+    QMutexLocker lock(&cache_mutex_);
+    cache_.setMaxCost(bytes);
+}
+
+void Cmark::clearCache() {
+    QMutexLocker lock(&cache_mutex_);
+    cache_.clear();
+    hits_ = 0;
+    misses_ = 0;
+}
+
+QString Cmark::render(const QString& markdown) {
+    Renderer renderer;
+    renderer.render(markdown);
+    return renderer.take();
+}
+
+void Cmark::renderBatch(const QStringList& documents, const BatchSink& sink, int threads, QThreadPool* pool) {
+    if (documents.isEmpty() || !sink) {
+        return;
+    }
+    if (!pool) {
+        pool = QThreadPool::globalInstance();
+    }
+    const int wanted = threads > 0 ? threads : std::max(1, pool->maxThreadCount());
+    const int workers = static_cast<int>(std::min<qsizetype>(wanted, documents.size()));
+
+    std::atomic<qsizetype> next{0};
+    const auto work = [&] {
+        Renderer renderer;
+        for (qsizetype i = next.fetch_add(1, std::memory_order_relaxed); i < documents.size();
+             i = next.fetch_add(1, std::memory_order_relaxed)) {
+            sink(i, renderer.render(documents.at(i)));
         }
-        outText += text.mid(last);
-        return outText;
     };
 
-    QString rebuilt;
-    rebuilt.reserve(out.size());
-    int i = 0;
-    while (i < out.size()) {
-        const int tagStart = out.indexOf(QLatin1Char('<'), i);
-        if (tagStart < 0) {
-            rebuilt += transformText(out.mid(i));
+    // The calling thread works too, so a busy pool (or a caller that is itself a pool thread)
+    // only means fewer helpers, never a stall.
+    QSemaphore finished;
+    int helpers = 0;
+    for (; helpers + 1 < workers; ++helpers) {
+        if (!pool->tryStart([&] {
+                work();
+                finished.release();
+            })) {
             break;
         }
-        rebuilt += transformText(out.mid(i, tagStart - i));
-        const int tagEnd = out.indexOf(QLatin1Char('>'), tagStart);
-        if (tagEnd < 0) {
-            rebuilt += out.mid(tagStart);
-            break;
-        }
-        rebuilt += out.mid(tagStart, tagEnd - tagStart + 1);
-        i = tagEnd + 1;
     }
-    out = std::move(rebuilt);
-
-    return sanitizeHtmlForNotes(out);
+    work();
+    finished.acquire(helpers);
 }
 
 } // namespace zinc::ui
@@ -1,18 +1,38 @@
 #pragma once
 
+#include <QCache>
 #include <QJSEngine>
+#include <QMutex>
 #include <QObject>
 #include <QQmlEngine>
 #include <QString>
+#include <QStringList>
+#include <QStringView>
+
+#include <functional>
+
+class QThreadPool;
 
 namespace zinc::ui {
 
+/**
+ * Cmark - markdown → sanitized HTML for block rendering.
+ *
+ * Results are kept in an LRU cache keyed by a hash of the markdown, so delegates that are
+ * recreated while scrolling, or re-evaluate their bindings, do not re-render unchanged blocks.
+ * The cache is bounded by the UTF-16 bytes of the markdown and HTML it holds.
+ *
+ * renderBatch() is the bulk path for exports: it bypasses the cache and renders many documents
+ * across a thread pool.
+ */
 class Cmark : public QObject {
     Q_OBJECT
     QML_ELEMENT
     QML_SINGLETON
 
 public:
+    static constexpr qsizetype kDefaultCacheBytes = qsizetype{16} << 20;
+
     explicit Cmark(QObject* parent = nullptr);
 
     static Cmark* create(QQmlEngine* engine, QJSEngine*) {
@@ -24,6 +44,39 @@ public:
     }
 
     Q_INVOKABLE QString toHtml(const QString& markdown) const;
+
+    [[nodiscard]] quint64 cacheHits() const;
+    [[nodiscard]] quint64 cacheMisses() const;
+    [[nodiscard]] qsizetype cacheBytes() const;
+    // 0 disables caching.
+    void setCacheCapacity(qsizetype bytes);
+    Q_INVOKABLE void clearCache();
+
+    // Renders one document without touching any cache.
+    static QString render(const QString& markdown);
+
+    // Receives a rendered document by its index in the batch. `html` is only valid during the
+    // call. Calls come from the rendering threads, possibly concurrently, in completion order.
+    using BatchSink = std::function<void(qsizetype index, QStringView html)>;
+
+    // Renders `documents` on up to `threads` threads (0: the pool's maxThreadCount), the calling
+    // thread included, taking the rest from `pool` (the global pool if null). Each thread reuses
+    // one cmark parser and output buffer. Returns once every document has reached `sink`.
+    static void renderBatch(const QStringList& documents,
+                            const BatchSink& sink,
+                            int threads = 0,
+                            QThreadPool* pool = nullptr);
+
+private:
+    struct CachedHtml {
+        QString markdown;
+        QString html;
+    };
+
+    mutable QMutex cache_mutex_;
+    mutable QCache<size_t, CachedHtml> cache_;
+    mutable quint64 hits_ = 0;
+    mutable quint64 misses_ = 0;
 };
 
 } // namespace zinc::ui
@@ -3,6 +3,7 @@
 #include <QDateTime>
 #include <QTimeZone>
 #include <QCoreApplication>
+#include <QCryptographicHash>
 #include <QPointer>
 #include <QSqlQuery>
 #include <QSqlError>
@@ -17,16 +18,32 @@
 #include <QSettings>
 #include <QSet>
 #include <QDebug>
+#include <QFutureWatcher>
 #include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QPromise>
 #include <QRegularExpression>
 #include <QStringConverter>
 #include <QTextStream>
+#include <QSemaphore>
+#include <QThreadPool>
 #include <QUuid>
 #include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <memory>
 #include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 #include "core/three_way_merge.hpp"
+#include "core/types.hpp"
+#include "ui/AttachmentThumbnailCache.hpp"
 #include "ui/Cmark.hpp"
+#include "ui/ExportArchive.hpp"
 
 namespace zinc::ui {
 
@@ -93,6 +110,7 @@ QString normalize_export_format(const QString& format) {
     const auto f = format.trimmed().toLower();
     if (f == QStringLiteral("markdown") || f == QStringLiteral("md")) return QStringLiteral("markdown");
     if (f == QStringLiteral("html") || f == QStringLiteral("htm")) return QStringLiteral("html");
+    if (f == QStringLiteral("archive") || f == QStringLiteral("zincpack")) return QStringLiteral("archive");
     return {};
 }
 
@@ -265,10 +283,10 @@ bool write_text_file(const QString& filePath, const QString& text, QString* outE
 
 QString html_document_for_page(const QString& title,
                                const QString& markdown,
+                               QStringView renderedHtml,
                                const QString& pageId,
                                const QString& notebookId,
                                const QHash<QString, QString>& pageIdToFileName) {
-    const Cmark cmark;
     const auto render_task_list_checkboxes = [](const QString& html) -> QString {
         if (html.isEmpty()) return html;
 
@@ -323,8 +341,7 @@ QString html_document_for_page(const QString& title,
         return out;
     };
 
-    auto body = cmark.toHtml(markdown);
-    body = render_task_list_checkboxes(body);
+    auto body = render_task_list_checkboxes(renderedHtml.toString());
     body = rewrite_page_links(body);
     const auto embeddedMarkdown = markdown.toHtmlEscaped();
     return QStringLiteral(
@@ -414,25 +431,6 @@ QString rewrite_attachment_urls_in_markdown(const QString& markdown, const QHash
     return out;
 }
 
-QString rewrite_exported_attachment_paths_to_zinc_urls(const QString& text) {
-    if (text.isEmpty()) return text;
-    static const QRegularExpression re(QStringLiteral(R"((?:\./)?attachments/([0-9a-fA-F-]{36})\.[A-Za-z0-9]+)"));
-
-    QString out;
-    out.reserve(text.size());
-
-    int last = 0;
-    auto it = re.globalMatch(text);
-    while (it.hasNext()) {
-        const auto m = it.next();
-        out += text.mid(last, m.capturedStart(0) - last);
-        out += QStringLiteral("image://attachments/") + m.captured(1);
-        last = m.capturedEnd(0);
-    }
-    out += text.mid(last);
-    return out;
-}
-
 std::optional<QString> extract_embedded_markdown_from_zinc_html(const QString& html) {
     if (html.isEmpty()) return std::nullopt;
     static const QRegularExpression re(
@@ -605,48 +603,89 @@ QString mime_from_extension(const QString& ext) {
     return QStringLiteral("application/octet-stream");
 }
 
-QString rewrite_zinc_attachment_ids(const QString& markdown, const QHash<QString, QString>& oldToNew) {
-    if (markdown.isEmpty()) return markdown;
-    if (oldToNew.isEmpty()) return markdown;
-    static const QRegularExpression re(QStringLiteral(R"(image://attachments/([0-9a-fA-F-]{36}))"));
+bool is_zinc_id_char(QChar c) {
+    const auto u = c.unicode();
+    return (u >= '0' && u <= '9') || (u >= 'a' && u <= 'f') || (u >= 'A' && u <= 'F') || u == '-';
+}
 
-    QString out;
-    out.reserve(markdown.size());
-    int last = 0;
-    auto it = re.globalMatch(markdown);
-    while (it.hasNext()) {
-        const auto m = it.next();
-        out += markdown.mid(last, m.capturedStart(0) - last);
-        const auto oldId = m.captured(1);
-        const auto mapped = oldToNew.value(oldId);
-        out += mapped.isEmpty() ? m.captured(0) : (QStringLiteral("image://attachments/") + mapped);
-        last = m.capturedEnd(0);
-    }
-    out += markdown.mid(last);
-    return out;
+bool is_ascii_alnum(QChar c) {
+    const auto u = c.unicode();
+    return (u >= '0' && u <= '9') || (u >= 'a' && u <= 'z') || (u >= 'A' && u <= 'Z');
 }
 
-QString rewrite_zinc_page_links(const QString& markdown, const QHash<QString, QString>& oldToNew) {
-    if (markdown.isEmpty()) return markdown;
-    if (oldToNew.isEmpty()) return markdown;
-    static const QRegularExpression re(QStringLiteral(R"(zinc://page/([0-9a-fA-F-]{36}))"));
+// Rewrites the links of an imported page in one scan:
+// - exported attachment paths, `[./]attachments/<id>.<ext>`, become `image://attachments/<id>`
+// - ids in `image://attachments/<id>` and in exported paths go through `attachmentIds`
+// - ids in `zinc://page/<id>` go through `pageIds`
+// Ids without an entry are kept. Each pattern has a '/' right before its 36-character id, so
+// the scan only stops at slashes.
+QString rewrite_imported_links(const QString& markdown,
+                               const QHash<QString, QString>& attachmentIds,
+                               const QHash<QString, QString>& pageIds) {
+    constexpr qsizetype kIdLength = 36;
+    constexpr QStringView kAttachments(u"attachments");
+    const QStringView src(markdown);
+    const auto size = src.size();
+    const auto idAt = [&](qsizetype pos) {
+        if (pos + kIdLength > size) return false;
+        for (qsizetype i = pos; i < pos + kIdLength; ++i) {
+            if (!is_zinc_id_char(src[i])) return false;
+        }
+        return true;
+    };
 
     QString out;
-    out.reserve(markdown.size());
-    int last = 0;
-    auto it = re.globalMatch(markdown);
-    while (it.hasNext()) {
-        const auto m = it.next();
-        out += markdown.mid(last, m.capturedStart(0) - last);
-        const auto oldId = m.captured(1);
-        const auto mapped = oldToNew.value(oldId);
-        out += mapped.isEmpty() ? m.captured(0) : (QStringLiteral("zinc://page/") + mapped);
-        last = m.capturedEnd(0);
-    }
-    out += markdown.mid(last);
+    qsizetype copied = 0;
+    for (auto slash = src.indexOf(u'/'); slash >= 0; slash = src.indexOf(u'/', slash + 1)) {
+        const auto idStart = slash + 1;
+        if (!idAt(idStart)) continue;
+        const auto before = src.first(slash);
+        const auto id = src.sliced(idStart, kIdLength).toString();
+
+        qsizetype from = idStart;
+        qsizetype to = idStart + kIdLength;
+        QString replacement;
+        if (before.endsWith(u"zinc://page")) {
+            replacement = pageIds.value(id);
+        } else if (before.endsWith(u"image://attachments")) {
+            replacement = attachmentIds.value(id);
+        } else if (before.endsWith(kAttachments)) {
+            if (to >= size || src[to] != u'.') continue;
+            auto extEnd = to + 1;
+            while (extEnd < size && is_ascii_alnum(src[extEnd])) ++extEnd;
+            if (extEnd == to + 1) continue;
+            from = slash - kAttachments.size();
+            if (src.first(from).endsWith(u"./")) from -= 2;
+            to = extEnd;
+            replacement = QStringLiteral("image://attachments/") + attachmentIds.value(id, id);
+        }
+        if (replacement.isEmpty()) continue;
+
+        if (out.isEmpty()) out.reserve(size + 64);
+        out.append(src.sliced(copied, from - copied));
+        out.append(replacement);
+        copied = to;
+        slash = to - 1;
+    }
+    if (copied == 0) return markdown;
+    out.append(src.sliced(copied));
     return out;
 }
 
+// Inserts or replaces a page; shared by savePage() and the import writer.
+constexpr auto kUpsertPageSql = R"SQL(
+    INSERT INTO pages (id, notebook_id, title, parent_id, content_markdown, depth, sort_order, updated_at)
+    VALUES (?, ?, ?, ?, ?, ?, ?, ?)
+    ON CONFLICT(id) DO UPDATE SET
+        notebook_id = excluded.notebook_id,
+        title = excluded.title,
+        parent_id = excluded.parent_id,
+        content_markdown = excluded.content_markdown,
+        depth = excluded.depth,
+        sort_order = excluded.sort_order,
+        updated_at = excluded.updated_at;
+)SQL";
+
 int deleted_pages_retention_limit() {
     QSettings settings;
     return normalize_retention_limit(
@@ -820,7 +859,7 @@ void upsert_deleted_page(QSqlDatabase& db,
         ON CONFLICT(page_id) DO UPDATE SET
             deleted_at = excluded.deleted_at;
     )SQL");
-    upsert.addBindValue(pageId);
+    upsert.addBindValue(sql_id(pageId));
     upsert.addBindValue(deletedAt);
     upsert.exec();
 }
@@ -934,6 +973,41 @@ QString normalize_parent_id(const QVariant& value) {
     return str.isNull() ? QString() : str;
 }
 
+// Page, block and attachment ids are stored as 16-byte BLOBs when they are canonical
+// lowercase UUIDs (what QUuid and zinc::Uuid emit). Any other spelling ("p1", seeded
+// "1".."4", upper case) stays TEXT so ids remain opaque strings to QML and sync.
+// Byte order of the BLOB matches the hex text order, so (updated_at, id) cursors hold.
+QVariant sql_id(const QString& id) {
+    if (id.size() != static_cast<qsizetype>(zinc::Uuid::STRING_SIZE)) {
+        return id;
+    }
+    zinc::Uuid::Chars text{};
+    for (qsizetype i = 0; i < id.size(); ++i) {
+        const auto ch = id.at(i).unicode();
+        if (ch >= 0x80) return id;
+        text[static_cast<size_t>(i)] = static_cast<char>(ch);
+    }
+    const auto uuid = zinc::Uuid::parse(std::string_view(text.data(), text.size()));
+    if (!uuid || uuid->to_chars() != text) {
+        return id;
+    }
+    const auto& bytes = uuid->bytes();
+    return QByteArray(reinterpret_cast<const char*>(bytes.data()), static_cast<qsizetype>(bytes.size()));
+}
+
+QString id_from_sql(const QVariant& value) {
+    if (value.typeId() == QMetaType::QByteArray) {
+        const auto raw = value.toByteArray();
+        if (raw.size() == static_cast<qsizetype>(zinc::Uuid::BYTE_SIZE)) {
+            zinc::Uuid::Bytes bytes{};
+            std::memcpy(bytes.data(), raw.constData(), bytes.size());
+            const auto text = zinc::Uuid(bytes).to_chars();
+            return QString::fromLatin1(text.data(), static_cast<qsizetype>(text.size()));
+        }
+    }
+    return value.toString();
+}
+
 QString normalize_title(const QVariant& value) {
     const auto raw = value.toString().trimmed();
     if (raw.isEmpty()) {
@@ -1018,6 +1092,174 @@ QString merge_conflict_title(const QString& baseTitle,
     return QStringLiteral("%1 | %2").arg(local, remote);
 }
 
+// Merge of a stored conflict, precomputed so the conflict dialog never reruns the diff.
+struct ConflictMerge {
+    QString kind;
+    QString markdown;
+    QString hunksJson;
+};
+
+ConflictMerge compute_conflict_merge(const QString& baseMd, const QString& localMd, const QString& remoteMd) {
+    const auto base = baseMd.toUtf8();
+    const auto ours = localMd.toUtf8();
+    const auto theirs = remoteMd.toUtf8();
+
+    const auto result = zinc::three_way_merge_text(
+        std::string_view(base.constData(), static_cast<size_t>(base.size())),
+        std::string_view(ours.constData(), static_cast<size_t>(ours.size())),
+        std::string_view(theirs.constData(), static_cast<size_t>(theirs.size())));
+
+    QJsonArray hunks;
+    for (const auto& hunk : result.conflicts) {
+        hunks.append(QJsonObject{
+            {QStringLiteral("line"), static_cast<qint64>(hunk.line)},
+            {QStringLiteral("ours"), QString::fromStdString(hunk.ours)},
+            {QStringLiteral("theirs"), QString::fromStdString(hunk.theirs)},
+        });
+    }
+
+    ConflictMerge out;
+    out.kind = (result.kind == zinc::ThreeWayMergeResult::Kind::Clean)
+        ? QStringLiteral("clean")
+        : (result.kind == zinc::ThreeWayMergeResult::Kind::Conflict)
+            ? QStringLiteral("conflict")
+            : QStringLiteral("fallback");
+    out.markdown = QString::fromStdString(result.merged);
+    out.hunksJson = QString::fromUtf8(QJsonDocument(hunks).toJson(QJsonDocument::Compact));
+    return out;
+}
+
+QVariantMap conflict_merge_preview(const ConflictMerge& merge,
+                                   const QString& baseTitle,
+                                   const QString& localTitle,
+                                   const QString& remoteTitle) {
+    QVariantMap out;
+    out["mergedMarkdown"] = merge.markdown;
+    out["clean"] = merge.kind == QStringLiteral("clean");
+    out["kind"] = merge.kind;
+    out["hunks"] = QJsonDocument::fromJson(merge.hunksJson.toUtf8()).array().toVariantList();
+    out["mergedTitle"] = merge_conflict_title(baseTitle, localTitle, remoteTitle);
+    return out;
+}
+
+// Tables keyed by page, block or attachment id (see sql_id()). createTables() creates them
+// under their own names; migration 13 creates them under a staging name and copies rows in.
+// Narrow tables are WITHOUT ROWID so the 16-byte key is the clustered key.
+const QStringList& id_keyed_tables() {
+    static const QStringList tables{
+        QStringLiteral("pages"),
+        QStringLiteral("deleted_pages"),
+        QStringLiteral("page_conflicts"),
+        QStringLiteral("blocks"),
+        QStringLiteral("attachments"),
+    };
+    return tables;
+}
+
+QString id_keyed_table_sql(const QString& table, const QString& name) {
+    if (table == QStringLiteral("pages")) {
+        return QStringLiteral(R"SQL(
+            CREATE TABLE IF NOT EXISTS %1 (
+                id BLOB PRIMARY KEY,
+                notebook_id TEXT NOT NULL DEFAULT '',
+                title TEXT NOT NULL DEFAULT 'Untitled',
+                parent_id BLOB,
+                content_markdown TEXT NOT NULL DEFAULT '',
+                depth INTEGER DEFAULT 0,
+                sort_order INTEGER DEFAULT 0,
+                last_synced_at TEXT DEFAULT '',
+                last_synced_title TEXT DEFAULT '',
+                last_synced_content_markdown TEXT NOT NULL DEFAULT '',
+                created_at TEXT DEFAULT CURRENT_TIMESTAMP,
+                updated_at TEXT DEFAULT CURRENT_TIMESTAMP
+            )
+        )SQL").arg(name);
+    }
+    if (table == QStringLiteral("deleted_pages")) {
+        return QStringLiteral(R"SQL(
+            CREATE TABLE IF NOT EXISTS %1 (
+                page_id BLOB PRIMARY KEY,
+                deleted_at TEXT NOT NULL
+            ) WITHOUT ROWID
+        )SQL").arg(name);
+    }
+    if (table == QStringLiteral("page_conflicts")) {
+        // Page conflicts (detected when both sides changed since last synced base)
+        return QStringLiteral(R"SQL(
+            CREATE TABLE IF NOT EXISTS %1 (
+                page_id BLOB PRIMARY KEY,
+                base_updated_at TEXT NOT NULL DEFAULT '',
+                local_updated_at TEXT NOT NULL DEFAULT '',
+                remote_updated_at TEXT NOT NULL DEFAULT '',
+                base_title TEXT NOT NULL DEFAULT '',
+                local_title TEXT NOT NULL DEFAULT '',
+                remote_title TEXT NOT NULL DEFAULT '',
+                base_content_markdown TEXT NOT NULL DEFAULT '',
+                local_content_markdown TEXT NOT NULL DEFAULT '',
+                remote_content_markdown TEXT NOT NULL DEFAULT '',
+                merged_kind TEXT NOT NULL DEFAULT '',
+                merged_content_markdown TEXT NOT NULL DEFAULT '',
+                merged_hunks_json TEXT NOT NULL DEFAULT '[]',
+                created_at TEXT DEFAULT CURRENT_TIMESTAMP
+            )
+        )SQL").arg(name);
+    }
+    if (table == QStringLiteral("blocks")) {
+        return QStringLiteral(R"SQL(
+            CREATE TABLE IF NOT EXISTS %1 (
+                id BLOB PRIMARY KEY,
+                page_id BLOB NOT NULL,
+                block_type TEXT NOT NULL DEFAULT 'paragraph',
+                content TEXT DEFAULT '',
+                depth INTEGER DEFAULT 0,
+                checked INTEGER DEFAULT 0,
+                collapsed INTEGER DEFAULT 0,
+                language TEXT DEFAULT '',
+                heading_level INTEGER DEFAULT 0,
+                sort_order INTEGER DEFAULT 0,
+                created_at TEXT DEFAULT CURRENT_TIMESTAMP,
+                updated_at TEXT DEFAULT CURRENT_TIMESTAMP,
+                FOREIGN KEY (page_id) REFERENCES pages(id) ON DELETE CASCADE
+            )
+        )SQL").arg(name);
+    }
+    if (table == QStringLiteral("attachments")) {
+        // Attachments table (file-backed; bytes live on disk)
+        return QStringLiteral(R"SQL(
+            CREATE TABLE IF NOT EXISTS %1 (
+                id BLOB PRIMARY KEY,
+                mime_type TEXT NOT NULL,
+                file_name TEXT NOT NULL,
+                created_at TEXT DEFAULT CURRENT_TIMESTAMP,
+                updated_at TEXT DEFAULT CURRENT_TIMESTAMP
+            ) WITHOUT ROWID
+        )SQL").arg(name);
+    }
+    return {};
+}
+
+QStringList id_keyed_table_indexes(const QString& table) {
+    if (table == QStringLiteral("pages")) {
+        return {
+            QStringLiteral("CREATE INDEX IF NOT EXISTS idx_pages_parent_id ON pages(parent_id)"),
+            QStringLiteral("CREATE INDEX IF NOT EXISTS idx_pages_notebook_id ON pages(notebook_id)"),
+        };
+    }
+    if (table == QStringLiteral("deleted_pages")) {
+        return {QStringLiteral("CREATE INDEX IF NOT EXISTS idx_deleted_pages_deleted_at ON deleted_pages(deleted_at)")};
+    }
+    if (table == QStringLiteral("page_conflicts")) {
+        return {QStringLiteral("CREATE INDEX IF NOT EXISTS idx_page_conflicts_created_at ON page_conflicts(created_at, page_id)")};
+    }
+    if (table == QStringLiteral("blocks")) {
+        return {QStringLiteral("CREATE INDEX IF NOT EXISTS idx_blocks_page_id ON blocks(page_id)")};
+    }
+    if (table == QStringLiteral("attachments")) {
+        return {QStringLiteral("CREATE INDEX IF NOT EXISTS idx_attachments_updated_at ON attachments(updated_at, id)")};
+    }
+    return {};
+}
+
 } // namespace
 
 DataStore::DataStore(QObject* parent)
@@ -1026,6 +1268,9 @@ DataStore::DataStore(QObject* parent)
 }
 
 DataStore::~DataStore() {
+    // Background exports and imports keep running on their own connections until they see this.
+    cancelExport();
+    cancelImport();
     if (m_db.isOpen()) {
         m_db.close();
     }
@@ -1064,11 +1309,20 @@ bool DataStore::initialize() {
         emit error("Failed to open database: " + m_db.lastError().text());
         return false;
     }
+    // WAL lets export snapshots and import batches on their own connections run without
+    // blocking the GUI's writes. The mode is stored in the file, so those connections inherit it.
+    QSqlQuery walQuery(m_db);
+    if (!walQuery.exec(QStringLiteral("PRAGMA journal_mode = WAL"))) {
+        qWarning() << "DataStore: could not enable WAL:" << walQuery.lastError().text();
+    }
+    walQuery.finish();
     
     createTables();
     m_ready = true;
     runMigrations();
-    if (is_fresh_database_for_default_seeding(m_db)) {
+    // Relays (zincd) start empty and only mirror what peers send.
+    if (!qEnvironmentVariableIsSet("ZINC_DISABLE_DEFAULT_PAGES") &&
+        is_fresh_database_for_default_seeding(m_db)) {
         seedDefaultPages();
     }
     ensureDefaultNotebook();
@@ -1080,24 +1334,11 @@ bool DataStore::initialize() {
 
 void DataStore::createTables() {
     QSqlQuery query(m_db);
-    
-    // Pages table
-    query.exec(R"(
-        CREATE TABLE IF NOT EXISTS pages (
-            id TEXT PRIMARY KEY,
-            notebook_id TEXT NOT NULL DEFAULT '',
-            title TEXT NOT NULL DEFAULT 'Untitled',
-            parent_id TEXT,
-            content_markdown TEXT NOT NULL DEFAULT '',
-            depth INTEGER DEFAULT 0,
-            sort_order INTEGER DEFAULT 0,
-            last_synced_at TEXT DEFAULT '',
-            last_synced_title TEXT DEFAULT '',
-            last_synced_content_markdown TEXT NOT NULL DEFAULT '',
-            created_at TEXT DEFAULT CURRENT_TIMESTAMP,
-            updated_at TEXT DEFAULT CURRENT_TIMESTAMP
-        )
-    )");
+
+    // Pages, page tombstones/conflicts, blocks and attachments (BLOB ids, see sql_id())
+    for (const auto& table : id_keyed_tables()) {
+        query.exec(id_keyed_table_sql(table, table));
+    }
 
     query.exec(R"(
         CREATE TABLE IF NOT EXISTS notebooks (
@@ -1116,49 +1357,6 @@ void DataStore::createTables() {
         )
     )");
 
-    query.exec(R"(
-        CREATE TABLE IF NOT EXISTS deleted_pages (
-            page_id TEXT PRIMARY KEY,
-            deleted_at TEXT NOT NULL
-        )
-    )");
-
-    // Page conflicts (detected when both sides changed since last synced base)
-    query.exec(R"(
-        CREATE TABLE IF NOT EXISTS page_conflicts (
-            page_id TEXT PRIMARY KEY,
-            base_updated_at TEXT NOT NULL DEFAULT '',
-            local_updated_at TEXT NOT NULL DEFAULT '',
-            remote_updated_at TEXT NOT NULL DEFAULT '',
-            base_title TEXT NOT NULL DEFAULT '',
-            local_title TEXT NOT NULL DEFAULT '',
-            remote_title TEXT NOT NULL DEFAULT '',
-            base_content_markdown TEXT NOT NULL DEFAULT '',
-            local_content_markdown TEXT NOT NULL DEFAULT '',
-            remote_content_markdown TEXT NOT NULL DEFAULT '',
-            created_at TEXT DEFAULT CURRENT_TIMESTAMP
-        )
-    )");
-    
-    // Blocks table
-    query.exec(R"(
-        CREATE TABLE IF NOT EXISTS blocks (
-            id TEXT PRIMARY KEY,
-            page_id TEXT NOT NULL,
-            block_type TEXT NOT NULL DEFAULT 'paragraph',
-            content TEXT DEFAULT '',
-            depth INTEGER DEFAULT 0,
-            checked INTEGER DEFAULT 0,
-            collapsed INTEGER DEFAULT 0,
-            language TEXT DEFAULT '',
-            heading_level INTEGER DEFAULT 0,
-            sort_order INTEGER DEFAULT 0,
-            created_at TEXT DEFAULT CURRENT_TIMESTAMP,
-            updated_at TEXT DEFAULT CURRENT_TIMESTAMP,
-            FOREIGN KEY (page_id) REFERENCES pages(id) ON DELETE CASCADE
-        )
-    )");
-
     // Paired devices table
     query.exec(R"(
         CREATE TABLE IF NOT EXISTS paired_devices (
@@ -1174,26 +1372,14 @@ void DataStore::createTables() {
         )
     )");
 
-    // Attachments table (file-backed; bytes live on disk)
-    query.exec(R"(
-        CREATE TABLE IF NOT EXISTS attachments (
-            id TEXT PRIMARY KEY,
-            mime_type TEXT NOT NULL,
-            file_name TEXT NOT NULL,
-            created_at TEXT DEFAULT CURRENT_TIMESTAMP,
-            updated_at TEXT DEFAULT CURRENT_TIMESTAMP
-        )
-    )");
-
     // Create index for faster lookups
-    query.exec("CREATE INDEX IF NOT EXISTS idx_blocks_page_id ON blocks(page_id)");
-    query.exec("CREATE INDEX IF NOT EXISTS idx_pages_parent_id ON pages(parent_id)");
-    query.exec("CREATE INDEX IF NOT EXISTS idx_pages_notebook_id ON pages(notebook_id)");
-    query.exec("CREATE INDEX IF NOT EXISTS idx_deleted_pages_deleted_at ON deleted_pages(deleted_at)");
+    for (const auto& table : id_keyed_tables()) {
+        for (const auto& index : id_keyed_table_indexes(table)) {
+            query.exec(index);
+        }
+    }
     query.exec("CREATE INDEX IF NOT EXISTS idx_deleted_notebooks_deleted_at ON deleted_notebooks(deleted_at)");
     query.exec("CREATE INDEX IF NOT EXISTS idx_paired_devices_workspace_id ON paired_devices(workspace_id)");
-    query.exec("CREATE INDEX IF NOT EXISTS idx_attachments_updated_at ON attachments(updated_at, id)");
-    query.exec("CREATE INDEX IF NOT EXISTS idx_page_conflicts_created_at ON page_conflicts(created_at, page_id)");
 }
 
 QVariantList DataStore::getAllPages() {
@@ -1209,10 +1395,10 @@ QVariantList DataStore::getAllPages() {
     
     while (query.next()) {
         QVariantMap page;
-        page["pageId"] = query.value(0).toString();
+        page["pageId"] = id_from_sql(query.value(0));
         page["notebookId"] = query.value(1).toString();
         page["title"] = query.value(2).toString();
-        page["parentId"] = query.value(3).toString();
+        page["parentId"] = id_from_sql(query.value(3));
         page["depth"] = query.value(4).toInt();
         page["sortOrder"] = query.value(5).toInt();
         page["createdAt"] = query.value(6).toString();
@@ -1244,10 +1430,10 @@ QVariantList DataStore::getPagesForNotebook(const QString& notebookId) {
 
     while (query.next()) {
         QVariantMap page;
-        page["pageId"] = query.value(0).toString();
+        page["pageId"] = id_from_sql(query.value(0));
         page["notebookId"] = query.value(1).toString();
         page["title"] = query.value(2).toString();
-        page["parentId"] = query.value(3).toString();
+        page["parentId"] = id_from_sql(query.value(3));
         page["depth"] = query.value(4).toInt();
         page["sortOrder"] = query.value(5).toInt();
         page["createdAt"] = query.value(6).toString();
@@ -1293,22 +1479,11 @@ QString make_snippet(const QString& text, const QString& query, int contextChars
     return snippet;
 }
 
-bool contains_case_insensitive(const QString& haystack, const QString& needle) {
+bool contains_case_insensitive(QStringView haystack, QStringView needle) {
     if (needle.isEmpty()) return true;
     return haystack.indexOf(needle, 0, Qt::CaseInsensitive) >= 0;
 }
 
-QString display_text_for_block(const QVariantMap& block) {
-    const auto type = block.value("blockType").toString();
-    const auto content = block.value("content").toString();
-    if (type == QStringLiteral("link")) {
-        const auto parts = content.split('|');
-        const auto title = parts.value(1, QStringLiteral("Untitled"));
-        return title;
-    }
-    return content;
-}
-
 } // namespace
 
 QVariantList DataStore::searchPages(const QString& query, int limit) {
@@ -1342,23 +1517,22 @@ QVariantList DataStore::searchPages(const QString& query, int limit) {
         return out;
     }
 
-    MarkdownBlocks codec;
     while (q.next()) {
-        const auto pageId = q.value(0).toString();
+        const auto pageId = id_from_sql(q.value(0));
         const auto title = q.value(1).toString();
         const auto markdown = q.value(2).toString();
 
         const bool titleMatch = contains_case_insensitive(title, trimmed);
 
-        QVariantList blocks;
+        // Blocks stay as views into `markdown`; only hits are copied out for the snippet.
+        std::vector<MarkdownBlocks::ParsedBlock> blocks;
         if (!markdown.trimmed().isEmpty()) {
-            blocks = codec.parseWithSpans(markdown);
+            blocks = MarkdownBlocks::parseBlocksWithSpans(markdown);
         }
 
         bool anyBlockMatch = false;
-        for (int i = 0; i < blocks.size(); ++i) {
-            const auto block = blocks[i].toMap();
-            const auto text = display_text_for_block(block);
+        for (size_t i = 0; i < blocks.size(); ++i) {
+            const auto text = blocks[i].text();
             if (!contains_case_insensitive(text, trimmed)) {
                 continue;
             }
@@ -1367,9 +1541,9 @@ QVariantList DataStore::searchPages(const QString& query, int limit) {
             QVariantMap result;
             result["pageId"] = pageId;
             result["blockId"] = QString();
-            result["blockIndex"] = i;
+            result["blockIndex"] = static_cast<int>(i);
             result["pageTitle"] = title;
-            result["snippet"] = make_snippet(text, trimmed, 60);
+            result["snippet"] = make_snippet(text.toString(), trimmed, 60);
             result["rank"] = titleMatch ? 1.0 : 0.5;
             out.append(result);
             if (out.size() >= clampedLimit) {
@@ -1406,10 +1580,10 @@ QVariantList DataStore::getPagesForSync() {
 
     while (query.next()) {
         QVariantMap page;
-        page["pageId"] = query.value(0).toString();
+        page["pageId"] = id_from_sql(query.value(0));
         page["notebookId"] = query.value(1).toString();
         page["title"] = query.value(2).toString();
-        page["parentId"] = query.value(3).toString();
+        page["parentId"] = id_from_sql(query.value(3));
         page["contentMarkdown"] = query.value(4).toString();
         page["depth"] = query.value(5).toInt();
         page["sortOrder"] = query.value(6).toInt();
@@ -1443,7 +1617,7 @@ QVariantList DataStore::getPagesForSyncSince(const QString& updatedAtCursor,
     )SQL");
     query.addBindValue(updatedAtCursor);
     query.addBindValue(updatedAtCursor);
-    query.addBindValue(pageIdCursor);
+    query.addBindValue(sql_id(pageIdCursor));
 
     if (!query.exec()) {
         qWarning() << "DataStore: getPagesForSyncSince query failed:" << query.lastError().text();
@@ -1452,10 +1626,10 @@ QVariantList DataStore::getPagesForSyncSince(const QString& updatedAtCursor,
 
     while (query.next()) {
         QVariantMap page;
-        page["pageId"] = query.value(0).toString();
+        page["pageId"] = id_from_sql(query.value(0));
         page["notebookId"] = query.value(1).toString();
         page["title"] = query.value(2).toString();
-        page["parentId"] = query.value(3).toString();
+        page["parentId"] = id_from_sql(query.value(3));
         page["contentMarkdown"] = query.value(4).toString();
         page["depth"] = query.value(5).toInt();
         page["sortOrder"] = query.value(6).toInt();
@@ -1494,8 +1668,8 @@ void DataStore::markPagesAsSynced(const QVariantList& pagesOrIds) {
     for (const auto& v : pagesOrIds) {
         const auto pageId = pageIdFor(v);
         if (pageId.isEmpty()) continue;
-        q.bindValue(0, pageId);
-        q.bindValue(1, pageId);
+        q.bindValue(0, sql_id(pageId));
+        q.bindValue(1, sql_id(pageId));
         q.exec();
         q.finish();
     }
@@ -1515,7 +1689,7 @@ QVariantList DataStore::getPageConflicts() {
 
     while (q.next()) {
         QVariantMap row;
-        row["pageId"] = q.value(0).toString();
+        row["pageId"] = id_from_sql(q.value(0));
         row["localTitle"] = q.value(1).toString();
         row["remoteTitle"] = q.value(2).toString();
         row["localUpdatedAt"] = q.value(3).toString();
@@ -1540,12 +1714,12 @@ QVariantMap DataStore::getPageConflict(const QString& pageId) {
         FROM page_conflicts
         WHERE page_id = ?
     )SQL");
-    q.addBindValue(pageId);
+    q.addBindValue(sql_id(pageId));
     if (!q.exec() || !q.next()) {
         return out;
     }
 
-    out["pageId"] = q.value(0).toString();
+    out["pageId"] = id_from_sql(q.value(0));
     out["baseUpdatedAt"] = q.value(1).toString();
     out["localUpdatedAt"] = q.value(2).toString();
     out["remoteUpdatedAt"] = q.value(3).toString();
@@ -1563,35 +1737,114 @@ bool DataStore::hasPageConflict(const QString& pageId) {
     if (!m_ready || pageId.isEmpty()) return false;
     QSqlQuery q(m_db);
     q.prepare("SELECT 1 FROM page_conflicts WHERE page_id = ? LIMIT 1");
-    q.addBindValue(pageId);
+    q.addBindValue(sql_id(pageId));
     return q.exec() && q.next();
 }
 
 QVariantMap DataStore::previewMergeForPageConflict(const QString& pageId) {
     QVariantMap out;
+    if (!m_ready || pageId.isEmpty()) return out;
+
+    QSqlQuery q(m_db);
+    q.prepare(R"SQL(
+        SELECT base_title, local_title, remote_title,
+               merged_kind, merged_content_markdown, merged_hunks_json
+        FROM page_conflicts
+        WHERE page_id = ?
+    )SQL");
+    q.addBindValue(sql_id(pageId));
+    if (!q.exec() || !q.next()) {
+        return out;
+    }
+    const auto baseTitle = q.value(0).toString();
+    const auto localTitle = q.value(1).toString();
+    const auto remoteTitle = q.value(2).toString();
+    ConflictMerge merge{q.value(3).toString(), q.value(4).toString(), q.value(5).toString()};
+    q.finish();
+
+    if (merge.kind.isEmpty()) {
+        // Not precomputed yet (background merge still running, or a pre-v12 row). The diff
+        // budget keeps this bounded on the GUI thread however far the sides have drifted.
+        const auto conflict = getPageConflict(pageId);
+        if (conflict.isEmpty()) return out;
+        const auto baseMd = conflict.value(QStringLiteral("baseContentMarkdown")).toString();
+        const auto localMd = conflict.value(QStringLiteral("localContentMarkdown")).toString();
+        const auto remoteMd = conflict.value(QStringLiteral("remoteContentMarkdown")).toString();
+        merge = compute_conflict_merge(baseMd, localMd, remoteMd);
+        storeConflictMerge(pageId, baseMd, localMd, remoteMd, merge.kind, merge.markdown, merge.hunksJson);
+    }
+
+    return conflict_merge_preview(merge, baseTitle, localTitle, remoteTitle);
+}
+
+void DataStore::scheduleConflictMerge(const QString& pageId) {
+    {
+        // Replaying a conflict whose sides did not change keeps its merge; don't diff it again.
+        QSqlQuery q(m_db);
+        q.prepare("SELECT merged_kind FROM page_conflicts WHERE page_id = ?");
+        q.addBindValue(sql_id(pageId));
+        if (!q.exec() || !q.next() || !q.value(0).toString().isEmpty()) return;
+    }
+
     const auto conflict = getPageConflict(pageId);
-    if (conflict.isEmpty()) return out;
+    if (conflict.isEmpty()) return;
 
-    const auto base = conflict.value(QStringLiteral("baseContentMarkdown")).toString().toUtf8();
-    const auto ours = conflict.value(QStringLiteral("localContentMarkdown")).toString().toUtf8();
-    const auto theirs = conflict.value(QStringLiteral("remoteContentMarkdown")).toString().toUtf8();
+    const auto baseMd = conflict.value(QStringLiteral("baseContentMarkdown")).toString();
+    const auto localMd = conflict.value(QStringLiteral("localContentMarkdown")).toString();
+    const auto remoteMd = conflict.value(QStringLiteral("remoteContentMarkdown")).toString();
 
-    const auto result = zinc::three_way_merge_text(
-        std::string_view(base.constData(), static_cast<size_t>(base.size())),
-        std::string_view(ours.constData(), static_cast<size_t>(ours.size())),
-        std::string_view(theirs.constData(), static_cast<size_t>(theirs.size())));
+    // The diff runs on the pool; the result is written back on this thread, where m_db lives.
+    // The watcher is our child, so a result arriving after destruction is dropped.
+    auto promise = std::make_shared<QPromise<ConflictMerge>>();
+    auto* watcher = new QFutureWatcher<ConflictMerge>(this);
+    connect(watcher, &QFutureWatcher<ConflictMerge>::finished, this,
+            [this, watcher, pageId, baseMd, localMd, remoteMd]() {
+                watcher->deleteLater();
+                if (watcher->future().resultCount() == 0) return;
+                const auto merge = watcher->result();
+                if (storeConflictMerge(pageId, baseMd, localMd, remoteMd,
+                                       merge.kind, merge.markdown, merge.hunksJson)) {
+                    emit pageConflictMergeReady(pageId);
+                }
+            });
+    watcher->setFuture(promise->future());
+    promise->start();
+    QThreadPool::globalInstance()->start([promise, baseMd, localMd, remoteMd]() {
+        promise->addResult(compute_conflict_merge(baseMd, localMd, remoteMd));
+        promise->finish();
+    });
+}
+
+bool DataStore::storeConflictMerge(const QString& pageId,
+                                   const QString& baseMd,
+                                   const QString& localMd,
+                                   const QString& remoteMd,
+                                   const QString& kind,
+                                   const QString& mergedMd,
+                                   const QString& hunksJson) {
+    if (!m_ready) return false;
 
-    out["mergedMarkdown"] = QString::fromUtf8(result.merged);
-    out["clean"] = result.clean();
-    out["kind"] = (result.kind == zinc::ThreeWayMergeResult::Kind::Clean)
-        ? QStringLiteral("clean")
-        : (result.kind == zinc::ThreeWayMergeResult::Kind::Conflict)
-            ? QStringLiteral("conflict")
-            : QStringLiteral("fallback");
-    out["mergedTitle"] = merge_conflict_title(conflict.value(QStringLiteral("baseTitle")).toString(),
-                                              conflict.value(QStringLiteral("localTitle")).toString(),
-                                              conflict.value(QStringLiteral("remoteTitle")).toString());
-    return out;
+    // Only store against the sides it was computed from, and only once per cache reset.
+    QSqlQuery q(m_db);
+    q.prepare(R"SQL(
+        UPDATE page_conflicts
+        SET merged_kind = ?,
+            merged_content_markdown = ?,
+            merged_hunks_json = ?
+        WHERE page_id = ?
+          AND base_content_markdown = ?
+          AND local_content_markdown = ?
+          AND remote_content_markdown = ?
+          AND merged_kind = ''
+    )SQL");
+    q.addBindValue(kind);
+    q.addBindValue(mergedMd);
+    q.addBindValue(hunksJson);
+    q.addBindValue(sql_id(pageId));
+    q.addBindValue(baseMd);
+    q.addBindValue(localMd);
+    q.addBindValue(remoteMd);
+    return q.exec() && q.numRowsAffected() > 0;
 }
 
 void DataStore::resolvePageConflict(const QString& pageId, const QString& resolution) {
@@ -1666,14 +1919,14 @@ void DataStore::resolvePageConflict(const QString& pageId, const QString& resolu
             last_synced_title = excluded.last_synced_title,
             last_synced_content_markdown = excluded.last_synced_content_markdown;
     )SQL");
-    upsert.addBindValue(pageId);
-    upsert.addBindValue(pageId);
+    upsert.addBindValue(sql_id(pageId));
+    upsert.addBindValue(sql_id(pageId));
     upsert.addBindValue(ensureDefaultNotebook());
     upsert.addBindValue(resolvedTitle);
-    upsert.addBindValue(pageId);
+    upsert.addBindValue(sql_id(pageId));
     upsert.addBindValue(resolvedMd);
-    upsert.addBindValue(pageId);
-    upsert.addBindValue(pageId);
+    upsert.addBindValue(sql_id(pageId));
+    upsert.addBindValue(sql_id(pageId));
     upsert.addBindValue(resolvedUpdatedAt);
     upsert.addBindValue(resolvedTitle);
     upsert.addBindValue(resolvedMd);
@@ -1682,7 +1935,7 @@ void DataStore::resolvePageConflict(const QString& pageId, const QString& resolu
 
     QSqlQuery del(m_db);
     del.prepare("DELETE FROM page_conflicts WHERE page_id = ?");
-    del.addBindValue(pageId);
+    del.addBindValue(sql_id(pageId));
     del.exec();
 
     m_db.commit();
@@ -1707,7 +1960,7 @@ QVariantList DataStore::getDeletedPagesForSync() {
 
     while (query.next()) {
         QVariantMap entry;
-        entry["pageId"] = query.value(0).toString();
+        entry["pageId"] = id_from_sql(query.value(0));
         entry["deletedAt"] = query.value(1).toString();
         deletedPages.append(entry);
     }
@@ -1759,7 +2012,7 @@ QString DataStore::saveAttachmentFromDataUrl(const QString& dataUrl) {
             file_name = excluded.file_name,
             updated_at = excluded.updated_at;
     )SQL");
-    upsert.addBindValue(id);
+    upsert.addBindValue(sql_id(id));
     upsert.addBindValue(parsed->mime);
     upsert.addBindValue(id);
     upsert.addBindValue(updatedAt);
@@ -1768,6 +2021,10 @@ QString DataStore::saveAttachmentFromDataUrl(const QString& dataUrl) {
         return {};
     }
 
+    if (parsed->mime.startsWith(QStringLiteral("image/"))) {
+        AttachmentThumbnailCache::generateInBackground(resolve_attachments_dir(), {id});
+    }
+
     emit attachmentsChanged();
     return id;
 }
@@ -1784,7 +2041,7 @@ QVariantList DataStore::getAttachmentsForSync() {
     )SQL");
 
     while (query.next()) {
-        const auto id = query.value(0).toString();
+        const auto id = id_from_sql(query.value(0));
         const auto fileName = query.value(2).toString().isEmpty() ? id : query.value(2).toString();
         const auto path = attachment_file_path_for_id(fileName);
         const auto bytes = read_file_bytes(path);
@@ -1821,14 +2078,14 @@ QVariantList DataStore::getAttachmentsForSyncSince(const QString& updatedAtCurso
     )SQL");
     query.addBindValue(updatedAtCursor);
     query.addBindValue(updatedAtCursor);
-    query.addBindValue(attachmentIdCursor);
+    query.addBindValue(sql_id(attachmentIdCursor));
     if (!query.exec()) {
         qWarning() << "DataStore: getAttachmentsForSyncSince query failed:" << query.lastError().text();
         return out;
     }
 
     while (query.next()) {
-        const auto id = query.value(0).toString();
+        const auto id = id_from_sql(query.value(0));
         const auto fileName = query.value(2).toString().isEmpty() ? id : query.value(2).toString();
         const auto path = attachment_file_path_for_id(fileName);
         const auto bytes = read_file_bytes(path);
@@ -1873,7 +2130,7 @@ QVariantList DataStore::getAttachmentsByIds(const QVariantList& attachmentIds) {
         "WHERE id IN (%1) "
         "ORDER BY updated_at, id").arg(placeholders.join(',')));
     for (const auto& id : ids) {
-        query.addBindValue(id);
+        query.addBindValue(sql_id(id));
     }
     if (!query.exec()) {
         qWarning() << "DataStore: getAttachmentsByIds query failed:" << query.lastError().text();
@@ -1881,7 +2138,7 @@ QVariantList DataStore::getAttachmentsByIds(const QVariantList& attachmentIds) {
     }
 
     while (query.next()) {
-        const auto id = query.value(0).toString();
+        const auto id = id_from_sql(query.value(0));
         const auto fileName = query.value(2).toString().isEmpty() ? id : query.value(2).toString();
         const auto path = attachment_file_path_for_id(fileName);
         const auto bytes = read_file_bytes(path);
@@ -1908,6 +2165,7 @@ void DataStore::applyAttachmentUpdates(const QVariantList& attachments) {
 
     m_db.transaction();
 
+    QStringList images;
     QSqlQuery upsert(m_db);
     upsert.prepare(R"SQL(
         INSERT INTO attachments (id, mime_type, file_name, updated_at)
@@ -1942,15 +2200,19 @@ void DataStore::applyAttachmentUpdates(const QVariantList& attachments) {
         if (!is_safe_attachment_id(normalizedId)) continue;
         if (!write_bytes_atomic(attachment_file_path_for_id(normalizedId), bytes)) continue;
 
-        upsert.bindValue(0, normalizedId);
+        upsert.bindValue(0, sql_id(normalizedId));
         upsert.bindValue(1, mime);
         upsert.bindValue(2, normalizedId);
         upsert.bindValue(3, updatedAt);
         upsert.exec();
         upsert.finish();
+        if (mime.startsWith(QStringLiteral("image/"))) images.append(normalizedId);
     }
 
     m_db.commit();
+    if (!images.isEmpty()) {
+        AttachmentThumbnailCache::generateInBackground(resolve_attachments_dir(), images);
+    }
     if (debugAttachments || debugSync) {
         int total = attachments.size();
         int insertedOrUpdated = 0;
@@ -2021,7 +2283,7 @@ QVariantList DataStore::getDeletedPagesForSyncSince(const QString& deletedAtCurs
     )SQL");
     query.addBindValue(deletedAtCursor);
     query.addBindValue(deletedAtCursor);
-    query.addBindValue(pageIdCursor);
+    query.addBindValue(sql_id(pageIdCursor));
 
     if (!query.exec()) {
         qWarning() << "DataStore: getDeletedPagesForSyncSince query failed:" << query.lastError().text();
@@ -2030,7 +2292,7 @@ QVariantList DataStore::getDeletedPagesForSyncSince(const QString& deletedAtCurs
 
     while (query.next()) {
         QVariantMap entry;
-        entry["pageId"] = query.value(0).toString();
+        entry["pageId"] = id_from_sql(query.value(0));
         entry["deletedAt"] = query.value(1).toString();
         deletedPages.append(entry);
     }
@@ -2044,13 +2306,13 @@ QVariantMap DataStore::getPage(const QString& pageId) {
     
     QSqlQuery query(m_db);
     query.prepare("SELECT id, notebook_id, title, parent_id, content_markdown, depth, sort_order FROM pages WHERE id = ?");
-    query.addBindValue(pageId);
+    query.addBindValue(sql_id(pageId));
     
     if (query.exec() && query.next()) {
-        page["pageId"] = query.value(0).toString();
+        page["pageId"] = id_from_sql(query.value(0));
         page["notebookId"] = query.value(1).toString();
         page["title"] = query.value(2).toString();
-        page["parentId"] = query.value(3).toString();
+        page["parentId"] = id_from_sql(query.value(3));
         page["contentMarkdown"] = query.value(4).toString();
         page["depth"] = query.value(5).toInt();
         page["sortOrder"] = query.value(6).toInt();
@@ -2068,24 +2330,13 @@ void DataStore::savePage(const QVariantMap& page) {
         : ensureDefaultNotebook();
 
     QSqlQuery query(m_db);
-    query.prepare(R"SQL(
-        INSERT INTO pages (id, notebook_id, title, parent_id, content_markdown, depth, sort_order, updated_at)
-        VALUES (?, ?, ?, ?, ?, ?, ?, ?)
-        ON CONFLICT(id) DO UPDATE SET
-            notebook_id = excluded.notebook_id,
-            title = excluded.title,
-            parent_id = excluded.parent_id,
-            content_markdown = excluded.content_markdown,
-            depth = excluded.depth,
-            sort_order = excluded.sort_order,
-            updated_at = excluded.updated_at;
-    )SQL");
+    query.prepare(QString::fromLatin1(kUpsertPageSql));
     
     const QString updatedAt = now_timestamp_utc();
-    query.addBindValue(page["pageId"].toString());
+    query.addBindValue(sql_id(page["pageId"].toString()));
     query.addBindValue(notebookId);
     query.addBindValue(normalize_title(page.value("title")));
-    query.addBindValue(normalize_parent_id(page.value("parentId")));
+    query.addBindValue(sql_id(normalize_parent_id(page.value("parentId"))));
     query.addBindValue(page.value("contentMarkdown").toString());
     query.addBindValue(page["depth"].toInt());
     query.addBindValue(page["sortOrder"].toInt());
@@ -2109,7 +2360,7 @@ void DataStore::deletePage(const QString& pageId) {
     
     QSqlQuery query(m_db);
     query.prepare("DELETE FROM pages WHERE id = ?");
-    query.addBindValue(pageId);
+    query.addBindValue(sql_id(pageId));
     
     if (!query.exec()) {
         qWarning() << "DataStore: Failed to delete page:" << query.lastError().text();
@@ -2150,11 +2401,11 @@ void DataStore::saveAllPages(const QVariantList& pages) {
         QSqlQuery removedQuery(m_db);
         removedQuery.prepare("SELECT id FROM pages WHERE id NOT IN (" + placeholders + ")");
         for (int i = 0; i < ids.size(); ++i) {
-            removedQuery.addBindValue(ids[i]);
+            removedQuery.addBindValue(sql_id(ids[i]));
         }
         if (removedQuery.exec()) {
             while (removedQuery.next()) {
-                const QString pageId = removedQuery.value(0).toString();
+                const QString pageId = id_from_sql(removedQuery.value(0));
                 deleteBlocksForPage(pageId);
                 upsert_deleted_page(m_db, pageId, deletedAt);
             }
@@ -2168,7 +2419,7 @@ void DataStore::saveAllPages(const QVariantList& pages) {
         QSqlQuery deleteQuery(m_db);
         deleteQuery.prepare("DELETE FROM pages WHERE id NOT IN (" + placeholders + ")");
         for (int i = 0; i < ids.size(); ++i) {
-            deleteQuery.addBindValue(ids[i]);
+            deleteQuery.addBindValue(sql_id(ids[i]));
         }
         deleteQuery.exec();
     } else {
@@ -2176,7 +2427,7 @@ void DataStore::saveAllPages(const QVariantList& pages) {
         QSqlQuery allIds(m_db);
         allIds.exec("SELECT id FROM pages");
         while (allIds.next()) {
-            const QString pageId = allIds.value(0).toString();
+            const QString pageId = id_from_sql(allIds.value(0));
             deleteBlocksForPage(pageId);
             upsert_deleted_page(m_db, pageId, deletedAt);
         }
@@ -2223,7 +2474,7 @@ void DataStore::saveAllPages(const QVariantList& pages) {
         const int depth = page.value("depth").toInt();
         const int sortOrder = page.contains("sortOrder") ? page.value("sortOrder").toInt() : i;
 
-        selectQuery.bindValue(0, pageId);
+        selectQuery.bindValue(0, sql_id(pageId));
         bool exists = false;
         QString existingNotebook;
         QString existingTitle;
@@ -2234,17 +2485,17 @@ void DataStore::saveAllPages(const QVariantList& pages) {
             exists = true;
             existingNotebook = selectQuery.value(0).toString();
             existingTitle = selectQuery.value(1).toString();
-            existingParent = selectQuery.value(2).toString();
+            existingParent = id_from_sql(selectQuery.value(2));
             existingDepth = selectQuery.value(3).toInt();
             existingOrder = selectQuery.value(4).toInt();
         }
         selectQuery.finish();
 
         if (!exists) {
-            insertQuery.bindValue(0, pageId);
+            insertQuery.bindValue(0, sql_id(pageId));
             insertQuery.bindValue(1, notebookId);
             insertQuery.bindValue(2, title);
-            insertQuery.bindValue(3, parentId);
+            insertQuery.bindValue(3, sql_id(parentId));
             insertQuery.bindValue(4, QStringLiteral(""));
             insertQuery.bindValue(5, depth);
             insertQuery.bindValue(6, sortOrder);
@@ -2266,22 +2517,22 @@ void DataStore::saveAllPages(const QVariantList& pages) {
         if (contentChanged) {
             updateContentQuery.bindValue(0, notebookId);
             updateContentQuery.bindValue(1, title);
-            updateContentQuery.bindValue(2, parentId);
+            updateContentQuery.bindValue(2, sql_id(parentId));
             updateContentQuery.bindValue(3, depth);
             updateContentQuery.bindValue(4, sortOrder);
             updateContentQuery.bindValue(5, updatedAt);
-            updateContentQuery.bindValue(6, pageId);
+            updateContentQuery.bindValue(6, sql_id(pageId));
             if (!updateContentQuery.exec()) {
                 qWarning() << "DataStore: Failed to update page:" << updateContentQuery.lastError().text();
             }
             updateContentQuery.finish();
         } else if (orderChanged) {
             updateOrderQuery.bindValue(0, notebookId);
-            updateOrderQuery.bindValue(1, parentId);
+            updateOrderQuery.bindValue(1, sql_id(parentId));
             updateOrderQuery.bindValue(2, depth);
             updateOrderQuery.bindValue(3, sortOrder);
             updateOrderQuery.bindValue(4, updatedAt);
-            updateOrderQuery.bindValue(5, pageId);
+            updateOrderQuery.bindValue(5, sql_id(pageId));
             if (!updateOrderQuery.exec()) {
                 qWarning() << "DataStore: Failed to update page order:" << updateOrderQuery.lastError().text();
             }
@@ -2324,11 +2575,11 @@ void DataStore::savePagesForNotebook(const QString& notebookId, const QVariantLi
         removedQuery.prepare("SELECT id FROM pages WHERE notebook_id = ? AND id NOT IN (" + placeholders + ")");
         removedQuery.addBindValue(resolvedNotebookId);
         for (int i = 0; i < ids.size(); ++i) {
-            removedQuery.addBindValue(ids[i]);
+            removedQuery.addBindValue(sql_id(ids[i]));
         }
         if (removedQuery.exec()) {
             while (removedQuery.next()) {
-                const QString pageId = removedQuery.value(0).toString();
+                const QString pageId = id_from_sql(removedQuery.value(0));
                 deleteBlocksForPage(pageId);
                 upsert_deleted_page(m_db, pageId, deletedAt);
             }
@@ -2338,7 +2589,7 @@ void DataStore::savePagesForNotebook(const QString& notebookId, const QVariantLi
         deleteQuery.prepare("DELETE FROM pages WHERE notebook_id = ? AND id NOT IN (" + placeholders + ")");
         deleteQuery.addBindValue(resolvedNotebookId);
         for (int i = 0; i < ids.size(); ++i) {
-            deleteQuery.addBindValue(ids[i]);
+            deleteQuery.addBindValue(sql_id(ids[i]));
         }
         deleteQuery.exec();
     } else {
@@ -2347,7 +2598,7 @@ void DataStore::savePagesForNotebook(const QString& notebookId, const QVariantLi
         allIds.addBindValue(resolvedNotebookId);
         allIds.exec();
         while (allIds.next()) {
-            const QString pageId = allIds.value(0).toString();
+            const QString pageId = id_from_sql(allIds.value(0));
             deleteBlocksForPage(pageId);
             upsert_deleted_page(m_db, pageId, deletedAt);
         }
@@ -2392,7 +2643,7 @@ void DataStore::savePagesForNotebook(const QString& notebookId, const QVariantLi
         const int depth = page.value("depth").toInt();
         const int sortOrder = page.contains("sortOrder") ? page.value("sortOrder").toInt() : i;
 
-        selectQuery.bindValue(0, pageId);
+        selectQuery.bindValue(0, sql_id(pageId));
         bool exists = false;
         QString existingTitle;
         QString existingParent;
@@ -2401,17 +2652,17 @@ void DataStore::savePagesForNotebook(const QString& notebookId, const QVariantLi
         if (selectQuery.exec() && selectQuery.next()) {
             exists = true;
             existingTitle = selectQuery.value(0).toString();
-            existingParent = selectQuery.value(1).toString();
+            existingParent = id_from_sql(selectQuery.value(1));
             existingDepth = selectQuery.value(2).toInt();
             existingOrder = selectQuery.value(3).toInt();
         }
         selectQuery.finish();
 
         if (!exists) {
-            insertQuery.bindValue(0, pageId);
+            insertQuery.bindValue(0, sql_id(pageId));
             insertQuery.bindValue(1, resolvedNotebookId);
             insertQuery.bindValue(2, title);
-            insertQuery.bindValue(3, parentId);
+            insertQuery.bindValue(3, sql_id(parentId));
             insertQuery.bindValue(4, QStringLiteral(""));
             insertQuery.bindValue(5, depth);
             insertQuery.bindValue(6, sortOrder);
@@ -2431,22 +2682,22 @@ void DataStore::savePagesForNotebook(const QString& notebookId, const QVariantLi
         if (contentChanged) {
             updateContentQuery.bindValue(0, resolvedNotebookId);
             updateContentQuery.bindValue(1, title);
-            updateContentQuery.bindValue(2, parentId);
+            updateContentQuery.bindValue(2, sql_id(parentId));
             updateContentQuery.bindValue(3, depth);
             updateContentQuery.bindValue(4, sortOrder);
             updateContentQuery.bindValue(5, updatedAt);
-            updateContentQuery.bindValue(6, pageId);
+            updateContentQuery.bindValue(6, sql_id(pageId));
             if (!updateContentQuery.exec()) {
                 qWarning() << "DataStore: Failed to update page:" << updateContentQuery.lastError().text();
             }
             updateContentQuery.finish();
         } else if (orderChanged) {
             updateOrderQuery.bindValue(0, resolvedNotebookId);
-            updateOrderQuery.bindValue(1, parentId);
+            updateOrderQuery.bindValue(1, sql_id(parentId));
             updateOrderQuery.bindValue(2, depth);
             updateOrderQuery.bindValue(3, sortOrder);
             updateOrderQuery.bindValue(4, updatedAt);
-            updateOrderQuery.bindValue(5, pageId);
+            updateOrderQuery.bindValue(5, sql_id(pageId));
             if (!updateOrderQuery.exec()) {
                 qWarning() << "DataStore: Failed to update page order:" << updateOrderQuery.lastError().text();
             }
@@ -2505,6 +2756,11 @@ void DataStore::applyPageUpdates(const QVariantList& pages) {
             base_content_markdown = excluded.base_content_markdown,
             local_content_markdown = excluded.local_content_markdown,
             remote_content_markdown = excluded.remote_content_markdown,
+            merged_kind = CASE
+                WHEN page_conflicts.base_content_markdown = excluded.base_content_markdown
+                 AND page_conflicts.local_content_markdown = excluded.local_content_markdown
+                 AND page_conflicts.remote_content_markdown = excluded.remote_content_markdown
+                THEN page_conflicts.merged_kind ELSE '' END,
             created_at = CURRENT_TIMESTAMP;
     )SQL");
 
@@ -2577,7 +2833,7 @@ void DataStore::applyPageUpdates(const QVariantList& pages) {
                     << "remoteBytes=" << remoteMd.toUtf8().size();
         }
 
-        tombstoneSelect.bindValue(0, pageId);
+        tombstoneSelect.bindValue(0, sql_id(pageId));
         QString deletedAt;
         if (tombstoneSelect.exec() && tombstoneSelect.next()) {
             deletedAt = tombstoneSelect.value(0).toString();
@@ -2590,13 +2846,13 @@ void DataStore::applyPageUpdates(const QVariantList& pages) {
                 continue;
             }
             if (deletedTime.isValid() && remoteTime.isValid() && deletedTime <= remoteTime) {
-                tombstoneDelete.bindValue(0, pageId);
+                tombstoneDelete.bindValue(0, sql_id(pageId));
                 tombstoneDelete.exec();
                 tombstoneDelete.finish();
             }
         }
 
-        selectQuery.bindValue(0, pageId);
+        selectQuery.bindValue(0, sql_id(pageId));
         QString localUpdated;
         QString localTitle;
         QString localMd;
@@ -2621,7 +2877,7 @@ void DataStore::applyPageUpdates(const QVariantList& pages) {
         // If we already have a conflict for this page, check whether this incoming update is a
         // "resolved" version (newer than both sides at detection time). If so, clear the conflict
         // and apply the update, but only if the user hasn't edited locally since the conflict.
-        conflictSelect.bindValue(0, pageId);
+        conflictSelect.bindValue(0, sql_id(pageId));
         QString conflictLocalUpdated;
         QString conflictRemoteUpdated;
         QString conflictLocalTitle;
@@ -2651,7 +2907,7 @@ void DataStore::applyPageUpdates(const QVariantList& pages) {
             const auto threshold = std::max(conflictLocalTime, conflictRemoteTime);
             if (remoteTime <= threshold) return false;
 
-            conflictDelete.bindValue(0, pageId);
+            conflictDelete.bindValue(0, sql_id(pageId));
             conflictDelete.exec();
             conflictDelete.finish();
             resolvedConflictPageIds.insert(pageId);
@@ -2722,7 +2978,7 @@ void DataStore::applyPageUpdates(const QVariantList& pages) {
                 return false;
             }
 
-            conflictUpsert.bindValue(0, pageId);
+            conflictUpsert.bindValue(0, sql_id(pageId));
             conflictUpsert.bindValue(1, baseUpdated);
             conflictUpsert.bindValue(2, localUpdated);
             conflictUpsert.bindValue(3, remoteUpdated);
@@ -2753,18 +3009,18 @@ void DataStore::applyPageUpdates(const QVariantList& pages) {
             const bool sameTitle = normalize_title(localTitle) == remoteTitle;
             const bool sameContent = localMd == remoteMd;
             if (sameTitle && sameContent) {
-                markSynced.bindValue(0, pageId);
-                markSynced.bindValue(1, pageId);
+                markSynced.bindValue(0, sql_id(pageId));
+                markSynced.bindValue(1, sql_id(pageId));
                 markSynced.exec();
                 markSynced.finish();
                 continue;
             }
         }
 
-        upsertQuery.bindValue(0, pageId);
+        upsertQuery.bindValue(0, sql_id(pageId));
         upsertQuery.bindValue(1, remoteNotebook);
         upsertQuery.bindValue(2, remoteTitle);
-        upsertQuery.bindValue(3, normalize_parent_id(page.value("parentId")));
+        upsertQuery.bindValue(3, sql_id(normalize_parent_id(page.value("parentId"))));
         if (hasRemoteContent) {
             upsertQuery.bindValue(4, remoteMd);
             contentChangedPages.insert(pageId);
@@ -2804,6 +3060,7 @@ void DataStore::applyPageUpdates(const QVariantList& pages) {
             if (!conflict.isEmpty()) {
                 emit pageConflictDetected(conflict);
             }
+            scheduleConflictMerge(pageId);
         }
     }
     if (!resolvedConflictPageIds.isEmpty()) {
@@ -2817,7 +3074,7 @@ QString DataStore::getPageContentMarkdown(const QString& pageId) {
     }
     QSqlQuery query(m_db);
     query.prepare(QStringLiteral("SELECT content_markdown FROM pages WHERE id = ?"));
-    query.addBindValue(pageId);
+    query.addBindValue(sql_id(pageId));
     if (!query.exec() || !query.next()) {
         return {};
     }
@@ -2832,7 +3089,7 @@ void DataStore::savePageContentMarkdown(const QString& pageId, const QString& ma
     {
         QSqlQuery existing(m_db);
         existing.prepare(QStringLiteral("SELECT content_markdown FROM pages WHERE id = ?"));
-        existing.addBindValue(pageId);
+        existing.addBindValue(sql_id(pageId));
         if (existing.exec() && existing.next()) {
             const auto current = existing.value(0).toString();
             if (current == markdown) {
@@ -2856,14 +3113,14 @@ void DataStore::savePageContentMarkdown(const QString& pageId, const QString& ma
             content_markdown = excluded.content_markdown,
             updated_at = excluded.updated_at;
     )SQL");
-    query.addBindValue(pageId);
-    query.addBindValue(pageId);
+    query.addBindValue(sql_id(pageId));
+    query.addBindValue(sql_id(pageId));
     query.addBindValue(ensureDefaultNotebook());
-    query.addBindValue(pageId);
-    query.addBindValue(pageId);
+    query.addBindValue(sql_id(pageId));
+    query.addBindValue(sql_id(pageId));
     query.addBindValue(markdown);
-    query.addBindValue(pageId);
-    query.addBindValue(pageId);
+    query.addBindValue(sql_id(pageId));
+    query.addBindValue(sql_id(pageId));
     query.addBindValue(updatedAt);
 
     if (!query.exec()) {
@@ -2887,12 +3144,12 @@ void DataStore::applyDeletedPageUpdates(const QVariantList& deletedPages) {
         for (int i = 0; i < ids.size(); ++i) {
             QSqlQuery children(m_db);
             children.prepare("SELECT id FROM pages WHERE parent_id = ?");
-            children.addBindValue(ids[i]);
+            children.addBindValue(sql_id(ids[i]));
             if (!children.exec()) {
                 continue;
             }
             while (children.next()) {
-                const QString childId = children.value(0).toString();
+                const QString childId = id_from_sql(children.value(0));
                 if (!childId.isEmpty() && !ids.contains(childId)) {
                     ids.append(childId);
                 }
@@ -2920,7 +3177,7 @@ void DataStore::applyDeletedPageUpdates(const QVariantList& deletedPages) {
         const QString remoteDeletedAt = normalize_timestamp(deleted.value("deletedAt"));
         QDateTime remoteDeletedTime = parse_timestamp(remoteDeletedAt);
 
-        tombstoneSelect.bindValue(0, pageId);
+        tombstoneSelect.bindValue(0, sql_id(pageId));
         QString localDeletedAt;
         if (tombstoneSelect.exec() && tombstoneSelect.next()) {
             localDeletedAt = tombstoneSelect.value(0).toString();
@@ -2938,7 +3195,7 @@ void DataStore::applyDeletedPageUpdates(const QVariantList& deletedPages) {
         const auto ids = subtreePageIds(pageId);
         for (const auto& id : ids) {
             deleteBlocksForPage(id);
-            pageDelete.bindValue(0, id);
+            pageDelete.bindValue(0, sql_id(id));
             pageDelete.exec();
             pageDelete.finish();
             upsert_deleted_page(m_db, id, remoteDeletedAt);
@@ -3049,8 +3306,8 @@ QVariantList DataStore::getBlocksForSync() {
 
     while (query.next()) {
         QVariantMap block;
-        block["blockId"] = query.value(0).toString();
-        block["pageId"] = query.value(1).toString();
+        block["blockId"] = id_from_sql(query.value(0));
+        block["pageId"] = id_from_sql(query.value(1));
         block["blockType"] = query.value(2).toString();
         block["content"] = query.value(3).toString();
         block["depth"] = query.value(4).toInt();
@@ -3087,7 +3344,7 @@ QVariantList DataStore::getBlocksForSyncSince(const QString& updatedAtCursor,
     )SQL");
     query.addBindValue(updatedAtCursor);
     query.addBindValue(updatedAtCursor);
-    query.addBindValue(blockIdCursor);
+    query.addBindValue(sql_id(blockIdCursor));
 
     if (!query.exec()) {
         qWarning() << "DataStore: getBlocksForSyncSince query failed:" << query.lastError().text();
@@ -3096,8 +3353,8 @@ QVariantList DataStore::getBlocksForSyncSince(const QString& updatedAtCursor,
 
     while (query.next()) {
         QVariantMap block;
-        block["blockId"] = query.value(0).toString();
-        block["pageId"] = query.value(1).toString();
+        block["blockId"] = id_from_sql(query.value(0));
+        block["pageId"] = id_from_sql(query.value(1));
         block["blockType"] = query.value(2).toString();
         block["content"] = query.value(3).toString();
         block["depth"] = query.value(4).toInt();
@@ -3152,7 +3409,7 @@ void DataStore::applyBlockUpdates(const QVariantList& blocks) {
         const QString remoteUpdated = normalize_timestamp(block.value("updatedAt"));
         QDateTime remoteTime = parse_timestamp(remoteUpdated);
 
-        selectQuery.bindValue(0, blockId);
+        selectQuery.bindValue(0, sql_id(blockId));
         QString localUpdated;
         if (selectQuery.exec() && selectQuery.next()) {
             localUpdated = selectQuery.value(0).toString();
@@ -3166,8 +3423,8 @@ void DataStore::applyBlockUpdates(const QVariantList& blocks) {
             }
         }
 
-        upsertQuery.bindValue(0, blockId);
-        upsertQuery.bindValue(1, pageId);
+        upsertQuery.bindValue(0, sql_id(blockId));
+        upsertQuery.bindValue(1, sql_id(pageId));
         upsertQuery.bindValue(2, block.value("blockType").toString());
         upsertQuery.bindValue(3, block.value("content").toString());
         upsertQuery.bindValue(4, block.value("depth").toInt());
@@ -3202,12 +3459,12 @@ QVariantList DataStore::getBlocksForPage(const QString& pageId) {
         SELECT id, block_type, content, depth, checked, collapsed, language, heading_level, sort_order, updated_at
         FROM blocks WHERE page_id = ? ORDER BY sort_order
     )");
-    query.addBindValue(pageId);
+    query.addBindValue(sql_id(pageId));
     
     if (query.exec()) {
         while (query.next()) {
             QVariantMap block;
-            block["blockId"] = query.value(0).toString();
+            block["blockId"] = id_from_sql(query.value(0));
             block["blockType"] = query.value(1).toString();
             block["content"] = query.value(2).toString();
             block["depth"] = query.value(3).toInt();
@@ -3233,7 +3490,7 @@ void DataStore::saveBlocksForPage(const QString& pageId, const QVariantList& blo
     // Delete existing blocks for this page
     QSqlQuery deleteQuery(m_db);
     deleteQuery.prepare("DELETE FROM blocks WHERE page_id = ?");
-    deleteQuery.addBindValue(pageId);
+    deleteQuery.addBindValue(sql_id(pageId));
     deleteQuery.exec();
     
     // Insert new blocks
@@ -3245,8 +3502,8 @@ void DataStore::saveBlocksForPage(const QString& pageId, const QVariantList& blo
     
     for (int i = 0; i < blocks.size(); ++i) {
         QVariantMap block = blocks[i].toMap();
-        query.addBindValue(block["blockId"].toString());
-        query.addBindValue(pageId);
+        query.addBindValue(sql_id(block["blockId"].toString()));
+        query.addBindValue(sql_id(pageId));
         query.addBindValue(block["blockType"].toString());
         query.addBindValue(block["content"].toString());
         query.addBindValue(block["depth"].toInt());
@@ -3271,7 +3528,7 @@ void DataStore::deleteBlocksForPage(const QString& pageId) {
     
     QSqlQuery query(m_db);
     query.prepare("DELETE FROM blocks WHERE page_id = ?");
-    query.addBindValue(pageId);
+    query.addBindValue(sql_id(pageId));
     
     if (!query.exec()) {
         qWarning() << "DataStore: Failed to delete blocks:" << query.lastError().text();
@@ -3490,10 +3747,10 @@ bool DataStore::seedDefaultPages() {
     const auto seedTs = QString::fromLatin1(kDefaultPagesSeedTimestamp);
     for (const auto& page : defaults) {
         const auto content = read_utf8_text_file_or_empty(default_page_resource_path(page.resourceRelativePath));
-        insert.bindValue(0, QString::fromLatin1(page.id));
+        insert.bindValue(0, sql_id(QString::fromLatin1(page.id)));
         insert.bindValue(1, notebookId);
         insert.bindValue(2, QString::fromLatin1(page.title));
-        insert.bindValue(3, QString::fromLatin1(page.parent));
+        insert.bindValue(3, sql_id(QString::fromLatin1(page.parent)));
         insert.bindValue(4, content);
         insert.bindValue(5, page.depth);
         insert.bindValue(6, page.sortOrder);
@@ -3623,7 +3880,7 @@ void DataStore::deleteNotebook(const QString& notebookId, bool deletePages) {
             q.addBindValue(notebookId);
             if (q.exec()) {
                 while (q.next()) {
-                    const auto id = q.value(0).toString();
+                    const auto id = id_from_sql(q.value(0));
                     if (!id.isEmpty()) {
                         pageIds.push_back(id);
                     }
@@ -4528,294 +4785,1113 @@ bool DataStore::runMigrations() {
         m_db.commit();
         currentVersion = 11;
     }
-    
-    qDebug() << "DataStore: Migrations complete. Schema version:" << currentVersion;
-    emit schemaVersionChanged();
-    return true;
-}
 
-bool DataStore::exportNotebooks(const QVariantList& notebookIds,
-                                const QUrl& destinationFolder,
-                                const QString& format) {
-    return exportNotebooks(notebookIds, destinationFolder, format, false);
-}
+    // Migration 12: Precomputed merge previews for page conflicts.
+    if (currentVersion < 12) {
+        qDebug() << "DataStore: Running migration to version 12";
+        m_db.transaction();
 
-bool DataStore::exportNotebooks(const QVariantList& notebookIds,
-                                const QUrl& destinationFolder,
-                                const QString& format,
-                                bool includeAttachments) {
-    if (!m_ready) {
-        emit error(QStringLiteral("Export failed: database not initialized"));
-        return false;
-    }
+        QSet<QString> columns;
+        QSqlQuery info(m_db);
+        if (info.exec("PRAGMA table_info(page_conflicts)")) {
+            while (info.next()) {
+                columns.insert(info.value(1).toString());
+            }
+        }
+        info.finish();
 
-    const auto normalizedFormat = normalize_export_format(format);
-    if (normalizedFormat.isEmpty()) {
-        emit error(QStringLiteral("Export failed: unsupported format"));
-        return false;
-    }
+        QSqlQuery migration(m_db);
+        if (!columns.contains(QStringLiteral("merged_kind"))) {
+            migration.exec("ALTER TABLE page_conflicts ADD COLUMN merged_kind TEXT NOT NULL DEFAULT ''");
+        }
+        if (!columns.contains(QStringLiteral("merged_content_markdown"))) {
+            migration.exec("ALTER TABLE page_conflicts ADD COLUMN merged_content_markdown TEXT NOT NULL DEFAULT ''");
+        }
+        if (!columns.contains(QStringLiteral("merged_hunks_json"))) {
+            migration.exec("ALTER TABLE page_conflicts ADD COLUMN merged_hunks_json TEXT NOT NULL DEFAULT '[]'");
+        }
 
-    if (!destinationFolder.isValid() || !destinationFolder.isLocalFile()) {
-        emit error(QStringLiteral("Export failed: destination must be a local folder"));
-        return false;
+        migration.exec("PRAGMA user_version = 12");
+        m_db.commit();
+        currentVersion = 12;
     }
 
-    const auto rootPath = QDir(destinationFolder.toLocalFile()).absolutePath();
-    if (rootPath.isEmpty()) {
-        emit error(QStringLiteral("Export failed: invalid destination folder"));
-        return false;
-    }
-    if (!QDir().mkpath(rootPath)) {
-        emit error(QStringLiteral("Export failed: could not create destination folder"));
-        return false;
-    }
+    // Migration 13: 16-byte BLOB ids for pages, blocks and attachments. SQLite can't change
+    // a column's declared type in place, so each table is copied into a staging table with
+    // ids re-encoded through sql_id(), then swapped in. Notebook ids stay TEXT.
+    if (currentVersion < 13) {
+        qDebug() << "DataStore: Running migration to version 13";
+        m_db.transaction();
 
-    const auto resolvedNotebookIds = [&]() -> QStringList {
-        if (!notebookIds.isEmpty()) {
-            QStringList ids;
-            ids.reserve(notebookIds.size());
-            for (const auto& v : notebookIds) {
-                const auto id = v.toString();
-                if (!id.isEmpty()) ids.append(id);
-            }
-            return ids;
-        }
-        const auto notebooks = getAllNotebooks();
-        QStringList ids;
-        ids.reserve(notebooks.size());
-        for (const auto& entry : notebooks) {
-            const auto nb = entry.toMap();
-            const auto id = nb.value(QStringLiteral("notebookId")).toString();
-            if (!id.isEmpty()) ids.append(id);
-        }
-        return ids;
-    }();
+        QSqlQuery migration(m_db);
+        auto execChecked = [&](const QString& sql) -> bool {
+            if (migration.exec(sql)) return true;
+            qWarning() << "DataStore: Migration 13 SQL failed:" << migration.lastError().text()
+                       << "sql=" << sql;
+            return false;
+        };
+
+        auto tableColumns = [&](const QString& table) -> QStringList {
+            QStringList cols;
+            QSqlQuery info(m_db);
+            info.exec(QStringLiteral("PRAGMA table_info(%1)").arg(table));
+            while (info.next()) {
+                cols.append(info.value(1).toString());
+            }
+            info.finish();
+            return cols;
+        };
+
+        const QSet<QString> idColumns{
+            QStringLiteral("id"),
+            QStringLiteral("page_id"),
+            QStringLiteral("parent_id"),
+        };
+
+        auto rebuild = [&](const QString& table) -> bool {
+            const auto staging = table + QStringLiteral("_v13");
+            if (!execChecked(QStringLiteral("DROP TABLE IF EXISTS %1").arg(staging))) return false;
+            if (!execChecked(id_keyed_table_sql(table, staging))) return false;
+
+            const auto oldColumns = tableColumns(table);
+            QStringList columns;
+            for (const auto& col : tableColumns(staging)) {
+                if (oldColumns.contains(col)) columns.append(col);
+            }
+            const auto columnList = columns.join(QStringLiteral(", "));
+            const auto placeholders = QStringList(columns.size(), QStringLiteral("?")).join(QStringLiteral(", "));
+
+            {
+                QSqlQuery select(m_db);
+                if (!select.exec(QStringLiteral("SELECT %1 FROM %2").arg(columnList, table))) {
+                    qWarning() << "DataStore: Migration 13 select failed table=" << table
+                               << ":" << select.lastError().text();
+                    return false;
+                }
+
+                QSqlQuery insert(m_db);
+                insert.prepare(QStringLiteral("INSERT INTO %1 (%2) VALUES (%3)").arg(staging, columnList, placeholders));
+                while (select.next()) {
+                    for (int i = 0; i < columns.size(); ++i) {
+                        const auto value = select.value(i);
+                        const bool encode = idColumns.contains(columns[i]) && !value.isNull();
+                        insert.bindValue(i, encode ? sql_id(value.toString()) : value);
+                    }
+                    if (!insert.exec()) {
+                        qWarning() << "DataStore: Migration 13 insert failed table=" << table
+                                   << ":" << insert.lastError().text();
+                        return false;
+                    }
+                    insert.finish();
+                }
+                select.finish();
+            }
+
+            if (!execChecked(QStringLiteral("DROP TABLE %1").arg(table))) return false;
+            if (!execChecked(QStringLiteral("ALTER TABLE %1 RENAME TO %2").arg(staging, table))) return false;
+            for (const auto& index : id_keyed_table_indexes(table)) {
+                if (!execChecked(index)) return false;
+            }
+            return true;
+        };
+
+        bool ok = true;
+        for (const auto& table : id_keyed_tables()) {
+            ok = ok && rebuild(table);
+        }
+        ok = ok && execChecked(QStringLiteral("PRAGMA user_version = 13"));
+        if (!ok) {
+            qWarning() << "DataStore: Migration 13 failed; rolling back";
+            m_db.rollback();
+            return false;
+        }
+        m_db.commit();
+        currentVersion = 13;
+    }
+
+    qDebug() << "DataStore: Migrations complete. Schema version:" << currentVersion;
+    emit schemaVersionChanged();
+    return true;
+}
+
+namespace {
+
+// Runs fn(i) for every i in [0, count) on the global pool, the calling thread included.
+// Helpers are only taken while the pool has idle threads, so a busy pool means fewer of them
+// rather than a wait.
+template <typename Fn>
+void parallel_for(qsizetype count, Fn&& fn) {
+    if (count <= 0) return;
+    auto* pool = QThreadPool::globalInstance();
+    const auto workers = std::min<qsizetype>(std::max(1, pool->maxThreadCount()), count);
+
+    std::atomic<qsizetype> next{0};
+    const auto work = [&] {
+        for (qsizetype i = next.fetch_add(1, std::memory_order_relaxed); i < count;
+             i = next.fetch_add(1, std::memory_order_relaxed)) {
+            fn(i);
+        }
+    };
+
+    QSemaphore finished;
+    int helpers = 0;
+    for (; helpers + 1 < workers; ++helpers) {
+        if (!pool->tryStart([&] {
+                work();
+                finished.release();
+            })) {
+            break;
+        }
+    }
+    work();
+    finished.acquire(helpers);
+}
+
+// A private read-only connection holding one read transaction, so everything an export reads
+// comes from the same snapshot while the GUI connection keeps writing (the database is in WAL
+// mode, see initialize()). Used on one thread.
+class ReadSnapshot {
+public:
+    explicit ReadSnapshot(const QString& databasePath)
+        : m_name(QStringLiteral("zinc_export_%1").arg(QUuid::createUuid().toString(QUuid::WithoutBraces))) {
+        m_db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), m_name);
+        m_db.setConnectOptions(QStringLiteral("QSQLITE_OPEN_READONLY"));
+        m_db.setDatabaseName(databasePath);
+        m_ok = m_db.open() && m_db.transaction();
+    }
+    ~ReadSnapshot() {
+        if (m_db.isOpen()) {
+            m_db.rollback();
+            m_db.close();
+        }
+        m_db = QSqlDatabase();
+        QSqlDatabase::removeDatabase(m_name);
+    }
+    ReadSnapshot(const ReadSnapshot&) = delete;
+    ReadSnapshot& operator=(const ReadSnapshot&) = delete;
+
+    bool ok() const { return m_ok; }
+    const QSqlDatabase& db() const { return m_db; }
+
+private:
+    QString m_name;
+    QSqlDatabase m_db;
+    bool m_ok = false;
+};
+
+// A private connection that imports pages, one transaction per batch, so the import can run
+// off the GUI thread. Used on one thread.
+class PageBatchWriter {
+public:
+    explicit PageBatchWriter(const QString& databasePath)
+        : m_name(QStringLiteral("zinc_import_%1").arg(QUuid::createUuid().toString(QUuid::WithoutBraces))) {
+        m_db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), m_name);
+        m_db.setDatabaseName(databasePath);
+        if (m_db.open()) {
+            m_upsert = QSqlQuery(m_db);
+            m_ok = m_upsert.prepare(QString::fromLatin1(kUpsertPageSql));
+        }
+    }
+    ~PageBatchWriter() {
+        m_upsert = QSqlQuery();
+        if (m_db.isOpen()) m_db.close();
+        m_db = QSqlDatabase();
+        QSqlDatabase::removeDatabase(m_name);
+    }
+    PageBatchWriter(const PageBatchWriter&) = delete;
+    PageBatchWriter& operator=(const PageBatchWriter&) = delete;
+
+    bool ok() const { return m_ok; }
+    bool begin() { return m_db.transaction(); }
+    bool upsert(const QString& pageId,
+                const QString& notebookId,
+                const QString& title,
+                const QString& parentId,
+                const QString& markdown,
+                int depth,
+                int sortOrder,
+                const QString& updatedAt) {
+        m_upsert.addBindValue(sql_id(pageId));
+        m_upsert.addBindValue(notebookId);
+        m_upsert.addBindValue(normalize_title(title));
+        m_upsert.addBindValue(sql_id(normalize_parent_id(parentId)));
+        m_upsert.addBindValue(markdown);
+        m_upsert.addBindValue(depth);
+        m_upsert.addBindValue(sortOrder);
+        m_upsert.addBindValue(updatedAt);
+        return m_upsert.exec();
+    }
+    bool commit() { return m_db.commit(); }
+    void rollback() { m_db.rollback(); }
+    QString lastError() const { return m_upsert.lastError().text(); }
+
+private:
+    QString m_name;
+    QSqlDatabase m_db;
+    QSqlQuery m_upsert;
+    bool m_ok = false;
+};
+
+// Pages per import transaction; the next batch is parsed while one is written.
+constexpr qsizetype kImportBatchPages = 512;
+
+// Keeps the first failure reported by any worker.
+class FirstError {
+public:
+    void set(const QString& message) {
+        QMutexLocker lock(&m_mutex);
+        if (m_message.isEmpty()) m_message = message;
+    }
+    QString message() const {
+        QMutexLocker lock(&m_mutex);
+        return m_message;
+    }
 
-    const auto extension = (normalizedFormat == QStringLiteral("html")) ? QStringLiteral("html") : QStringLiteral("md");
+private:
+    mutable QMutex m_mutex;
+    QString m_message;
+};
+
+// Streams `srcPath` into `dstPath` in chunks, replacing it atomically and feeding `hash` along
+// the way. Returns the bytes copied, or -1 on failure or cancel.
+qint64 copy_file_atomic(const QString& srcPath,
+                        const QString& dstPath,
+                        const std::atomic<bool>& cancelled,
+                        QCryptographicHash& hash) {
+    QFile src(srcPath);
+    if (!src.open(QIODevice::ReadOnly)) return -1;
+    QSaveFile dst(dstPath);
+    if (!dst.open(QIODevice::WriteOnly)) return -1;
+
+    constexpr qint64 kChunk = qint64{1} << 20;
+    QByteArray buffer(kChunk, Qt::Uninitialized);
+    qint64 copied = 0;
+    for (;;) {
+        if (cancelled.load(std::memory_order_relaxed)) {
+            dst.cancelWriting();
+            return -1;
+        }
+        const auto n = src.read(buffer.data(), kChunk);
+        if (n < 0) return -1;
+        if (n == 0) break;
+        if (dst.write(buffer.constData(), n) != n) return -1;
+        hash.addData(QByteArrayView(buffer.constData(), n));
+        copied += n;
+    }
+    return dst.commit() ? copied : -1;
+}
+
+// Version 2 adds the hashes and sizes incremental exports compare against.
+constexpr int kExportManifestVersion = 2;
+// Part of every page's output hash. Bump it when html_document_for_page or the markdown file
+// layout changes, so the next export rewrites pages whose content did not change.
+constexpr int kExportPageLayoutRevision = 1;
+
+constexpr QLatin1String kExportArchiveFileName("zinc-export.zincpack");
+constexpr QLatin1String kExportArchiveSuffix(".zincpack");
+
+void add_hash_field(QCryptographicHash& hash, QStringView value) {
+    hash.addData(value.toUtf8());
+    hash.addData(QByteArrayView("\0", 1));
+}
+
+QString hash_hex(const QCryptographicHash& hash) {
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+// A page as stored in the database. Restores compare it with the manifest to skip pages that
+// are already there.
+QString export_page_content_hash(const QString& title, const QString& markdown) {
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    add_hash_field(hash, title);
+    add_hash_field(hash, markdown);
+    return hash_hex(hash);
+}
+
+// Everything an exported page file is made from: equal hashes mean an identical file.
+// `linkTargets` is the hash of the notebook's page-to-file map for html pages with page links.
+QString export_page_output_hash(const QString& format,
+                                bool includeAttachments,
+                                const QString& notebookId,
+                                const QString& pageId,
+                                const QString& title,
+                                const QString& markdown,
+                                const QString& linkTargets) {
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    add_hash_field(hash, QString::number(kExportPageLayoutRevision));
+    add_hash_field(hash, format);
+    add_hash_field(hash, includeAttachments ? u"1" : u"0");
+    add_hash_field(hash, notebookId);
+    add_hash_field(hash, pageId);
+    add_hash_field(hash, title);
+    add_hash_field(hash, markdown);
+    add_hash_field(hash, linkTargets);
+    return hash_hex(hash);
+}
+
+QString export_link_targets_hash(const QHash<QString, QString>& pageIdToFileName) {
+    auto pageIds = pageIdToFileName.keys();
+    pageIds.sort();
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    for (const auto& pageId : pageIds) {
+        add_hash_field(hash, pageId);
+        add_hash_field(hash, pageIdToFileName.value(pageId));
+    }
+    return hash_hex(hash);
+}
+
+// A file listed in an earlier export's manifest.
+struct ExportedFile {
+    QString id;
+    QString hash;
+    QString outputHash; // pages
+    QString source;     // attachments: fingerprint of the stored file
+    qint64 size = -1;
+    qint64 mtime = -1;  // ms since epoch, as the export left it
+};
 
-    QSet<QString> usedNotebookDirNames;
+struct PreviousExport {
+    QByteArray manifest;
+    QHash<QString, ExportedFile> pages;       // by relative file path
+    QHash<QString, ExportedFile> attachments; // by relative file path
     QJsonArray notebooksJson;
     QJsonArray pagesJson;
     QJsonArray attachmentsJson;
+};
 
-    for (const auto& notebookId : resolvedNotebookIds) {
-        const auto nb = getNotebook(notebookId);
-        const auto notebookNameRaw = nb.value(QStringLiteral("name")).toString();
-        const auto notebookName = sanitize_export_component(notebookNameRaw).isEmpty()
-            ? QStringLiteral("Notebook")
-            : sanitize_export_component(notebookNameRaw);
-
-        const auto notebookDirName = unique_with_counter_suffix(notebookName, usedNotebookDirNames);
-        usedNotebookDirNames.insert(notebookDirName);
-        const auto notebookDirPath = QDir(rootPath).filePath(notebookDirName);
-        if (!QDir().mkpath(notebookDirPath)) {
-            emit error(QStringLiteral("Export failed: could not create notebook folder"));
-            return false;
+PreviousExport read_previous_export(const QString& rootPath) {
+    PreviousExport previous;
+    QFile f(QDir(rootPath).filePath(QStringLiteral("zinc-export.json")));
+    if (!f.open(QIODevice::ReadOnly | QIODevice::Text)) return previous;
+    previous.manifest = f.readAll();
+
+    const auto manifest = QJsonDocument::fromJson(previous.manifest).object();
+    const auto read = [](const QJsonArray& entries, const QString& idKey, QHash<QString, ExportedFile>& out) {
+        for (const auto& v : entries) {
+            const auto obj = v.toObject();
+            const auto file = obj.value(QStringLiteral("file")).toString();
+            if (file.isEmpty()) continue;
+            out.insert(file, ExportedFile{obj.value(idKey).toString(),
+                                          obj.value(QStringLiteral("hash")).toString(),
+                                          obj.value(QStringLiteral("outputHash")).toString(),
+                                          obj.value(QStringLiteral("source")).toString(),
+                                          obj.value(QStringLiteral("size")).toInteger(-1),
+                                          obj.value(QStringLiteral("mtime")).toInteger(-1)});
         }
+    };
+    previous.notebooksJson = manifest.value(QStringLiteral("notebooks")).toArray();
+    previous.pagesJson = manifest.value(QStringLiteral("pages")).toArray();
+    previous.attachmentsJson = manifest.value(QStringLiteral("attachments")).toArray();
+    read(previous.pagesJson, QStringLiteral("pageId"), previous.pages);
+    read(previous.attachmentsJson, QStringLiteral("attachmentId"), previous.attachments);
+    return previous;
+}
+
+// Whether an earlier export's file is still on disk as it was written.
+bool exported_file_intact(const QString& path, qint64 size, qint64 mtime) {
+    if (size < 0 || mtime < 0) return false;
+    const QFileInfo info(path);
+    return info.isFile() && info.size() == size && info.lastModified().toMSecsSinceEpoch() == mtime;
+}
+
+// The manifest entries of notebooks an earlier export wrote into this folder but the current one
+// does not include; their files stay where they are.
+struct CarriedExport {
+    QSet<QString> folders;
+    QSet<QString> files;
+    QJsonArray notebooksJson;
+    QJsonArray pagesJson;
+    QJsonArray attachmentsJson;
+};
 
-        {
-            QJsonObject nbObj;
-            nbObj.insert(QStringLiteral("notebookId"), notebookId);
-            nbObj.insert(QStringLiteral("name"), notebookNameRaw);
-            nbObj.insert(QStringLiteral("folder"), notebookDirName);
-            notebooksJson.append(nbObj);
+CarriedExport carry_unselected_notebooks(const PreviousExport& previous, const QStringList& selectedNotebookIds) {
+    CarriedExport carried;
+    QSet<QString> notebookIds;
+    for (const auto& v : previous.notebooksJson) {
+        const auto obj = v.toObject();
+        const auto notebookId = obj.value(QStringLiteral("notebookId")).toString();
+        const auto folder = obj.value(QStringLiteral("folder")).toString();
+        if (notebookId.isEmpty() || folder.isEmpty() || selectedNotebookIds.contains(notebookId)) continue;
+        notebookIds.insert(notebookId);
+        carried.folders.insert(folder);
+        carried.notebooksJson.append(obj);
+    }
+    for (const auto& v : previous.pagesJson) {
+        const auto obj = v.toObject();
+        if (!notebookIds.contains(obj.value(QStringLiteral("notebookId")).toString())) continue;
+        carried.files.insert(obj.value(QStringLiteral("file")).toString());
+        carried.pagesJson.append(obj);
+    }
+    // Attachments are copied into each notebook's own folder, so the folder says whose they are.
+    for (const auto& v : previous.attachmentsJson) {
+        const auto obj = v.toObject();
+        const auto file = obj.value(QStringLiteral("file")).toString();
+        if (!carried.folders.contains(file.section(QLatin1Char('/'), 0, 0))) continue;
+        carried.files.insert(file);
+        carried.attachmentsJson.append(obj);
+    }
+    return carried;
+}
+
+// Deletes the files an earlier export wrote that are not in `current`, then the folders that
+// leaves empty.
+void remove_stale_export_files(const QString& rootPath, const PreviousExport& previous, const QSet<QString>& current) {
+    const auto root = QDir::cleanPath(rootPath);
+    const auto removeAll = [&](const QHash<QString, ExportedFile>& files) {
+        for (auto it = files.cbegin(); it != files.cend(); ++it) {
+            if (current.contains(it.key())) continue;
+            const auto abs = safe_resolve_export_relative_path(rootPath, it.key());
+            if (abs.isEmpty() || !QFile::remove(abs)) continue;
+            for (auto dir = QFileInfo(abs).absolutePath();
+                 dir.startsWith(root + QLatin1Char('/')) && QDir().rmdir(dir);
+                 dir = QFileInfo(dir).absolutePath()) {
+            }
         }
+    };
+    removeAll(previous.pages);
+    removeAll(previous.attachments);
+}
 
-        QSqlQuery q(m_db);
+constexpr qsizetype kExportRenderChunk = 256;
+
+} // namespace
+
+bool DataStore::exportNotebooks(const QVariantList& notebookIds,
+                                const QUrl& destinationFolder,
+                                const QString& format) {
+    return exportNotebooks(notebookIds, destinationFolder, format, false);
+}
+
+bool DataStore::exportNotebooks(const QVariantList& notebookIds,
+                                const QUrl& destinationFolder,
+                                const QString& format,
+                                bool includeAttachments) {
+    const auto request = prepareExport(notebookIds, destinationFolder, format, includeAttachments);
+    if (!request) return false;
+
+    const std::atomic<bool> cancelled{false};
+    const auto failure = runExport(m_db.databaseName(), *request, cancelled, {});
+    if (!failure.isEmpty()) {
+        emit error(failure);
+        return false;
+    }
+    return true;
+}
+
+bool DataStore::startExportNotebooks(const QVariantList& notebookIds,
+                                     const QUrl& destinationFolder,
+                                     const QString& format,
+                                     bool includeAttachments) {
+    if (m_exportCancel) {
+        emit error(QStringLiteral("Export failed: an export is already running"));
+        return false;
+    }
+    const auto request = prepareExport(notebookIds, destinationFolder, format, includeAttachments);
+    if (!request) return false;
+
+    // The export runs on the pool with its own connection; progress and the result come back
+    // through the watcher, which is our child, so nothing arrives after destruction.
+    auto cancel = std::make_shared<std::atomic<bool>>(false);
+    m_exportCancel = cancel;
+    emit exportingChanged();
+
+    auto promise = std::make_shared<QPromise<QString>>();
+    auto* watcher = new QFutureWatcher<QString>(this);
+    connect(watcher, &QFutureWatcher<QString>::progressValueChanged, this, [this, watcher](int done) {
+        emit exportProgress(done, watcher->progressMaximum());
+    });
+    connect(watcher, &QFutureWatcher<QString>::finished, this, [this, watcher, cancel]() {
+        watcher->deleteLater();
+        const auto failure = watcher->future().resultCount() > 0 ? watcher->result()
+                                                                 : QStringLiteral("Export failed");
+        m_exportCancel.reset();
+        emit exportingChanged();
+        if (!failure.isEmpty() && !cancel->load()) emit error(failure);
+        emit exportFinished(failure.isEmpty(), failure);
+    });
+    watcher->setFuture(promise->future());
+    promise->start();
+
+    QThreadPool::globalInstance()->start([promise, cancel, job = *request, databasePath = m_db.databaseName()]() {
+        const auto progress = [&promise](int done, int total) {
+            promise->setProgressRange(0, total);
+            promise->setProgressValue(done);
+        };
+        promise->addResult(runExport(databasePath, job, *cancel, progress));
+        promise->finish();
+    });
+    return true;
+}
+
+void DataStore::cancelExport() {
+    if (m_exportCancel) {
+        m_exportCancel->store(true);
+    }
+}
+
+bool DataStore::isExporting() const {
+    return m_exportCancel != nullptr;
+}
+
+std::optional<DataStore::ExportRequest> DataStore::prepareExport(const QVariantList& notebookIds,
+                                                                 const QUrl& destinationFolder,
+                                                                 const QString& format,
+                                                                 bool includeAttachments) {
+    if (!m_ready) {
+        emit error(QStringLiteral("Export failed: database not initialized"));
+        return std::nullopt;
+    }
+
+    ExportRequest request;
+    request.includeAttachments = includeAttachments;
+    request.format = normalize_export_format(format);
+    if (request.format.isEmpty()) {
+        emit error(QStringLiteral("Export failed: unsupported format"));
+        return std::nullopt;
+    }
+
+    if (!destinationFolder.isValid() || !destinationFolder.isLocalFile()) {
+        emit error(QStringLiteral("Export failed: destination must be a local folder"));
+        return std::nullopt;
+    }
+
+    request.rootPath = QDir(destinationFolder.toLocalFile()).absolutePath();
+    if (request.format == QStringLiteral("archive")) {
+        if (request.rootPath.endsWith(kExportArchiveSuffix, Qt::CaseInsensitive)) {
+            request.archivePath = request.rootPath;
+            request.rootPath = QFileInfo(request.archivePath).absolutePath();
+        } else {
+            request.archivePath = QDir(request.rootPath).filePath(kExportArchiveFileName);
+        }
+    }
+    if (request.rootPath.isEmpty()) {
+        emit error(QStringLiteral("Export failed: invalid destination folder"));
+        return std::nullopt;
+    }
+    if (!QDir().mkpath(request.rootPath)) {
+        emit error(QStringLiteral("Export failed: could not create destination folder"));
+        return std::nullopt;
+    }
+
+    if (!notebookIds.isEmpty()) {
+        request.notebookIds.reserve(notebookIds.size());
+        for (const auto& v : notebookIds) {
+            const auto id = v.toString();
+            if (!id.isEmpty()) request.notebookIds.append(id);
+        }
+    } else {
+        const auto notebooks = getAllNotebooks();
+        request.notebookIds.reserve(notebooks.size());
+        for (const auto& entry : notebooks) {
+            const auto nb = entry.toMap();
+            const auto id = nb.value(QStringLiteral("notebookId")).toString();
+            if (!id.isEmpty()) request.notebookIds.append(id);
+        }
+    }
+    return request;
+}
+
+QString DataStore::runExport(const QString& databasePath,
+                             const ExportRequest& request,
+                             const std::atomic<bool>& cancelled,
+                             const std::function<void(int, int)>& progress) {
+    const bool html = request.format == QStringLiteral("html");
+    // An archive holds the markdown tree's pages and attachments as entries of one file.
+    const bool archive = request.format == QStringLiteral("archive");
+    const auto extension = html ? QStringLiteral("html") : QStringLiteral("md");
+    const auto cancelledError = QStringLiteral("Export cancelled");
+
+    struct NotebookOut {
+        QString notebookId;
+        QString dirName;
+        QString dirPath;
+        QSet<QString> attachmentIds;
+        QHash<QString, QString> attachmentIdToRelativePath;
+        QHash<QString, QString> pageIdToFileName;
+        QString linkTargetsHash;
+    };
+    struct PageRow {
+        QString pageId;
+        QString title;
+        QString markdown;
+        int sortOrder = 0;
+        qsizetype notebook = 0;
+        QString relativePath;
+        QString filePath;
+        QString hash;
+        QString outputHash;
+        qint64 offset = -1; // archive only
+        qint64 size = -1;
+        qint64 mtime = -1;
+        bool write = true;
+    };
+    struct AttachmentSource {
+        QString mime;
+        QString path;
+        QString updatedAt;
+    };
+    struct AttachmentCopy {
+        QString attachmentId;
+        QString mime;
+        QString updatedAt;
+        QString sourcePath;
+        QString relativePath;
+        QString destinationPath;
+        QString source;
+        QString hash;
+        qint64 offset = -1; // archive only
+        qint64 size = -1;
+        qint64 mtime = -1;
+    };
+
+    std::vector<NotebookOut> notebooks;
+    notebooks.reserve(static_cast<size_t>(request.notebookIds.size()));
+    QList<PageRow> pages;
+    QHash<QString, AttachmentSource> attachmentSources;
+
+    // What an earlier export left here; files it wrote that are still current are kept as they
+    // are, and notebooks it wrote that are not selected now keep their folders.
+    const auto previous = archive ? PreviousExport{} : read_previous_export(request.rootPath);
+    const auto carried = carry_unselected_notebooks(previous, request.notebookIds);
+
+    QSet<QString> usedNotebookDirNames = carried.folders;
+    QJsonArray notebooksJson;
+
+    // Read everything from one snapshot, then let the GUI connection have the file back.
+    {
+        ReadSnapshot snapshot(databasePath);
+        if (!snapshot.ok()) {
+            return QStringLiteral("Export failed: could not open database");
+        }
+
+        QSqlQuery nb(snapshot.db());
+        nb.prepare(QStringLiteral("SELECT name FROM notebooks WHERE id = ?"));
+        QSqlQuery q(snapshot.db());
         q.prepare(R"SQL(
             SELECT id, title, content_markdown, sort_order, created_at
             FROM pages
             WHERE notebook_id = ?
             ORDER BY sort_order, created_at
         )SQL");
-        q.addBindValue(notebookId);
-        if (!q.exec()) {
-            emit error(QStringLiteral("Export failed: could not query pages"));
-            return false;
-        }
 
-        struct PageRow {
-            QString pageId;
-            QString title;
-            QString markdown;
-            int sortOrder = 0;
-        };
+        for (const auto& notebookId : request.notebookIds) {
+            if (cancelled) return cancelledError;
+
+            nb.bindValue(0, notebookId);
+            const auto notebookNameRaw = (nb.exec() && nb.next()) ? nb.value(0).toString() : QString();
+            nb.finish();
+            const auto notebookName = sanitize_export_component(notebookNameRaw).isEmpty()
+                ? QStringLiteral("Notebook")
+                : sanitize_export_component(notebookNameRaw);
+
+            NotebookOut out;
+            out.notebookId = notebookId;
+            out.dirName = unique_with_counter_suffix(notebookName, usedNotebookDirNames);
+            usedNotebookDirNames.insert(out.dirName);
+            out.dirPath = QDir(request.rootPath).filePath(out.dirName);
+            if (!archive && !QDir().mkpath(out.dirPath)) {
+                return QStringLiteral("Export failed: could not create notebook folder");
+            }
 
-        QList<PageRow> pages;
-        QSet<QString> attachmentIds;
+            {
+                QJsonObject nbObj;
+                nbObj.insert(QStringLiteral("notebookId"), notebookId);
+                nbObj.insert(QStringLiteral("name"), notebookNameRaw);
+                nbObj.insert(QStringLiteral("folder"), out.dirName);
+                notebooksJson.append(nbObj);
+            }
 
-        while (q.next()) {
-            PageRow row;
-            row.pageId = q.value(0).toString();
-            row.title = normalize_title(q.value(1));
-            row.markdown = q.value(2).toString();
-            row.sortOrder = q.value(3).toInt();
-            pages.append(row);
-            if (includeAttachments) {
-                attachmentIds.unite(collect_attachment_ids_from_markdown(row.markdown));
+            q.bindValue(0, notebookId);
+            if (!q.exec()) {
+                return QStringLiteral("Export failed: could not query pages");
             }
+            while (q.next()) {
+                PageRow row;
+                row.pageId = id_from_sql(q.value(0));
+                row.title = normalize_title(q.value(1));
+                row.markdown = q.value(2).toString();
+                row.sortOrder = q.value(3).toInt();
+                row.notebook = static_cast<qsizetype>(notebooks.size());
+                pages.append(std::move(row));
+            }
+            q.finish();
+            notebooks.push_back(std::move(out));
         }
 
-        QHash<QString, QString> attachmentIdToRelativePath;
-        if (includeAttachments && !attachmentIds.isEmpty()) {
-            const auto attachmentsDirPath = QDir(notebookDirPath).filePath(QStringLiteral("attachments"));
-            if (!QDir().mkpath(attachmentsDirPath)) {
-                emit error(QStringLiteral("Export failed: could not create attachments folder"));
-                return false;
+        if (request.includeAttachments) {
+            std::vector<QSet<QString>> referenced(static_cast<size_t>(pages.size()));
+            parallel_for(pages.size(), [&](qsizetype i) {
+                referenced[static_cast<size_t>(i)] = collect_attachment_ids_from_markdown(pages.at(i).markdown);
+            });
+            for (qsizetype i = 0; i < pages.size(); ++i) {
+                notebooks[static_cast<size_t>(pages.at(i).notebook)].attachmentIds.unite(referenced[static_cast<size_t>(i)]);
             }
 
-            QSqlQuery a(m_db);
-            a.prepare(QStringLiteral("SELECT mime_type, file_name FROM attachments WHERE id = ?"));
-
-            for (const auto& attachmentId : attachmentIds) {
-                a.bindValue(0, attachmentId);
-                if (!a.exec() || !a.next()) {
-                    emit error(QStringLiteral("Export failed: missing attachment %1").arg(attachmentId));
-                    return false;
-                }
-                const auto mime = a.value(0).toString();
-                const auto fileName = a.value(1).toString().isEmpty() ? attachmentId : a.value(1).toString();
-
-                const auto srcPath = attachment_file_path_for_id(fileName);
-                const auto bytes = read_file_bytes(srcPath);
-                if (!bytes || bytes->isEmpty()) {
-                    emit error(QStringLiteral("Export failed: missing attachment file %1").arg(attachmentId));
-                    return false;
+            // One lookup per attachment, however many notebooks use it.
+            QSqlQuery a(snapshot.db());
+            a.prepare(QStringLiteral("SELECT mime_type, file_name, updated_at FROM attachments WHERE id = ?"));
+            for (const auto& notebook : notebooks) {
+                for (const auto& attachmentId : notebook.attachmentIds) {
+                    if (attachmentSources.contains(attachmentId)) continue;
+                    a.bindValue(0, sql_id(attachmentId));
+                    if (!a.exec() || !a.next()) {
+                        return QStringLiteral("Export failed: missing attachment %1").arg(attachmentId);
+                    }
+                    const auto fileName = a.value(1).toString().isEmpty() ? attachmentId : a.value(1).toString();
+                    attachmentSources.insert(attachmentId,
+                                             AttachmentSource{a.value(0).toString(),
+                                                              attachment_file_path_for_id(fileName),
+                                                              a.value(2).toString()});
+                    a.finish();
                 }
+            }
+        }
+    }
 
-                const auto ext = attachment_extension_for_mime(mime);
-                const auto outFileName = attachmentId + QLatin1Char('.') + ext;
-                const auto dstPath = QDir(attachmentsDirPath).filePath(outFileName);
-                if (!write_bytes_atomic(dstPath, *bytes)) {
-                    emit error(QStringLiteral("Export failed: could not write attachment %1").arg(attachmentId));
-                    return false;
-                }
+    std::vector<AttachmentCopy> copies;
+    for (auto& notebook : notebooks) {
+        if (notebook.attachmentIds.isEmpty()) continue;
+        const auto attachmentsDirPath = QDir(notebook.dirPath).filePath(QStringLiteral("attachments"));
+        if (!archive && !QDir().mkpath(attachmentsDirPath)) {
+            return QStringLiteral("Export failed: could not create attachments folder");
+        }
+        // Sorted, so an unchanged workspace produces an identical manifest.
+        auto attachmentIds = notebook.attachmentIds.values();
+        attachmentIds.sort();
+        for (const auto& attachmentId : attachmentIds) {
+            const auto source = attachmentSources.value(attachmentId);
+            const auto outFileName = attachmentId + QLatin1Char('.') + attachment_extension_for_mime(source.mime);
+            AttachmentCopy copy;
+            copy.attachmentId = attachmentId;
+            copy.mime = source.mime;
+            copy.updatedAt = source.updatedAt;
+            copy.sourcePath = source.path;
+            copy.relativePath = notebook.dirName + QStringLiteral("/attachments/") + outFileName;
+            copy.destinationPath = QDir(attachmentsDirPath).filePath(outFileName);
+            copies.push_back(std::move(copy));
+            notebook.attachmentIdToRelativePath.insert(attachmentId, QStringLiteral("attachments/%1").arg(outFileName));
+        }
+    }
 
-                attachmentIdToRelativePath.insert(attachmentId, QStringLiteral("attachments/%1").arg(outFileName));
-                {
-                    QJsonObject aObj;
-                    aObj.insert(QStringLiteral("attachmentId"), attachmentId);
-                    aObj.insert(QStringLiteral("mimeType"), mime);
-                    aObj.insert(QStringLiteral("file"), notebookDirName + QStringLiteral("/attachments/") + outFileName);
-                    attachmentsJson.append(aObj);
-                }
-                a.finish();
+    {
+        QSet<QString> usedFileNames;
+        qsizetype currentNotebook = -1;
+        for (auto& row : pages) {
+            auto& notebook = notebooks[static_cast<size_t>(row.notebook)];
+            if (row.notebook != currentNotebook) {
+                currentNotebook = row.notebook;
+                usedFileNames.clear();
+            }
+            const auto fileTitle = sanitize_export_component(row.title).isEmpty()
+                ? QStringLiteral("Untitled")
+                : sanitize_export_component(row.title);
+            const auto fileName = unique_file_name_for_stem(fileTitle, extension, usedFileNames);
+            usedFileNames.insert(fileName);
+            notebook.pageIdToFileName.insert(row.pageId, fileName);
+            row.relativePath = notebook.dirName + QLatin1Char('/') + fileName;
+            row.filePath = QDir(notebook.dirPath).filePath(fileName);
+        }
+        if (html) {
+            for (auto& notebook : notebooks) {
+                notebook.linkTargetsHash = export_link_targets_hash(notebook.pageIdToFileName);
             }
         }
+    }
 
-        const auto pageIdToFileName = [&]() -> QHash<QString, QString> {
-            QHash<QString, QString> out;
-            out.reserve(pages.size());
-            QSet<QString> usedFileNames;
-            for (const auto& row : pages) {
-                const auto pageId = row.pageId;
-                const auto title = row.title;
-                const auto fileTitle = sanitize_export_component(title).isEmpty()
-                    ? QStringLiteral("Untitled")
-                    : sanitize_export_component(title);
-                const auto fileName = unique_file_name_for_stem(fileTitle, extension, usedFileNames);
-                usedFileNames.insert(fileName);
-                out.insert(pageId, fileName);
-
-                QJsonObject pObj;
-                pObj.insert(QStringLiteral("pageId"), pageId);
-                pObj.insert(QStringLiteral("notebookId"), notebookId);
-                pObj.insert(QStringLiteral("title"), title);
-                pObj.insert(QStringLiteral("sortOrder"), row.sortOrder);
-                pObj.insert(QStringLiteral("file"), notebookDirName + QLatin1Char('/') + fileName);
-                pagesJson.append(pObj);
+    const int total = static_cast<int>(pages.size() + static_cast<qsizetype>(copies.size()));
+    std::atomic<int> done{0};
+    const auto tick = [&] {
+        const int d = done.fetch_add(1, std::memory_order_relaxed) + 1;
+        if (progress) progress(d, total);
+    };
+    FirstError failure;
+
+    // An attachment is copied unless the previous export has the same stored file at the same
+    // path; the fingerprint stands in for its content so unchanged files are not re-read.
+    parallel_for(archive ? 0 : static_cast<qsizetype>(copies.size()), [&](qsizetype i) {
+        if (cancelled) return;
+        auto& copy = copies[static_cast<size_t>(i)];
+        const QFileInfo source(copy.sourcePath);
+        if (!source.isFile() || source.size() <= 0) {
+            failure.set(QStringLiteral("Export failed: missing attachment file %1").arg(copy.attachmentId));
+            tick();
+            return;
+        }
+        copy.source = QStringLiteral("%1|%2|%3")
+                          .arg(copy.updatedAt)
+                          .arg(source.size())
+                          .arg(source.lastModified().toMSecsSinceEpoch());
+
+        const auto prev = previous.attachments.constFind(copy.relativePath);
+        if (prev != previous.attachments.cend() && prev->id == copy.attachmentId && prev->source == copy.source &&
+            !prev->hash.isEmpty() && exported_file_intact(copy.destinationPath, prev->size, prev->mtime)) {
+            copy.hash = prev->hash;
+            copy.size = prev->size;
+            copy.mtime = prev->mtime;
+        } else {
+            QCryptographicHash hash(QCryptographicHash::Sha256);
+            copy.size = copy_file_atomic(copy.sourcePath, copy.destinationPath, cancelled, hash);
+            if (copy.size >= 0) {
+                copy.hash = hash_hex(hash);
+                copy.mtime = QFileInfo(copy.destinationPath).lastModified().toMSecsSinceEpoch();
+            } else if (!cancelled) {
+                failure.set(QStringLiteral("Export failed: could not write attachment %1").arg(copy.attachmentId));
             }
-            return out;
-        }();
-
-        for (const auto& row : pages) {
-            const auto pageId = row.pageId;
-            const auto title = row.title;
-            const auto markdown = includeAttachments
-                ? rewrite_attachment_urls_in_markdown(row.markdown, attachmentIdToRelativePath)
-                : row.markdown;
-
-            const auto fileName = pageIdToFileName.value(pageId);
-            const auto filePath = QDir(notebookDirPath).filePath(fileName);
-
-            const auto payload = (normalizedFormat == QStringLiteral("html"))
-                ? html_document_for_page(title, markdown, pageId, notebookId, pageIdToFileName)
-                : (markdown.endsWith(QLatin1Char('\n')) ? markdown : (markdown + QLatin1Char('\n')));
+        }
+        tick();
+    });
+    if (cancelled) return cancelledError;
+    if (const auto message = failure.message(); !message.isEmpty()) return message;
+
+    // Attachment links point into each notebook's own attachments folder. A page is written
+    // unless the previous export has a file with the same output hash at the same path.
+    PageRow* rows = pages.data();
+    QStringList markdowns;
+    markdowns.resize(pages.size());
+    QString* rewritten = markdowns.data();
+    parallel_for(pages.size(), [&](qsizetype i) {
+        auto& row = rows[i];
+        const auto& notebook = notebooks[static_cast<size_t>(row.notebook)];
+        rewritten[i] = request.includeAttachments
+            ? rewrite_attachment_urls_in_markdown(row.markdown, notebook.attachmentIdToRelativePath)
+            : row.markdown;
+
+        row.hash = export_page_content_hash(row.title, row.markdown);
+        const bool linksPages = html && rewritten[i].contains(QStringLiteral("zinc://page/"));
+        row.outputHash = export_page_output_hash(request.format, request.includeAttachments, notebook.notebookId,
+                                                 row.pageId, row.title, rewritten[i],
+                                                 linksPages ? notebook.linkTargetsHash : QString());
+        const auto prev = previous.pages.constFind(row.relativePath);
+        if (prev != previous.pages.cend() && prev->id == row.pageId && prev->outputHash == row.outputHash &&
+            exported_file_intact(row.filePath, prev->size, prev->mtime)) {
+            row.size = prev->size;
+            row.mtime = prev->mtime;
+            row.write = false;
+            tick();
+        }
+    });
+
+    std::vector<qsizetype> pending;
+    for (qsizetype i = 0; i < pages.size(); ++i) {
+        if (rows[i].write) pending.push_back(i);
+    }
+    const auto pendingCount = static_cast<qsizetype>(pending.size());
+
+    const auto writePage = [&](qsizetype i, const QString& payload) {
+        auto& row = rows[i];
+        QString err;
+        if (write_text_file(row.filePath, payload, &err)) {
+            const QFileInfo info(row.filePath);
+            row.size = info.size();
+            row.mtime = info.lastModified().toMSecsSinceEpoch();
+        } else {
+            failure.set(QStringLiteral("Export failed: %1").arg(err));
+        }
+        tick();
+    };
 
-            QString err;
-            if (!write_text_file(filePath, payload, &err)) {
-                emit error(QStringLiteral("Export failed: %1").arg(err));
-                return false;
+    std::optional<ExportArchiveWriter> writer;
+    if (archive) {
+        // One sequential pass: attachments, then pages, then the table of contents.
+        writer.emplace(request.archivePath);
+        if (!writer->open()) {
+            return QStringLiteral("Export failed: %1").arg(writer->errorString());
+        }
+        for (auto& copy : copies) {
+            if (cancelled) break;
+            if (!QFileInfo(copy.sourcePath).isFile()) {
+                failure.set(QStringLiteral("Export failed: missing attachment file %1").arg(copy.attachmentId));
+                break;
+            }
+            QCryptographicHash hash(QCryptographicHash::Sha256);
+            copy.offset = writer->appendFile(copy.sourcePath, cancelled, hash, copy.size);
+            if (copy.offset < 0) {
+                if (!cancelled) failure.set(QStringLiteral("Export failed: could not write attachment %1").arg(copy.attachmentId));
+                break;
             }
+            copy.hash = hash_hex(hash);
+            tick();
+        }
+        for (qsizetype i = 0; i < pages.size() && !cancelled && failure.message().isEmpty(); ++i) {
+            auto& row = rows[i];
+            const auto& markdown = markdowns.at(i);
+            const auto bytes = (markdown.endsWith(QLatin1Char('\n')) ? markdown : (markdown + QLatin1Char('\n'))).toUtf8();
+            row.offset = writer->append(bytes);
+            if (row.offset < 0) {
+                failure.set(QStringLiteral("Export failed: %1").arg(writer->errorString()));
+                break;
+            }
+            row.size = bytes.size();
+            tick();
+        }
+        if (cancelled || !failure.message().isEmpty()) writer->cancel();
+    } else if (html) {
+        // Rendered in chunks so a cancel is noticed without waiting for the whole workspace.
+        for (qsizetype from = 0; from < pendingCount && !cancelled; from += kExportRenderChunk) {
+            const auto to = std::min(from + kExportRenderChunk, pendingCount);
+            QStringList chunk;
+            chunk.reserve(to - from);
+            for (auto k = from; k < to; ++k) {
+                chunk.append(markdowns.at(pending[static_cast<size_t>(k)]));
+            }
+            Cmark::renderBatch(chunk, [&](qsizetype index, QStringView body) {
+                const auto i = pending[static_cast<size_t>(from + index)];
+                const auto& row = rows[i];
+                const auto& notebook = notebooks[static_cast<size_t>(row.notebook)];
+                writePage(i, html_document_for_page(row.title, markdowns.at(i), body, row.pageId,
+                                                    notebook.notebookId, notebook.pageIdToFileName));
+            });
         }
+    } else {
+        parallel_for(pendingCount, [&](qsizetype k) {
+            if (cancelled) return;
+            const auto i = pending[static_cast<size_t>(k)];
+            const auto& markdown = markdowns.at(i);
+            writePage(i, markdown.endsWith(QLatin1Char('\n')) ? markdown : (markdown + QLatin1Char('\n')));
+        });
+    }
+    if (cancelled) return cancelledError;
+    if (const auto message = failure.message(); !message.isEmpty()) return message;
+
+    QSet<QString> currentFiles;
+    currentFiles.reserve(pages.size() + static_cast<qsizetype>(copies.size()));
+    QJsonArray pagesJson;
+    for (const auto& row : std::as_const(pages)) {
+        currentFiles.insert(row.relativePath);
+        QJsonObject pObj;
+        pObj.insert(QStringLiteral("pageId"), row.pageId);
+        pObj.insert(QStringLiteral("notebookId"), notebooks[static_cast<size_t>(row.notebook)].notebookId);
+        pObj.insert(QStringLiteral("title"), row.title);
+        pObj.insert(QStringLiteral("sortOrder"), row.sortOrder);
+        pObj.insert(QStringLiteral("file"), row.relativePath);
+        pObj.insert(QStringLiteral("hash"), row.hash);
+        pObj.insert(QStringLiteral("outputHash"), row.outputHash);
+        pObj.insert(QStringLiteral("size"), row.size);
+        if (archive) {
+            pObj.insert(QStringLiteral("offset"), row.offset);
+            pObj.insert(QStringLiteral("length"), row.size);
+        } else {
+            pObj.insert(QStringLiteral("mtime"), row.mtime);
+        }
+        pagesJson.append(pObj);
+    }
+    QJsonArray attachmentsJson;
+    for (const auto& copy : copies) {
+        currentFiles.insert(copy.relativePath);
+        QJsonObject aObj;
+        aObj.insert(QStringLiteral("attachmentId"), copy.attachmentId);
+        aObj.insert(QStringLiteral("mimeType"), copy.mime);
+        aObj.insert(QStringLiteral("file"), copy.relativePath);
+        aObj.insert(QStringLiteral("hash"), copy.hash);
+        aObj.insert(QStringLiteral("source"), copy.source);
+        aObj.insert(QStringLiteral("size"), copy.size);
+        if (archive) {
+            aObj.insert(QStringLiteral("offset"), copy.offset);
+            aObj.insert(QStringLiteral("length"), copy.size);
+        } else {
+            aObj.insert(QStringLiteral("mtime"), copy.mtime);
+        }
+        attachmentsJson.append(aObj);
+    }
+
+    if (!archive) {
+        for (const auto& v : carried.notebooksJson) notebooksJson.append(v);
+        for (const auto& v : carried.pagesJson) pagesJson.append(v);
+        for (const auto& v : carried.attachmentsJson) attachmentsJson.append(v);
+        remove_stale_export_files(request.rootPath, previous, currentFiles | carried.files);
     }
 
     {
         QJsonObject manifest;
-        manifest.insert(QStringLiteral("version"), 1);
-        manifest.insert(QStringLiteral("format"), normalizedFormat);
-        manifest.insert(QStringLiteral("includeAttachments"), includeAttachments);
+        manifest.insert(QStringLiteral("version"), kExportManifestVersion);
+        manifest.insert(QStringLiteral("format"), request.format);
+        manifest.insert(QStringLiteral("includeAttachments"), request.includeAttachments);
         manifest.insert(QStringLiteral("notebooks"), notebooksJson);
         manifest.insert(QStringLiteral("pages"), pagesJson);
         manifest.insert(QStringLiteral("attachments"), attachmentsJson);
 
-        const auto outPath = QDir(rootPath).filePath(QStringLiteral("zinc-export.json"));
+        if (archive) {
+            if (!writer->finish(manifest)) {
+                return QStringLiteral("Export failed: %1").arg(writer->errorString());
+            }
+            return {};
+        }
+
         const auto bytes = QJsonDocument(manifest).toJson(QJsonDocument::Indented);
-        QString err;
-        if (!write_text_file(outPath, QString::fromUtf8(bytes), &err)) {
-            emit error(QStringLiteral("Export failed: %1").arg(err));
-            return false;
+        if (bytes != previous.manifest) {
+            const auto outPath = QDir(request.rootPath).filePath(QStringLiteral("zinc-export.json"));
+            QString err;
+            if (!write_text_file(outPath, QString::fromUtf8(bytes), &err)) {
+                return QStringLiteral("Export failed: %1").arg(err);
+            }
         }
     }
 
-    return true;
+    return {};
 }
 
-bool DataStore::importNotebooks(const QUrl& sourceFolder,
-                                const QString& format,
-                                bool replaceExisting) {
+std::optional<DataStore::ImportPlan> DataStore::prepareImport(const QUrl& sourceFolder,
+                                                             const QString& format,
+                                                             bool replaceExisting) {
     if (!m_ready) {
         emit error(QStringLiteral("Import failed: database not initialized"));
-        return false;
+        return std::nullopt;
     }
 
     const auto normalizedFormat = normalize_import_format(format);
     if (normalizedFormat.isEmpty()) {
         emit error(QStringLiteral("Import failed: unsupported format"));
-        return false;
+        return std::nullopt;
     }
 
     if (!sourceFolder.isValid() || !sourceFolder.isLocalFile()) {
         emit error(QStringLiteral("Import failed: source must be a local folder"));
-        return false;
+        return std::nullopt;
     }
 
     const auto rootPath = QDir(sourceFolder.toLocalFile()).absolutePath();
     if (rootPath.isEmpty()) {
         emit error(QStringLiteral("Import failed: invalid source folder"));
-        return false;
+        return std::nullopt;
     }
-    if (!QDir(rootPath).exists()) {
+
+    QFile manifestFile(QDir(rootPath).filePath(QStringLiteral("zinc-export.json")));
+
+    // An archive is a single file, chosen directly or found in the chosen folder.
+    const QFileInfo sourceInfo(rootPath);
+    const auto archivePath = sourceInfo.isFile() ? rootPath : QDir(rootPath).filePath(kExportArchiveFileName);
+    const bool fromArchive = normalizedFormat == QStringLiteral("archive") ||
+        (normalizedFormat == QStringLiteral("auto") &&
+         (sourceInfo.isFile() || (!manifestFile.exists() && QFileInfo(archivePath).isFile())));
+    std::shared_ptr<ExportArchiveReader> archive;
+    if (fromArchive) {
+        archive = std::make_shared<ExportArchiveReader>();
+        if (!archive->open(archivePath)) {
+            emit error(QStringLiteral("Import failed: could not read archive"));
+            return std::nullopt;
+        }
+    } else if (!sourceInfo.isDir()) {
         emit error(QStringLiteral("Import failed: source folder does not exist"));
-        return false;
+        return std::nullopt;
     }
 
-    QFile manifestFile(QDir(rootPath).filePath(QStringLiteral("zinc-export.json")));
     QJsonObject manifest;
-    if (manifestFile.exists()) {
+    if (fromArchive) {
+        manifest = archive->toc();
+    } else if (manifestFile.exists()) {
         if (!manifestFile.open(QIODevice::ReadOnly)) {
             emit error(QStringLiteral("Import failed: could not read zinc-export.json"));
-            return false;
+            return std::nullopt;
         }
         const auto doc = QJsonDocument::fromJson(manifestFile.readAll());
         if (!doc.isObject()) {
             emit error(QStringLiteral("Import failed: invalid zinc-export.json"));
-            return false;
+            return std::nullopt;
         }
         manifest = doc.object();
     } else if (normalizedFormat == QStringLiteral("auto")) {
         emit error(QStringLiteral("Import failed: missing zinc-export.json"));
-        return false;
+        return std::nullopt;
     }
 
     const auto manifestFormat = manifest.value(QStringLiteral("format")).toString().trimmed().toLower();
@@ -4830,44 +5906,53 @@ bool DataStore::importNotebooks(const QUrl& sourceFolder,
     }();
     if (resolvedFormat.isEmpty()) {
         emit error(QStringLiteral("Import failed: could not determine format"));
-        return false;
+        return std::nullopt;
+    }
+
+    ImportPlan plan;
+    plan.files = resolvedFormat == QStringLiteral("html") ? ImportPlan::Files::ZincHtml
+                                                          : ImportPlan::Files::Markdown;
+    plan.archive = archive;
+
+    // A restore keeps the pages the database still holds exactly as exported, rather than
+    // reading (and for html, extracting) their files again.
+    const bool hasManifest = fromArchive || manifestFile.exists();
+    QHash<QString, QString> unchangedMarkdown;
+    if (replaceExisting && hasManifest) {
+        QHash<QString, QString> exportedHashes;
+        for (const auto& v : manifest.value(QStringLiteral("pages")).toArray()) {
+            const auto obj = v.toObject();
+            const auto hash = obj.value(QStringLiteral("hash")).toString();
+            if (!hash.isEmpty()) exportedHashes.insert(obj.value(QStringLiteral("pageId")).toString(), hash);
+        }
+        if (!exportedHashes.isEmpty()) {
+            QSqlQuery q(m_db);
+            if (q.exec(QStringLiteral("SELECT id, title, content_markdown FROM pages"))) {
+                while (q.next()) {
+                    const auto it = exportedHashes.constFind(id_from_sql(q.value(0)));
+                    if (it == exportedHashes.cend()) continue;
+                    auto markdown = q.value(2).toString();
+                    if (export_page_content_hash(normalize_title(q.value(1)), markdown) == *it) {
+                        unchangedMarkdown.insert(it.key(), std::move(markdown));
+                    }
+                }
+            }
+        }
     }
 
     if (replaceExisting) {
+        if (!backUpForRestore()) {
+            emit error(QStringLiteral("Import failed: could not back up the current data"));
+            return std::nullopt;
+        }
         if (!resetDatabase()) {
             emit error(QStringLiteral("Import failed: could not reset database"));
-            return false;
+            return std::nullopt;
         }
     }
 
     const auto now = now_timestamp_utc();
 
-    struct ReadPageMarkdownResult {
-        bool ok = false;
-        bool missingEmbeddedMarkdown = false;
-        QString markdown;
-    };
-
-    const auto read_markdown_from_file = [&](const QString& absPath) -> ReadPageMarkdownResult {
-        QFile f(absPath);
-        if (!f.open(QIODevice::ReadOnly | QIODevice::Text)) {
-            return {};
-        }
-        const auto rawText = QString::fromUtf8(f.readAll());
-        if (resolvedFormat == QStringLiteral("markdown")) {
-            return {.ok = true, .missingEmbeddedMarkdown = false, .markdown = rawText};
-        }
-        if (resolvedFormat == QStringLiteral("html")) {
-            const auto extracted = extract_embedded_markdown_from_zinc_html(rawText);
-            if (!extracted) {
-                return {.ok = true, .missingEmbeddedMarkdown = true, .markdown = {}};
-            }
-            return {.ok = true, .missingEmbeddedMarkdown = false, .markdown = *extracted};
-        }
-        return {};
-    };
-
-    const bool hasManifest = manifestFile.exists();
     if (hasManifest) {
         const auto notebooksArr = manifest.value(QStringLiteral("notebooks")).toArray();
         const auto pagesArr = manifest.value(QStringLiteral("pages")).toArray();
@@ -4916,7 +6001,7 @@ bool DataStore::importNotebooks(const QUrl& sourceFolder,
                 const auto newId = createNotebook(uniqueName);
                 if (newId.isEmpty()) {
                     emit error(QStringLiteral("Import failed: could not create notebook"));
-                    return false;
+                    return std::nullopt;
                 }
                 notebookIdMap.insert(oldId, newId);
             }
@@ -4933,27 +6018,56 @@ bool DataStore::importNotebooks(const QUrl& sourceFolder,
                              replaceExisting ? oldPageId : QUuid::createUuid().toString(QUuid::WithoutBraces));
         }
 
-        QHash<QString, QString> attachmentIdMap;
+        // Attachment data is read (or taken from the archive) and encoded on the pool.
+        std::vector<std::optional<QByteArrayView>> attachmentEntries(static_cast<size_t>(attachmentsArr.size()));
+        std::vector<QString> attachmentPaths(static_cast<size_t>(attachmentsArr.size()));
+        for (qsizetype i = 0; i < attachmentsArr.size(); ++i) {
+            const auto obj = attachmentsArr.at(i).toObject();
+            const auto rel = obj.value(QStringLiteral("file")).toString();
+            if (obj.value(QStringLiteral("attachmentId")).toString().isEmpty() ||
+                obj.value(QStringLiteral("mimeType")).toString().isEmpty() || rel.isEmpty()) {
+                continue;
+            }
+            if (fromArchive) {
+                attachmentEntries[static_cast<size_t>(i)] = archive->entry(obj);
+                continue;
+            }
+            const auto abs = safe_resolve_export_relative_path(rootPath, rel);
+            if (abs.isEmpty()) {
+                emit error(QStringLiteral("Import failed: invalid attachment path"));
+                return std::nullopt;
+            }
+            attachmentPaths[static_cast<size_t>(i)] = abs;
+        }
+        std::vector<QString> attachmentData(static_cast<size_t>(attachmentsArr.size()));
+        parallel_for(attachmentsArr.size(), [&](qsizetype i) {
+            const auto index = static_cast<size_t>(i);
+            if (const auto& entry = attachmentEntries[index]; entry && !entry->isEmpty()) {
+                attachmentData[index] =
+                    QString::fromLatin1(QByteArray::fromRawData(entry->data(), entry->size()).toBase64());
+            } else if (!attachmentPaths[index].isEmpty()) {
+                if (const auto bytes = read_file_bytes(attachmentPaths[index])) {
+                    attachmentData[index] = QString::fromLatin1(bytes->toBase64());
+                }
+            }
+        });
+
+        auto& attachmentIdMap = plan.attachmentMaps.front();
         attachmentIdMap.reserve(attachmentsArr.size());
 
         QVariantList attachmentUpdates;
         attachmentUpdates.reserve(attachmentsArr.size());
-        for (const auto& v : attachmentsArr) {
-            const auto obj = v.toObject();
+        for (qsizetype i = 0; i < attachmentsArr.size(); ++i) {
+            const auto obj = attachmentsArr.at(i).toObject();
             const auto oldId = obj.value(QStringLiteral("attachmentId")).toString();
             const auto mimeType = obj.value(QStringLiteral("mimeType")).toString();
             const auto rel = obj.value(QStringLiteral("file")).toString();
             if (oldId.isEmpty() || mimeType.isEmpty() || rel.isEmpty()) continue;
 
-            const auto abs = safe_resolve_export_relative_path(rootPath, rel);
-            if (abs.isEmpty()) {
-                emit error(QStringLiteral("Import failed: invalid attachment path"));
-                return false;
-            }
-            const auto bytes = read_file_bytes(abs);
-            if (!bytes || bytes->isEmpty()) {
+            auto& dataBase64 = attachmentData[static_cast<size_t>(i)];
+            if (dataBase64.isEmpty()) {
                 emit error(QStringLiteral("Import failed: missing attachment file %1").arg(oldId));
-                return false;
+                return std::nullopt;
             }
 
             const auto newId = replaceExisting ? oldId : QUuid::createUuid().toString(QUuid::WithoutBraces);
@@ -4962,7 +6076,7 @@ bool DataStore::importNotebooks(const QUrl& sourceFolder,
             QVariantMap a;
             a.insert(QStringLiteral("attachmentId"), newId);
             a.insert(QStringLiteral("mimeType"), mimeType);
-            a.insert(QStringLiteral("dataBase64"), QString::fromLatin1(bytes->toBase64()));
+            a.insert(QStringLiteral("dataBase64"), std::move(dataBase64));
             a.insert(QStringLiteral("updatedAt"), now);
             attachmentUpdates.append(a);
         }
@@ -4970,54 +6084,46 @@ bool DataStore::importNotebooks(const QUrl& sourceFolder,
             applyAttachmentUpdates(attachmentUpdates);
         }
 
+        QString defaultNotebookId;
+        plan.pages.reserve(pagesArr.size());
         for (const auto& v : pagesArr) {
             const auto obj = v.toObject();
             const auto oldPageId = obj.value(QStringLiteral("pageId")).toString();
             const auto oldNotebookId = obj.value(QStringLiteral("notebookId")).toString();
-            const auto title = obj.value(QStringLiteral("title")).toString();
             const auto rel = obj.value(QStringLiteral("file")).toString();
-            const auto sortOrder = obj.value(QStringLiteral("sortOrder")).toInt();
             if (oldPageId.isEmpty() || rel.isEmpty()) continue;
 
-            const auto abs = safe_resolve_export_relative_path(rootPath, rel);
-            if (abs.isEmpty()) {
-                emit error(QStringLiteral("Import failed: invalid page path"));
-                return false;
+            ImportPage page;
+            page.pageId = pageIdMap.value(oldPageId, oldPageId);
+            page.notebookId = notebookIdMap.value(oldNotebookId, oldNotebookId);
+            if (page.notebookId.isEmpty()) {
+                if (defaultNotebookId.isEmpty()) defaultNotebookId = ensureDefaultNotebook();
+                page.notebookId = defaultNotebookId;
             }
-
-            const auto read = read_markdown_from_file(abs);
-            if (!read.ok) {
-                emit error(QStringLiteral("Import failed: could not read page file"));
-                return false;
-            }
-            if (read.missingEmbeddedMarkdown) {
-                emit error(QStringLiteral("Import failed: HTML file missing embedded markdown"));
-                return false;
-            }
-
-            auto markdown = read.markdown;
-
-            markdown = rewrite_exported_attachment_paths_to_zinc_urls(markdown);
-            markdown = rewrite_zinc_attachment_ids(markdown, attachmentIdMap);
-            if (!replaceExisting) {
-                markdown = rewrite_zinc_page_links(markdown, pageIdMap);
+            page.title = obj.value(QStringLiteral("title")).toString();
+            page.sortOrder = obj.value(QStringLiteral("sortOrder")).toInt();
+
+            if (const auto it = unchangedMarkdown.constFind(oldPageId); it != unchangedMarkdown.cend()) {
+                page.markdown = *it;
+            } else if (fromArchive) {
+                page.entry = archive->entry(obj);
+                if (!page.entry) {
+                    emit error(QStringLiteral("Import failed: could not read page file"));
+                    return std::nullopt;
+                }
+            } else {
+                page.path = safe_resolve_export_relative_path(rootPath, rel);
+                if (page.path.isEmpty()) {
+                    emit error(QStringLiteral("Import failed: invalid page path"));
+                    return std::nullopt;
+                }
             }
-
-            const auto newPageId = pageIdMap.value(oldPageId, oldPageId);
-            const auto newNotebookId = notebookIdMap.value(oldNotebookId, oldNotebookId);
-
-            QVariantMap page;
-            page.insert(QStringLiteral("pageId"), newPageId);
-            if (!newNotebookId.isEmpty()) page.insert(QStringLiteral("notebookId"), newNotebookId);
-            page.insert(QStringLiteral("title"), title);
-            page.insert(QStringLiteral("parentId"), QString{});
-            page.insert(QStringLiteral("depth"), 0);
-            page.insert(QStringLiteral("sortOrder"), sortOrder);
-            page.insert(QStringLiteral("contentMarkdown"), markdown);
-            savePage(page);
+            plan.pages.append(std::move(page));
         }
-
-        return true;
+        if (!replaceExisting) {
+            plan.pageIds = std::move(pageIdMap);
+        }
+        return plan;
     }
 
     // No manifest: treat the folder as a best-effort import.
@@ -5026,7 +6132,7 @@ bool DataStore::importNotebooks(const QUrl& sourceFolder,
     // - attachments/ is imported if present and markdown references are rewritten.
     if (normalizedFormat == QStringLiteral("auto")) {
         emit error(QStringLiteral("Import failed: missing zinc-export.json"));
-        return false;
+        return std::nullopt;
     }
 
     QSet<QString> existingNotebookNames;
@@ -5038,6 +6144,8 @@ bool DataStore::importNotebooks(const QUrl& sourceFolder,
         }
     }
 
+    // Every notebook folder has its own attachments/, so its pages get their own id map.
+    plan.attachmentMaps.clear();
     const auto import_notebook_dir = [&](const QDir& nbDir, const QString& notebookNameRaw) -> bool {
         const auto uniqueName = unique_notebook_name_for_import(notebookNameRaw, existingNotebookNames);
         existingNotebookNames.insert(uniqueName);
@@ -5048,27 +6156,36 @@ bool DataStore::importNotebooks(const QUrl& sourceFolder,
         }
 
         // Attachments (optional)
-        QHash<QString, QString> attachmentIdMap;
+        const auto attachmentMap = static_cast<qsizetype>(plan.attachmentMaps.size());
+        auto& attachmentIdMap = plan.attachmentMaps.emplace_back();
         {
             const QDir attachmentsDir(nbDir.filePath(QStringLiteral("attachments")));
             if (attachmentsDir.exists()) {
-                const auto files = attachmentsDir.entryInfoList(QDir::Files | QDir::NoDotAndDotDot);
+                QFileInfoList files;
+                for (const auto& info : attachmentsDir.entryInfoList(QDir::Files | QDir::NoDotAndDotDot)) {
+                    if (info.baseName().size() == 36) files.append(info); // expect UUID
+                }
+                std::vector<QString> data(static_cast<size_t>(files.size()));
+                parallel_for(files.size(), [&](qsizetype i) {
+                    if (const auto bytes = read_file_bytes(files.at(i).absoluteFilePath()); bytes && !bytes->isEmpty()) {
+                        data[static_cast<size_t>(i)] = QString::fromLatin1(bytes->toBase64());
+                    }
+                });
+
                 QVariantList attachmentUpdates;
                 attachmentUpdates.reserve(files.size());
-                for (const auto& info : files) {
-                    const auto base = info.baseName();
-                    const auto ext = info.suffix();
-                    if (base.size() != 36) continue; // expect UUID
-                    const auto bytes = read_file_bytes(info.absoluteFilePath());
-                    if (!bytes || bytes->isEmpty()) continue;
+                for (qsizetype i = 0; i < files.size(); ++i) {
+                    auto& dataBase64 = data[static_cast<size_t>(i)];
+                    if (dataBase64.isEmpty()) continue;
+                    const auto base = files.at(i).baseName();
 
                     const auto newId = replaceExisting ? base : QUuid::createUuid().toString(QUuid::WithoutBraces);
                     attachmentIdMap.insert(base, newId);
 
                     QVariantMap a;
                     a.insert(QStringLiteral("attachmentId"), newId);
-                    a.insert(QStringLiteral("mimeType"), mime_from_extension(ext));
-                    a.insert(QStringLiteral("dataBase64"), QString::fromLatin1(bytes->toBase64()));
+                    a.insert(QStringLiteral("mimeType"), mime_from_extension(files.at(i).suffix()));
+                    a.insert(QStringLiteral("dataBase64"), std::move(dataBase64));
                     a.insert(QStringLiteral("updatedAt"), now);
                     attachmentUpdates.append(a);
                 }
@@ -5081,33 +6198,14 @@ bool DataStore::importNotebooks(const QUrl& sourceFolder,
         const auto pageFiles = nbDir.entryInfoList(QStringList{QStringLiteral("*.%1").arg(resolvedFormat == QStringLiteral("html") ? "html" : "md")},
                                                    QDir::Files | QDir::NoDotAndDotDot);
         for (const auto& info : pageFiles) {
-            const auto read = read_markdown_from_file(info.absoluteFilePath());
-            if (!read.ok) {
-                emit error(QStringLiteral("Import failed: could not read page file"));
-                return false;
-            }
-            if (read.missingEmbeddedMarkdown) {
-                emit error(QStringLiteral("Import failed: HTML file missing embedded markdown"));
-                return false;
-            }
-            auto markdown = read.markdown;
-
-            markdown = rewrite_exported_attachment_paths_to_zinc_urls(markdown);
-            markdown = rewrite_zinc_attachment_ids(markdown, attachmentIdMap);
-
-            const auto title = normalize_imported_title_from_filename(info.completeBaseName());
-            const auto sortOrder = normalize_imported_sort_order_from_filename(info.completeBaseName());
-            const auto pageId = QUuid::createUuid().toString(QUuid::WithoutBraces);
-
-            QVariantMap page;
-            page.insert(QStringLiteral("pageId"), pageId);
-            page.insert(QStringLiteral("notebookId"), notebookId);
-            page.insert(QStringLiteral("title"), title);
-            page.insert(QStringLiteral("parentId"), QString{});
-            page.insert(QStringLiteral("depth"), 0);
-            page.insert(QStringLiteral("sortOrder"), sortOrder);
-            page.insert(QStringLiteral("contentMarkdown"), markdown);
-            savePage(page);
+            ImportPage page;
+            page.pageId = QUuid::createUuid().toString(QUuid::WithoutBraces);
+            page.notebookId = notebookId;
+            page.title = normalize_imported_title_from_filename(info.completeBaseName());
+            page.sortOrder = normalize_imported_sort_order_from_filename(info.completeBaseName());
+            page.path = info.absoluteFilePath();
+            page.attachmentMap = attachmentMap;
+            plan.pages.append(std::move(page));
         }
         return true;
     };
@@ -5121,7 +6219,7 @@ bool DataStore::importNotebooks(const QUrl& sourceFolder,
         if (import_notebook_dir(nbDir, rawName)) {
             importedAny = true;
         } else {
-            return false;
+            return std::nullopt;
         }
     }
 
@@ -5129,19 +6227,270 @@ bool DataStore::importNotebooks(const QUrl& sourceFolder,
     if (!importedAny) {
         const auto rawName = QFileInfo(rootPath).fileName().isEmpty() ? QStringLiteral("Imported") : QFileInfo(rootPath).fileName();
         if (!import_notebook_dir(rootDir, rawName)) {
-            return false;
+            return std::nullopt;
         }
         importedAny = true;
     }
 
     if (!importedAny) {
         emit error(QStringLiteral("Import failed: no notebooks found"));
+        return std::nullopt;
+    }
+
+    return plan;
+}
+
+bool DataStore::backUpForRestore() {
+    const auto backupDir = databasePath() + QStringLiteral(".restore");
+    QDir(backupDir).removeRecursively();
+    if (!QDir().mkpath(backupDir)) return false;
+
+    // VACUUM INTO writes a consistent copy through the open connection.
+    auto escaped = QDir(backupDir).filePath(QStringLiteral("zinc.db"));
+    escaped.replace(QLatin1Char('\''), QStringLiteral("''"));
+    QSqlQuery q(m_db);
+    if (!q.exec(QStringLiteral("VACUUM INTO '%1'").arg(escaped))) {
+        qWarning() << "DataStore: restore backup failed:" << q.lastError().text();
+        QDir(backupDir).removeRecursively();
         return false;
     }
 
+    const auto attachmentsDir = resolve_attachments_dir();
+    if (QDir(attachmentsDir).exists() &&
+        !QDir().rename(attachmentsDir, QDir(backupDir).filePath(QStringLiteral("attachments")))) {
+        QDir(backupDir).removeRecursively();
+        return false;
+    }
+    m_restoreBackupDir = backupDir;
     return true;
 }
 
+void DataStore::finishRestore(bool keep) {
+    const auto backupDir = std::exchange(m_restoreBackupDir, QString());
+    if (backupDir.isEmpty()) return;
+    if (keep) {
+        QDir(backupDir).removeRecursively();
+        return;
+    }
+
+    qWarning() << "DataStore: restore did not complete, putting the previous data back";
+    m_db.close();
+    m_ready = false;
+    const auto dbPath = databasePath();
+    for (const auto& suffix : {QString(), QStringLiteral("-journal"), QStringLiteral("-wal"), QStringLiteral("-shm")}) {
+        QFile::remove(dbPath + suffix);
+    }
+    const auto attachmentsDir = resolve_attachments_dir();
+    QDir(attachmentsDir).removeRecursively();
+    const bool restored = QFile::rename(QDir(backupDir).filePath(QStringLiteral("zinc.db")), dbPath);
+    const QDir savedAttachments(QDir(backupDir).filePath(QStringLiteral("attachments")));
+    if (savedAttachments.exists()) QDir().rename(savedAttachments.absolutePath(), attachmentsDir);
+    if (restored) {
+        QDir(backupDir).removeRecursively();
+    } else {
+        // Keep the backup rather than lose it; the database starts empty.
+        emit error(QStringLiteral("Import failed: could not put the previous data back; it is kept in %1").arg(backupDir));
+    }
+
+    initialize();
+    emit databasePathChanged();
+    emit schemaVersionChanged();
+    emit notebooksChanged();
+    emit pagesChanged();
+    emit attachmentsChanged();
+}
+
+QString DataStore::runImport(const QString& databasePath,
+                             const ImportPlan& plan,
+                             const std::atomic<bool>& cancelled,
+                             const std::function<void(int, int)>& progress) {
+    const auto total = plan.pages.size();
+    if (total == 0) return {};
+
+    PageBatchWriter writer(databasePath);
+    if (!writer.ok()) return QStringLiteral("Import failed: could not open database");
+
+    // Reads and parses the markdown of pages [from, from + out.size()).
+    FirstError failure;
+    const auto parse_batch = [&](qsizetype from, std::vector<QString>& out) {
+        parallel_for(static_cast<qsizetype>(out.size()), [&](qsizetype k) {
+            if (cancelled.load(std::memory_order_relaxed)) return;
+            const auto& page = plan.pages.at(from + k);
+            auto& markdown = out[static_cast<size_t>(k)];
+            if (page.markdown) {
+                markdown = *page.markdown;
+                return;
+            }
+
+            if (page.entry) {
+                markdown = QString::fromUtf8(*page.entry);
+            } else {
+                QIODevice::OpenMode mode = QIODevice::ReadOnly;
+                if (plan.files != ImportPlan::Files::Dropped) mode |= QIODevice::Text;
+                QFile f(page.path);
+                if (!f.open(mode)) {
+                    failure.set(QStringLiteral("Import failed: could not read page file"));
+                    return;
+                }
+                const auto bytes = f.readAll();
+                if (plan.files == ImportPlan::Files::Dropped) {
+                    if (is_html_extension(QFileInfo(page.path).suffix().trimmed().toLower())) {
+                        const auto rawText = QString::fromUtf8(bytes);
+                        markdown = extract_embedded_markdown_from_zinc_html(rawText).value_or(rawText);
+                    } else if (is_probably_binary_payload(bytes)) {
+                        markdown = render_ascii_from_bytes(bytes);
+                    } else {
+                        markdown = QString::fromUtf8(bytes);
+                    }
+                    return;
+                }
+                markdown = QString::fromUtf8(bytes);
+            }
+
+            if (plan.files == ImportPlan::Files::ZincHtml) {
+                auto extracted = extract_embedded_markdown_from_zinc_html(markdown);
+                if (!extracted) {
+                    failure.set(QStringLiteral("Import failed: HTML file missing embedded markdown"));
+                    return;
+                }
+                markdown = std::move(*extracted);
+            }
+            markdown = rewrite_imported_links(
+                markdown, plan.attachmentMaps.at(static_cast<size_t>(page.attachmentMap)), plan.pageIds);
+        });
+    };
+
+    const auto write_batch = [&](qsizetype from, const std::vector<QString>& markdowns) -> QString {
+        if (!writer.begin()) return QStringLiteral("Import failed: could not start a transaction");
+        const auto updatedAt = now_timestamp_utc();
+        for (size_t k = 0; k < markdowns.size(); ++k) {
+            const auto& page = plan.pages.at(from + static_cast<qsizetype>(k));
+            if (!writer.upsert(page.pageId, page.notebookId, page.title, page.parentId, markdowns[k],
+                               page.depth, page.sortOrder, updatedAt)) {
+                const auto message = QStringLiteral("Import failed: could not save page: %1").arg(writer.lastError());
+                writer.rollback();
+                return message;
+            }
+        }
+        return writer.commit() ? QString() : QStringLiteral("Import failed: could not commit pages");
+    };
+
+    // While one batch is committed, the next one is parsed on the pool.
+    const auto batch_size = [&](qsizetype from) {
+        return static_cast<size_t>(std::min(kImportBatchPages, total - from));
+    };
+    std::vector<QString> current(batch_size(0));
+    parse_batch(0, current);
+    std::vector<QString> next;
+    for (qsizetype from = 0; from < total; from += kImportBatchPages) {
+        if (cancelled.load()) return QStringLiteral("Import cancelled");
+        if (auto message = failure.message(); !message.isEmpty()) return message;
+
+        const auto nextFrom = from + kImportBatchPages;
+        QSemaphore parsed;
+        bool parsing = false;
+        if (nextFrom < total) {
+            next.assign(batch_size(nextFrom), QString());
+            parsing = QThreadPool::globalInstance()->tryStart([&] {
+                parse_batch(nextFrom, next);
+                parsed.release();
+            });
+        }
+        const auto written = write_batch(from, current);
+        if (parsing) {
+            parsed.acquire();
+        } else if (nextFrom < total && written.isEmpty()) {
+            parse_batch(nextFrom, next);
+        }
+        if (!written.isEmpty()) return written;
+
+        if (progress) progress(static_cast<int>(std::min(nextFrom, total)), static_cast<int>(total));
+        current.swap(next);
+    }
+    return {};
+}
+
+bool DataStore::importNotebooks(const QUrl& sourceFolder,
+                                const QString& format,
+                                bool replaceExisting) {
+    const auto plan = prepareImport(sourceFolder, format, replaceExisting);
+    if (!plan) {
+        finishRestore(false);
+        return false;
+    }
+
+    const std::atomic<bool> cancelled{false};
+    const auto failure = runImport(m_db.databaseName(), *plan, cancelled, [this](int done, int total) {
+        emit importProgress(done, total);
+    });
+    finishRestore(failure.isEmpty());
+    if (!plan->pages.isEmpty()) emit pagesChanged();
+    if (!failure.isEmpty()) {
+        emit error(failure);
+        return false;
+    }
+    return true;
+}
+
+bool DataStore::startImportNotebooks(const QUrl& sourceFolder,
+                                     const QString& format,
+                                     bool replaceExisting) {
+    if (m_importCancel) {
+        emit error(QStringLiteral("Import failed: an import is already running"));
+        return false;
+    }
+    auto plan = prepareImport(sourceFolder, format, replaceExisting);
+    if (!plan) {
+        finishRestore(false);
+        return false;
+    }
+
+    // As with exports: the pages are written on the pool through their own connection, and the
+    // watcher brings progress and the result back.
+    auto cancel = std::make_shared<std::atomic<bool>>(false);
+    m_importCancel = cancel;
+    emit importingChanged();
+
+    auto promise = std::make_shared<QPromise<QString>>();
+    auto* watcher = new QFutureWatcher<QString>(this);
+    connect(watcher, &QFutureWatcher<QString>::progressValueChanged, this, [this, watcher](int done) {
+        emit importProgress(done, watcher->progressMaximum());
+    });
+    connect(watcher, &QFutureWatcher<QString>::finished, this, [this, watcher, cancel]() {
+        watcher->deleteLater();
+        const auto failure = watcher->future().resultCount() > 0 ? watcher->result()
+                                                                 : QStringLiteral("Import failed");
+        m_importCancel.reset();
+        finishRestore(failure.isEmpty());
+        emit importingChanged();
+        emit pagesChanged();
+        if (!failure.isEmpty() && !cancel->load()) emit error(failure);
+        emit importFinished(failure.isEmpty(), failure);
+    });
+    watcher->setFuture(promise->future());
+    promise->start();
+
+    QThreadPool::globalInstance()->start([promise, cancel, job = std::move(*plan), databasePath = m_db.databaseName()]() {
+        const auto progress = [&promise](int done, int total) {
+            promise->setProgressRange(0, total);
+            promise->setProgressValue(done);
+        };
+        promise->addResult(runImport(databasePath, job, *cancel, progress));
+        promise->finish();
+    });
+    return true;
+}
+
+void DataStore::cancelImport() {
+    if (m_importCancel) {
+        m_importCancel->store(true);
+    }
+}
+
+bool DataStore::isImporting() const {
+    return m_importCancel != nullptr;
+}
+
 QVariantList DataStore::importPagesFromFiles(const QVariantList& fileUrls,
                                              const QString& targetParentPageId,
                                              const QString& targetNotebookId) {
@@ -5158,7 +6507,7 @@ QVariantList DataStore::importPagesFromFiles(const QVariantList& fileUrls,
     if (!resolvedParentId.isEmpty()) {
         QSqlQuery parentQuery(m_db);
         parentQuery.prepare(QStringLiteral("SELECT notebook_id, depth FROM pages WHERE id = ? LIMIT 1"));
-        parentQuery.addBindValue(resolvedParentId);
+        parentQuery.addBindValue(sql_id(resolvedParentId));
         if (!parentQuery.exec() || !parentQuery.next()) {
             emit error(QStringLiteral("Import failed: target parent page not found"));
             return importedPageIds;
@@ -5171,7 +6520,7 @@ QVariantList DataStore::importPagesFromFiles(const QVariantList& fileUrls,
     siblingQuery.prepare(QStringLiteral(
         "SELECT sort_order, title FROM pages WHERE notebook_id = ? AND parent_id = ?"));
     siblingQuery.addBindValue(resolvedNotebookId);
-    siblingQuery.addBindValue(resolvedParentId);
+    siblingQuery.addBindValue(sql_id(resolvedParentId));
     if (!siblingQuery.exec()) {
         emit error(QStringLiteral("Import failed: could not read current pages"));
         return importedPageIds;
@@ -5184,31 +6533,15 @@ QVariantList DataStore::importPagesFromFiles(const QVariantList& fileUrls,
         siblingTitles.insert(siblingQuery.value(1).toString());
     }
 
+    // The files are read and converted by runImport; only readable ones get a page.
+    ImportPlan plan;
+    plan.files = ImportPlan::Files::Dropped;
     for (const auto& value : fileUrls) {
         const auto fileUrl = value.toUrl();
         if (!fileUrl.isValid() || !fileUrl.isLocalFile()) continue;
 
         const QFileInfo info(fileUrl.toLocalFile());
-        if (!info.exists() || !info.isFile()) continue;
-
-        QFile f(info.absoluteFilePath());
-        if (!f.open(QIODevice::ReadOnly)) continue;
-        const auto bytes = f.readAll();
-        const auto rawText = QString::fromUtf8(bytes);
-
-        QString markdown;
-        const auto ext = info.suffix().trimmed().toLower();
-        if (is_html_extension(ext)) {
-            if (const auto embedded = extract_embedded_markdown_from_zinc_html(rawText); embedded) {
-                markdown = *embedded;
-            } else {
-                markdown = rawText;
-            }
-        } else if (is_probably_binary_payload(bytes)) {
-            markdown = render_ascii_from_bytes(bytes);
-        } else {
-            markdown = rawText;
-        }
+        if (!info.exists() || !info.isFile() || !info.isReadable()) continue;
 
         const auto titleBase = info.fileName().isEmpty()
             ? normalize_imported_title_from_filename(info.completeBaseName())
@@ -5216,25 +6549,34 @@ QVariantList DataStore::importPagesFromFiles(const QVariantList& fileUrls,
         const auto title = unique_imported_page_title(titleBase, siblingTitles);
         siblingTitles.insert(title);
 
-        const auto pageId = QUuid::createUuid().toString(QUuid::WithoutBraces);
-
-        QVariantMap page;
-        page.insert(QStringLiteral("pageId"), pageId);
-        page.insert(QStringLiteral("notebookId"), resolvedNotebookId);
-        page.insert(QStringLiteral("title"), title);
-        page.insert(QStringLiteral("parentId"), resolvedParentId);
-        page.insert(QStringLiteral("depth"), resolvedDepth);
-        page.insert(QStringLiteral("sortOrder"), nextSortOrder++);
-        page.insert(QStringLiteral("contentMarkdown"), markdown);
-        savePage(page);
-
-        importedPageIds.append(pageId);
+        ImportPage page;
+        page.pageId = QUuid::createUuid().toString(QUuid::WithoutBraces);
+        page.notebookId = resolvedNotebookId;
+        page.parentId = resolvedParentId;
+        page.title = title;
+        page.depth = resolvedDepth;
+        page.sortOrder = nextSortOrder++;
+        page.path = info.absoluteFilePath();
+        plan.pages.append(std::move(page));
     }
 
-    if (importedPageIds.isEmpty()) {
+    if (plan.pages.isEmpty()) {
         emit error(QStringLiteral("Import failed: no files were dropped"));
+        return importedPageIds;
+    }
+
+    const std::atomic<bool> cancelled{false};
+    const auto failure = runImport(m_db.databaseName(), plan, cancelled, {});
+    emit pagesChanged();
+    if (!failure.isEmpty()) {
+        emit error(failure);
+        return importedPageIds;
     }
 
+    importedPageIds.reserve(plan.pages.size());
+    for (const auto& page : plan.pages) {
+        importedPageIds.append(page.pageId);
+    }
     return importedPageIds;
 }
 
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <QByteArrayView>
+#include <QHash>
+#include <QList>
 #include <QObject>
 #include <QQmlEngine>
 #include <QString>
@@ -7,9 +10,18 @@
 #include <QVariantList>
 #include <QVariantMap>
 #include <QSqlDatabase>
+#include <QStringList>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
 
 namespace zinc::ui {
 
+class ExportArchiveReader;
+
 /**
  * DataStore - SQLite-backed storage for pages and blocks.
  * Exposed to QML as a singleton.
@@ -21,6 +33,8 @@ class DataStore : public QObject {
 
     Q_PROPERTY(QString databasePath READ databasePath NOTIFY databasePathChanged)
     Q_PROPERTY(int schemaVersion READ schemaVersion NOTIFY schemaVersionChanged)
+    Q_PROPERTY(bool exporting READ isExporting NOTIFY exportingChanged)
+    Q_PROPERTY(bool importing READ isImporting NOTIFY importingChanged)
     
 public:
     explicit DataStore(QObject* parent = nullptr);
@@ -42,7 +56,8 @@ public:
     Q_INVOKABLE QVariantList getPageConflicts();
     Q_INVOKABLE QVariantMap getPageConflict(const QString& pageId);
     Q_INVOKABLE bool hasPageConflict(const QString& pageId);
-    // Returns { mergedMarkdown: string, clean: bool, kind: string } or empty if not found.
+    // Returns { mergedMarkdown, clean, kind, mergedTitle, hunks: [{ line, ours, theirs }] } or empty if
+    // not found. Served from the merge precomputed when the conflict was recorded.
     Q_INVOKABLE QVariantMap previewMergeForPageConflict(const QString& pageId);
     // resolution: "local" | "remote" | "merge"
     Q_INVOKABLE void resolvePageConflict(const QString& pageId, const QString& resolution);
@@ -171,7 +186,9 @@ public:
     // Export
     // - notebookIds empty => export all notebooks
     // - destinationFolder must be a local file URL
-    // - format: "markdown" | "html"
+    // - format: "markdown" | "html" | "archive"
+    // - "archive" writes one zinc-export.zincpack into the folder, or to destinationFolder
+    //   itself when it names a .zincpack file; see ExportArchive.hpp
     Q_INVOKABLE bool exportNotebooks(const QVariantList& notebookIds,
                                      const QUrl& destinationFolder,
                                      const QString& format);
@@ -181,14 +198,36 @@ public:
                                      const QUrl& destinationFolder,
                                      const QString& format,
                                      bool includeAttachments);
+    // Same export, run in the background: pages are read from a read-only snapshot of the
+    // database, rendered and written on the thread pool, and attachments are copied in parallel.
+    // Reports exportProgress() and ends with exportFinished(); returns false (and emits error())
+    // if it could not start, e.g. while another export is running.
+    Q_INVOKABLE bool startExportNotebooks(const QVariantList& notebookIds,
+                                          const QUrl& destinationFolder,
+                                          const QString& format,
+                                          bool includeAttachments);
+    // Stops the running export after the files in flight; it finishes with ok=false.
+    Q_INVOKABLE void cancelExport();
+    Q_INVOKABLE bool isExporting() const;
 
     // Import (backup/restore)
-    // - sourceFolder must be a local folder URL containing a Zinc export
-    // - format: "auto" | "markdown" | "html"
+    // - sourceFolder must be a local folder URL containing a Zinc export, or a .zincpack file
+    // - format: "auto" | "markdown" | "html" | "archive"
     // - when replaceExisting=true, the current DB + attachments are wiped before import
+    // Notebooks and attachments are set up first; pages then go through runImport(), which
+    // reads and parses files on the thread pool and writes them in batched transactions.
     Q_INVOKABLE bool importNotebooks(const QUrl& sourceFolder,
                                      const QString& format,
                                      bool replaceExisting);
+    // Same import with the pages read and written in the background. Reports importProgress()
+    // and ends with importFinished(); returns false (and emits error()) if it could not start.
+    Q_INVOKABLE bool startImportNotebooks(const QUrl& sourceFolder,
+                                          const QString& format,
+                                          bool replaceExisting);
+    // Stops the running import after the batch in flight and finishes with ok=false. A duplicate
+    // import keeps the pages already written; a restore puts the previous data back.
+    Q_INVOKABLE void cancelImport();
+    Q_INVOKABLE bool isImporting() const;
     // Import plain files dropped from the OS into pages.
     // - fileUrls: list of local file URLs (supports .txt, .md, .markdown, .html, .htm)
     // - targetParentPageId: when set, imported pages become children of this page
@@ -211,16 +250,101 @@ signals:
     void pairedDevicesChanged();
     void pageConflictsChanged();
     void pageConflictDetected(const QVariantMap& conflict);
+    void pageConflictMergeReady(const QString& pageId);
     void notebooksChanged();
     void error(const QString& message);
+    void exportingChanged();
+    // `done` of `total` pages and attachment copies have been written.
+    void exportProgress(int done, int total);
+    void exportFinished(bool ok, const QString& message);
+    void importingChanged();
+    // `done` of `total` pages have been written.
+    void importProgress(int done, int total);
+    void importFinished(bool ok, const QString& message);
 
 private:
     void createTables();
     QString getDatabasePath();
     QString ensureDefaultNotebook();
+    void scheduleConflictMerge(const QString& pageId);
+    bool storeConflictMerge(const QString& pageId,
+                            const QString& baseMd,
+                            const QString& localMd,
+                            const QString& remoteMd,
+                            const QString& kind,
+                            const QString& mergedMd,
+                            const QString& hunksJson);
     
+    struct ExportRequest {
+        QStringList notebookIds;
+        QString rootPath;
+        QString archivePath; // format "archive" only
+        QString format;
+        bool includeAttachments = false;
+    };
+    // Validates the arguments and resolves the notebook list; emits error() on failure.
+    std::optional<ExportRequest> prepareExport(const QVariantList& notebookIds,
+                                               const QUrl& destinationFolder,
+                                               const QString& format,
+                                               bool includeAttachments);
+    // Runs an export against its own connection to `databasePath`, so it may run on any
+    // thread. Returns an empty string on success, otherwise the error message.
+    static QString runExport(const QString& databasePath,
+                             const ExportRequest& request,
+                             const std::atomic<bool>& cancelled,
+                             const std::function<void(int, int)>& progress);
+
+    // A page to import. Its markdown comes from `markdown` when set, else from the archive
+    // `entry`, else from the file at `path`.
+    struct ImportPage {
+        QString pageId;
+        QString notebookId;
+        QString parentId;
+        QString title;
+        int depth = 0;
+        int sortOrder = 0;
+        QString path;
+        std::optional<QByteArrayView> entry;
+        std::optional<QString> markdown; // final, not parsed or rewritten
+        qsizetype attachmentMap = 0;     // index into ImportPlan::attachmentMaps
+    };
+    struct ImportPlan {
+        enum class Files {
+            Markdown,
+            ZincHtml, // markdown embedded by an html export
+            Dropped,  // arbitrary files, taken as they are
+        };
+        Files files = Files::Markdown;
+        QList<ImportPage> pages;
+        std::vector<QHash<QString, QString>> attachmentMaps{1}; // old → new attachment ids
+        QHash<QString, QString> pageIds;                          // old → new; empty keeps links
+        std::shared_ptr<const ExportArchiveReader> archive;       // keeps entries valid
+    };
+    // Reads the export's manifest, resets the database if asked and creates the notebooks and
+    // attachments; emits error() on failure. A reset is preceded by backUpForRestore().
+    std::optional<ImportPlan> prepareImport(const QUrl& sourceFolder, const QString& format, bool replaceExisting);
+    // Writes the plan's pages through its own connection to `databasePath`, so it may run on
+    // any thread: batches are read and parsed on the thread pool while the previous one is
+    // committed in a single transaction. Returns an empty string on success, otherwise the
+    // error message.
+    static QString runImport(const QString& databasePath,
+                             const ImportPlan& plan,
+                             const std::atomic<bool>& cancelled,
+                             const std::function<void(int, int)>& progress);
+
+    // A restore replaces everything only if it completes: the database and attachments are set
+    // aside before the reset, then dropped on success or put back on failure or cancel.
+    bool backUpForRestore();
+    void finishRestore(bool keep);
+
     QSqlDatabase m_db;
     bool m_ready = false;
+    // Set while a background export runs; the flag is shared with it.
+    std::shared_ptr<std::atomic<bool>> m_exportCancel;
+    // Same for a background import.
+    std::shared_ptr<std::atomic<bool>> m_importCancel;
+    // Where backUpForRestore() put the data a running restore replaces; empty otherwise.
+    QString m_restoreBackupDir;
 };
 
 } // namespace zinc::ui
@@ -0,0 +1,122 @@
+#include "ui/ExportArchive.hpp"
+
+#include <QCryptographicHash>
+#include <QJsonDocument>
+#include <QtEndian>
+
+#include <cstring>
+
+namespace zinc::ui {
+namespace {
+
+constexpr char kMagic[] = "ZINCPAK1";
+constexpr char kTocMagic[] = "ZINCTOC1";
+constexpr qint64 kMagicSize = 8;
+constexpr qint64 kTrailerSize = 8 + 8 + kMagicSize;
+
+} // namespace
+
+ExportArchiveWriter::ExportArchiveWriter(const QString& path)
+    : m_file(path) {}
+
+bool ExportArchiveWriter::open() {
+    m_pos = 0;
+    return m_file.open(QIODevice::WriteOnly) && write(QByteArrayView(kMagic, kMagicSize));
+}
+
+bool ExportArchiveWriter::write(QByteArrayView data) {
+    if (m_file.write(data.data(), data.size()) != data.size()) return false;
+    m_pos += data.size();
+    return true;
+}
+
+qint64 ExportArchiveWriter::append(QByteArrayView data) {
+    const auto offset = m_pos;
+    return write(data) ? offset : -1;
+}
+
+qint64 ExportArchiveWriter::appendFile(const QString& path,
+                                       const std::atomic<bool>& cancelled,
+                                       QCryptographicHash& hash,
+                                       qint64& length) {
+    QFile src(path);
+    if (!src.open(QIODevice::ReadOnly)) return -1;
+
+    const auto offset = m_pos;
+    constexpr qint64 kChunk = qint64{1} << 20;
+    QByteArray buffer(kChunk, Qt::Uninitialized);
+    for (;;) {
+        if (cancelled.load(std::memory_order_relaxed)) return -1;
+        const auto n = src.read(buffer.data(), kChunk);
+        if (n < 0) return -1;
+        if (n == 0) break;
+        const QByteArrayView chunk(buffer.constData(), n);
+        if (!write(chunk)) return -1;
+        hash.addData(chunk);
+    }
+    length = m_pos - offset;
+    return offset;
+}
+
+bool ExportArchiveWriter::finish(const QJsonObject& toc) {
+    const auto tocBytes = QJsonDocument(toc).toJson(QJsonDocument::Compact);
+    const auto tocOffset = m_pos;
+    if (!write(tocBytes)) return false;
+
+    char trailer[kTrailerSize];
+    qToLittleEndian<quint64>(static_cast<quint64>(tocOffset), trailer);
+    qToLittleEndian<quint64>(static_cast<quint64>(tocBytes.size()), trailer + 8);
+    std::memcpy(trailer + 16, kTocMagic, kMagicSize);
+    return write(QByteArrayView(trailer, kTrailerSize)) && m_file.commit();
+}
+
+void ExportArchiveWriter::cancel() {
+    m_file.cancelWriting();
+}
+
+QString ExportArchiveWriter::errorString() const {
+    return m_file.errorString();
+}
+
+bool ExportArchiveReader::open(const QString& path) {
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) return false;
+    const auto size = m_file.size();
+    if (size < kMagicSize + kTrailerSize) return false;
+
+    if (const auto* mapped = m_file.map(0, size)) {
+        m_data = reinterpret_cast<const char*>(mapped);
+    } else {
+        m_unmapped = m_file.readAll();
+        if (m_unmapped.size() != size) return false;
+        m_data = m_unmapped.constData();
+    }
+    if (std::memcmp(m_data, kMagic, kMagicSize) != 0) return false;
+
+    const char* trailer = m_data + size - kTrailerSize;
+    if (std::memcmp(trailer + 16, kTocMagic, kMagicSize) != 0) return false;
+    const auto tocOffset = qFromLittleEndian<quint64>(trailer);
+    const auto tocLength = qFromLittleEndian<quint64>(trailer + 8);
+    const auto tocEnd = static_cast<quint64>(size - kTrailerSize);
+    if (tocOffset < static_cast<quint64>(kMagicSize) || tocOffset > tocEnd || tocLength > tocEnd - tocOffset) {
+        return false;
+    }
+
+    const auto doc = QJsonDocument::fromJson(
+        QByteArray::fromRawData(m_data + tocOffset, static_cast<qsizetype>(tocLength)));
+    if (!doc.isObject()) return false;
+    m_toc = doc.object();
+    m_dataEnd = static_cast<qint64>(tocOffset);
+    return true;
+}
+
+std::optional<QByteArrayView> ExportArchiveReader::entry(const QJsonObject& tocEntry) const {
+    const auto offset = tocEntry.value(QStringLiteral("offset")).toInteger(-1);
+    const auto length = tocEntry.value(QStringLiteral("length")).toInteger(-1);
+    if (!m_data || offset < kMagicSize || length < 0 || offset > m_dataEnd || length > m_dataEnd - offset) {
+        return std::nullopt;
+    }
+    return QByteArrayView(m_data + offset, length);
+}
+
+} // namespace zinc::ui
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QFile>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QString>
+
+#include <atomic>
+#include <optional>
+
+class QCryptographicHash;
+
+namespace zinc::ui {
+
+/**
+ * ExportArchive - the single-file export container (`.zincpack`).
+ *
+ * Layout, integers little-endian:
+ *   "ZINCPAK1"                    magic
+ *   entry data                    pages (UTF-8 markdown) and attachments, stored as is
+ *   table of contents             UTF-8 JSON: the export manifest, where every page and
+ *                                 attachment also has the "offset" and "length" of its data
+ *   u64 toc offset, u64 toc length, "ZINCTOC1"
+ *
+ * The writer makes one sequential pass and puts the table of contents last, so nothing is
+ * seeked back to. The reader maps the file; entries are views into the mapping that any
+ * number of threads can read at once.
+ */
+class ExportArchiveWriter {
+public:
+    explicit ExportArchiveWriter(const QString& path);
+
+    bool open();
+    // Appends `data`; returns its offset, or -1 if the write failed.
+    qint64 append(QByteArrayView data);
+    // Streams the file at `path` in, feeding `hash`. Returns the offset and sets `length`, or
+    // returns -1 on failure or cancel.
+    qint64 appendFile(const QString& path,
+                      const std::atomic<bool>& cancelled,
+                      QCryptographicHash& hash,
+                      qint64& length);
+    // Writes the table of contents and trailer, then replaces the destination atomically.
+    bool finish(const QJsonObject& toc);
+    // Drops everything written; the destination is left as it was.
+    void cancel();
+
+    [[nodiscard]] QString errorString() const;
+
+private:
+    bool write(QByteArrayView data);
+
+    QSaveFile m_file;
+    qint64 m_pos = 0;
+};
+
+class ExportArchiveReader {
+public:
+    bool open(const QString& path);
+
+    [[nodiscard]] const QJsonObject& toc() const { return m_toc; }
+    // The data of a table-of-contents entry, or nullopt if its range is missing or invalid.
+    // Valid while the reader is.
+    [[nodiscard]] std::optional<QByteArrayView> entry(const QJsonObject& tocEntry) const;
+
+private:
+    QFile m_file;
+    QByteArray m_unmapped; // file contents when mapping is not available
+    const char* m_data = nullptr;
+    qint64 m_dataEnd = 0;  // entries end where the table of contents starts
+    QJsonObject m_toc;
+};
+
+} // namespace zinc::ui
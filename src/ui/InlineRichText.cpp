@@ -10,31 +10,125 @@
 namespace zinc::ui {
 namespace {
 
-struct InlineAttrs {
-    QString fontFamily;
-    int fontPointSize = 0;
-    QColor color;
-    bool hasColor = false;
-    bool bold = false;
-    bool italic = false;
-    bool underline = false;
-    bool strike = false;
-
-    bool operator==(const InlineAttrs& o) const {
-        return fontFamily == o.fontFamily && fontPointSize == o.fontPointSize && hasColor == o.hasColor &&
-               (!hasColor || color == o.color) && bold == o.bold && italic == o.italic && underline == o.underline &&
-               strike == o.strike;
+using InlineAttrs = InlineRichText::Attrs;
+using Run = InlineRichText::Run;
+
+QVariantMap runToVariantMap(const Run& r) {
+    QVariantMap m;
+    m.insert(QStringLiteral("start"), r.start);
+    m.insert(QStringLiteral("end"), r.end);
+    m.insert(QStringLiteral("attrs"), InlineRichText::attrsToVariantMap(r.attrs));
+    return m;
+}
+
+std::vector<Run> applyDelta(std::vector<Run> runs,
+                            int start,
+                            int removedLen,
+                            int insertedLen,
+                            const InlineAttrs& insertAttrs,
+                            int textLenAfter) {
+    const int end = start + removedLen;
+    const int delta = insertedLen - removedLen;
+
+    std::vector<Run> out;
+    out.reserve(runs.size() + 2);
+
+    for (const auto& r : runs) {
+        if (r.end <= start) {
+            out.push_back(r);
+            continue;
+        }
+        if (r.start >= end) {
+            Run shifted = r;
+            shifted.start += delta;
+            shifted.end += delta;
+            out.push_back(shifted);
+            continue;
+        }
+        // Overlapping removal: keep left part and/or right part.
+        if (r.start < start) {
+            out.push_back(Run{r.start, start, r.attrs});
+        }
+        if (r.end > end) {
+            out.push_back(Run{start + insertedLen, (r.end + delta), r.attrs});
+        }
     }
-};
 
-struct Run {
-    int start = 0;
-    int end = 0;
-    InlineAttrs attrs;
+    if (insertedLen > 0) {
+        out.push_back(Run{start, start + insertedLen, insertAttrs});
+    }
+
+    std::sort(out.begin(), out.end(), [](const Run& a, const Run& b) { return a.start < b.start; });
+    return InlineRichText::normalizeRuns(out, textLenAfter);
+}
+
+InlineAttrs parseStyleToAttrs(const QString& style) {
+    InlineAttrs out;
+    const auto s = style;
+
+    const auto fontFamilyRe = QRegularExpression(QStringLiteral(R"(font-family\s*:\s*([^;]+))"),
+                                                 QRegularExpression::CaseInsensitiveOption);
+    const auto fontSizeRe =
+        QRegularExpression(QStringLiteral(R"(font-size\s*:\s*([0-9]+)\s*(pt|px)?)"),
+                           QRegularExpression::CaseInsensitiveOption);
+    const auto colorRe = QRegularExpression(QStringLiteral(R"(color\s*:\s*(#[0-9a-fA-F]{6}))"));
+
+    if (const auto m = fontFamilyRe.match(s); m.hasMatch()) {
+        auto v = m.captured(1).trimmed();
+        if ((v.startsWith('"') && v.endsWith('"')) || (v.startsWith('\'') && v.endsWith('\''))) {
+            v = v.mid(1, v.size() - 2);
+        }
+        out.fontFamily = v;
+    }
+
+    if (const auto m = fontSizeRe.match(s); m.hasMatch()) {
+        const int n = m.captured(1).toInt();
+        const auto unit = m.captured(2).toLower();
+        if (unit == QStringLiteral("px")) {
+            out.fontPointSize = std::max(1, static_cast<int>(std::round(static_cast<double>(n) * 0.75)));
+        } else {
+            out.fontPointSize = std::max(1, n);
+        }
+    }
+
+    if (const auto m = colorRe.match(s); m.hasMatch()) {
+        const QColor c(m.captured(1));
+        if (c.isValid()) {
+            out.color = c;
+            out.hasColor = true;
+        }
+    }
+
+    return out;
+}
+
+InlineAttrs mergeAttrs(const InlineAttrs& base, const InlineAttrs& overlay) {
+    InlineAttrs out = base;
+    if (!overlay.fontFamily.isEmpty()) out.fontFamily = overlay.fontFamily;
+    if (overlay.fontPointSize > 0) out.fontPointSize = overlay.fontPointSize;
+    if (overlay.hasColor) {
+        out.color = overlay.color;
+        out.hasColor = true;
+    }
+    out.bold = base.bold || overlay.bold;
+    out.italic = base.italic || overlay.italic;
+    out.underline = base.underline || overlay.underline;
+    out.strike = base.strike || overlay.strike;
+    return out;
+}
+
+struct TagState {
+    InlineAttrs overlay;
+    InlineAttrs prev;
 };
 
-InlineAttrs attrsFromVariantMap(const QVariantMap& m) {
-    InlineAttrs a;
+} // namespace
+
+InlineRichText::InlineRichText(QObject* parent)
+    : QObject(parent) {}
+
+InlineRichText::Attrs InlineRichText::attrsFromVariantMap(const QVariantMap& m) {
+    Attrs a;
     a.fontFamily = m.value(QStringLiteral("fontFamily")).toString();
     a.fontPointSize = m.value(QStringLiteral("fontPointSize")).toInt();
     const auto colorStr = m.value(QStringLiteral("color")).toString();
@@ -52,7 +146,7 @@ InlineAttrs attrsFromVariantMap(const QVariantMap& m) {
     return a;
 }
 
-QVariantMap attrsToVariantMap(const InlineAttrs& a) {
+QVariantMap InlineRichText::attrsToVariantMap(const Attrs& a) {
     QVariantMap m;
     if (!a.fontFamily.isEmpty()) {
         m.insert(QStringLiteral("fontFamily"), a.fontFamily);
@@ -78,15 +172,7 @@ QVariantMap attrsToVariantMap(const InlineAttrs& a) {
     return m;
 }
 
-QVariantMap runToVariantMap(const Run& r) {
-    QVariantMap m;
-    m.insert(QStringLiteral("start"), r.start);
-    m.insert(QStringLiteral("end"), r.end);
-    m.insert(QStringLiteral("attrs"), attrsToVariantMap(r.attrs));
-    return m;
-}
-
-std::vector<Run> runsFromVariantList(const QVariantList& list) {
+std::vector<InlineRichText::Run> InlineRichText::runsFromVariantList(const QVariantList& list) {
     std::vector<Run> out;
     out.reserve(static_cast<size_t>(list.size()));
     for (const auto& v : list) {
@@ -103,7 +189,7 @@ std::vector<Run> runsFromVariantList(const QVariantList& list) {
     return out;
 }
 
-QVariantList runsToVariantList(const std::vector<Run>& runs) {
+QVariantList InlineRichText::runsToVariantList(const std::vector<Run>& runs) {
     QVariantList out;
     out.reserve(static_cast<int>(runs.size()));
     for (const auto& r : runs) {
@@ -112,14 +198,14 @@ QVariantList runsToVariantList(const std::vector<Run>& runs) {
     return out;
 }
 
-std::vector<Run> normalizeRuns(const std::vector<Run>& runs, int textLen) {
+std::vector<InlineRichText::Run> InlineRichText::normalizeRuns(const std::vector<Run>& runs, int textLen) {
     const auto clamp = [](int v, int lo, int hi) { return std::max(lo, std::min(v, hi)); };
 
     std::vector<Run> out;
     out.reserve(runs.size() + 1);
 
     int pos = 0;
-    InlineAttrs empty;
+    Attrs empty;
     for (const auto& r0 : runs) {
         const int a = clamp(r0.start, 0, textLen);
         const int b = clamp(r0.end, 0, textLen);
@@ -158,27 +244,7 @@ std::vector<Run> normalizeRuns(const std::vector<Run>& runs, int textLen) {
     return merged;
 }
 
-InlineAttrs attrsAtPos(const std::vector<Run>& runs, int pos) {
-    if (runs.empty()) return InlineAttrs{};
-    const int p = std::max(0, pos);
-    auto it = std::upper_bound(runs.begin(), runs.end(), p, [](int value, const Run& r) { return value < r.start; });
-    if (it == runs.begin()) {
-        return runs.front().attrs;
-    }
-    --it;
-    if (p >= it->start && p < it->end) {
-        return it->attrs;
-    }
-    return runs.front().attrs;
-}
-
-struct Diff {
-    int start = 0;
-    int removedLen = 0;
-    int insertedLen = 0;
-};
-
-Diff diffSingleChange(const QString& before, const QString& after) {
+InlineRichText::Change InlineRichText::diffTextChange(const QString& before, const QString& after) {
     const int aLen = before.size();
     const int bLen = after.size();
 
@@ -197,120 +263,40 @@ Diff diffSingleChange(const QString& before, const QString& after) {
     const int removed = (aLen - prefix - suffix);
     const int inserted = (bLen - prefix - suffix);
 
-    Diff d;
+    Change d;
     d.start = prefix;
     d.removedLen = std::max(0, removed);
     d.insertedLen = std::max(0, inserted);
     return d;
 }
 
-std::vector<Run> applyDelta(std::vector<Run> runs,
-                            int start,
-                            int removedLen,
-                            int insertedLen,
-                            const InlineAttrs& insertAttrs,
-                            int textLenAfter) {
-    const int end = start + removedLen;
-    const int delta = insertedLen - removedLen;
-
-    std::vector<Run> out;
-    out.reserve(runs.size() + 2);
-
-    for (const auto& r : runs) {
-        if (r.end <= start) {
-            out.push_back(r);
-            continue;
-        }
-        if (r.start >= end) {
-            Run shifted = r;
-            shifted.start += delta;
-            shifted.end += delta;
-            out.push_back(shifted);
-            continue;
-        }
-        // Overlapping removal: keep left part and/or right part.
-        if (r.start < start) {
-            out.push_back(Run{r.start, start, r.attrs});
-        }
-        if (r.end > end) {
-            out.push_back(Run{start + insertedLen, (r.end + delta), r.attrs});
-        }
+InlineRichText::Attrs InlineRichText::attrsAtPos(const std::vector<Run>& runs, int pos) {
+    if (runs.empty()) return Attrs{};
+    const int p = std::max(0, pos);
+    auto it = std::upper_bound(runs.begin(), runs.end(), p, [](int value, const Run& r) { return value < r.start; });
+    if (it == runs.begin()) {
+        return runs.front().attrs;
     }
-
-    if (insertedLen > 0) {
-        out.push_back(Run{start, start + insertedLen, insertAttrs});
+    --it;
+    if (p >= it->start && p < it->end) {
+        return it->attrs;
     }
-
-    std::sort(out.begin(), out.end(), [](const Run& a, const Run& b) { return a.start < b.start; });
-    return normalizeRuns(out, textLenAfter);
+    return runs.front().attrs;
 }
 
-InlineAttrs parseStyleToAttrs(const QString& style) {
-    InlineAttrs out;
-    const auto s = style;
-
-    const auto fontFamilyRe = QRegularExpression(QStringLiteral(R"(font-family\s*:\s*([^;]+))"),
-                                                 QRegularExpression::CaseInsensitiveOption);
-    const auto fontSizeRe =
-        QRegularExpression(QStringLiteral(R"(font-size\s*:\s*([0-9]+)\s*(pt|px)?)"),
-                           QRegularExpression::CaseInsensitiveOption);
-    const auto colorRe = QRegularExpression(QStringLiteral(R"(color\s*:\s*(#[0-9a-fA-F]{6}))"));
-
-    if (const auto m = fontFamilyRe.match(s); m.hasMatch()) {
-        auto v = m.captured(1).trimmed();
-        if ((v.startsWith('"') && v.endsWith('"')) || (v.startsWith('\'') && v.endsWith('\''))) {
-            v = v.mid(1, v.size() - 2);
-        }
-        out.fontFamily = v;
-    }
-
-    if (const auto m = fontSizeRe.match(s); m.hasMatch()) {
-        const int n = m.captured(1).toInt();
-        const auto unit = m.captured(2).toLower();
-        if (unit == QStringLiteral("px")) {
-            out.fontPointSize = std::max(1, static_cast<int>(std::round(static_cast<double>(n) * 0.75)));
-        } else {
-            out.fontPointSize = std::max(1, n);
-        }
-    }
-
-    if (const auto m = colorRe.match(s); m.hasMatch()) {
-        const QColor c(m.captured(1));
-        if (c.isValid()) {
-            out.color = c;
-            out.hasColor = true;
-        }
-    }
-
+QVariantMap InlineRichText::parse(const QString& markup) const {
+    const auto parsed = parseRuns(markup);
+    QVariantMap out;
+    out.insert(QStringLiteral("text"), parsed.text);
+    out.insert(QStringLiteral("runs"), runsToVariantList(parsed.runs));
     return out;
 }
 
-InlineAttrs mergeAttrs(const InlineAttrs& base, const InlineAttrs& overlay) {
-    InlineAttrs out = base;
-    if (!overlay.fontFamily.isEmpty()) out.fontFamily = overlay.fontFamily;
-    if (overlay.fontPointSize > 0) out.fontPointSize = overlay.fontPointSize;
-    if (overlay.hasColor) {
-        out.color = overlay.color;
-        out.hasColor = true;
-    }
-    out.bold = base.bold || overlay.bold;
-    out.italic = base.italic || overlay.italic;
-    out.underline = base.underline || overlay.underline;
-    out.strike = base.strike || overlay.strike;
-    return out;
+QString InlineRichText::serialize(const QString& text, const QVariantList& runsVar) const {
+    return serializeRuns(text, runsFromVariantList(runsVar));
 }
 
-struct TagState {
-    InlineAttrs overlay;
-    InlineAttrs prev;
-};
-
-} // namespace
-
-InlineRichText::InlineRichText(QObject* parent)
-    : QObject(parent) {}
-
-QVariantMap InlineRichText::parse(const QString& markup) const {
+InlineRichText::Parsed InlineRichText::parseRuns(const QString& markup) {
     QString plain;
     plain.reserve(markup.size());
 
@@ -454,15 +440,11 @@ QVariantMap InlineRichText::parse(const QString& markup) const {
     // Flush final run.
     flushRunTo(plain.size());
     runs = normalizeRuns(runs, plain.size());
-
-    QVariantMap out;
-    out.insert(QStringLiteral("text"), plain);
-    out.insert(QStringLiteral("runs"), runsToVariantList(runs));
-    return out;
+    return Parsed{std::move(plain), std::move(runs)};
 }
 
-QString InlineRichText::serialize(const QString& text, const QVariantList& runsVar) const {
-    auto runs = normalizeRuns(runsFromVariantList(runsVar), text.size());
+QString InlineRichText::serializeRuns(const QString& text, const std::vector<Run>& unnormalized) {
+    const auto runs = normalizeRuns(unnormalized, text.size());
 
     auto quoteCssString = [](const QString& s) {
         QString escaped;
@@ -543,7 +525,7 @@ QVariantMap InlineRichText::reconcileTextChange(const QString& beforeText,
                                                 const QVariantList& runsVar,
                                                 const QVariantMap& typingAttrsVar,
                                                 int cursorPosition) const {
-    const auto diff = diffSingleChange(beforeText, afterText);
+    const auto diff = diffTextChange(beforeText, afterText);
     auto runs = normalizeRuns(runsFromVariantList(runsVar), beforeText.size());
 
     InlineAttrs insertAttrs;
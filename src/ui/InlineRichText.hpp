@@ -1,17 +1,55 @@
 #pragma once
 
+#include <QColor>
 #include <QObject>
 #include <QVariantList>
 #include <QVariantMap>
 
 #include <QQmlEngine>
 
+#include <vector>
+
 namespace zinc::ui {
 
 class InlineRichText : public QObject {
     Q_OBJECT
 
 public:
+    struct Attrs {
+        QString fontFamily;
+        int fontPointSize = 0;
+        QColor color;
+        bool hasColor = false;
+        bool bold = false;
+        bool italic = false;
+        bool underline = false;
+        bool strike = false;
+
+        bool operator==(const Attrs& o) const {
+            return fontFamily == o.fontFamily && fontPointSize == o.fontPointSize && hasColor == o.hasColor &&
+                   (!hasColor || color == o.color) && bold == o.bold && italic == o.italic &&
+                   underline == o.underline && strike == o.strike;
+        }
+    };
+
+    struct Run {
+        int start = 0;
+        int end = 0;
+        Attrs attrs;
+    };
+
+    // A single contiguous edit: `removedLen` characters at `start` replaced by `insertedLen`.
+    struct Change {
+        int start = 0;
+        int removedLen = 0;
+        int insertedLen = 0;
+    };
+
+    struct Parsed {
+        QString text;
+        std::vector<Run> runs;
+    };
+
     explicit InlineRichText(QObject* parent = nullptr);
 
     static InlineRichText* create(QQmlEngine* engine, QJSEngine*) {
@@ -42,6 +80,20 @@ public:
                                         const QVariantMap& typingAttrs) const;
 
     Q_INVOKABLE QVariantMap attrsAt(const QVariantList& runs, int pos) const;
+
+    // Native forms of the above, used by InlineRunStore and the highlighter. Runs returned
+    // by parseRuns/normalizeRuns are sorted, cover [0, text length) and never repeat attrs
+    // in adjacent runs.
+    static Parsed parseRuns(const QString& markup);
+    static QString serializeRuns(const QString& text, const std::vector<Run>& runs);
+    static std::vector<Run> normalizeRuns(const std::vector<Run>& runs, int textLen);
+    static Attrs attrsAtPos(const std::vector<Run>& runs, int pos);
+    static Change diffTextChange(const QString& before, const QString& after);
+
+    static Attrs attrsFromVariantMap(const QVariantMap& map);
+    static QVariantMap attrsToVariantMap(const Attrs& attrs);
+    static std::vector<Run> runsFromVariantList(const QVariantList& list);
+    static QVariantList runsToVariantList(const std::vector<Run>& runs);
 };
 
 } // namespace zinc::ui
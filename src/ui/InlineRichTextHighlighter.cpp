@@ -1,4 +1,5 @@
 #include "ui/InlineRichTextHighlighter.hpp"
+#include "ui/InlineRunStore.hpp"
 
 #include <QColor>
 #include <QQuickTextDocument>
@@ -6,72 +7,25 @@
 #include <QTextBlock>
 #include <QTextCharFormat>
 #include <QTextDocument>
+#include <QElapsedTimer>
 #include <QMetaObject>
+#include <QTimer>
 
 #include <algorithm>
+#include <limits>
+#include <utility>
 #include <vector>
 
 namespace zinc::ui {
 namespace {
 
-struct InlineAttrs {
-    QString fontFamily;
-    int fontPointSize = 0;
-    QColor color;
-    bool hasColor = false;
-    bool bold = false;
-    bool italic = false;
-    bool underline = false;
-    bool strike = false;
-
-    bool operator==(const InlineAttrs& o) const {
-        return fontFamily == o.fontFamily && fontPointSize == o.fontPointSize && hasColor == o.hasColor &&
-               (!hasColor || color == o.color) && bold == o.bold && italic == o.italic && underline == o.underline &&
-               strike == o.strike;
-    }
-};
+using InlineAttrs = InlineRichText::Attrs;
+using Run = InlineRichText::Run;
 
-struct Run {
-    int start = 0;
-    int end = 0;
-    InlineAttrs attrs;
-};
-
-InlineAttrs attrsFromVariantMap(const QVariantMap& m) {
-    InlineAttrs a;
-    a.fontFamily = m.value(QStringLiteral("fontFamily")).toString();
-    a.fontPointSize = m.value(QStringLiteral("fontPointSize")).toInt();
-    const auto colorStr = m.value(QStringLiteral("color")).toString();
-    if (!colorStr.isEmpty()) {
-        const QColor c(colorStr);
-        if (c.isValid()) {
-            a.color = c;
-            a.hasColor = true;
-        }
-    }
-    a.bold = m.value(QStringLiteral("bold")).toBool();
-    a.italic = m.value(QStringLiteral("italic")).toBool();
-    a.underline = m.value(QStringLiteral("underline")).toBool();
-    a.strike = m.value(QStringLiteral("strike")).toBool();
-    return a;
-}
-
-std::vector<Run> runsFromVariantList(const QVariantList& list) {
-    std::vector<Run> out;
-    out.reserve(static_cast<size_t>(list.size()));
-    for (const auto& v : list) {
-        const auto m = v.toMap();
-        Run r;
-        r.start = m.value(QStringLiteral("start")).toInt();
-        r.end = m.value(QStringLiteral("end")).toInt();
-        r.attrs = attrsFromVariantMap(m.value(QStringLiteral("attrs")).toMap());
-        if (r.end > r.start) {
-            out.push_back(std::move(r));
-        }
-    }
-    std::sort(out.begin(), out.end(), [](const Run& a, const Run& b) { return a.start < b.start; });
-    return out;
-}
+// Documents with more text blocks than this are restyled a slice at a time.
+constexpr int kProgressiveBlockThreshold = 200;
+constexpr int kSliceBudgetMs = 4;
+constexpr int kAllBlocks = std::numeric_limits<int>::max();
 
 QTextCharFormat toFormat(const InlineAttrs& a) {
     QTextCharFormat f;
@@ -92,33 +46,56 @@ public:
     explicit Impl(QTextDocument* doc)
         : QSyntaxHighlighter(doc) {}
 
-    void setRuns(const QVariantList& runs) {
-        m_runs = runsFromVariantList(runs);
-        rehighlight();
+    void setRuns(const QVariantList& runs, const QString& runKey) {
+        m_runs = runKey.isEmpty() ? InlineRichText::runsFromVariantList(runs) : std::vector<Run>{};
+        m_run_key = runKey;
     }
 
+    // Text blocks numbered at or past this are left unstyled until a progressive pass reaches them.
+    int readyBlocks() const { return m_ready_blocks; }
+    void setReadyBlocks(int count) { m_ready_blocks = count; }
+    quint64 highlightedBlocks() const { return m_highlighted_blocks; }
+
 protected:
     void highlightBlock(const QString& text) override {
-        if (m_runs.empty()) return;
+        if (currentBlock().blockNumber() >= m_ready_blocks) return;
+        ++m_highlighted_blocks;
+        const auto* runs = m_run_key.isEmpty() ? &m_runs : InlineRunStore::instance()->runsFor(m_run_key);
+        if (!runs || runs->empty()) return;
         const int blockPos = currentBlock().position();
         const int blockEnd = blockPos + text.size();
 
-        for (const auto& r : m_runs) {
-            if (r.end <= blockPos) continue;
-            if (r.start >= blockEnd) break;
-            const int a = std::max(r.start, blockPos);
-            const int b = std::min(r.end, blockEnd);
+        auto it = std::upper_bound(runs->begin(), runs->end(), blockPos,
+                                   [](int pos, const Run& r) { return pos < r.end; });
+        for (; it != runs->end() && it->start < blockEnd; ++it) {
+            if (it->attrs == InlineRichText::Attrs{}) continue;
+            const int a = std::max(it->start, blockPos);
+            const int b = std::min(it->end, blockEnd);
             if (b <= a) continue;
-            setFormat(a - blockPos, b - a, toFormat(r.attrs));
+            setFormat(a - blockPos, b - a, toFormat(it->attrs));
         }
     }
 
 private:
     std::vector<Run> m_runs;
+    QString m_run_key;
+    int m_ready_blocks = kAllBlocks;
+    quint64 m_highlighted_blocks = 0;
 };
 
 InlineRichTextHighlighter::InlineRichTextHighlighter(QObject* parent)
-    : QObject(parent) {}
+    : QObject(parent) {
+    auto* store = InlineRunStore::instance();
+    connect(store, &InlineRunStore::runsChanged, this, [this](const QString& key) {
+        if (!m_run_key.isEmpty() && key == m_run_key) scheduleApply(true);
+    });
+    connect(store, &InlineRunStore::runsEdited, this,
+            [this](const QString& key, int start, int removedLen, int insertedLen) {
+                if (m_run_key.isEmpty() || key != m_run_key) return;
+                addDamage(start, removedLen, insertedLen);
+                scheduleApply(false);
+            });
+}
 
 InlineRichTextHighlighter::~InlineRichTextHighlighter() = default;
 
@@ -130,7 +107,7 @@ void InlineRichTextHighlighter::setDocument(QQuickTextDocument* doc) {
     if (m_document == doc) return;
     m_document = doc;
     emit documentChanged();
-    scheduleApply();
+    scheduleApply(true);
 }
 
 QVariantList InlineRichTextHighlighter::runs() const {
@@ -141,7 +118,44 @@ void InlineRichTextHighlighter::setRuns(const QVariantList& runs) {
     if (m_runs == runs) return;
     m_runs = runs;
     emit runsChanged();
-    scheduleApply();
+    scheduleApply(!m_change_noted);
+    m_change_noted = false;
+}
+
+quint64 InlineRichTextHighlighter::highlightedBlockCount() const {
+    return m_impl ? m_impl->highlightedBlocks() : 0;
+}
+
+QString InlineRichTextHighlighter::runKey() const {
+    return m_run_key;
+}
+
+void InlineRichTextHighlighter::setRunKey(const QString& key) {
+    if (m_run_key == key) return;
+    m_run_key = key;
+    emit runKeyChanged();
+    scheduleApply(true);
+}
+
+void InlineRichTextHighlighter::noteTextChange(int start, int removedLen, int insertedLen) {
+    addDamage(start, removedLen, insertedLen);
+    m_change_noted = true;
+}
+
+void InlineRichTextHighlighter::addDamage(int start, int removedLen, int insertedLen) {
+    const int end = start + std::max(0, insertedLen);
+    if (m_damage_from < 0) {
+        m_damage_from = start;
+        m_damage_to = end;
+        return;
+    }
+    // Move the pending range through this edit so both are in the latest text's coordinates.
+    const auto shift = [&](int pos) {
+        if (pos >= start + removedLen) return pos + insertedLen - removedLen;
+        return std::min(pos, start);
+    };
+    m_damage_from = std::min(shift(m_damage_from), start);
+    m_damage_to = std::max(shift(m_damage_to), end);
 }
 
 void InlineRichTextHighlighter::rebuildHighlighter() {
@@ -153,10 +167,10 @@ void InlineRichTextHighlighter::rebuildHighlighter() {
     auto* doc = m_document->textDocument();
     if (!doc) return;
     m_impl = new Impl(doc);
-    m_impl->setRuns(m_runs);
 }
 
-void InlineRichTextHighlighter::scheduleApply() {
+void InlineRichTextHighlighter::scheduleApply(bool full) {
+    m_full_apply = m_full_apply || full;
     if (m_apply_scheduled) return;
     m_apply_scheduled = true;
     QMetaObject::invokeMethod(this, [this]() { applyNow(); }, Qt::QueuedConnection);
@@ -164,6 +178,9 @@ void InlineRichTextHighlighter::scheduleApply() {
 
 void InlineRichTextHighlighter::applyNow() {
     m_apply_scheduled = false;
+    bool full = std::exchange(m_full_apply, false);
+    const int from = std::exchange(m_damage_from, -1);
+    const int to = std::exchange(m_damage_to, -1);
 
     if (!m_document) {
         if (m_impl) {
@@ -184,10 +201,57 @@ void InlineRichTextHighlighter::applyNow() {
 
     if (!m_impl || m_impl->document() != doc) {
         rebuildHighlighter();
+        full = true;
+    }
+    m_impl->setRuns(m_runs, m_run_key);
+
+    if (full) {
+        if (doc->blockCount() <= kProgressiveBlockThreshold) {
+            m_impl->setReadyBlocks(kAllBlocks);
+            m_impl->rehighlight();
+        } else {
+            m_impl->setReadyBlocks(0);
+            scheduleSlice();
+        }
         return;
     }
+    if (from < 0) return;
 
-    m_impl->setRuns(m_runs);
+    // Only the text blocks holding the edit can have changed formatting; blocks after it
+    // keep theirs, since formats are stored relative to their block.
+    const int last = std::max(from, to - 1);
+    auto block = doc->findBlock(from);
+    if (!block.isValid()) block = doc->lastBlock();
+    while (block.isValid() && block.position() <= last && block.blockNumber() < m_impl->readyBlocks()) {
+        m_impl->rehighlightBlock(block);
+        block = block.next();
+    }
+}
+
+void InlineRichTextHighlighter::scheduleSlice() {
+    if (m_slice_scheduled) return;
+    m_slice_scheduled = true;
+    // A zero timer yields to the event loop, so the scene can render between slices.
+    QTimer::singleShot(0, this, [this]() { rehighlightSlice(); });
+}
+
+void InlineRichTextHighlighter::rehighlightSlice() {
+    m_slice_scheduled = false;
+    if (!m_impl || !m_impl->document()) return;
+
+    QElapsedTimer timer;
+    timer.start();
+    auto block = m_impl->document()->findBlockByNumber(m_impl->readyBlocks());
+    while (block.isValid()) {
+        m_impl->setReadyBlocks(block.blockNumber() + 1);
+        m_impl->rehighlightBlock(block);
+        block = block.next();
+        if (block.isValid() && timer.elapsed() >= kSliceBudgetMs) {
+            scheduleSlice();
+            return;
+        }
+    }
+    m_impl->setReadyBlocks(kAllBlocks);
 }
 
 } // namespace zinc::ui
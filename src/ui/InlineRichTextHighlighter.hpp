@@ -13,6 +13,8 @@ class InlineRichTextHighlighter : public QObject {
     Q_OBJECT
     Q_PROPERTY(QQuickTextDocument* document READ document WRITE setDocument NOTIFY documentChanged)
     Q_PROPERTY(QVariantList runs READ runs WRITE setRuns NOTIFY runsChanged)
+    // When set, runs are read from InlineRunStore under this key instead of `runs`.
+    Q_PROPERTY(QString runKey READ runKey WRITE setRunKey NOTIFY runKeyChanged)
 
 public:
     explicit InlineRichTextHighlighter(QObject* parent = nullptr);
@@ -24,18 +26,40 @@ public:
     QVariantList runs() const;
     void setRuns(const QVariantList& runs);
 
+    QString runKey() const;
+    void setRunKey(const QString& key);
+
+    // Limits the next `runs` update to restyling the text blocks touched by this edit; pass the
+    // changeStart/removedLen/insertedLen from InlineRichText.reconcileTextChange. Edits made
+    // through InlineRunStore are tracked without this.
+    Q_INVOKABLE void noteTextChange(int start, int removedLen, int insertedLen);
+
+    // Text blocks restyled for the current document so far, including ones with no runs.
+    [[nodiscard]] quint64 highlightedBlockCount() const;
+
 signals:
     void documentChanged();
     void runsChanged();
+    void runKeyChanged();
 
 private:
     void rebuildHighlighter();
-    void scheduleApply();
+    void addDamage(int start, int removedLen, int insertedLen);
+    void scheduleApply(bool full);
     void applyNow();
+    void scheduleSlice();
+    void rehighlightSlice();
 
     QPointer<QQuickTextDocument> m_document;
     QVariantList m_runs;
+    QString m_run_key;
     bool m_apply_scheduled = false;
+    // Pending restyle: the whole document, or the text range [m_damage_from, m_damage_to).
+    bool m_full_apply = false;
+    int m_damage_from = -1;
+    int m_damage_to = -1;
+    bool m_change_noted = false;
+    bool m_slice_scheduled = false;
 
     class Impl;
     QPointer<Impl> m_impl;
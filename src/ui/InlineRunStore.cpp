@@ -0,0 +1,246 @@
+#include "ui/InlineRunStore.hpp"
+
+#include <algorithm>
+
+namespace zinc::ui {
+namespace {
+
+using Attrs = InlineRichText::Attrs;
+using Run = InlineRichText::Run;
+
+bool isPlain(const Attrs& attrs) {
+    return attrs == Attrs{};
+}
+
+// Index of the first run ending after `pos` (the run containing it), or runs.size().
+size_t runAt(const std::vector<Run>& runs, int pos) {
+    const auto it = std::upper_bound(runs.begin(), runs.end(), pos,
+                                     [](int p, const Run& r) { return p < r.end; });
+    return static_cast<size_t>(it - runs.begin());
+}
+
+void shiftRuns(std::vector<Run>& runs, size_t from, int delta) {
+    for (size_t i = from; i < runs.size(); ++i) {
+        runs[i].start += delta;
+        runs[i].end += delta;
+    }
+}
+
+void insertRun(std::vector<Run>& runs, int pos, int length, const Attrs& attrs) {
+    if (length <= 0) return;
+    const size_t i = runAt(runs, pos);
+    if (i == runs.size()) {
+        if (!runs.empty() && runs.back().attrs == attrs) {
+            runs.back().end += length;
+        } else {
+            runs.push_back(Run{pos, pos + length, attrs});
+        }
+        return;
+    }
+
+    Run& run = runs[i];
+    if (run.attrs == attrs) {
+        run.end += length;
+        shiftRuns(runs, i + 1, length);
+        return;
+    }
+    if (run.start < pos) {
+        const Run right{pos + length, run.end + length, run.attrs};
+        run.end = pos;
+        shiftRuns(runs, i + 1, length);
+        runs.insert(runs.begin() + static_cast<std::ptrdiff_t>(i) + 1, {Run{pos, pos + length, attrs}, right});
+        return;
+    }
+    if (i > 0 && runs[i - 1].attrs == attrs) {
+        runs[i - 1].end += length;
+        shiftRuns(runs, i, length);
+        return;
+    }
+    shiftRuns(runs, i, length);
+    runs.insert(runs.begin() + static_cast<std::ptrdiff_t>(i), Run{pos, pos + length, attrs});
+}
+
+void removeRange(std::vector<Run>& runs, int pos, int length) {
+    if (length <= 0) return;
+    const int end = pos + length;
+    const size_t first = runAt(runs, pos);
+    size_t last = first;
+    while (last < runs.size() && runs[last].start < end) {
+        ++last;
+    }
+    if (first == last) return;
+
+    if (first + 1 == last && runs[first].start < pos && runs[first].end > end) {
+        runs[first].end -= length;
+        shiftRuns(runs, last, -length);
+        return;
+    }
+
+    size_t eraseFrom = first;
+    size_t eraseTo = last;
+    if (runs[first].start < pos) {
+        runs[first].end = pos;
+        eraseFrom = first + 1;
+    }
+    if (runs[last - 1].end > end) {
+        runs[last - 1].start = pos;
+        runs[last - 1].end -= length;
+        eraseTo = last - 1;
+    }
+    shiftRuns(runs, last, -length);
+    runs.erase(runs.begin() + static_cast<std::ptrdiff_t>(eraseFrom),
+               runs.begin() + static_cast<std::ptrdiff_t>(eraseTo));
+
+    // The pieces either side of the removed range may now be equal neighbours.
+    const size_t seam = eraseFrom;
+    if (seam > 0 && seam < runs.size() && runs[seam - 1].attrs == runs[seam].attrs) {
+        runs[seam - 1].end = runs[seam].end;
+        runs.erase(runs.begin() + static_cast<std::ptrdiff_t>(seam));
+    }
+}
+
+} // namespace
+
+InlineRunStore::InlineRunStore(QObject* parent)
+    : QObject(parent) {}
+
+QString InlineRunStore::retain(const QString& key) {
+    const QString k = key.isEmpty() ? QStringLiteral("inline-runs:%1").arg(++next_key_) : key;
+    ++entries_[k].refs;
+    return k;
+}
+
+void InlineRunStore::release(const QString& key) {
+    auto it = entries_.find(key);
+    if (it == entries_.end()) return;
+    if (--it->refs <= 0) {
+        entries_.erase(it);
+    }
+}
+
+InlineRunStore::Entry* InlineRunStore::find(const QString& key) {
+    auto it = entries_.find(key);
+    return it == entries_.end() ? nullptr : &it.value();
+}
+
+const InlineRunStore::Entry* InlineRunStore::find(const QString& key) const {
+    auto it = entries_.constFind(key);
+    return it == entries_.cend() ? nullptr : &it.value();
+}
+
+QString InlineRunStore::load(const QString& key, const QString& markup) {
+    auto parsed = InlineRichText::parseRuns(markup);
+    auto& entry = entries_[key];
+    entry.text = std::move(parsed.text);
+    entry.runs = std::move(parsed.runs);
+    emit runsChanged(key);
+    return entry.text;
+}
+
+QString InlineRunStore::markup(const QString& key) const {
+    const auto* entry = find(key);
+    if (!entry) return {};
+    if (entry->runs.empty() || (entry->runs.size() == 1 && isPlain(entry->runs.front().attrs))) {
+        return entry->text;
+    }
+    return InlineRichText::serializeRuns(entry->text, entry->runs);
+}
+
+QString InlineRunStore::text(const QString& key) const {
+    const auto* entry = find(key);
+    return entry ? entry->text : QString();
+}
+
+void InlineRunStore::insertInto(Entry& entry, int pos, const QString& text) {
+    const Attrs attrs = isPlain(entry.typing)
+                            ? InlineRichText::attrsAtPos(entry.runs, pos > 0 ? pos - 1 : pos)
+                            : entry.typing;
+    insertRun(entry.runs, pos, static_cast<int>(text.size()), attrs);
+    entry.text.insert(pos, text);
+}
+
+void InlineRunStore::removeFrom(Entry& entry, int pos, int length) {
+    removeRange(entry.runs, pos, length);
+    entry.text.remove(pos, length);
+}
+
+void InlineRunStore::insert(const QString& key, int pos, const QString& text) {
+    auto* entry = find(key);
+    if (!entry || text.isEmpty()) return;
+    const int at = std::clamp(pos, 0, static_cast<int>(entry->text.size()));
+    insertInto(*entry, at, text);
+    emit runsEdited(key, at, 0, static_cast<int>(text.size()));
+}
+
+void InlineRunStore::remove(const QString& key, int pos, int length) {
+    auto* entry = find(key);
+    if (!entry) return;
+    const int len = static_cast<int>(entry->text.size());
+    const int a = std::clamp(pos, 0, len);
+    const int b = std::clamp(pos + std::max(0, length), a, len);
+    if (b == a) return;
+    removeFrom(*entry, a, b - a);
+    emit runsEdited(key, a, b - a, 0);
+}
+
+bool InlineRunStore::reconcile(const QString& key, const QString& text, int cursorPosition) {
+    auto* entry = find(key);
+    if (!entry || entry->text == text) return false;
+
+    const auto change = InlineRichText::diffTextChange(entry->text, text);
+    const Attrs attrs = (change.insertedLen > 0 && !isPlain(entry->typing))
+                            ? entry->typing
+                            : InlineRichText::attrsAtPos(entry->runs, change.start > 0 ? change.start - 1 : change.start);
+    removeRange(entry->runs, change.start, change.removedLen);
+    insertRun(entry->runs, change.start, change.insertedLen, attrs);
+    entry->text = text;
+
+    // Pure deletion moves the caret into new context, so typing follows the text there.
+    if (change.insertedLen == 0 && change.removedLen > 0) {
+        const int last = static_cast<int>(text.size()) - 1;
+        entry->typing = InlineRichText::attrsAtPos(entry->runs, std::max(0, std::min(cursorPosition, last)));
+    }
+    emit runsEdited(key, change.start, change.removedLen, change.insertedLen);
+    return true;
+}
+
+void InlineRunStore::moveCursor(const QString& key, int cursorPosition) {
+    auto* entry = find(key);
+    if (!entry) return;
+    // A caret at the end of the text has no character under it; typing then inherits on insert.
+    entry->typing = (cursorPosition < 0 || cursorPosition >= entry->text.size())
+                        ? Attrs{}
+                        : InlineRichText::attrsAtPos(entry->runs, cursorPosition);
+}
+
+QVariantList InlineRunStore::runs(const QString& key) const {
+    const auto* entry = find(key);
+    return entry ? InlineRichText::runsToVariantList(entry->runs) : QVariantList();
+}
+
+void InlineRunStore::setRuns(const QString& key, const QString& text, const QVariantList& runs) {
+    auto* entry = find(key);
+    if (!entry) return;
+    entry->text = text;
+    entry->runs = InlineRichText::normalizeRuns(InlineRichText::runsFromVariantList(runs),
+                                                static_cast<int>(text.size()));
+    emit runsChanged(key);
+}
+
+QVariantMap InlineRunStore::typingAttrs(const QString& key) const {
+    const auto* entry = find(key);
+    return entry ? InlineRichText::attrsToVariantMap(entry->typing) : QVariantMap();
+}
+
+void InlineRunStore::setTypingAttrs(const QString& key, const QVariantMap& attrs) {
+    if (auto* entry = find(key)) {
+        entry->typing = InlineRichText::attrsFromVariantMap(attrs);
+    }
+}
+
+const std::vector<InlineRichText::Run>* InlineRunStore::runsFor(const QString& key) const {
+    const auto* entry = find(key);
+    return entry ? &entry->runs : nullptr;
+}
+
+} // namespace zinc::ui
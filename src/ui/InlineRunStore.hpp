@@ -0,0 +1,95 @@
+#pragma once
+
+#include <QHash>
+#include <QObject>
+#include <QVariantList>
+#include <QVariantMap>
+
+#include <QQmlEngine>
+
+#include <vector>
+
+#include "ui/InlineRichText.hpp"
+
+namespace zinc::ui {
+
+/**
+ * InlineRunStore - native inline formatting state for the blocks being edited.
+ *
+ * Each entry holds a block's plain text, its runs (sorted, covering the whole text, no equal
+ * neighbours) and the attrs for the next typed character. Text edits are applied to the runs
+ * in place, so a keystroke costs a diff of the two strings plus a shift of the runs after the
+ * caret; no QVariant lists cross into QML. InlineRichTextHighlighter reads the runs directly
+ * by key.
+ *
+ * Entries are keyed by block id and reference counted by the editors using them.
+ */
+class InlineRunStore : public QObject {
+    Q_OBJECT
+
+public:
+    using Attrs = InlineRichText::Attrs;
+    using Run = InlineRichText::Run;
+
+    explicit InlineRunStore(QObject* parent = nullptr);
+
+    static InlineRunStore* create(QQmlEngine* engine, QJSEngine*) {
+        static InlineRunStore instance;
+        if (engine) {
+            QQmlEngine::setObjectOwnership(&instance, QQmlEngine::CppOwnership);
+        }
+        return &instance;
+    }
+    static InlineRunStore* instance() { return create(nullptr, nullptr); }
+
+    // Takes a reference on `key`'s entry and returns the key; an empty key gets a fresh one.
+    Q_INVOKABLE QString retain(const QString& key);
+    Q_INVOKABLE void release(const QString& key);
+
+    // Replaces the entry with parsed `markup` and returns its plain text. Typing attrs are kept.
+    Q_INVOKABLE QString load(const QString& key, const QString& markup);
+    Q_INVOKABLE QString markup(const QString& key) const;
+    Q_INVOKABLE QString text(const QString& key) const;
+
+    // Inserted text takes the typing attrs if set, otherwise the attrs of the preceding character.
+    Q_INVOKABLE void insert(const QString& key, int pos, const QString& text);
+    Q_INVOKABLE void remove(const QString& key, int pos, int length);
+    // Applies the single contiguous edit that turns the stored text into `text`, with the same
+    // rules as InlineRichText.reconcileTextChange. Returns false if the text did not change.
+    Q_INVOKABLE bool reconcile(const QString& key, const QString& text, int cursorPosition);
+    // Updates the typing attrs for a caret at `cursorPosition`, like InlineRichText.attrsAt.
+    Q_INVOKABLE void moveCursor(const QString& key, int cursorPosition);
+
+    Q_INVOKABLE QVariantList runs(const QString& key) const;
+    Q_INVOKABLE void setRuns(const QString& key, const QString& text, const QVariantList& runs);
+    Q_INVOKABLE QVariantMap typingAttrs(const QString& key) const;
+    Q_INVOKABLE void setTypingAttrs(const QString& key, const QVariantMap& attrs);
+
+    // Valid until the entry is next modified; nullptr for unknown keys.
+    [[nodiscard]] const std::vector<Run>* runsFor(const QString& key) const;
+
+signals:
+    // The entry was replaced wholesale (load, setRuns).
+    void runsChanged(const QString& key);
+    // `removedLen` characters at `start` were replaced by `insertedLen`; only the inserted
+    // range carries new formatting.
+    void runsEdited(const QString& key, int start, int removedLen, int insertedLen);
+
+private:
+    struct Entry {
+        QString text;
+        std::vector<Run> runs;
+        Attrs typing;
+        int refs = 0;
+    };
+
+    Entry* find(const QString& key);
+    const Entry* find(const QString& key) const;
+    void insertInto(Entry& entry, int pos, const QString& text);
+    void removeFrom(Entry& entry, int pos, int length);
+
+    QHash<QString, Entry> entries_;
+    quint64 next_key_ = 0;
+};
+
+} // namespace zinc::ui
@@ -1,12 +1,12 @@
 #include "ui/MarkdownBlocks.hpp"
 
-#include <QRegularExpression>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonParseError>
 #include <QStringList>
 #include <algorithm>
 #include <optional>
+#include <vector>
 
 namespace zinc::ui {
 
@@ -80,60 +80,130 @@ QString image_to_markdown(const QString& content) {
     return QStringLiteral("![](%1%2)").arg(src, title);
 }
 
-std::optional<QString> parse_image(const QString& line) {
-    static const QRegularExpression re1(
-        R"re(^!\[[^\]]*\]\(<([^>]+)>(?:\s+"([^"]*)")?\)\s*$)re");
-    if (const auto m = re1.match(line); m.hasMatch()) {
-        const auto src = m.captured(1).trimmed();
-        const auto title = m.captured(2).trimmed();
-        int w = 0;
-        int h = 0;
-        const auto parts = title.split(' ', Qt::SkipEmptyParts);
-        for (const auto& part : parts) {
-            if (part.startsWith(QStringLiteral("zinc-w="))) {
-                w = part.mid(QStringLiteral("zinc-w=").size()).toInt();
-            } else if (part.startsWith(QStringLiteral("zinc-h="))) {
-                h = part.mid(QStringLiteral("zinc-h=").size()).toInt();
-            }
+constexpr QStringView kHeaderLine = u"<!-- zinc-blocks v1 -->";
+
+// The ASCII whitespace class (`\s` without Unicode properties). Line trimming still uses
+// QChar::isSpace, matching QString::trimmed().
+constexpr bool is_ascii_space(QChar c) {
+    const auto u = c.unicode();
+    return u == u' ' || (u >= u'\t' && u <= u'\r');
+}
+
+qsizetype skip_spaces(QStringView s, qsizetype i) {
+    while (i < s.size() && is_ascii_space(s[i])) ++i;
+    return i;
+}
+
+struct Line {
+    qsizetype start = 0;
+    qsizetype end = 0; // exclusive, includes newline if present
+    QStringView text;
+    QStringView trimmed;
+};
+
+std::vector<Line> split_lines(QStringView markdown) {
+    std::vector<Line> lines;
+    lines.reserve(static_cast<size_t>(markdown.size() / 32 + 1));
+    qsizetype pos = 0;
+    for (;;) {
+        auto lineEnd = markdown.indexOf(u'\n', pos);
+        const bool hasNewline = lineEnd >= 0;
+        if (!hasNewline) lineEnd = markdown.size();
+        const auto text = markdown.sliced(pos, lineEnd - pos);
+        lines.push_back(Line{
+            .start = pos,
+            .end = hasNewline ? lineEnd + 1 : lineEnd,
+            .text = text,
+            .trimmed = text.trimmed(),
+        });
+        if (!hasNewline) break;
+        pos = lineEnd + 1;
+    }
+    return lines;
+}
+
+// Lines [first, last) joined by their newlines, as a view into the source.
+QStringView line_range(QStringView markdown, const std::vector<Line>& lines, size_t first, size_t last) {
+    if (first >= last) return {};
+    const auto begin = lines[first].start;
+    return markdown.sliced(begin, lines[last - 1].start + lines[last - 1].text.size() - begin);
+}
+
+QString image_json(QStringView src, QStringView title) {
+    int w = 0;
+    int h = 0;
+    const auto parts = title.trimmed().split(u' ', Qt::SkipEmptyParts);
+    for (const auto& part : parts) {
+        if (part.startsWith(u"zinc-w=")) {
+            w = part.sliced(7).toInt();
+        } else if (part.startsWith(u"zinc-h=")) {
+            h = part.sliced(7).toInt();
         }
-        const auto json = QJsonObject{
-            {QStringLiteral("src"), src},
-            {QStringLiteral("w"), w},
-            {QStringLiteral("h"), h},
-        };
-        return QString::fromUtf8(QJsonDocument(json).toJson(QJsonDocument::Compact));
     }
-    static const QRegularExpression re2(
-        R"re(^!\[[^\]]*\]\(([^)]+?)(?:\s+"([^"]*)")?\)\s*$)re");
-    if (const auto m = re2.match(line); m.hasMatch()) {
-        const auto src = m.captured(1).trimmed();
-        const auto title = m.captured(2).trimmed();
-        int w = 0;
-        int h = 0;
-        const auto parts = title.split(' ', Qt::SkipEmptyParts);
-        for (const auto& part : parts) {
-            if (part.startsWith(QStringLiteral("zinc-w="))) {
-                w = part.mid(QStringLiteral("zinc-w=").size()).toInt();
-            } else if (part.startsWith(QStringLiteral("zinc-h="))) {
-                h = part.mid(QStringLiteral("zinc-h=").size()).toInt();
-            }
+    const auto json = QJsonObject{
+        {QStringLiteral("src"), src.trimmed().toString()},
+        {QStringLiteral("w"), w},
+        {QStringLiteral("h"), h},
+    };
+    return QString::fromUtf8(QJsonDocument(json).toJson(QJsonDocument::Compact));
+}
+
+// `![alt](<src> "title")` or `![alt](src "title")`, followed only by whitespace.
+std::optional<QString> parse_image(QStringView line) {
+    if (!line.startsWith(u"![")) return std::nullopt;
+    const auto close = line.indexOf(u']', 2);
+    if (close < 0 || close + 1 >= line.size() || line[close + 1] != u'(') return std::nullopt;
+    const auto open = close + 2;
+
+    auto closes_at = [&](qsizetype i) {
+        return i < line.size() && line[i] == u')' && skip_spaces(line, i + 1) == line.size();
+    };
+    auto title_at = [&](qsizetype i) -> std::optional<QStringView> {
+        const auto quote = skip_spaces(line, i);
+        if (quote == i || quote >= line.size() || line[quote] != u'"') return std::nullopt;
+        const auto endQuote = line.indexOf(u'"', quote + 1);
+        if (endQuote < 0 || !closes_at(endQuote + 1)) return std::nullopt;
+        return line.sliced(quote + 1, endQuote - quote - 1);
+    };
+
+    if (open < line.size() && line[open] == u'<') {
+        const auto gt = line.indexOf(u'>', open + 1);
+        if (gt > open + 1) {
+            const auto src = line.sliced(open + 1, gt - open - 1);
+            if (closes_at(gt + 1)) return image_json(src, {});
+            if (const auto title = title_at(gt + 1)) return image_json(src, *title);
         }
-        const auto json = QJsonObject{
-            {QStringLiteral("src"), src},
-            {QStringLiteral("w"), w},
-            {QStringLiteral("h"), h},
-        };
-        return QString::fromUtf8(QJsonDocument(json).toJson(QJsonDocument::Compact));
+    }
+
+    // Unbracketed source: the shortest run before `)` or a title that ends the line.
+    for (auto i = open + 1; i <= line.size() && line[i - 1] != u')'; ++i) {
+        const auto src = line.sliced(open, i - open);
+        if (const auto title = title_at(i)) return image_json(src, *title);
+        if (closes_at(i)) return image_json(src, {});
     }
     return std::nullopt;
 }
 
-std::optional<QString> parse_columns(const QString& line) {
-    static const QRegularExpression re(
-        R"(^<!--\s*zinc-columns\s+v1\s+(.+?)\s*-->\s*$)");
-    const auto m = re.match(line);
-    if (!m.hasMatch()) return std::nullopt;
-    const auto json = m.captured(1).trimmed();
+// `<!-- zinc-columns v1 {...} -->` with a JSON object payload.
+std::optional<QStringView> parse_columns(QStringView line) {
+    if (!line.startsWith(u"<!--")) return std::nullopt;
+    auto i = skip_spaces(line, 4);
+    if (!line.sliced(i).startsWith(u"zinc-columns")) return std::nullopt;
+    i += 12;
+    if (skip_spaces(line, i) == i) return std::nullopt;
+    i = skip_spaces(line, i);
+    if (!line.sliced(i).startsWith(u"v1")) return std::nullopt;
+    i += 2;
+    if (skip_spaces(line, i) == i) return std::nullopt;
+    i = skip_spaces(line, i);
+
+    auto e = line.size();
+    while (e > i && is_ascii_space(line[e - 1])) --e;
+    if (e - i < 3 || line.sliced(e - 3, 3) != u"-->") return std::nullopt;
+    e -= 3;
+    const auto json = line.sliced(i, e - i).trimmed();
+    if (json.isEmpty()) return std::nullopt;
+
     QJsonParseError err{};
     const auto doc = QJsonDocument::fromJson(json.toUtf8(), &err);
     if (err.error != QJsonParseError::NoError || !doc.isObject()) {
@@ -142,9 +212,128 @@ std::optional<QString> parse_columns(const QString& line) {
     return json;
 }
 
-bool is_bulleted_list_item(const QString& line) {
-    static const QRegularExpression bulletRe(R"(^\s*-\s+(?!\[).+$)");
-    return bulletRe.match(line).hasMatch();
+// `- item`, but not `- [ ] todo`.
+bool is_bulleted_list_item(QStringView line) {
+    const auto dash = skip_spaces(line, 0);
+    if (dash >= line.size() || line[dash] != u'-') return false;
+    const auto next = skip_spaces(line, dash + 1);
+    const auto gap = next - dash - 1;
+    if (gap == 0) return false;
+    // With two or more spaces after the dash, the second one is item text.
+    return gap >= 2 || (next < line.size() && line[next] != u'[');
+}
+
+struct Heading {
+    int level = 0;
+    QStringView text;
+};
+
+// `# Title` through `### Title`, on a trimmed line.
+std::optional<Heading> parse_heading(QStringView trimmed) {
+    qsizetype level = 0;
+    while (level < trimmed.size() && trimmed[level] == u'#') ++level;
+    if (level < 1 || level > 3) return std::nullopt;
+    const auto text = skip_spaces(trimmed, level);
+    if (text == level) return std::nullopt;
+    return Heading{static_cast<int>(level), trimmed.sliced(text)};
+}
+
+struct Todo {
+    int depth = 0;
+    bool checked = false;
+    QStringView text;
+};
+
+// `- [ ] task` / `- [x] task`, two spaces of indent per level.
+std::optional<Todo> parse_todo(QStringView line) {
+    const auto indent = skip_spaces(line, 0);
+    if (indent >= line.size() || line[indent] != u'-') return std::nullopt;
+    const auto box = skip_spaces(line, indent + 1);
+    if (box == indent + 1 || box + 3 > line.size()) return std::nullopt;
+    if (line[box] != u'[' || line[box + 2] != u']') return std::nullopt;
+    const auto mark = line[box + 1];
+    if (mark != u' ' && mark != u'x' && mark != u'X') return std::nullopt;
+    const auto text = skip_spaces(line, box + 3);
+    if (text == box + 3) return std::nullopt;
+    return Todo{static_cast<int>(indent / 2), mark != u' ', line.sliced(text)};
+}
+
+struct Toggle {
+    bool open = false;
+    QStringView summary;
+};
+
+// `<details open><summary>...</summary></details>` on a trimmed line.
+std::optional<Toggle> parse_details(QStringView trimmed) {
+    if (!trimmed.startsWith(u"<details")) return std::nullopt;
+    qsizetype i = 8;
+    bool open = false;
+    if (i < trimmed.size() && trimmed[i] == u'>') {
+        ++i;
+    } else {
+        const auto attr = skip_spaces(trimmed, i);
+        if (attr == i || !trimmed.sliced(attr).startsWith(u"open>")) return std::nullopt;
+        open = true;
+        i = attr + 5;
+    }
+    i = skip_spaces(trimmed, i);
+    if (!trimmed.sliced(i).startsWith(u"<summary>")) return std::nullopt;
+    i += 9;
+
+    if (!trimmed.endsWith(u"</details>")) return std::nullopt;
+    auto e = trimmed.size() - 10;
+    while (e > i && is_ascii_space(trimmed[e - 1])) --e;
+    if (e - i < 10 || trimmed.sliced(e - 10, 10) != u"</summary>") return std::nullopt;
+    return Toggle{open, trimmed.sliced(i, e - 10 - i)};
+}
+
+using ParsedBlock = MarkdownBlocks::ParsedBlock;
+using BlockType = ParsedBlock::Type;
+
+ParsedBlock make_parsed(BlockType type, QStringView content, qsizetype start, qsizetype end) {
+    ParsedBlock block;
+    block.type = type;
+    block.content = content;
+    block.start = start;
+    block.end = end;
+    return block;
+}
+
+ParsedBlock make_owned(BlockType type, QString content, qsizetype start, qsizetype end) {
+    ParsedBlock block;
+    block.type = type;
+    block.owned = std::move(content);
+    block.ownsContent = true;
+    block.start = start;
+    block.end = end;
+    return block;
+}
+
+// Consecutive `>` lines starting at `first`; returns one past the last quoted line.
+size_t collect_quote(const std::vector<Line>& lines, size_t first, QString& out) {
+    size_t j = first;
+    for (; j < lines.size() && lines[j].trimmed.startsWith(u'>'); ++j) {
+        auto q = lines[j].trimmed.sliced(1);
+        if (q.startsWith(u' ')) q = q.sliced(1);
+        if (j > first) out += u'\n';
+        out += q;
+    }
+    return j;
+}
+
+// A bullet line followed by more bullets or lines indented past its dash; returns one past
+// the last line of the list.
+size_t collect_bullets(const std::vector<Line>& lines, size_t first) {
+    const auto baseIndent = skip_spaces(lines[first].text, 0);
+    size_t j = first + 1;
+    for (; j < lines.size(); ++j) {
+        if (lines[j].trimmed.isEmpty()) break;
+        if (is_bulleted_list_item(lines[j].text)) continue;
+        // Continuation line: indented beyond the bullet level.
+        if (skip_spaces(lines[j].text, 0) > baseIndent) continue;
+        break;
+    }
+    return j;
 }
 
 } // namespace
@@ -154,7 +343,7 @@ MarkdownBlocks::MarkdownBlocks(QObject* parent)
 }
 
 QString MarkdownBlocks::headerLine() {
-    return QStringLiteral("<!-- zinc-blocks v1 -->");
+    return kHeaderLine.toString();
 }
 
 bool MarkdownBlocks::isZincBlocksPayload(const QString& markdown) const {
@@ -302,339 +491,272 @@ QString MarkdownBlocks::serializeContent(const QVariantList& blocks) const {
     return out.join('\n') + "\n";
 }
 
-QVariantList MarkdownBlocks::parse(const QString& markdown) const {
-    QStringList lines = markdown.split('\n');
-    while (!lines.isEmpty() && lines.last().isEmpty()) {
-        lines.removeLast();
+QString MarkdownBlocks::typeName(ParsedBlock::Type type) {
+    switch (type) {
+    case BlockType::Paragraph: return QStringLiteral("paragraph");
+    case BlockType::Heading: return QStringLiteral("heading");
+    case BlockType::Todo: return QStringLiteral("todo");
+    case BlockType::Bulleted: return QStringLiteral("bulleted");
+    case BlockType::Quote: return QStringLiteral("quote");
+    case BlockType::Code: return QStringLiteral("code");
+    case BlockType::Divider: return QStringLiteral("divider");
+    case BlockType::Toggle: return QStringLiteral("toggle");
+    case BlockType::Image: return QStringLiteral("image");
+    case BlockType::Columns: return QStringLiteral("columns");
     }
+    return QStringLiteral("paragraph");
+}
 
-    int start = 0;
-    for (; start < lines.size(); ++start) {
-        if (!lines[start].trimmed().isEmpty()) break;
-    }
-    if (start < lines.size() && lines[start].trimmed() == headerLine()) {
-        ++start;
+QVariantMap MarkdownBlocks::toVariantMap(const ParsedBlock& block) {
+    return make_block(typeName(block.type),
+                      block.text().toString(),
+                      block.depth,
+                      block.checked,
+                      block.collapsed,
+                      block.language.toString(),
+                      block.headingLevel);
+}
+
+std::vector<MarkdownBlocks::ParsedBlock> MarkdownBlocks::parseBlocks(QStringView markdown) {
+    auto lines = split_lines(markdown);
+    while (!lines.empty() && lines.back().text.isEmpty()) {
+        lines.pop_back();
     }
 
-    QVariantList blocks;
+    size_t i = 0;
+    while (i < lines.size() && lines[i].trimmed.isEmpty()) ++i;
+    if (i < lines.size() && lines[i].trimmed == kHeaderLine) {
+        ++i;
+    }
 
-    auto emit_paragraph = [&](QStringList& buffer) {
-        if (buffer.isEmpty()) return;
-        blocks.append(make_block("paragraph", buffer.join('\n')));
-        buffer.clear();
+    std::vector<ParsedBlock> blocks;
+    blocks.reserve(lines.size() / 2 + 1);
+
+    // Paragraph lines are always consecutive, so the pending paragraph is a line range.
+    size_t paraFirst = 0;
+    size_t paraEnd = 0;
+    auto emit_paragraph = [&] {
+        if (paraFirst == paraEnd) return;
+        blocks.push_back(make_parsed(BlockType::Paragraph,
+                                     line_range(markdown, lines, paraFirst, paraEnd),
+                                     lines[paraFirst].start, lines[paraEnd - 1].end));
+        paraFirst = paraEnd = 0;
     };
 
-    QStringList paragraph;
-    for (int i = start; i < lines.size(); ++i) {	
-        const auto line = lines[i];
-        const auto trimmed = line.trimmed();
+    for (; i < lines.size(); ++i) {
+        const auto& line = lines[i];
+        const auto trimmed = line.trimmed;
 
-        if (is_bulleted_list_item(line)) {
-            emit_paragraph(paragraph);
-
-            QStringList listLines;
-            listLines << line;
-            const int baseIndent = line.indexOf('-');
-            for (++i; i < lines.size(); ++i) {
-                const auto next = lines[i];
-                if (next.trimmed().isEmpty()) {
-                    --i;
-                    break;
-                }
-                if (is_bulleted_list_item(next)) {
-                    listLines << next;
-                    continue;
-                }
-                // Continuation line: indented beyond the bullet level.
-                const int nonSpace = next.indexOf(QRegularExpression("\\S"));
-                if (nonSpace >= 0 && nonSpace > baseIndent) {
-                    listLines << next;
-                    continue;
-                }
-                --i;
-                break;
-            }
-            blocks.append(make_block("bulleted", listLines.join('\n')));
+        if (is_bulleted_list_item(line.text)) {
+            emit_paragraph();
+            const auto end = collect_bullets(lines, i);
+            blocks.push_back(make_parsed(BlockType::Bulleted, line_range(markdown, lines, i, end),
+                                         line.start, lines[end - 1].end));
+            i = end - 1;
             continue;
         }
 
-        if (auto cols = parse_columns(line)) {
-            emit_paragraph(paragraph);
-            blocks.append(make_block("columns", *cols));
+        if (auto cols = parse_columns(line.text)) {
+            emit_paragraph();
+            blocks.push_back(make_parsed(BlockType::Columns, *cols, line.start, line.end));
             continue;
         }
 
-        if (auto image = parse_image(line)) {
-            emit_paragraph(paragraph);
-            blocks.append(make_block("image", *image));
+        if (auto image = parse_image(line.text)) {
+            emit_paragraph();
+            blocks.push_back(make_owned(BlockType::Image, std::move(*image), line.start, line.end));
             continue;
         }
 
-        if (trimmed.startsWith("```")) {
-            emit_paragraph(paragraph);
-
-            const auto language = trimmed.mid(3).trimmed();
-            QStringList code;
-            for (++i; i < lines.size(); ++i) {
-                if (lines[i].trimmed() == "```") {
-                    break;
-                }
-                code << lines[i];
-            }
-            blocks.append(make_block("code", code.join('\n'), 0, false, false, language));
+        if (trimmed.startsWith(u"```")) {
+            emit_paragraph();
+            size_t j = i + 1;
+            while (j < lines.size() && lines[j].trimmed != u"```") ++j;
+            auto block = make_parsed(BlockType::Code, line_range(markdown, lines, i + 1, j),
+                                     line.start, lines[std::min(j, lines.size() - 1)].end);
+            block.language = trimmed.sliced(3).trimmed();
+            blocks.push_back(block);
+            i = j;
             continue;
         }
 
-        if (trimmed.startsWith("<details")) {
-            emit_paragraph(paragraph);
-
-            static const QRegularExpression detailsRe(
-                R"(^<details(\s+open)?>\s*<summary>(.*)</summary>\s*</details>\s*$)");
-            const auto m = detailsRe.match(trimmed);
-            if (m.hasMatch()) {
-                const bool open = !m.captured(1).isEmpty();
-                const auto summary = m.captured(2);
-                blocks.append(make_block("toggle", summary, 0, false, !open));
+        if (trimmed.startsWith(u"<details")) {
+            emit_paragraph();
+            if (auto toggle = parse_details(trimmed)) {
+                auto block = make_parsed(BlockType::Toggle, toggle->summary, line.start, line.end);
+                block.collapsed = !toggle->open;
+                blocks.push_back(block);
                 continue;
             }
         }
 
-        if (trimmed == "---") {
-            emit_paragraph(paragraph);
-            blocks.append(make_block("divider", QString()));
+        if (trimmed == u"---") {
+            emit_paragraph();
+            blocks.push_back(make_parsed(BlockType::Divider, {}, line.start, line.end));
             continue;
         }
 
-        static const QRegularExpression headingRe(R"(^(#{1,3})\s+(.*)$)");
-        if (auto m = headingRe.match(trimmed); m.hasMatch()) {
-            emit_paragraph(paragraph);
-            const int level = m.captured(1).size();
-            blocks.append(make_block("heading", m.captured(2), 0, false, false, {}, level));
+        if (auto heading = parse_heading(trimmed)) {
+            emit_paragraph();
+            auto block = make_parsed(BlockType::Heading, heading->text, line.start, line.end);
+            block.headingLevel = heading->level;
+            blocks.push_back(block);
             continue;
         }
 
-        static const QRegularExpression todoRe(R"(^(\s*)-\s+\[([ xX])\]\s+(.*)$)");
-        if (auto m = todoRe.match(line); m.hasMatch()) {
-            emit_paragraph(paragraph);
-            const auto spaces = m.captured(1).size();
-            const int depth = spaces / 2;
-            const bool checked = m.captured(2).trimmed().toLower() == "x";
-            blocks.append(make_block("todo", m.captured(3), depth, checked));
+        if (auto todo = parse_todo(line.text)) {
+            emit_paragraph();
+            auto block = make_parsed(BlockType::Todo, todo->text, line.start, line.end);
+            block.depth = todo->depth;
+            block.checked = todo->checked;
+            blocks.push_back(block);
             continue;
         }
 
-        if (trimmed.startsWith(">")) {
-            emit_paragraph(paragraph);
-            QStringList quoted;
-            for (; i < lines.size(); ++i) {
-                const auto t = lines[i].trimmed();
-                if (!t.startsWith(">")) {
-                    --i;
-                    break;
-                }
-                auto q = t.mid(1);
-                if (q.startsWith(' ')) q = q.mid(1);
-                quoted << q;
-            }
-            blocks.append(make_block("quote", quoted.join('\n')));
+        if (trimmed.startsWith(u'>')) {
+            emit_paragraph();
+            QString quoted;
+            const auto end = collect_quote(lines, i, quoted);
+            blocks.push_back(make_owned(BlockType::Quote, std::move(quoted), line.start, lines[end - 1].end));
+            i = end - 1;
             continue;
         }
 
         if (trimmed.isEmpty()) {
-            emit_paragraph(paragraph);
+            emit_paragraph();
             continue;
         }
 
-        paragraph << line;
+        if (paraFirst == paraEnd) paraFirst = i;
+        paraEnd = i + 1;
     }
 
-    emit_paragraph(paragraph);
+    emit_paragraph();
     return blocks;
 }
 
-QVariantList MarkdownBlocks::parseWithSpans(const QString& markdown) const {
-    struct Line {
-        int start = 0;
-        int end = 0; // exclusive, includes newline if present
-        QString view;
-        QString trimmed;
-    };
-
-    QVector<Line> lines;
-    lines.reserve(markdown.size() / 20);
-
-    int pos = 0;
-    while (pos <= markdown.size()) {
-        const int lineStart = pos;
-        int lineEnd = markdown.indexOf('\n', pos);
-        bool hasNewline = true;
-        if (lineEnd < 0) {
-            lineEnd = markdown.size();
-            hasNewline = false;
-        }
-        const int lineEndWithNewline = hasNewline ? (lineEnd + 1) : lineEnd;
-        const QString lineText = markdown.mid(lineStart, lineEnd - lineStart);
-        lines.push_back(Line{
-            .start = lineStart,
-            .end = lineEndWithNewline,
-            .view = lineText,
-            .trimmed = lineText.trimmed(),
-        });
-        if (!hasNewline) break;
-        pos = lineEndWithNewline;
-    }
+std::vector<MarkdownBlocks::ParsedBlock> MarkdownBlocks::parseBlocksWithSpans(QStringView markdown) {
+    const auto lines = split_lines(markdown);
 
-    int i = 0;
+    size_t i = 0;
     while (i < lines.size() && lines[i].trimmed.isEmpty()) ++i;
-    if (i < lines.size() && lines[i].trimmed == headerLine()) {
+    if (i < lines.size() && lines[i].trimmed == kHeaderLine) {
         ++i;
         while (i < lines.size() && lines[i].trimmed.isEmpty()) ++i;
     }
 
-    QVariantList out;
-    auto addBlock = [&](const QVariantMap& block, int startOffset, int endOffset) {
-        QVariantMap entry = block;
-        entry["start"] = startOffset;
-        entry["end"] = endOffset;
-        entry["raw"] = markdown.mid(startOffset, endOffset - startOffset);
-        out.append(entry);
-    };
-
-    auto makeParagraph = [&](int startLine, int endLineInclusive) {
-        QStringList parts;
-        parts.reserve(endLineInclusive - startLine + 1);
-        for (int k = startLine; k <= endLineInclusive; ++k) {
-            parts << lines[k].view;
-        }
-        return parts.join('\n');
-    };
+    std::vector<ParsedBlock> blocks;
+    blocks.reserve(lines.size() / 2 + 1);
 
     while (i < lines.size()) {
         while (i < lines.size() && lines[i].trimmed.isEmpty()) ++i;
         if (i >= lines.size()) break;
 
-        const int blockStartLine = i;
-        const int blockStartOffset = lines[i].start;
-        const auto trimmed = lines[i].trimmed;
+        const auto& line = lines[i];
+        const auto trimmed = line.trimmed;
 
-        if (auto cols = parse_columns(lines[i].view)) {
-            addBlock(make_block("columns", *cols), blockStartOffset, lines[i].end);
-            i = i + 1;
+        if (auto cols = parse_columns(line.text)) {
+            blocks.push_back(make_parsed(BlockType::Columns, *cols, line.start, line.end));
+            ++i;
             continue;
         }
 
-        if (auto image = parse_image(lines[i].view)) {
-            addBlock(make_block("image", *image), blockStartOffset, lines[i].end);
-            i = i + 1;
+        if (auto image = parse_image(line.text)) {
+            blocks.push_back(make_owned(BlockType::Image, std::move(*image), line.start, line.end));
+            ++i;
             continue;
         }
 
-        if (trimmed.startsWith("```")) {
-            const auto language = trimmed.mid(3).trimmed();
-            QStringList code;
-            int j = i + 1;
-            for (; j < lines.size(); ++j) {
-                if (lines[j].trimmed == "```") {
-                    break;
-                }
-                code << lines[j].view;
-            }
-            const int endLine = (j < lines.size()) ? j : (lines.size() - 1);
-            const int blockEndOffset = lines[endLine].end;
-            addBlock(make_block("code", code.join('\n'), 0, false, false, language),
-                     blockStartOffset, blockEndOffset);
+        if (trimmed.startsWith(u"```")) {
+            size_t j = i + 1;
+            while (j < lines.size() && lines[j].trimmed != u"```") ++j;
+            const auto endLine = std::min(j, lines.size() - 1);
+            auto block = make_parsed(BlockType::Code, line_range(markdown, lines, i + 1, j),
+                                     line.start, lines[endLine].end);
+            block.language = trimmed.sliced(3).trimmed();
+            blocks.push_back(block);
             i = endLine + 1;
             continue;
         }
 
-        static const QRegularExpression detailsRe(
-            R"(^<details(\s+open)?>\s*<summary>(.*)</summary>\s*</details>\s*$)");
-        if (auto m = detailsRe.match(trimmed); m.hasMatch()) {
-            const bool open = !m.captured(1).isEmpty();
-            addBlock(make_block("toggle", m.captured(2), 0, false, !open),
-                     blockStartOffset, lines[i].end);
-            i = i + 1;
+        if (auto toggle = parse_details(trimmed)) {
+            auto block = make_parsed(BlockType::Toggle, toggle->summary, line.start, line.end);
+            block.collapsed = !toggle->open;
+            blocks.push_back(block);
+            ++i;
             continue;
         }
 
-        if (trimmed == "---") {
-            addBlock(make_block("divider", QString()), blockStartOffset, lines[i].end);
-            i = i + 1;
+        if (trimmed == u"---") {
+            blocks.push_back(make_parsed(BlockType::Divider, {}, line.start, line.end));
+            ++i;
             continue;
         }
 
-        static const QRegularExpression headingRe(R"(^(#{1,3})\s+(.*)$)");
-        if (auto m = headingRe.match(trimmed); m.hasMatch()) {
-            const int level = m.captured(1).size();
-            addBlock(make_block("heading", m.captured(2), 0, false, false, {}, level),
-                     blockStartOffset, lines[i].end);
-            i = i + 1;
+        if (auto heading = parse_heading(trimmed)) {
+            auto block = make_parsed(BlockType::Heading, heading->text, line.start, line.end);
+            block.headingLevel = heading->level;
+            blocks.push_back(block);
+            ++i;
             continue;
         }
 
-        static const QRegularExpression todoRe(R"(^(\s*)-\s+\[([ xX])\]\s+(.*)$)");
-        if (auto m = todoRe.match(lines[i].view); m.hasMatch()) {
-            const int spaces = m.captured(1).size();
-            const int depth = spaces / 2;
-            const bool checked = m.captured(2).trimmed().toLower() == "x";
-            addBlock(make_block("todo", m.captured(3), depth, checked),
-                     blockStartOffset, lines[i].end);
-            i = i + 1;
+        if (auto todo = parse_todo(line.text)) {
+            auto block = make_parsed(BlockType::Todo, todo->text, line.start, line.end);
+            block.depth = todo->depth;
+            block.checked = todo->checked;
+            blocks.push_back(block);
+            ++i;
             continue;
         }
 
-        if (is_bulleted_list_item(lines[i].view)) {
-            QStringList listLines;
-            listLines << lines[i].view;
-            const int baseIndent = lines[i].view.indexOf('-');
-            int j = i + 1;
-            for (; j < lines.size(); ++j) {
-                if (lines[j].trimmed.isEmpty()) break;
-                if (is_bulleted_list_item(lines[j].view)) {
-                    listLines << lines[j].view;
-                    continue;
-                }
-                const int nonSpace = lines[j].view.indexOf(QRegularExpression("\\S"));
-                if (nonSpace >= 0 && nonSpace > baseIndent) {
-                    listLines << lines[j].view;
-                    continue;
-                }
-                break;
-            }
-            const int endLine = j - 1;
-            addBlock(make_block("bulleted", listLines.join('\n')),
-                     blockStartOffset, lines[endLine].end);
-            i = j;
+        if (is_bulleted_list_item(line.text)) {
+            const auto end = collect_bullets(lines, i);
+            blocks.push_back(make_parsed(BlockType::Bulleted, line_range(markdown, lines, i, end),
+                                         line.start, lines[end - 1].end));
+            i = end;
             continue;
         }
 
-        if (trimmed.startsWith(">")) {
-            QStringList quoted;
-            int j = i;
-            for (; j < lines.size(); ++j) {
-                const auto t = lines[j].trimmed;
-                if (!t.startsWith(">")) break;
-                auto q = t.mid(1);
-                if (q.startsWith(' ')) q = q.mid(1);
-                quoted << q;
-            }
-            const int endLine = j - 1;
-            addBlock(make_block("quote", quoted.join('\n')),
-                     blockStartOffset, lines[endLine].end);
-            i = j;
+        if (trimmed.startsWith(u'>')) {
+            QString quoted;
+            const auto end = collect_quote(lines, i, quoted);
+            blocks.push_back(make_owned(BlockType::Quote, std::move(quoted), line.start, lines[end - 1].end));
+            i = end;
             continue;
         }
 
-        int j = i;
-        for (; j < lines.size(); ++j) {
-            if (lines[j].trimmed.isEmpty()) break;
-        }
-        const int endLine = j - 1;
-        addBlock(make_block("paragraph", makeParagraph(blockStartLine, endLine)),
-                 blockStartOffset, lines[endLine].end);
+        size_t j = i;
+        while (j < lines.size() && !lines[j].trimmed.isEmpty()) ++j;
+        blocks.push_back(make_parsed(BlockType::Paragraph, line_range(markdown, lines, i, j),
+                                     line.start, lines[j - 1].end));
         i = j + 1;
     }
 
+    return blocks;
+}
+
+QVariantList MarkdownBlocks::parse(const QString& markdown) const {
+    const auto parsed = parseBlocks(markdown);
+    QVariantList blocks;
+    blocks.reserve(static_cast<qsizetype>(parsed.size()));
+    for (const auto& block : parsed) {
+        blocks.append(toVariantMap(block));
+    }
+    return blocks;
+}
+
+QVariantList MarkdownBlocks::parseWithSpans(const QString& markdown) const {
+    const auto parsed = parseBlocksWithSpans(markdown);
+    QVariantList out;
+    out.reserve(static_cast<qsizetype>(parsed.size()));
+    for (const auto& block : parsed) {
+        auto entry = toVariantMap(block);
+        entry["start"] = static_cast<int>(block.start);
+        entry["end"] = static_cast<int>(block.end);
+        entry["raw"] = markdown.mid(block.start, block.end - block.start);
+        out.append(entry);
+    }
     return out;
 }
 
@@ -3,7 +3,10 @@
 #include <QObject>
 #include <QJSEngine>
 #include <QQmlEngine>
+#include <QStringView>
 #include <QVariantList>
+#include <QVariantMap>
+#include <vector>
 
 namespace zinc::ui {
 
@@ -13,6 +16,38 @@ class MarkdownBlocks : public QObject {
     QML_SINGLETON
 
 public:
+    // Native parse result. `content` and `language` are views into the markdown handed to
+    // parseBlocks()/parseBlocksWithSpans(), which must outlive the blocks; quote bodies and
+    // image JSON are not substrings of the source and are stored in `owned` instead.
+    struct ParsedBlock {
+        enum class Type : quint8 {
+            Paragraph,
+            Heading,
+            Todo,
+            Bulleted,
+            Quote,
+            Code,
+            Divider,
+            Toggle,
+            Image,
+            Columns,
+        };
+
+        Type type = Type::Paragraph;
+        QStringView content;
+        QStringView language;
+        QString owned;
+        bool ownsContent = false;
+        int depth = 0;
+        int headingLevel = 0;
+        bool checked = false;
+        bool collapsed = false;
+        qsizetype start = 0; // source offsets; `end` is exclusive and includes the newline
+        qsizetype end = 0;
+
+        QStringView text() const { return ownsContent ? QStringView(owned) : content; }
+    };
+
     explicit MarkdownBlocks(QObject* parent = nullptr);
 
     static MarkdownBlocks* create(QQmlEngine* engine, QJSEngine*) {
@@ -30,6 +65,13 @@ public:
     Q_INVOKABLE bool isZincBlocksPayload(const QString& markdown) const;
 
     static QString headerLine();
+
+    // Single-pass line classifiers behind parse() and parseWithSpans(); they produce the same
+    // blocks without going through QVariant.
+    static std::vector<ParsedBlock> parseBlocks(QStringView markdown);
+    static std::vector<ParsedBlock> parseBlocksWithSpans(QStringView markdown);
+    static QString typeName(ParsedBlock::Type type);
+    static QVariantMap toVariantMap(const ParsedBlock& block);
 };
 
 } // namespace zinc::ui
@@ -74,8 +74,8 @@ Result<QString> render_note(DataStore& store, const NoteOptions& options) {
         if (!options.html) {
             return ensure_trailing_newline(markdown);
         }
-        const Cmark cmark;
-        return ensure_trailing_newline(cmark.toHtml(markdown));
+        // One-shot render; the CLI has no use for Cmark's cache.
+        return ensure_trailing_newline(Cmark::render(markdown));
     });
 }
 
@@ -3,11 +3,15 @@
 #include "crypto/keys.hpp"
 #include "ui/controllers/sync_presence.hpp"
 #include <QCryptographicHash>
+#include <QDir>
+#include <QFileInfo>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QSettings>
+#include <QStandardPaths>
 #include <QDateTime>
+#include <QTimeZone>
 #include <algorithm>
 #include <vector>
 
@@ -33,6 +37,20 @@ Uuid get_or_create_device_id(QSettings& settings) {
     return id;
 }
 
+// Lives next to the database so test runs (ZINC_DB_PATH) don't share a cache with the app.
+QString resolve_peer_cache_path() {
+    const auto overrideDb = qEnvironmentVariable("ZINC_DB_PATH");
+    if (!overrideDb.isEmpty()) {
+        return QFileInfo(overrideDb).absolutePath() + QStringLiteral("/sync_peer_cache.json");
+    }
+    const auto dataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    QDir dir(dataPath);
+    if (!dir.exists()) {
+        dir.mkpath(".");
+    }
+    return dataPath + QStringLiteral("/sync_peer_cache.json");
+}
+
 const SyncPresence* newest_presence(const std::map<Uuid, SyncPresence>& presences) {
     if (presences.empty()) return nullptr;
     const auto it = std::max_element(
@@ -87,6 +105,13 @@ SyncController::SyncController(QObject* parent)
             this, [this]() {
                 emit peerCountChanged();
                 emit peersChanged();
+                emit peerLinksChanged();
+            });
+    connect(sync_manager_.get(), &network::SyncManager::peerLinkStatsChanged,
+            this, &SyncController::peerLinksChanged);
+    connect(sync_manager_.get(), &network::SyncManager::peerTimedOut,
+            this, [this](const Uuid& device_id) {
+                emit peerTimedOut(QString::fromStdString(device_id.to_string()));
             });
     connect(sync_manager_.get(), &network::SyncManager::peerConnected,
             this, [this](const Uuid& device_id) {
@@ -375,6 +400,24 @@ QVariantList SyncController::remoteCursors() const {
     return out;
 }
 
+QVariantList SyncController::peerLinks() const {
+    QVariantList out;
+    const auto nowMs = QDateTime::currentMSecsSinceEpoch();
+    for (const auto& stats : sync_manager_->peerLinkStats()) {
+        QVariantMap link;
+        link.insert(QStringLiteral("deviceId"), QString::fromStdString(stats.device_id.to_string()));
+        link.insert(QStringLiteral("deviceName"), stats.device_name);
+        // -1 until the first Pong arrives.
+        link.insert(QStringLiteral("rttMs"), stats.rtt_ms.value_or(-1.0));
+        link.insert(QStringLiteral("jitterMs"), stats.jitter_ms.value_or(-1.0));
+        link.insert(QStringLiteral("lastActivity"),
+                    QDateTime::fromMSecsSinceEpoch(nowMs - stats.idle_ms, QTimeZone::UTC).toString(Qt::ISODate));
+        link.insert(QStringLiteral("missedPongs"), stats.missed_pongs);
+        out.append(link);
+    }
+    return out;
+}
+
 bool SyncController::configure(const QString& workspaceId, const QString& deviceName) {
     auto parsed = Uuid::parse(workspaceId.toStdString());
     if (!parsed) {
@@ -391,6 +434,7 @@ bool SyncController::configure(const QString& workspaceId, const QString& device
     settings.setValue(QString::fromLatin1(kSettingsWorkspaceId), workspaceId);
     settings.setValue(QString::fromLatin1(kSettingsDeviceName), resolved_name);
     sync_manager_->initialize(keys, *parsed, resolved_name, device_id);
+    sync_manager_->setPeerCachePath(resolve_peer_cache_path());
     configured_ = true;
     workspace_id_ = workspaceId;
     discovered_peers_.clear();
@@ -561,6 +605,16 @@ bool SyncController::isPeerConnected(const QString& deviceId) const {
     return sync_manager_->isPeerConnected(*parsed);
 }
 
+QVariantMap SyncController::trafficStats() const {
+    const auto counters = sync_manager_->trafficCounters();
+    QVariantMap out;
+    out["bytesSent"] = static_cast<qulonglong>(counters.bytes_sent);
+    out["bytesReceived"] = static_cast<qulonglong>(counters.bytes_received);
+    out["messagesSent"] = static_cast<qulonglong>(counters.messages_sent);
+    out["messagesReceived"] = static_cast<qulonglong>(counters.messages_received);
+    return out;
+}
+
 void SyncController::sendPageSnapshot(const QString& jsonPayload) {
     if (jsonPayload.isEmpty()) {
         return;
@@ -4,6 +4,7 @@
 #include <QObject>
 #include <QQmlEngine>
 #include <QVariantList>
+#include <QVariantMap>
 #include <map>
 #include <optional>
 
@@ -29,6 +30,7 @@ class SyncController : public QObject {
     Q_PROPERTY(int remoteCursorBlockIndex READ remoteCursorBlockIndex NOTIFY remotePresenceChanged)
     Q_PROPERTY(int remoteCursorPos READ remoteCursorPos NOTIFY remotePresenceChanged)
     Q_PROPERTY(QVariantList remoteCursors READ remoteCursors NOTIFY remotePresenceChanged)
+    Q_PROPERTY(QVariantList peerLinks READ peerLinks NOTIFY peerLinksChanged)
     
 public:
     explicit SyncController(QObject* parent = nullptr);
@@ -44,6 +46,7 @@ public:
     [[nodiscard]] int remoteCursorBlockIndex() const;
     [[nodiscard]] int remoteCursorPos() const;
     [[nodiscard]] QVariantList remoteCursors() const;
+    [[nodiscard]] QVariantList peerLinks() const;
     
     Q_INVOKABLE bool configure(const QString& workspaceId, const QString& deviceName);
     Q_INVOKABLE bool tryAutoStart(const QString& defaultDeviceName);
@@ -63,6 +66,8 @@ public:
     Q_INVOKABLE void approvePeer(const QString& deviceId, bool approved);
     Q_INVOKABLE int listeningPort() const;
     Q_INVOKABLE bool isPeerConnected(const QString& deviceId) const;
+    // { bytesSent, bytesReceived, messagesSent, messagesReceived } since construction.
+    Q_INVOKABLE QVariantMap trafficStats() const;
     Q_INVOKABLE void sendPageSnapshot(const QString& jsonPayload);
     Q_INVOKABLE void sendPresence(const QString& pageId,
                                   int blockIndex,
@@ -119,6 +124,8 @@ signals:
     void notebookSnapshotReceivedNotebooks(const QVariantList& notebooks);
     void deletedNotebookSnapshotReceivedNotebooks(const QVariantList& deletedNotebooks);
     void remotePresenceChanged();
+    void peerLinksChanged();
+    void peerTimedOut(const QString& deviceId);
     void error(const QString& message);
 
 private:
@@ -4,8 +4,11 @@
 
 #include <QUndoCommand>
 #include <QVariantList>
+#include <QHash>
 #include <QUuid>
 #include <algorithm>
+#include <iterator>
+#include <numeric>
 
 namespace zinc::ui {
 
@@ -63,19 +66,226 @@ QString predecessor_id_after_list_move(const std::vector<QString>& ids_in, int f
     return ids[static_cast<size_t>(idx - 1)];
 }
 
-class SetPropertyCommand final : public QUndoCommand {
+bool same_block(const auto& a, const auto& b) {
+    return a.block_type == b.block_type && a.content == b.content && a.depth == b.depth &&
+           a.checked == b.checked && a.collapsed == b.collapsed && a.language == b.language &&
+           a.heading_level == b.heading_level;
+}
+
+struct BlockMergePlan {
+    // For each row of `next`, the index of the `current` row it reuses, or -1 for a new row.
+    std::vector<qsizetype> source;
+    // Rows reused out of order; every other reused row keeps its relative position.
+    std::vector<bool> moved;
+};
+
+// Identical rows are matched first (common prefix/suffix, then an LCS of the middle), then
+// identical rows that moved, and finally leftovers in the same gap are paired up as edits.
+template <typename Row>
+BlockMergePlan plan_block_merge(const std::vector<Row>& current, const std::vector<Row>& next) {
+    // Above this the LCS table costs more than the model resets it would save.
+    constexpr size_t kMaxLcsCells = size_t{1} << 20;
+
+    const auto n = static_cast<qsizetype>(current.size());
+    const auto m = static_cast<qsizetype>(next.size());
+    std::vector<qsizetype> source(static_cast<size_t>(m), -1);
+    std::vector<bool> moved(static_cast<size_t>(m), false);
+    std::vector<bool> claimed(static_cast<size_t>(n), false);
+    auto reuse = [&](qsizetype from, qsizetype to) {
+        source[static_cast<size_t>(to)] = from;
+        claimed[static_cast<size_t>(from)] = true;
+    };
+
+    qsizetype prefix = 0;
+    while (prefix < n && prefix < m && same_block(current[prefix], next[prefix])) {
+        reuse(prefix, prefix);
+        ++prefix;
+    }
+    qsizetype suffix = 0;
+    while (suffix < n - prefix && suffix < m - prefix &&
+           same_block(current[n - 1 - suffix], next[m - 1 - suffix])) {
+        reuse(n - 1 - suffix, m - 1 - suffix);
+        ++suffix;
+    }
+
+    const auto a = n - prefix - suffix;
+    const auto b = m - prefix - suffix;
+    // Matched (current, next) pairs in order; they split the middle into gaps.
+    std::vector<std::pair<qsizetype, qsizetype>> anchors;
+    anchors.emplace_back(prefix - 1, prefix - 1);
+    if (a > 0 && b > 0 && static_cast<size_t>(a + 1) * static_cast<size_t>(b + 1) <= kMaxLcsCells) {
+        const auto width = static_cast<size_t>(b + 1);
+        std::vector<int> lcs(static_cast<size_t>(a + 1) * width, 0);
+        for (qsizetype i = a - 1; i >= 0; --i) {
+            for (qsizetype j = b - 1; j >= 0; --j) {
+                const auto at = static_cast<size_t>(i) * width + static_cast<size_t>(j);
+                lcs[at] = same_block(current[prefix + i], next[prefix + j])
+                              ? lcs[at + width + 1] + 1
+                              : std::max(lcs[at + width], lcs[at + 1]);
+            }
+        }
+        qsizetype i = 0;
+        qsizetype j = 0;
+        while (i < a && j < b) {
+            const auto at = static_cast<size_t>(i) * width + static_cast<size_t>(j);
+            if (same_block(current[prefix + i], next[prefix + j])) {
+                reuse(prefix + i, prefix + j);
+                anchors.emplace_back(prefix + i, prefix + j);
+                ++i;
+                ++j;
+            } else if (lcs[at + width] >= lcs[at + 1]) {
+                ++i;
+            } else {
+                ++j;
+            }
+        }
+    }
+    anchors.emplace_back(n - suffix, m - suffix);
+
+    // Blocks that moved: an unmatched new row identical to an unmatched current row.
+    QHash<QString, std::vector<qsizetype>> unmatched;
+    for (qsizetype i = prefix; i < n - suffix; ++i) {
+        if (!claimed[static_cast<size_t>(i)]) unmatched[current[i].content].push_back(i);
+    }
+    if (!unmatched.isEmpty()) {
+        for (qsizetype j = prefix; j < m - suffix; ++j) {
+            if (source[static_cast<size_t>(j)] >= 0) continue;
+            const auto it = unmatched.find(next[j].content);
+            if (it == unmatched.end()) continue;
+            for (const auto i : *it) {
+                if (!claimed[static_cast<size_t>(i)] && same_block(current[i], next[j])) {
+                    reuse(i, j);
+                    moved[static_cast<size_t>(j)] = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    // Whatever is left between two anchors was edited in place.
+    for (size_t k = 0; k + 1 < anchors.size(); ++k) {
+        auto i = anchors[k].first + 1;
+        auto j = anchors[k].second + 1;
+        const auto iEnd = anchors[k + 1].first;
+        const auto jEnd = anchors[k + 1].second;
+        while (i < iEnd && j < jEnd) {
+            if (claimed[static_cast<size_t>(i)]) {
+                ++i;
+            } else if (source[static_cast<size_t>(j)] >= 0) {
+                ++j;
+            } else {
+                reuse(i++, j++);
+            }
+        }
+    }
+    return {std::move(source), std::move(moved)};
+}
+
+qint64 string_bytes(const QString& s) {
+    return s.size() * qint64{sizeof(QChar)};
+}
+
+qint64 map_bytes(const QVariantMap& map) {
+    // Per entry: the map node plus the key and value payloads.
+    qint64 bytes = 0;
+    for (auto it = map.cbegin(); it != map.cend(); ++it) {
+        bytes += qint64{sizeof(QString) + sizeof(QVariant)} + 2 * qint64{sizeof(void*)} + string_bytes(it.key());
+        if (it.value().typeId() == QMetaType::QString) bytes += string_bytes(it.value().toString());
+    }
+    return bytes;
+}
+
+// An edit as "replace `removed` at `at` with `inserted`"; typing touches a few characters of
+// what may be a long block, so undo keeps only those.
+struct TextDelta {
+    qsizetype at = 0;
+    QString removed;
+    QString inserted;
+};
+
+TextDelta text_delta(const QString& before, const QString& after) {
+    const auto limit = std::min(before.size(), after.size());
+    qsizetype prefix = 0;
+    while (prefix < limit && before[prefix] == after[prefix]) ++prefix;
+    qsizetype suffix = 0;
+    while (suffix < limit - prefix && before[before.size() - 1 - suffix] == after[after.size() - 1 - suffix]) {
+        ++suffix;
+    }
+    return {prefix,
+            before.mid(prefix, before.size() - prefix - suffix),
+            after.mid(prefix, after.size() - prefix - suffix)};
+}
+
+// Replaces `from` at `at` with `to`; false if `text` doesn't hold `from` there.
+bool splice_text(QString& text, qsizetype at, const QString& from, const QString& to) {
+    if (at < 0 || at + from.size() > text.size()) return false;
+    if (QStringView(text).sliced(at, from.size()) != from) return false;
+    text.replace(at, from.size(), to);
+    return true;
+}
+
+// Commands report their footprint to the model so the history can be held to a byte budget.
+// Steps evicted from the budget are released: their payload is dropped and they are marked
+// obsolete, which BlockModel treats as the bottom of the history.
+class BlockUndoCommand : public QUndoCommand {
+public:
+    explicit BlockUndoCommand(BlockModel& model) : model_(model) {}
+    ~BlockUndoCommand() override { model_.adjustUndoMemory(-bytes_); }
+
+    void release() {
+        if (isObsolete()) return;
+        setObsolete(true);
+        dropPayload();
+        updateFootprint();
+    }
+
+protected:
+    BlockModel& model_;
+
+    virtual qint64 footprint() const = 0;
+    virtual void dropPayload() = 0;
+
+    void updateFootprint() {
+        const auto bytes = footprint();
+        model_.adjustUndoMemory(bytes - bytes_);
+        bytes_ = bytes;
+    }
+
+private:
+    qint64 bytes_ = 0;
+};
+
+// QUndoStack only hands out const commands, but they are ours to release.
+void release_undo_step(const QUndoCommand* command) {
+    if (const auto* own = dynamic_cast<const BlockUndoCommand*>(command)) {
+        const_cast<BlockUndoCommand*>(own)->release();
+    } else {
+        const_cast<QUndoCommand*>(command)->setObsolete(true);
+    }
+    for (int i = 0; i < command->childCount(); ++i) {
+        release_undo_step(command->child(i));
+    }
+}
+
+class SetPropertyCommand final : public BlockUndoCommand {
 public:
     SetPropertyCommand(BlockModel& model,
                        QString blockId,
                        QString property,
-                       QVariant oldValue,
-                       QVariant newValue)
-        : model_(model),
+                       const QVariant& oldValue,
+                       const QVariant& newValue)
+        : BlockUndoCommand(model),
           block_id_(std::move(blockId)),
           property_(std::move(property)),
-          old_value_(std::move(oldValue)),
-          new_value_(std::move(newValue))
+          textual_(property_ == QStringLiteral("content"))
     {
+        if (textual_) {
+            delta_ = text_delta(oldValue.toString(), newValue.toString());
+        } else {
+            old_value_ = oldValue;
+            new_value_ = newValue;
+        }
+        updateFootprint();
     }
 
     int id() const override { return 1; }
@@ -85,18 +295,57 @@ public:
         if (!o) return false;
         if (o->block_id_ != block_id_) return false;
         if (o->property_ != property_) return false;
-        if (property_ != QStringLiteral("content")) return false;
-        new_value_ = o->new_value_;
+        if (!textual_) return false;
+
+        // `other` is already applied: walk the text back through both deltas to the state
+        // before this command, then diff that against what the block holds now.
+        const int idx = model_.indexForBlockId(block_id_);
+        if (idx < 0) return false;
+        const auto current = model_.blockContent(idx);
+        auto before = current;
+        if (!splice_text(before, o->delta_.at, o->delta_.inserted, o->delta_.removed)) return false;
+        if (!splice_text(before, delta_.at, delta_.inserted, delta_.removed)) return false;
+        delta_ = text_delta(before, current);
+        updateFootprint();
         return true;
     }
 
-    void undo() override { apply(old_value_); }
-    void redo() override { apply(new_value_); }
+    void undo() override {
+        if (textual_) {
+            applyText(delta_.inserted, delta_.removed);
+        } else {
+            apply(old_value_);
+        }
+    }
+
+    void redo() override {
+        if (textual_) {
+            applyText(delta_.removed, delta_.inserted);
+        } else {
+            apply(new_value_);
+        }
+    }
+
+protected:
+    qint64 footprint() const override {
+        qint64 bytes = sizeof(*this) + string_bytes(block_id_) + string_bytes(property_) +
+                       string_bytes(delta_.removed) + string_bytes(delta_.inserted);
+        if (old_value_.typeId() == QMetaType::QString) bytes += string_bytes(old_value_.toString());
+        if (new_value_.typeId() == QMetaType::QString) bytes += string_bytes(new_value_.toString());
+        return bytes;
+    }
+
+    void dropPayload() override {
+        delta_ = {};
+        old_value_.clear();
+        new_value_.clear();
+    }
 
 private:
-    BlockModel& model_;
     QString block_id_;
     QString property_;
+    bool textual_ = false;
+    TextDelta delta_;
     QVariant old_value_;
     QVariant new_value_;
 
@@ -106,16 +355,26 @@ private:
         ScopedUndoSuppression guard(model_);
         model_.setProperty(idx, property_, v);
     }
+
+    void applyText(const QString& from, const QString& to) {
+        const int idx = model_.indexForBlockId(block_id_);
+        if (idx < 0) return;
+        auto text = model_.blockContent(idx);
+        if (!splice_text(text, delta_.at, from, to)) return;
+        ScopedUndoSuppression guard(model_);
+        model_.setProperty(idx, property_, text);
+    }
 };
 
-class InsertBlockCommand final : public QUndoCommand {
+class InsertBlockCommand final : public BlockUndoCommand {
 public:
     InsertBlockCommand(BlockModel& model, int index, QVariantMap block)
-        : model_(model),
+        : BlockUndoCommand(model),
           index_(index),
           block_(std::move(block))
     {
         block_id_ = block_.value(QStringLiteral("blockId")).toString();
+        updateFootprint();
     }
 
     void undo() override {
@@ -130,20 +389,30 @@ public:
         model_.insert(index_, block_);
     }
 
+protected:
+    qint64 footprint() const override {
+        return sizeof(*this) + map_bytes(block_) + string_bytes(block_id_);
+    }
+
+    void dropPayload() override {
+        block_.clear();
+        block_id_.clear();
+    }
+
 private:
-    BlockModel& model_;
     int index_;
     QVariantMap block_;
     QString block_id_;
 };
 
-class RemoveBlocksCommand final : public QUndoCommand {
+class RemoveBlocksCommand final : public BlockUndoCommand {
 public:
     RemoveBlocksCommand(BlockModel& model, int index, QList<QVariantMap> removed)
-        : model_(model),
+        : BlockUndoCommand(model),
           index_(index),
           removed_(std::move(removed))
     {
+        updateFootprint();
     }
 
     void undo() override {
@@ -160,27 +429,49 @@ public:
         model_.remove(index_, removed_.size());
     }
 
+protected:
+    qint64 footprint() const override {
+        qint64 bytes = sizeof(*this);
+        for (const auto& row : removed_) {
+            bytes += sizeof(QVariantMap) + map_bytes(row);
+        }
+        return bytes;
+    }
+
+    void dropPayload() override { removed_.clear(); }
+
 private:
-    BlockModel& model_;
     int index_;
     QList<QVariantMap> removed_;
 };
 
-class MoveBlockCommand final : public QUndoCommand {
+class MoveBlockCommand final : public BlockUndoCommand {
 public:
     MoveBlockCommand(BlockModel& model, QString blockId, QString redoPredecessor, QString undoPredecessor)
-        : model_(model),
+        : BlockUndoCommand(model),
           block_id_(std::move(blockId)),
           redo_predecessor_(std::move(redoPredecessor)),
           undo_predecessor_(std::move(undoPredecessor))
     {
+        updateFootprint();
     }
 
     void undo() override { apply_after(undo_predecessor_); }
     void redo() override { apply_after(redo_predecessor_); }
 
+protected:
+    qint64 footprint() const override {
+        return sizeof(*this) + string_bytes(block_id_) + string_bytes(redo_predecessor_) +
+               string_bytes(undo_predecessor_);
+    }
+
+    void dropPayload() override {
+        block_id_.clear();
+        redo_predecessor_.clear();
+        undo_predecessor_.clear();
+    }
+
 private:
-    BlockModel& model_;
     QString block_id_;
     QString redo_predecessor_;
     QString undo_predecessor_;
@@ -211,8 +502,14 @@ private:
 BlockModel::BlockModel(QObject* parent)
     : QAbstractListModel(parent)
 {
+    undo_stack_.setUndoLimit(kUndoStepLimit);
     connect(&undo_stack_, &QUndoStack::canUndoChanged, this, [this](bool) { emit canUndoChanged(); });
     connect(&undo_stack_, &QUndoStack::canRedoChanged, this, [this](bool) { emit canRedoChanged(); });
+    connect(&undo_stack_, &QUndoStack::indexChanged, this, [this](int) {
+        enforceUndoBudget();
+        // Whether the step below the index was released isn't something QUndoStack tracks.
+        emit canUndoChanged();
+    });
 }
 
 int BlockModel::rowCount(const QModelIndex& parent) const {
@@ -297,6 +594,8 @@ bool BlockModel::setData(const QModelIndex& index, const QVariant& value, int ro
     }
 
     row = normalize(row);
+    row.block_id = ensure_id(row.block_id);
+    window_dirty_ = windowed_;
     emit dataChanged(index, index, {role});
     emit blockChanged(index.row());
     return true;
@@ -326,7 +625,12 @@ void BlockModel::setPageId(const QString& pageId) {
     emit pageIdChanged();
 }
 
+bool BlockModel::canUndo() const {
+    return undo_stack_.canUndo() && undo_stack_.index() > releasedUndoSteps();
+}
+
 void BlockModel::undo() {
+    if (!canUndo()) return;
     undo_stack_.undo();
 }
 
@@ -336,6 +640,44 @@ void BlockModel::redo() {
 
 void BlockModel::clearUndoStack() {
     undo_stack_.clear();
+    enforceUndoBudget();
+}
+
+void BlockModel::setUndoMemoryBudget(qint64 bytes) {
+    bytes = std::max<qint64>(0, bytes);
+    if (undo_budget_ == bytes) return;
+    undo_budget_ = bytes;
+    emit undoMemoryBudgetChanged();
+    enforceUndoBudget();
+}
+
+// Released steps are always the oldest ones, so they form a prefix of the stack.
+int BlockModel::releasedUndoSteps() const {
+    int lo = 0;
+    int hi = undo_stack_.count();
+    while (lo < hi) {
+        const int mid = lo + (hi - lo) / 2;
+        if (undo_stack_.command(mid)->isObsolete()) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+void BlockModel::enforceUndoBudget() {
+    if (undo_budget_ > 0 && undo_bytes_ > undo_budget_) {
+        // The newest step stays undoable however large it is.
+        const int newest = undo_stack_.index() - 1;
+        for (int i = releasedUndoSteps(); i < newest && undo_bytes_ > undo_budget_; ++i) {
+            release_undo_step(undo_stack_.command(i));
+        }
+    }
+    if (undo_bytes_ != reported_undo_bytes_) {
+        reported_undo_bytes_ = undo_bytes_;
+        emit undoMemoryBytesChanged();
+    }
 }
 
 void BlockModel::beginUndoMacro(const QString& text) {
@@ -381,6 +723,7 @@ void BlockModel::insert(int index, const QVariantMap& block) {
     beginInsertRows(QModelIndex(), index, index);
     blocks_.insert(blocks_.begin() + index, std::move(row));
     endInsertRows();
+    window_dirty_ = windowed_;
     emit countChanged();
 }
 
@@ -406,6 +749,7 @@ void BlockModel::remove(int index, int countToRemove) {
     beginRemoveRows(QModelIndex(), index, last);
     blocks_.erase(blocks_.begin() + index, blocks_.begin() + last + 1);
     endRemoveRows();
+    window_dirty_ = windowed_;
     emit countChanged();
 }
 
@@ -435,10 +779,14 @@ void BlockModel::move(int from, int to, int countToMove) {
     const int insertAt = to;
     blocks_.insert(blocks_.begin() + insertAt, std::move(row));
     endMoveRows();
+    window_dirty_ = windowed_;
 }
 
 void BlockModel::clear() {
-    undo_stack_.clear();
+    clearUndoStack();
+    const bool wasWindowed = windowed_;
+    closeDocument();
+    if (wasWindowed) emit windowChanged();
     if (blocks_.empty()) return;
     beginResetModel();
     blocks_.clear();
@@ -447,28 +795,322 @@ void BlockModel::clear() {
 }
 
 bool BlockModel::loadFromMarkdown(const QString& markdown) {
-    MarkdownBlocks codec;
-    const auto parsed = codec.parse(markdown);
-    if (parsed.isEmpty()) return false;
-
-    undo_stack_.clear();
-    std::vector<BlockRow> rows;
-    rows.reserve(static_cast<size_t>(parsed.size()));
-    for (const auto& entry : parsed) {
-        auto row = normalize(fromVariantMap(entry.toMap()));
+    const auto parsed = MarkdownBlocks::parseBlocks(markdown);
+    if (parsed.empty()) return false;
+
+    clearUndoStack();
+    const bool wasWindowed = windowed_;
+    if (parsed.size() > static_cast<size_t>(kWindowThreshold)) {
+        openDocument(markdown, parsed, 0);
+    } else {
+        closeDocument();
+    }
+    auto rows = windowed_ ? rowsFromParsed(parsed, static_cast<size_t>(window_start_),
+                                           static_cast<size_t>(window_end_))
+                          : rowsFromParsed(parsed, 0, parsed.size());
+    for (auto& row : rows) {
         row.block_id = ensure_id(row.block_id);
-        rows.push_back(std::move(row));
     }
 
     beginResetModel();
     blocks_ = std::move(rows);
     endResetModel();
     emit countChanged();
+    if (windowed_ || wasWindowed) emit windowChanged();
     emit blocksLoaded();
     return true;
 }
 
+bool BlockModel::mergeFromMarkdown(const QString& markdown) {
+    const auto parsed = MarkdownBlocks::parseBlocks(markdown);
+    if (parsed.empty()) return false;
+
+    const bool wasWindowed = windowed_;
+    if (parsed.size() > static_cast<size_t>(kWindowThreshold)) {
+        // Stay where the reader is; the diff below then only touches the visible window.
+        openDocument(markdown, parsed, wasWindowed ? window_start_ : 0);
+    } else {
+        closeDocument();
+    }
+    clearUndoStack();
+    applyRows(windowed_ ? rowsFromParsed(parsed, static_cast<size_t>(window_start_),
+                                         static_cast<size_t>(window_end_))
+                        : rowsFromParsed(parsed, 0, parsed.size()));
+    if (windowed_ || wasWindowed) emit windowChanged();
+    emit blocksLoaded();
+    return true;
+}
+
+void BlockModel::applyRows(std::vector<BlockRow> next) {
+    const auto plan = plan_block_merge(blocks_, next);
+    const auto& source = plan.source;
+    const int previousCount = count();
+
+    // Drop rows nothing is reused from, back to front so indices stay valid.
+    std::vector<bool> reused(blocks_.size(), false);
+    for (const auto from : source) {
+        if (from >= 0) reused[static_cast<size_t>(from)] = true;
+    }
+    // Which original row each surviving row came from, kept in step with blocks_.
+    std::vector<qsizetype> origin(blocks_.size());
+    std::iota(origin.begin(), origin.end(), qsizetype{0});
+    for (int last = count() - 1; last >= 0;) {
+        if (reused[static_cast<size_t>(last)]) {
+            --last;
+            continue;
+        }
+        int first = last;
+        while (first > 0 && !reused[static_cast<size_t>(first - 1)]) --first;
+        beginRemoveRows(QModelIndex(), first, last);
+        blocks_.erase(blocks_.begin() + first, blocks_.begin() + last + 1);
+        origin.erase(origin.begin() + first, origin.begin() + last + 1);
+        endRemoveRows();
+        last = first - 1;
+    }
+
+    // Everything before `at` already matches `next`; move, edit or insert the row for `at`.
+    for (int at = 0; at < static_cast<int>(next.size());) {
+        if (source[static_cast<size_t>(at)] < 0) {
+            int end = at + 1;
+            while (end < static_cast<int>(next.size()) && source[static_cast<size_t>(end)] < 0) ++end;
+            beginInsertRows(QModelIndex(), at, end - 1);
+            for (int k = at; k < end; ++k) {
+                auto& row = next[static_cast<size_t>(k)];
+                row.block_id = ensure_id(QString());
+                blocks_.insert(blocks_.begin() + k, std::move(row));
+                origin.insert(origin.begin() + k, -1);
+            }
+            endInsertRows();
+            at = end;
+            continue;
+        }
+
+        auto from = static_cast<int>(
+            std::find(origin.begin() + at, origin.end(), source[static_cast<size_t>(at)]) - origin.begin());
+        if (from != at && !plan.moved[static_cast<size_t>(at)]) {
+            // Rows in the way moved further down the page; park them at the end for now so
+            // the in-order rows behind them don't each need a move.
+            for (; from > at; --from) {
+                beginMoveRows(QModelIndex(), at, at, QModelIndex(), count());
+                auto parked = std::move(blocks_[static_cast<size_t>(at)]);
+                blocks_.erase(blocks_.begin() + at);
+                blocks_.push_back(std::move(parked));
+                const auto parkedOrigin = origin[static_cast<size_t>(at)];
+                origin.erase(origin.begin() + at);
+                origin.push_back(parkedOrigin);
+                endMoveRows();
+            }
+        }
+        if (from != at) {
+            beginMoveRows(QModelIndex(), from, from, QModelIndex(), at);
+            auto moved = std::move(blocks_[static_cast<size_t>(from)]);
+            blocks_.erase(blocks_.begin() + from);
+            blocks_.insert(blocks_.begin() + at, std::move(moved));
+            origin.erase(origin.begin() + from);
+            origin.insert(origin.begin() + at, source[static_cast<size_t>(at)]);
+            endMoveRows();
+        }
+
+        auto& row = blocks_[static_cast<size_t>(at)];
+        const auto& want = next[static_cast<size_t>(at)];
+        QList<int> roles;
+        if (row.block_type != want.block_type) roles << BlockTypeRole;
+        if (row.content != want.content) roles << ContentRole;
+        if (row.depth != want.depth) roles << DepthRole;
+        if (row.checked != want.checked) roles << CheckedRole;
+        if (row.collapsed != want.collapsed) roles << CollapsedRole;
+        if (row.language != want.language) roles << LanguageRole;
+        if (row.heading_level != want.heading_level) roles << HeadingLevelRole;
+        if (!roles.isEmpty()) {
+            auto id = std::move(row.block_id);
+            row = want;
+            row.block_id = std::move(id);
+            const auto idx = createIndex(at, 0);
+            emit dataChanged(idx, idx, roles);
+            emit blockChanged(at);
+        }
+        ++at;
+    }
+
+    if (count() != previousCount) emit countChanged();
+}
+
+int BlockModel::totalCount() const {
+    if (!windowed_) return count();
+    return static_cast<int>(spans_.size()) - (window_end_ - window_start_) + count();
+}
+
+void BlockModel::openDocument(const QString& markdown,
+                              const std::vector<MarkdownBlocks::ParsedBlock>& parsed,
+                              int windowStart) {
+    document_ = markdown;
+    spans_.clear();
+    spans_.reserve(parsed.size());
+    for (const auto& block : parsed) {
+        spans_.emplace_back(block.start, block.end);
+    }
+    const auto total = static_cast<int>(spans_.size());
+    windowed_ = true;
+    window_start_ = std::clamp(windowStart, 0, std::max(0, total - kWindowSize));
+    window_end_ = std::min(total, window_start_ + kWindowSize);
+    window_dirty_ = false;
+}
+
+void BlockModel::closeDocument() {
+    document_.clear();
+    spans_.clear();
+    windowed_ = false;
+    window_start_ = 0;
+    window_end_ = 0;
+    window_dirty_ = false;
+}
+
+std::vector<BlockModel::BlockRow> BlockModel::rowsFromParsed(
+    const std::vector<MarkdownBlocks::ParsedBlock>& parsed, size_t first, size_t last) {
+    std::vector<BlockRow> rows;
+    rows.reserve(last - first);
+    for (size_t i = first; i < last; ++i) {
+        rows.push_back(normalize(fromParsedBlock(parsed[i])));
+    }
+    return rows;
+}
+
+std::vector<BlockModel::BlockRow> BlockModel::materialize(int first, int last) const {
+    if (first >= last) return {};
+    // Blocks never depend on the text before them, so a slice from a block start parses
+    // to the same blocks as the whole page does.
+    const auto begin = spans_[static_cast<size_t>(first)].first;
+    const auto end = spans_[static_cast<size_t>(last - 1)].second;
+    const auto parsed = MarkdownBlocks::parseBlocks(QStringView(document_).sliced(begin, end - begin));
+    auto rows = rowsFromParsed(parsed, 0, parsed.size());
+    for (auto& row : rows) {
+        row.block_id = ensure_id(row.block_id);
+    }
+    return rows;
+}
+
+// The window's rows serialized as the replacement for document_[start, end): the text
+// between the blocks around the window, so neighbours stay separated by a blank line.
+QString BlockModel::spliceText(qsizetype& start, qsizetype& end) const {
+    const auto total = static_cast<int>(spans_.size());
+    if (window_start_ > 0) {
+        start = spans_[static_cast<size_t>(window_start_ - 1)].second;
+    } else {
+        start = total > 0 ? spans_.front().first : 0;
+    }
+    end = window_end_ < total ? spans_[static_cast<size_t>(window_end_)].first : document_.size();
+
+    MarkdownBlocks codec;
+    QVariantList list;
+    list.reserve(count());
+    for (const auto& row : blocks_) {
+        list.append(toVariantMap(row));
+    }
+    auto text = codec.serializeContent(list);
+    if (window_start_ > 0) text.prepend(u'\n');
+    if (window_end_ < total) text.append(u'\n');
+    return text;
+}
+
+void BlockModel::spliceWindow() {
+    if (!windowed_ || !window_dirty_) return;
+
+    qsizetype start = 0;
+    qsizetype end = 0;
+    const auto text = spliceText(start, end);
+    document_.replace(start, end - start, text);
+    const auto delta = text.size() - (end - start);
+    for (auto it = spans_.begin() + window_end_; it != spans_.end(); ++it) {
+        it->first += delta;
+        it->second += delta;
+    }
+
+    const auto parsed = MarkdownBlocks::parseBlocks(QStringView(document_).sliced(start, text.size()));
+    std::vector<std::pair<qsizetype, qsizetype>> window;
+    window.reserve(parsed.size());
+    for (const auto& block : parsed) {
+        window.emplace_back(start + block.start, start + block.end);
+    }
+    spans_.erase(spans_.begin() + window_start_, spans_.begin() + window_end_);
+    spans_.insert(spans_.begin() + window_start_, window.begin(), window.end());
+    window_end_ = window_start_ + static_cast<int>(window.size());
+    window_dirty_ = false;
+
+    // Rows normally re-parse to themselves; when they don't (say, a heading turned into a
+    // paragraph that now runs into the next one), diff the page's view of them back in.
+    auto rows = rowsFromParsed(parsed, 0, parsed.size());
+    const bool same = rows.size() == blocks_.size() &&
+                      std::equal(rows.begin(), rows.end(), blocks_.begin(),
+                                 [](const BlockRow& a, const BlockRow& b) { return same_block(a, b); });
+    if (!same) applyRows(std::move(rows));
+}
+
+void BlockModel::setWindowStart(int first) {
+    if (!windowed_) return;
+    spliceWindow();
+
+    const auto total = static_cast<int>(spans_.size());
+    first = std::clamp(first, 0, std::max(0, total - kWindowSize));
+    const int last = std::min(total, first + kWindowSize);
+    if (first == window_start_ && last == window_end_) return;
+
+    // Undo commands address rows by window index, which would no longer line up.
+    clearUndoStack();
+    const int previousCount = count();
+    const int keepBegin = std::max(first, window_start_);
+    const int keepEnd = std::min(last, window_end_);
+    if (keepBegin >= keepEnd) {
+        auto rows = materialize(first, last);
+        beginResetModel();
+        blocks_ = std::move(rows);
+        endResetModel();
+    } else {
+        if (keepEnd < window_end_) {
+            beginRemoveRows(QModelIndex(), keepEnd - window_start_, window_end_ - window_start_ - 1);
+            blocks_.erase(blocks_.begin() + (keepEnd - window_start_), blocks_.end());
+            endRemoveRows();
+        }
+        if (window_start_ < keepBegin) {
+            beginRemoveRows(QModelIndex(), 0, keepBegin - window_start_ - 1);
+            blocks_.erase(blocks_.begin(), blocks_.begin() + (keepBegin - window_start_));
+            endRemoveRows();
+        }
+        if (first < keepBegin) {
+            auto rows = materialize(first, keepBegin);
+            beginInsertRows(QModelIndex(), 0, static_cast<int>(rows.size()) - 1);
+            blocks_.insert(blocks_.begin(), std::make_move_iterator(rows.begin()),
+                           std::make_move_iterator(rows.end()));
+            endInsertRows();
+        }
+        if (keepEnd < last) {
+            auto rows = materialize(keepEnd, last);
+            beginInsertRows(QModelIndex(), count(), count() + static_cast<int>(rows.size()) - 1);
+            blocks_.insert(blocks_.end(), std::make_move_iterator(rows.begin()),
+                           std::make_move_iterator(rows.end()));
+            endInsertRows();
+        }
+    }
+    window_start_ = first;
+    window_end_ = last;
+    if (count() != previousCount) emit countChanged();
+    emit windowChanged();
+}
+
 QString BlockModel::serializeContentToMarkdown() const {
+    if (windowed_) {
+        // Only the window can have changed; everything around it is written back verbatim.
+        if (!window_dirty_) return document_;
+        qsizetype start = 0;
+        qsizetype end = 0;
+        const auto text = spliceText(start, end);
+        QString out;
+        out.reserve(document_.size() - (end - start) + text.size());
+        out.append(QStringView(document_).first(start));
+        out.append(text);
+        out.append(QStringView(document_).sliced(end));
+        return out;
+    }
+
     MarkdownBlocks codec;
     QVariantList list;
     list.reserve(count());
@@ -483,6 +1125,11 @@ QString BlockModel::blockId(int index) const {
     return blocks_[static_cast<size_t>(index)].block_id;
 }
 
+int BlockModel::pageIndexForBlockId(const QString& blockId) const {
+    const auto index = indexForBlockId(blockId);
+    return index < 0 ? -1 : window_start_ + index;
+}
+
 QString BlockModel::blockType(int index) const {
     if (index < 0 || index >= count()) return {};
     return blocks_[static_cast<size_t>(index)].block_type;
@@ -559,7 +1206,6 @@ BlockModel::BlockRow BlockModel::normalize(BlockRow row) {
     if (row.block_type.isEmpty()) {
         row.block_type = QStringLiteral("paragraph");
     }
-    row.block_id = ensure_id(row.block_id);
     row.depth = std::clamp(row.depth, 0, 64);
     row.heading_level = std::clamp(row.heading_level, 0, 6);
 
@@ -584,6 +1230,18 @@ BlockModel::BlockRow BlockModel::fromVariantMap(const QVariantMap& map) {
     return row;
 }
 
+BlockModel::BlockRow BlockModel::fromParsedBlock(const MarkdownBlocks::ParsedBlock& block) {
+    BlockRow row;
+    row.block_type = MarkdownBlocks::typeName(block.type);
+    row.content = block.text().toString();
+    row.depth = block.depth;
+    row.checked = block.checked;
+    row.collapsed = block.collapsed;
+    row.language = block.language.toString();
+    row.heading_level = block.headingLevel;
+    return row;
+}
+
 QVariantMap BlockModel::toVariantMap(const BlockRow& row) {
     return QVariantMap{
         {QStringLiteral("blockId"), row.block_id},
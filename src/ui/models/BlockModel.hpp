@@ -6,6 +6,8 @@
 #include <QUndoStack>
 #include <vector>
 
+#include "ui/MarkdownBlocks.hpp"
+
 namespace zinc::ui {
 
 /**
@@ -17,6 +19,10 @@ namespace zinc::ui {
  *
  * Each row is a "block" with fields that match the MarkdownBlocks schema:
  * - blockId, blockType, content, depth, checked, collapsed, language, headingLevel
+ *
+ * Pages with more than kWindowThreshold blocks are opened windowed: the markdown stays in
+ * one string with a span per block, and only the rows [windowStart, windowStart + count)
+ * are materialized. Row indices are always relative to the window.
  */
 class BlockModel : public QAbstractListModel {
     Q_OBJECT
@@ -26,6 +32,12 @@ class BlockModel : public QAbstractListModel {
     Q_PROPERTY(QString pageId READ pageId WRITE setPageId NOTIFY pageIdChanged)
     Q_PROPERTY(bool canUndo READ canUndo NOTIFY canUndoChanged)
     Q_PROPERTY(bool canRedo READ canRedo NOTIFY canRedoChanged)
+    Q_PROPERTY(qint64 undoMemoryBytes READ undoMemoryBytes NOTIFY undoMemoryBytesChanged)
+    Q_PROPERTY(qint64 undoMemoryBudget READ undoMemoryBudget WRITE setUndoMemoryBudget NOTIFY undoMemoryBudgetChanged)
+    Q_PROPERTY(bool windowed READ windowed NOTIFY windowChanged)
+    Q_PROPERTY(int windowStart READ windowStart WRITE setWindowStart NOTIFY windowChanged)
+    Q_PROPERTY(int windowSize READ windowSize CONSTANT)
+    Q_PROPERTY(int totalCount READ totalCount NOTIFY windowChanged)
     
 public:
     enum Roles {
@@ -39,6 +51,12 @@ public:
         HeadingLevelRole,
     };
     
+    static constexpr int kWindowThreshold = 2000;
+    static constexpr int kWindowSize = 400;
+    static constexpr qint64 kDefaultUndoMemoryBudget = qint64{8} << 20;
+    // Backstop for released steps, which still cost a few hundred bytes each.
+    static constexpr int kUndoStepLimit = 1000;
+
     explicit BlockModel(QObject* parent = nullptr);
     
     // QAbstractListModel interface
@@ -52,8 +70,19 @@ public:
     [[nodiscard]] int count() const { return static_cast<int>(blocks_.size()); }
     [[nodiscard]] QString pageId() const { return page_id_; }
     void setPageId(const QString& pageId);
-    [[nodiscard]] bool canUndo() const { return undo_stack_.canUndo(); }
+    [[nodiscard]] bool canUndo() const;
     [[nodiscard]] bool canRedo() const { return undo_stack_.canRedo(); }
+    [[nodiscard]] qint64 undoMemoryBytes() const { return undo_bytes_; }
+    [[nodiscard]] qint64 undoMemoryBudget() const { return undo_budget_; }
+    // Oldest undo steps are released once the history holds more than `bytes`; 0 disables the limit.
+    void setUndoMemoryBudget(qint64 bytes);
+    [[nodiscard]] bool windowed() const { return windowed_; }
+    [[nodiscard]] int windowStart() const { return window_start_; }
+    [[nodiscard]] int windowSize() const { return kWindowSize; }
+    [[nodiscard]] int totalCount() const;
+    // Writes edits in the current window back into the page text, then materializes the
+    // window starting at `first`. Rows that stay in the window keep their ids.
+    void setWindowStart(int first);
 
     // Undo/redo (Qt's undo framework, with merge support for typing)
     Q_INVOKABLE void undo();
@@ -69,6 +98,7 @@ public:
     void setUndoSuppressed(bool suppressed) { suppress_undo_ = suppressed; }
     [[nodiscard]] bool undoSuppressed() const { return suppress_undo_; }
     [[nodiscard]] int indexForBlockId(const QString& blockId) const;
+    void adjustUndoMemory(qint64 delta) { undo_bytes_ += delta; }
     
     // QML ListModel-like helpers used by BlockEditor.qml
     Q_INVOKABLE QVariantMap get(int index) const;
@@ -81,10 +111,15 @@ public:
 
     // Markdown (de)serialization helpers
     Q_INVOKABLE bool loadFromMarkdown(const QString& markdown);
+    // Like loadFromMarkdown, but diffs against the current rows and applies only the
+    // inserts/removes/moves/dataChanged needed, so unchanged blocks keep their ids and delegates.
+    Q_INVOKABLE bool mergeFromMarkdown(const QString& markdown);
     Q_INVOKABLE QString serializeContentToMarkdown() const;
     
     // Get block at index
     Q_INVOKABLE QString blockId(int index) const;
+    // Page-wide index of a materialized block, or -1; blocks outside the window have no ids yet.
+    Q_INVOKABLE int pageIndexForBlockId(const QString& blockId) const;
     Q_INVOKABLE QString blockType(int index) const;
     Q_INVOKABLE QString blockContent(int index) const;
     Q_INVOKABLE int blockDepth(int index) const;
@@ -105,8 +140,11 @@ signals:
     void pageIdChanged();
     void canUndoChanged();
     void canRedoChanged();
+    void undoMemoryBytesChanged();
+    void undoMemoryBudgetChanged();
     void blockChanged(int index);
     void blocksLoaded();
+    void windowChanged();
 
 private:
     struct BlockRow {
@@ -122,11 +160,37 @@ private:
 
     QString page_id_;
     std::vector<BlockRow> blocks_;
+    // Declared before undo_stack_ so the commands it deletes on destruction can still report.
+    qint64 undo_bytes_ = 0;
+    qint64 undo_budget_ = kDefaultUndoMemoryBudget;
+    qint64 reported_undo_bytes_ = 0;
     QUndoStack undo_stack_;
     bool suppress_undo_ = false;
 
+    // Windowed pages: the page text, every block's [start, end) in it, and the blocks
+    // [window_start_, window_end_) that blocks_ holds. window_dirty_ marks unspliced edits.
+    QString document_;
+    std::vector<std::pair<qsizetype, qsizetype>> spans_;
+    int window_start_ = 0;
+    int window_end_ = 0;
+    bool windowed_ = false;
+    bool window_dirty_ = false;
+
+    static std::vector<BlockRow> rowsFromParsed(const std::vector<MarkdownBlocks::ParsedBlock>& parsed,
+                                                size_t first, size_t last);
+    std::vector<BlockRow> materialize(int first, int last) const;
+    QString spliceText(qsizetype& start, qsizetype& end) const;
+    void spliceWindow();
+    void openDocument(const QString& markdown, const std::vector<MarkdownBlocks::ParsedBlock>& parsed,
+                      int windowStart);
+    void closeDocument();
+    void applyRows(std::vector<BlockRow> next);
+    int releasedUndoSteps() const;
+    void enforceUndoBudget();
+
     static BlockRow normalize(BlockRow row);
     static BlockRow fromVariantMap(const QVariantMap& map);
+    static BlockRow fromParsedBlock(const MarkdownBlocks::ParsedBlock& block);
     static QVariantMap toVariantMap(const BlockRow& row);
     static int roleForPropertyName(const QString& property);
     static QString ensureId(const QString& blockId);
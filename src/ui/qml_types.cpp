@@ -7,6 +7,7 @@
 #include "ui/InlineFormatting.hpp"
 #include "ui/InlineRichText.hpp"
 #include "ui/InlineRichTextHighlighter.hpp"
+#include "ui/InlineRunStore.hpp"
 #include "ui/FontUtils.hpp"
 #include "ui/models/BlockModel.hpp"
 #include "ui/models/PageTreeModel.hpp"
@@ -35,6 +36,7 @@ void registerQmlTypes() {
 	qmlRegisterSingletonType<Cmark>("zinc", 1, 0, "Cmark", Cmark::create);
 	qmlRegisterSingletonType<InlineFormatting>("zinc", 1, 0, "InlineFormatting", InlineFormatting::create);
 	qmlRegisterSingletonType<InlineRichText>("zinc", 1, 0, "InlineRichText", InlineRichText::create);
+	qmlRegisterSingletonType<InlineRunStore>("zinc", 1, 0, "InlineRunStore", InlineRunStore::create);
 	qmlRegisterSingletonType<FontUtils>("zinc", 1, 0, "FontUtils", FontUtils::create);
 	qmlRegisterType<InlineRichTextHighlighter>("zinc", 1, 0, "InlineRichTextHighlighter");
 	    
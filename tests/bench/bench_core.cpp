@@ -0,0 +1,122 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "bench_inputs.hpp"
+#include "core/fractional_index.hpp"
+#include "core/search.hpp"
+#include "core/three_way_merge.hpp"
+#include "core/types.hpp"
+
+#include <vector>
+
+using namespace zinc;
+using namespace zinc::bench;
+
+TEST_CASE("three_way_merge_text", "[bench][core][merge]") {
+    for (const auto& size : kDocumentSizes) {
+        const auto base = markdown_document(size.bytes);
+        const auto ours = edit_lines(base, 20, 3, " (ours)");
+        const auto theirs = edit_lines(base, 20, 13, " (theirs)");
+
+        BENCHMARK(std::string("clean ") + size.label) {
+            return three_way_merge_text(base, ours, theirs);
+        };
+
+        const auto conflicting = edit_lines(base, 20, 3, " (theirs)");
+        BENCHMARK(std::string("conflict ") + size.label) {
+            return three_way_merge_text(base, ours, conflicting);
+        };
+    }
+}
+
+TEST_CASE("FractionalIndex::between", "[bench][core][fractional_index]") {
+    const auto a = FractionalIndex::first();
+    const auto b = a.after();
+
+    BENCHMARK("between neighbours") {
+        return FractionalIndex::between(a, b);
+    };
+
+    BENCHMARK("append 1000") {
+        FractionalIndex last = FractionalIndex::first();
+        for (int i = 0; i < 1000; ++i) {
+            last = last.after();
+        }
+        return last;
+    };
+
+    // Repeated inserts at the same gap grow keys; this is the worst case for key length.
+    BENCHMARK("bisect same gap 200") {
+        FractionalIndex lo = a;
+        FractionalIndex hi = b;
+        for (int i = 0; i < 200; ++i) {
+            hi = FractionalIndex::between(lo, hi);
+        }
+        return hi;
+    };
+}
+
+TEST_CASE("FractionalIndex bulk insert 10k", "[bench][core][fractional_index]") {
+    const auto a = FractionalIndex::first();
+    const auto b = a.after();
+
+    BENCHMARK("between chain 10000") {
+        FractionalIndex lo = a;
+        for (int i = 0; i < 10'000; ++i) {
+            lo = FractionalIndex::between(lo, b);
+        }
+        return lo;
+    };
+
+    BENCHMARK("between_n 10000") {
+        return FractionalIndex::between_n(a, b, 10'000);
+    };
+}
+
+TEST_CASE("Uuid parse/to_string/hash", "[bench][core][uuid]") {
+    std::vector<Uuid> ids;
+    std::vector<std::string> strings;
+    for (int i = 0; i < 1000; ++i) {
+        ids.push_back(Uuid::generate());
+        strings.push_back(ids.back().to_string());
+    }
+
+    BENCHMARK("to_string x1000") {
+        size_t total = 0;
+        for (const auto& id : ids) total += id.to_string().size();
+        return total;
+    };
+
+    BENCHMARK("parse x1000") {
+        size_t ok = 0;
+        for (const auto& s : strings) ok += Uuid::parse(s).has_value() ? 1 : 0;
+        return ok;
+    };
+
+    BENCHMARK("to_chars x1000") {
+        size_t total = 0;
+        for (const auto& id : ids) total += static_cast<unsigned char>(id.to_chars()[35]);
+        return total;
+    };
+
+    BENCHMARK("hash x1000") {
+        const std::hash<Uuid> hash;
+        size_t total = 0;
+        for (const auto& id : ids) total ^= hash(id);
+        return total;
+    };
+}
+
+TEST_CASE("search highlight_matches/create_snippet", "[bench][core][search]") {
+    for (const auto& size : kDocumentSizes) {
+        const auto text = markdown_document(size.bytes);
+
+        BENCHMARK(std::string("highlight_matches ") + size.label) {
+            return highlight_matches(text, "relay");
+        };
+
+        BENCHMARK(std::string("create_snippet ") + size.label) {
+            return create_snippet(text, "previous page");
+        };
+    }
+}
@@ -0,0 +1,55 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "bench_inputs.hpp"
+#include "crypto/keys.hpp"
+#include "crypto/noise_session.hpp"
+
+#include <vector>
+
+using namespace zinc;
+using namespace zinc::bench;
+
+namespace {
+
+struct SessionPair {
+    crypto::NoiseSession initiator;
+    crypto::NoiseSession responder;
+};
+
+SessionPair handshake() {
+    SessionPair pair{
+        crypto::NoiseSession(crypto::NoiseRole::Initiator, crypto::generate_keypair()),
+        crypto::NoiseSession(crypto::NoiseRole::Responder, crypto::generate_keypair()),
+    };
+    auto msg1 = pair.initiator.create_message1().unwrap();
+    auto msg2 = pair.responder.process_message1(msg1).unwrap();
+    auto msg3 = pair.initiator.process_message2(msg2).unwrap();
+    (void)pair.responder.process_message3(msg3).unwrap();
+    return pair;
+}
+
+} // namespace
+
+TEST_CASE("NoiseSession encrypt/decrypt", "[bench][crypto][noise]") {
+    auto pair = handshake();
+    REQUIRE(pair.initiator.is_transport_ready());
+    REQUIRE(pair.responder.is_transport_ready());
+
+    for (const auto& size : kDocumentSizes) {
+        const auto text = markdown_document(size.bytes);
+        const std::vector<uint8_t> plaintext(text.begin(), text.end());
+
+        BENCHMARK(std::string("encrypt ") + size.label) {
+            return pair.initiator.encrypt(plaintext).unwrap();
+        };
+
+        // Nonces must stay in lockstep, so each decrypt consumes a freshly encrypted frame.
+        BENCHMARK_ADVANCED(std::string("encrypt+decrypt ") + size.label)(Catch::Benchmark::Chronometer meter) {
+            meter.measure([&] {
+                auto frame = pair.initiator.encrypt(plaintext).unwrap();
+                return pair.responder.decrypt(frame).unwrap();
+            });
+        };
+    }
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <random>
+#include <string>
+
+// Deterministic, size-parameterized inputs shared by the benchmark files.
+
+namespace zinc::bench {
+
+struct InputSize {
+    const char* label;
+    size_t bytes;
+};
+
+inline constexpr std::array<InputSize, 4> kDocumentSizes{{
+    {"1KB", 1024},
+    {"16KB", 16 * 1024},
+    {"256KB", 256 * 1024},
+    {"1MB", 1024 * 1024},
+}};
+
+// Markdown with the block mix the editor produces: headings, paragraphs with inline
+// formatting, todos, quotes and fenced code.
+inline std::string markdown_document(size_t bytes, unsigned seed = 42) {
+    static constexpr std::array<const char*, 8> kLines{{
+        "## Meeting notes",
+        "Sync **relay** keeps *laptops* converging with `zincd` and [docs](https://example.com).",
+        "- [ ] follow up on merge previews",
+        "- [x] ship the peer cache",
+        "> Quoted context from the previous page.",
+        "Plain paragraph text that wraps across the editor width without any formatting at all.",
+        "1. ordered item with ~~strike~~ text",
+        "```\nint main() { return 0; }\n```",
+    }};
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<size_t> pick(0, kLines.size() - 1);
+    std::string out;
+    out.reserve(bytes + 128);
+    while (out.size() < bytes) {
+        out += kLines[pick(rng)];
+        out += "\n\n";
+    }
+    out.resize(bytes);
+    return out;
+}
+
+// Edit `text` at roughly every `stride` lines so 3-way merges see scattered, non-overlapping hunks.
+inline std::string edit_lines(const std::string& text, size_t stride, size_t offset, const char* marker) {
+    std::string out;
+    out.reserve(text.size() + text.size() / 16);
+    size_t line = 0;
+    size_t start = 0;
+    while (start < text.size()) {
+        auto end = text.find('\n', start);
+        if (end == std::string::npos) end = text.size();
+        out.append(text, start, end - start);
+        if (line % stride == offset) out += marker;
+        if (end < text.size()) out += '\n';
+        start = end + 1;
+        ++line;
+    }
+    return out;
+}
+
+// Catch2 reports time per iteration; parsers are easier to compare as MB/s of input.
+template <typename Fn>
+double megabytes_per_second(size_t bytes, Fn&& fn, int iterations = 20) {
+    using Clock = std::chrono::steady_clock;
+    size_t sink = 0;
+    const auto start = Clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        sink += static_cast<size_t>(fn());
+    }
+    const std::chrono::duration<double> elapsed = Clock::now() - start;
+    static volatile size_t observed = 0;
+    observed = sink;
+    return elapsed.count() > 0 ? (static_cast<double>(bytes) * iterations / 1e6) / elapsed.count() : 0.0;
+}
+
+} // namespace zinc::bench
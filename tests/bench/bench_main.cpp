@@ -0,0 +1,13 @@
+#include <QCoreApplication>
+#include <catch2/catch_session.hpp>
+
+#include "crypto/keys.hpp"
+
+int main(int argc, char** argv) {
+    QCoreApplication app(argc, argv);
+    if (zinc::crypto::init().is_err()) {
+        return 1;
+    }
+    Catch::Session session;
+    return session.run(argc, argv);
+}
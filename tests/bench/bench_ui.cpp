@@ -0,0 +1,340 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_message.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <QDir>
+#include <QStringList>
+#include <QTemporaryDir>
+#include <QThreadPool>
+#include <QUrl>
+#include <QUuid>
+
+#include <atomic>
+#include <chrono>
+
+#include "bench_inputs.hpp"
+#include "ui/Cmark.hpp"
+#include "ui/DataStore.hpp"
+#include "ui/InlineRichText.hpp"
+#include "ui/InlineRunStore.hpp"
+#include "ui/MarkdownBlocks.hpp"
+#include "ui/models/BlockModel.hpp"
+
+using namespace zinc::bench;
+using zinc::ui::BlockModel;
+using zinc::ui::Cmark;
+using zinc::ui::DataStore;
+using zinc::ui::InlineRichText;
+using zinc::ui::InlineRunStore;
+using zinc::ui::MarkdownBlocks;
+
+TEST_CASE("MarkdownBlocks parse/serialize", "[bench][ui][markdown_blocks]") {
+    MarkdownBlocks blocks;
+    for (const auto& size : kDocumentSizes) {
+        const auto markdown = QString::fromStdString(markdown_document(size.bytes));
+        const auto parsed = blocks.parse(markdown);
+        REQUIRE_FALSE(parsed.isEmpty());
+
+        BENCHMARK(std::string("parse ") + size.label) {
+            return blocks.parse(markdown);
+        };
+
+        // Native blocks, as BlockModel and DataStore::searchPages consume them.
+        BENCHMARK(std::string("parseBlocks ") + size.label) {
+            return MarkdownBlocks::parseBlocks(markdown);
+        };
+
+        BENCHMARK(std::string("parseBlocksWithSpans ") + size.label) {
+            return MarkdownBlocks::parseBlocksWithSpans(markdown);
+        };
+
+        WARN("parseBlocks " << size.label << ": "
+             << megabytes_per_second(size.bytes, [&] { return MarkdownBlocks::parseBlocks(markdown).size(); })
+             << " MB/s, parse: "
+             << megabytes_per_second(size.bytes, [&] { return blocks.parse(markdown).size(); })
+             << " MB/s");
+
+        BENCHMARK(std::string("serialize ") + size.label) {
+            return blocks.serialize(parsed);
+        };
+    }
+}
+
+TEST_CASE("BlockModel remote refresh", "[bench][ui][block_model]") {
+    // A 1,000-block page where the remote side edited one block in the middle.
+    auto page = [](const QString& edit) {
+        QStringList parts;
+        for (int i = 0; i < 1000; ++i) {
+            parts << QStringLiteral("Paragraph %1 with a little text%2").arg(i).arg(i == 500 ? edit : QString());
+        }
+        return parts.join(QStringLiteral("\n\n")) + QStringLiteral("\n");
+    };
+    const auto before = page(QString());
+    const auto after = page(QStringLiteral(" and a remote edit"));
+
+    BlockModel reloaded;
+    BENCHMARK("loadFromMarkdown 1000 blocks") {
+        reloaded.clear();
+        return reloaded.loadFromMarkdown(after);
+    };
+
+    BlockModel merged;
+    REQUIRE(merged.loadFromMarkdown(before));
+    bool flip = false;
+    // Alternates direction so every iteration is a one-block diff.
+    BENCHMARK("mergeFromMarkdown 1000 blocks, 1 edited") {
+        flip = !flip;
+        return merged.mergeFromMarkdown(flip ? after : before);
+    };
+}
+
+TEST_CASE("BlockModel open large page", "[bench][ui][block_model]") {
+    // Imported logs: open cost should stay flat once pages are windowed.
+    for (const int blocks : {1000, 10000, 50000}) {
+        QStringList parts;
+        for (int i = 0; i < blocks; ++i) {
+            parts << QStringLiteral("%1 Log line %2 with a little text").arg(i % 7 == 0 ? QStringLiteral("#") : QStringLiteral("-")).arg(i);
+        }
+        const auto page = parts.join(QStringLiteral("\n\n")) + QStringLiteral("\n");
+
+        BlockModel model;
+        BENCHMARK("loadFromMarkdown " + std::to_string(blocks) + " blocks") {
+            model.clear();
+            return model.loadFromMarkdown(page);
+        };
+    }
+}
+
+TEST_CASE("InlineRichText parse/reconcileTextChange", "[bench][ui][inline_rich_text]") {
+    InlineRichText inline_text;
+    for (const auto& size : kDocumentSizes) {
+        const auto markup = QString::fromStdString(markdown_document(size.bytes));
+
+        BENCHMARK(std::string("parse ") + size.label) {
+            return inline_text.parse(markup);
+        };
+
+        const auto parsed = inline_text.parse(markup);
+        const auto before = parsed.value(QStringLiteral("text")).toString();
+        const auto runs = parsed.value(QStringLiteral("runs")).toList();
+        const int mid = static_cast<int>(before.size() / 2);
+        const auto after = before.left(mid) + QLatin1Char('x') + before.mid(mid);
+
+        // A single keystroke in the middle of the block: the editor's hot path.
+        BENCHMARK(std::string("reconcileTextChange ") + size.label) {
+            return inline_text.reconcileTextChange(before, after, runs, QVariantMap(), mid + 1);
+        };
+    }
+}
+
+TEST_CASE("InlineRunStore keystroke", "[bench][ui][inline_rich_text]") {
+    // 500 styled runs in one block.
+    QString markup;
+    for (int i = 0; i < 250; ++i) {
+        markup += QStringLiteral("<b>styled</b> plain ");
+    }
+
+    InlineRichText inline_text;
+    const auto parsed = inline_text.parse(markup);
+    const auto before = parsed.value(QStringLiteral("text")).toString();
+    const auto runs = parsed.value(QStringLiteral("runs")).toList();
+    REQUIRE(runs.size() == 500);
+    const int mid = static_cast<int>(before.size() / 2);
+    const auto after = before.left(mid) + QLatin1Char('x') + before.mid(mid);
+
+    BENCHMARK("reconcileTextChange + serialize 500 runs") {
+        const auto reconciled = inline_text.reconcileTextChange(before, after, runs, QVariantMap(), mid + 1);
+        return inline_text.serialize(after, reconciled.value(QStringLiteral("runs")).toList());
+    };
+
+    InlineRunStore store;
+    const auto key = store.retain(QString());
+    store.load(key, markup);
+
+    // Type a character and delete it again, so every iteration starts from the same runs.
+    BENCHMARK("InlineRunStore insert + remove 500 runs") {
+        store.insert(key, mid, QStringLiteral("x"));
+        store.remove(key, mid, 1);
+        return store.runsFor(key)->size();
+    };
+
+    BENCHMARK("InlineRunStore reconcile + markup 500 runs") {
+        store.reconcile(key, after, mid + 1);
+        const auto out = store.markup(key);
+        store.reconcile(key, before, mid);
+        return out;
+    };
+}
+
+TEST_CASE("Cmark toHtml", "[bench][ui][cmark]") {
+    Cmark cmark;
+    // Render cost only; the cache would answer every iteration after the first.
+    cmark.setCacheCapacity(0);
+    for (const auto& size : kDocumentSizes) {
+        const auto markdown = QString::fromStdString(markdown_document(size.bytes));
+
+        BENCHMARK(std::string("toHtml ") + size.label) {
+            return cmark.toHtml(markdown);
+        };
+    }
+}
+
+TEST_CASE("Cmark scroll 2000-block page", "[bench][ui][cmark]") {
+    // Delegates render their block's markdown when created; scrolling a ListView through the page
+    // recreates them, so a full scroll down and back renders every block twice.
+    const auto markdown = QString::fromStdString(markdown_document(2000 * 64));
+    const auto blocks = MarkdownBlocks::parseBlocks(markdown);
+    QStringList contents;
+    contents.reserve(static_cast<qsizetype>(blocks.size()));
+    // The generator repeats a handful of lines; number them so every block is distinct.
+    for (const auto& block : blocks) {
+        contents.append(block.content.toString() + QStringLiteral(" %1").arg(contents.size()));
+    }
+    REQUIRE(contents.size() >= 2000);
+
+    const auto scroll = [&](const Cmark& cmark) {
+        qsizetype bytes = 0;
+        for (const auto& content : contents) {
+            bytes += cmark.toHtml(content).size();
+        }
+        for (auto it = contents.crbegin(); it != contents.crend(); ++it) {
+            bytes += cmark.toHtml(*it).size();
+        }
+        return bytes;
+    };
+
+    Cmark uncached;
+    uncached.setCacheCapacity(0);
+    BENCHMARK("scroll down and up, uncached") {
+        return scroll(uncached);
+    };
+
+    Cmark cached;
+    scroll(cached);
+    BENCHMARK("scroll down and up, cached") {
+        return scroll(cached);
+    };
+    WARN("Cmark cache after scrolling: " << cached.cacheHits() << " hits, " << cached.cacheMisses()
+         << " misses, " << cached.cacheBytes() << " bytes");
+    CHECK(cached.cacheHits() > cached.cacheMisses());
+}
+
+TEST_CASE("Cmark renderBatch", "[bench][ui][cmark]") {
+    // An html export's worth of pages: 10k distinct ~1KB documents.
+    QStringList pages;
+    pages.reserve(10000);
+    for (int i = 0; i < 10000; ++i) {
+        pages.append(QString::fromStdString(markdown_document(1024, static_cast<unsigned>(i))));
+    }
+
+    for (const int threads : {1, 2, 4, 8}) {
+        QThreadPool pool;
+        pool.setMaxThreadCount(threads);
+        std::atomic<qsizetype> bytes{0};
+        const auto run = [&] {
+            Cmark::renderBatch(pages, [&](qsizetype, QStringView html) {
+                bytes.fetch_add(html.size(), std::memory_order_relaxed);
+            }, threads, &pool);
+            return bytes.load();
+        };
+
+        BENCHMARK("renderBatch 10k pages, " + std::to_string(threads) + " threads") {
+            return run();
+        };
+
+        const auto start = std::chrono::steady_clock::now();
+        run();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        WARN("renderBatch " << threads << " threads: " << pages.size() / elapsed.count() << " pages/s");
+    }
+}
+
+TEST_CASE("DataStore export workspace", "[bench][ui][export]") {
+    // Defaults keep the run short; ZINC_BENCH_EXPORT_PAGES=20000 ZINC_BENCH_EXPORT_ATTACHMENT_MB=5120
+    // reproduces the 20k-page, 5 GB workspace.
+    const auto envInt = [](const char* name, int fallback) {
+        bool ok = false;
+        const int value = qEnvironmentVariableIntValue(name, &ok);
+        return ok && value > 0 ? value : fallback;
+    };
+    const int pageCount = envInt("ZINC_BENCH_EXPORT_PAGES", 2000);
+    const int attachmentCount = envInt("ZINC_BENCH_EXPORT_ATTACHMENT_MB", 64); // 1 MB each
+
+    QTemporaryDir workspace;
+    REQUIRE(workspace.isValid());
+    qputenv("ZINC_DB_PATH", QDir(workspace.path()).filePath(QStringLiteral("zinc.db")).toUtf8());
+    qputenv("ZINC_ATTACHMENTS_DIR", QDir(workspace.path()).filePath(QStringLiteral("attachments")).toUtf8());
+    qputenv("ZINC_DISABLE_DEFAULT_PAGES", "1");
+
+    DataStore store;
+    REQUIRE(store.initialize());
+
+    QStringList attachmentIds;
+    const auto payload = QString::fromLatin1(QByteArray(1 << 20, 'z').toBase64());
+    QVariantList batch;
+    for (int i = 0; i < attachmentCount; ++i) {
+        const auto id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+        attachmentIds.append(id);
+        batch.append(QVariantMap{{QStringLiteral("attachmentId"), id},
+                                 {QStringLiteral("mimeType"), QStringLiteral("image/png")},
+                                 {QStringLiteral("dataBase64"), payload},
+                                 {QStringLiteral("updatedAt"), QStringLiteral("2026-01-01T00:00:00.000Z")}});
+        if (batch.size() == 16 || i + 1 == attachmentCount) {
+            store.applyAttachmentUpdates(batch);
+            batch.clear();
+        }
+    }
+
+    QStringList notebookIds;
+    for (int i = 0; i < 10; ++i) {
+        notebookIds.append(store.createNotebook(QStringLiteral("Notebook %1").arg(i)));
+    }
+    QVariantList pages;
+    pages.reserve(pageCount);
+    for (int i = 0; i < pageCount; ++i) {
+        auto markdown = QString::fromStdString(markdown_document(2048, static_cast<unsigned>(i)));
+        if (!attachmentIds.isEmpty()) {
+            markdown += QStringLiteral("\n\n![](image://attachments/%1)\n").arg(attachmentIds.at(i % attachmentIds.size()));
+        }
+        pages.append(QVariantMap{{QStringLiteral("pageId"), QUuid::createUuid().toString(QUuid::WithoutBraces)},
+                                 {QStringLiteral("notebookId"), notebookIds.at(i % notebookIds.size())},
+                                 {QStringLiteral("title"), QStringLiteral("Page %1").arg(i)},
+                                 {QStringLiteral("parentId"), QString()},
+                                 {QStringLiteral("depth"), 0},
+                                 {QStringLiteral("sortOrder"), i},
+                                 {QStringLiteral("contentMarkdown"), markdown}});
+    }
+    store.saveAllPages(pages);
+
+    for (const auto* format : {"markdown", "html", "archive"}) {
+        QTemporaryDir destination;
+        REQUIRE(destination.isValid());
+        const auto start = std::chrono::steady_clock::now();
+        REQUIRE(store.exportNotebooks({}, QUrl::fromLocalFile(destination.path()), QString::fromLatin1(format), true));
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        WARN("export " << format << " " << pageCount << " pages, " << attachmentCount
+             << " MB attachments: " << elapsed.count() << " s");
+
+        // The nightly-backup case: the same workspace into the same folder again.
+        const auto again = std::chrono::steady_clock::now();
+        REQUIRE(store.exportNotebooks({}, QUrl::fromLocalFile(destination.path()), QString::fromLatin1(format), true));
+        const std::chrono::duration<double> unchanged = std::chrono::steady_clock::now() - again;
+        WARN("re-export " << format << " with no changes: " << unchanged.count() << " s");
+    }
+
+    // Importing the markdown tree back as a copy: parse, link rewrite and batched page writes.
+    {
+        QTemporaryDir source;
+        REQUIRE(source.isValid());
+        REQUIRE(store.exportNotebooks({}, QUrl::fromLocalFile(source.path()), QStringLiteral("markdown"), true));
+        const auto start = std::chrono::steady_clock::now();
+        REQUIRE(store.importNotebooks(QUrl::fromLocalFile(source.path()), QStringLiteral("auto"), false));
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        WARN("import markdown " << pageCount << " pages, " << attachmentCount
+             << " MB attachments: " << elapsed.count() << " s");
+    }
+
+    qunsetenv("ZINC_DB_PATH");
+    qunsetenv("ZINC_ATTACHMENTS_DIR");
+    qunsetenv("ZINC_DISABLE_DEFAULT_PAGES");
+}
@@ -0,0 +1,105 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include "network/keepalive.hpp"
+
+using namespace zinc::network;
+using Catch::Matchers::WithinAbs;
+
+namespace {
+
+KeepaliveConfig test_config() {
+    KeepaliveConfig config;
+    config.idle_interval_ms = 1000;
+    config.pong_timeout_ms = 500;
+    config.max_missed_pongs = 3;
+    return config;
+}
+
+} // namespace
+
+TEST_CASE("Keepalive: pings only after idle interval", "[integration][network][keepalive]") {
+    KeepaliveTracker tracker(test_config());
+    tracker.reset(0);
+
+    REQUIRE_FALSE(tracker.should_ping(500));
+    REQUIRE(tracker.should_ping(1000));
+
+    // Inbound sync traffic counts as liveness and postpones the ping.
+    tracker.on_activity(900);
+    REQUIRE_FALSE(tracker.should_ping(1000));
+    REQUIRE(tracker.should_ping(1900));
+
+    tracker.on_ping_sent(1900);
+    REQUIRE(tracker.ping_outstanding());
+    REQUIRE_FALSE(tracker.should_ping(5000));
+}
+
+TEST_CASE("Keepalive: RTT smoothing follows RFC 6298", "[integration][network][keepalive]") {
+    KeepaliveTracker tracker(test_config());
+    tracker.reset(0);
+
+    const auto first = tracker.on_ping_sent(1000);
+    REQUIRE(tracker.on_pong(first, 1100));
+    REQUIRE_THAT(*tracker.smoothed_rtt_ms(), WithinAbs(100.0, 1e-9));
+    REQUIRE_THAT(*tracker.rtt_jitter_ms(), WithinAbs(50.0, 1e-9));
+
+    const auto second = tracker.on_ping_sent(3000);
+    REQUIRE(tracker.on_pong(second, 3020));
+    REQUIRE_THAT(*tracker.rtt_jitter_ms(), WithinAbs(0.75 * 50.0 + 0.25 * 80.0, 1e-9));
+    REQUIRE_THAT(*tracker.smoothed_rtt_ms(), WithinAbs(0.875 * 100.0 + 0.125 * 20.0, 1e-9));
+    REQUIRE_THAT(*tracker.last_rtt_ms(), WithinAbs(20.0, 1e-9));
+}
+
+TEST_CASE("Keepalive: legacy empty pong matches outstanding ping", "[integration][network][keepalive]") {
+    KeepaliveTracker tracker(test_config());
+    tracker.reset(0);
+
+    tracker.on_ping_sent(1000);
+    REQUIRE(tracker.on_pong(decode_keepalive_nonce({}), 1040));
+    REQUIRE_FALSE(tracker.ping_outstanding());
+    REQUIRE_THAT(*tracker.smoothed_rtt_ms(), WithinAbs(40.0, 1e-9));
+}
+
+TEST_CASE("Keepalive: stale pong refreshes liveness without RTT sample", "[integration][network][keepalive]") {
+    KeepaliveTracker tracker(test_config());
+    tracker.reset(0);
+
+    const auto expired = tracker.on_ping_sent(1000);
+    REQUIRE(tracker.check_timeout(1500));
+    REQUIRE(tracker.missed_pongs() == 1);
+
+    tracker.on_ping_sent(1500);
+    REQUIRE_FALSE(tracker.on_pong(expired, 1600));
+    REQUIRE(tracker.missed_pongs() == 0);
+    REQUIRE(tracker.ping_outstanding());
+    REQUIRE_FALSE(tracker.smoothed_rtt_ms().has_value());
+}
+
+TEST_CASE("Keepalive: declares peer dead after N missed pongs", "[integration][network][keepalive]") {
+    KeepaliveTracker tracker(test_config());
+    tracker.reset(0);
+
+    int64_t now = 1000;
+    for (int i = 0; i < 3; ++i) {
+        REQUIRE_FALSE(tracker.is_dead());
+        // After the first miss, the next probe goes out immediately.
+        REQUIRE(tracker.should_ping(now));
+        tracker.on_ping_sent(now);
+        REQUIRE_FALSE(tracker.check_timeout(now + 499));
+        now += 500;
+        REQUIRE(tracker.check_timeout(now));
+    }
+    REQUIRE(tracker.is_dead());
+    REQUIRE_FALSE(tracker.should_ping(now));
+}
+
+TEST_CASE("Keepalive: nonce payload round-trips", "[integration][network][keepalive]") {
+    const uint64_t nonce = 0x0102030405060708ULL;
+    const auto payload = encode_keepalive_nonce(nonce);
+    REQUIRE(payload.size() == 8);
+    REQUIRE(payload.front() == 0x01);
+    REQUIRE(payload.back() == 0x08);
+    REQUIRE(decode_keepalive_nonce(payload) == nonce);
+    REQUIRE_FALSE(decode_keepalive_nonce({0x01, 0x02}).has_value());
+}
@@ -0,0 +1,116 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "network/peer_cache.hpp"
+
+#include <QHostAddress>
+#include <QTemporaryDir>
+
+using namespace zinc;
+using namespace zinc::network;
+
+namespace {
+
+PeerInfo make_peer(const Uuid& id, const Uuid& ws, const QString& host, uint16_t port, int64_t last_seen_ms) {
+    PeerInfo info{};
+    info.device_id = id;
+    info.workspace_id = ws;
+    info.device_name = QStringLiteral("Laptop");
+    info.host = QHostAddress(host);
+    info.port = port;
+    info.public_key_fingerprint = {0x0A, 0x0B, 0x0C};
+    info.last_seen = Timestamp(last_seen_ms);
+    info.protocol_version = 1;
+    return info;
+}
+
+} // namespace
+
+TEST_CASE("Peer cache: round-trips through JSON", "[integration][network][peer_cache]") {
+    const auto ws = Uuid::generate();
+    const auto id = Uuid::generate();
+
+    PeerCache cache;
+    REQUIRE(cache.upsert(make_peer(id, ws, QStringLiteral("192.168.1.10"), 47888, 1000)));
+    REQUIRE(cache.upsert(make_peer(id, ws, QStringLiteral("100.64.0.7"), 47888, 2000)));
+
+    const auto decoded = PeerCache::deserialize(cache.serialize());
+    REQUIRE(decoded.is_ok());
+    const auto entry = decoded.unwrap().peer(id);
+    REQUIRE(entry.has_value());
+    REQUIRE(entry->info.workspace_id == ws);
+    REQUIRE(entry->info.device_name == QStringLiteral("Laptop"));
+    REQUIRE(entry->info.public_key_fingerprint == std::vector<uint8_t>{0x0A, 0x0B, 0x0C});
+    REQUIRE(entry->info.last_seen == Timestamp(2000));
+    REQUIRE(entry->info.host == QHostAddress(QStringLiteral("100.64.0.7")));
+    REQUIRE(entry->endpoints.size() == 2);
+    REQUIRE(entry->endpoints[1].host == QHostAddress(QStringLiteral("192.168.1.10")));
+}
+
+TEST_CASE("Peer cache: heartbeat refresh is not persisted", "[integration][network][peer_cache]") {
+    const auto ws = Uuid::generate();
+    const auto id = Uuid::generate();
+
+    PeerCache cache;
+    REQUIRE(cache.upsert(make_peer(id, ws, QStringLiteral("192.168.1.10"), 47888, 1000)));
+    REQUIRE_FALSE(cache.upsert(make_peer(id, ws, QStringLiteral("192.168.1.10"), 47888, 2500)));
+    REQUIRE(cache.peer(id)->info.last_seen == Timestamp(2500));
+    REQUIRE(cache.upsert(make_peer(id, ws, QStringLiteral("192.168.1.10"), 47888,
+                                   2500 + PeerCache::kLastSeenPersistGranularityMs)));
+}
+
+TEST_CASE("Peer cache: bounds endpoints per peer", "[integration][network][peer_cache]") {
+    const auto ws = Uuid::generate();
+    const auto id = Uuid::generate();
+
+    PeerCache cache;
+    for (int i = 0; i < 10; ++i) {
+        cache.upsert(make_peer(id, ws, QStringLiteral("10.0.0.%1").arg(i + 1), 47888, 1000 + i));
+    }
+    const auto entry = cache.peer(id);
+    REQUIRE(entry->endpoints.size() == PeerCache::kMaxEndpointsPerPeer);
+    REQUIRE(entry->endpoints.front().host == QHostAddress(QStringLiteral("10.0.0.10")));
+}
+
+TEST_CASE("Peer cache: filters by workspace and age, newest first", "[integration][network][peer_cache]") {
+    const auto ws = Uuid::generate();
+    const auto other_ws = Uuid::generate();
+    const auto older = Uuid::generate();
+    const auto newer = Uuid::generate();
+    const auto stale = Uuid::generate();
+
+    PeerCache cache;
+    cache.upsert(make_peer(older, ws, QStringLiteral("10.0.0.1"), 47888, 5000));
+    cache.upsert(make_peer(newer, ws, QStringLiteral("10.0.0.2"), 47888, 9000));
+    cache.upsert(make_peer(stale, ws, QStringLiteral("10.0.0.3"), 47888, 100));
+    cache.upsert(make_peer(Uuid::generate(), other_ws, QStringLiteral("10.0.0.4"), 47888, 9500));
+
+    const auto peers = cache.peers_for_workspace(ws, Timestamp(10000), 6000);
+    REQUIRE(peers.size() == 2);
+    REQUIRE(peers[0].info.device_id == newer);
+    REQUIRE(peers[1].info.device_id == older);
+}
+
+TEST_CASE("Peer cache: missing file loads empty and save/load round-trips", "[integration][network][peer_cache]") {
+    QTemporaryDir dir;
+    REQUIRE(dir.isValid());
+    const auto path = dir.filePath(QStringLiteral("nested/sync_peer_cache.json"));
+
+    const auto empty = PeerCache::load(path);
+    REQUIRE(empty.is_ok());
+    REQUIRE(empty.unwrap().empty());
+
+    const auto ws = Uuid::generate();
+    const auto id = Uuid::generate();
+    PeerCache cache;
+    cache.upsert(make_peer(id, ws, QStringLiteral("127.0.0.1"), 50000, 1000));
+    REQUIRE(cache.save(path).is_ok());
+
+    const auto loaded = PeerCache::load(path);
+    REQUIRE(loaded.is_ok());
+    REQUIRE(loaded.unwrap().peer(id)->info.port == 50000);
+}
+
+TEST_CASE("Peer cache: rejects unknown format version", "[integration][network][peer_cache]") {
+    REQUIRE(PeerCache::deserialize(QByteArrayLiteral("{\"v\":99,\"peers\":[]}")).is_err());
+    REQUIRE(PeerCache::deserialize(QByteArrayLiteral("not json")).is_err());
+}
@@ -135,3 +135,50 @@ TEST_CASE("Property: string round-trip preserves value", "[property][fractional_
     );
 }
 
+
+TEST_CASE("Property: between_n produces ordered keys inside the gap", "[property][fractional_index]") {
+    rc::check("a < keys[0] < ... < keys[n-1] < b",
+        [](const FractionalIndex& a, const FractionalIndex& b) {
+            if (a >= b) return true;
+            // Nothing sorts between "x" and "x000..."; between_n rejects that gap.
+            const auto& av = a.value();
+            const auto& bv = b.value();
+            if (bv.compare(0, av.size(), av) == 0 &&
+                bv.find_first_not_of(FractionalIndex::SMALLEST, av.size()) == std::string::npos) {
+                return true;
+            }
+
+            const auto n = *rc::gen::inRange<size_t>(1, 200);
+            const auto keys = FractionalIndex::between_n(a, b, n);
+            RC_ASSERT(keys.size() == n);
+            RC_ASSERT(a < keys.front());
+            RC_ASSERT(keys.back() < b);
+            for (size_t i = 1; i < keys.size(); ++i) {
+                RC_ASSERT(keys[i - 1] < keys[i]);
+            }
+            return true;
+        }
+    );
+}
+
+TEST_CASE("Property: rebalance keeps order and bounds key length", "[property][fractional_index]") {
+    rc::check("rebalance(sorted keys) is strictly increasing and short",
+        [](std::vector<FractionalIndex> keys) {
+            std::sort(keys.begin(), keys.end());
+            const auto max_length = *rc::gen::inRange<size_t>(4, 9);
+
+            const auto rebalanced = FractionalIndex::rebalance(keys, max_length);
+            RC_ASSERT(rebalanced.size() == keys.size());
+            for (size_t i = 0; i < rebalanced.size(); ++i) {
+                RC_ASSERT(rebalanced[i].value().size() <= max_length);
+                if (i > 0) {
+                    RC_ASSERT(rebalanced[i - 1] < rebalanced[i]);
+                }
+            }
+
+            // Already-balanced lists are left untouched.
+            RC_ASSERT(FractionalIndex::rebalance(rebalanced, max_length) == rebalanced);
+            return true;
+        }
+    );
+}
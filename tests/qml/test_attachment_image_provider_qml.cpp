@@ -0,0 +1,264 @@
+#include <catch2/catch_message.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QImage>
+#include <QPainter>
+#include <QPointer>
+#include <QQmlComponent>
+#include <QQmlEngine>
+#include <QQmlError>
+#include <QQuickImageResponse>
+#include <QQuickItem>
+#include <QQuickWindow>
+#include <QSignalSpy>
+#include <QStringList>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QThreadPool>
+#include <QUuid>
+
+#include <memory>
+#include <vector>
+
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#endif
+
+#include "ui/AttachmentImageProvider.hpp"
+#include "ui/AttachmentThumbnailCache.hpp"
+
+namespace {
+
+QString formatErrors(const QList<QQmlError>& errors) {
+    QStringList lines;
+    lines.reserve(errors.size());
+    for (const auto& error : errors) {
+        lines.append(error.toString());
+    }
+    return lines.join('\n');
+}
+
+// Points the provider at a fresh attachments folder for the lifetime of the test.
+class AttachmentsDir {
+public:
+    AttachmentsDir() {
+        REQUIRE(m_dir.isValid());
+        qputenv("ZINC_ATTACHMENTS_DIR", m_dir.path().toUtf8());
+    }
+    ~AttachmentsDir() {
+        // Decoding originals queues thumbnail generation; let it finish before the folder goes.
+        QThreadPool::globalInstance()->waitForDone();
+        qunsetenv("ZINC_ATTACHMENTS_DIR");
+    }
+
+    [[nodiscard]] QString path() const { return m_dir.path(); }
+
+    // Writes `count` copies of one large photo-like JPEG under fresh ids.
+    QStringList addPhotos(int count, const QSize& size) {
+        QImage photo(size, QImage::Format_RGB32);
+        QPainter painter(&photo);
+        QLinearGradient gradient(0, 0, size.width(), size.height());
+        gradient.setColorAt(0, Qt::darkBlue);
+        gradient.setColorAt(1, Qt::yellow);
+        painter.fillRect(photo.rect(), gradient);
+        for (int i = 0; i < 200; ++i) {
+            painter.setPen(QColor::fromHsv((i * 37) % 360, 200, 220));
+            painter.drawLine(0, i * size.height() / 200, size.width(), size.height() - i * size.height() / 200);
+        }
+        painter.end();
+
+        const auto first = QDir(m_dir.path()).filePath(QStringLiteral("photo.jpg"));
+        REQUIRE(photo.save(first, "JPEG", 90));
+        QStringList ids;
+        for (int i = 0; i < count; ++i) {
+            const auto id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+            REQUIRE(QFile::copy(first, QDir(m_dir.path()).filePath(id)));
+            ids.append(id);
+        }
+        return ids;
+    }
+
+private:
+    QTemporaryDir m_dir;
+};
+
+struct PageTimings {
+    qint64 firstFrameMs = -1;
+    qint64 allLoadedMs = -1;
+};
+
+// Opens a window listing `ids` as 450x300 images and waits until every one has loaded.
+PageTimings open_image_page(const QStringList& ids) {
+    QQmlEngine engine;
+    engine.addImageProvider(QStringLiteral("attachments"), new zinc::ui::AttachmentImageProvider());
+    QQmlComponent component(&engine);
+    component.setData(
+        "import QtQuick\n"
+        "Window {\n"
+        "    width: 900\n"
+        "    height: 700\n"
+        "    visible: true\n"
+        "    property var ids: []\n"
+        "    Flickable {\n"
+        "        anchors.fill: parent\n"
+        "        contentHeight: column.height\n"
+        "        Column {\n"
+        "            id: column\n"
+        "            Repeater {\n"
+        "                model: ids\n"
+        "                Image {\n"
+        "                    objectName: \"attachmentImage\"\n"
+        "                    width: 450\n"
+        "                    height: 300\n"
+        "                    fillMode: Image.PreserveAspectFit\n"
+        "                    sourceSize.width: width\n"
+        "                    sourceSize.height: height\n"
+        "                    asynchronous: true\n"
+        "                    source: \"image://attachments/\" + modelData\n"
+        "                }\n"
+        "            }\n"
+        "        }\n"
+        "    }\n"
+        "}\n",
+        QUrl(QStringLiteral("qrc:/qt/qml/zinc/tests/AttachmentImagesPage.qml")));
+    REQUIRE_FALSE(component.isError());
+
+    PageTimings timings;
+    QElapsedTimer timer;
+    timer.start();
+    std::unique_ptr<QObject> root(component.createWithInitialProperties({{QStringLiteral("ids"), ids}}));
+    INFO(formatErrors(component.errors()).toStdString());
+    REQUIRE(root);
+    auto* window = qobject_cast<QQuickWindow*>(root.get());
+    REQUIRE(window);
+
+    QObject::connect(window, &QQuickWindow::frameSwapped, window, [&] {
+        if (timings.firstFrameMs < 0) timings.firstFrameMs = timer.elapsed();
+    });
+    const auto images = root->findChildren<QQuickItem*>(QStringLiteral("attachmentImage"));
+    REQUIRE(images.size() == ids.size());
+
+    const auto allReady = [&] {
+        for (auto* image : images) {
+            if (image->property("status").toInt() != 1) return false; // Image.Ready
+        }
+        return true;
+    };
+    REQUIRE(QTest::qWaitFor([&] { return timings.firstFrameMs >= 0; }, 20000));
+    REQUIRE(QTest::qWaitFor(allReady, 60000));
+    timings.allLoadedMs = timer.elapsed();
+
+    // Decoded at the requested size, not the original.
+    for (auto* image : images) {
+        REQUIRE(image->implicitWidth() <= 450);
+        REQUIRE(image->implicitHeight() <= 300);
+    }
+    return timings;
+}
+
+// Peak resident set size of this process in MiB, or -1 where it is not available.
+qint64 peak_rss_mib() {
+#ifdef Q_OS_UNIX
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return -1;
+#ifdef Q_OS_MACOS
+    return usage.ru_maxrss / (1024 * 1024); // bytes
+#else
+    return usage.ru_maxrss / 1024; // KiB
+#endif
+#else
+    return -1;
+#endif
+}
+
+} // namespace
+
+TEST_CASE("AttachmentImageProvider: overlapping requests share one decode", "[qml][image][attachments]") {
+    AttachmentsDir dir;
+    const auto ids = dir.addPhotos(1, QSize(4000, 3000));
+
+    zinc::ui::AttachmentImageProvider provider(2);
+    std::vector<std::unique_ptr<QQuickImageResponse>> responses;
+    std::vector<std::unique_ptr<QSignalSpy>> spies;
+    for (int i = 0; i < 8; ++i) {
+        responses.emplace_back(provider.requestImageResponse(ids.first(), QSize(400, 300)));
+        spies.push_back(std::make_unique<QSignalSpy>(responses.back().get(), &QQuickImageResponse::finished));
+    }
+    for (size_t i = 0; i < responses.size(); ++i) {
+        REQUIRE((spies[i]->count() > 0 || spies[i]->wait(20000)));
+        REQUIRE(responses[i]->errorString().isEmpty());
+    }
+    REQUIRE(provider.decodeCount() == 1);
+
+    // Cancelling a delivered response does not finish it again.
+    responses.front()->cancel();
+    REQUIRE(spies.front()->count() == 1);
+    REQUIRE(responses.front()->errorString().isEmpty());
+
+    // Another size is another decode.
+    std::unique_ptr<QQuickImageResponse> other(provider.requestImageResponse(ids.first(), QSize(200, 150)));
+    QSignalSpy finished(other.get(), &QQuickImageResponse::finished);
+    REQUIRE(finished.wait(20000));
+    REQUIRE(provider.decodeCount() == 2);
+}
+
+TEST_CASE("AttachmentImageProvider: cancelled requests are not decoded", "[qml][image][attachments]") {
+    AttachmentsDir dir;
+    const auto ids = dir.addPhotos(2, QSize(4000, 3000));
+
+    // One decode thread: the second request waits behind the first and is cancelled meanwhile.
+    zinc::ui::AttachmentImageProvider provider(1);
+    std::unique_ptr<QQuickImageResponse> busy(provider.requestImageResponse(ids.at(0), QSize(400, 300)));
+    QSignalSpy finished(busy.get(), &QQuickImageResponse::finished);
+    // Like the pixmap reader, the cancelled response is only deleted once it has finished.
+    QPointer<QQuickImageResponse> dropped(provider.requestImageResponse(ids.at(1), QSize(400, 300)));
+    QSignalSpy droppedFinished(dropped.data(), &QQuickImageResponse::finished);
+    QString droppedError;
+    QObject::connect(dropped.data(), &QQuickImageResponse::finished, dropped.data(),
+                     [&] { droppedError = dropped->errorString(); });
+    QObject::connect(dropped.data(), &QQuickImageResponse::finished, dropped.data(), &QObject::deleteLater);
+    dropped->cancel();
+    REQUIRE((droppedFinished.count() > 0 || droppedFinished.wait(5000)));
+    REQUIRE(droppedFinished.count() == 1);
+    REQUIRE(droppedError == QStringLiteral("cancelled"));
+    REQUIRE(QTest::qWaitFor([&] { return dropped.isNull(); }, 5000));
+
+    REQUIRE((finished.count() > 0 || finished.wait(20000)));
+    REQUIRE(busy->errorString().isEmpty());
+    QTest::qWait(200);
+    REQUIRE(provider.decodeCount() == 1);
+}
+
+TEST_CASE("QML: a page with 50 large images loads them in the background", "[qml][image][attachments]") {
+    AttachmentsDir dir;
+    const auto ids = dir.addPhotos(50, QSize(3000, 2000));
+
+    const auto timings = open_image_page(ids);
+    WARN("50 images of 3000x2000: first frame " << timings.firstFrameMs << " ms, all loaded "
+                                                << timings.allLoadedMs << " ms");
+}
+
+TEST_CASE("QML: an image-heavy page opens from cached thumbnails", "[qml][image][attachments][thumbnails]") {
+    AttachmentsDir dir;
+    const auto ids = dir.addPhotos(50, QSize(4000, 3000));
+
+    const zinc::ui::AttachmentThumbnailCache cache(dir.path());
+    for (const auto& id : ids) {
+        REQUIRE(cache.generate(id));
+    }
+    // Peak RSS only grows, so measure the thumbnail page first.
+    const auto fromThumbnails = open_image_page(ids);
+    const auto thumbnailsRss = peak_rss_mib();
+    WARN("50 images of 4000x3000 from thumbnails: first frame " << fromThumbnails.firstFrameMs
+                                                               << " ms, all loaded " << fromThumbnails.allLoadedMs
+                                                               << " ms, peak RSS " << thumbnailsRss << " MiB");
+
+    REQUIRE(QDir(cache.directory()).removeRecursively());
+    const auto fromOriginals = open_image_page(ids);
+    WARN("50 images of 4000x3000 from originals: first frame " << fromOriginals.firstFrameMs
+                                                              << " ms, all loaded " << fromOriginals.allLoadedMs
+                                                              << " ms, peak RSS " << peak_rss_mib() << " MiB");
+}
@@ -0,0 +1,200 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <QBuffer>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QPainter>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QThreadPool>
+
+#include <algorithm>
+
+#include "ui/AttachmentThumbnailCache.hpp"
+#include "ui/DataStore.hpp"
+
+using zinc::ui::AttachmentThumbnailCache;
+
+namespace {
+
+QImage make_photo(const QSize& size, QColor color) {
+    QImage image(size, QImage::Format_RGB32);
+    QPainter painter(&image);
+    painter.fillRect(image.rect(), color);
+    painter.setPen(Qt::white);
+    painter.drawLine(0, 0, size.width(), size.height());
+    return image;
+}
+
+void write_original(const QString& dir, const QString& id, const QImage& image, const char* format = "JPG") {
+    REQUIRE(image.save(QDir(dir).filePath(id), format));
+}
+
+QStringList thumbnail_files(const AttachmentThumbnailCache& cache, const QString& id) {
+    return QDir(QDir(cache.directory()).filePath(id)).entryList({QStringLiteral("*-*")}, QDir::Files);
+}
+
+int longest(const QImage& image) {
+    return std::max(image.width(), image.height());
+}
+
+void set_used_at(const QString& path, const QDateTime& at) {
+    QFile f(path);
+    REQUIRE(f.open(QIODevice::ReadOnly));
+    REQUIRE(f.setFileTime(at, QFileDevice::FileModificationTime));
+}
+
+} // namespace
+
+TEST_CASE("AttachmentThumbnailCache: serves the covering bucket or the next larger one", "[qml][attachments][thumbnails]") {
+    QTemporaryDir dir;
+    REQUIRE(dir.isValid());
+    const auto id = QStringLiteral("00000000-0000-0000-0000-0000000000e1");
+    write_original(dir.path(), id, make_photo(QSize(3000, 2000), Qt::darkGreen));
+
+    const AttachmentThumbnailCache cache(dir.path());
+    REQUIRE(cache.lookup(id, QSize(400, 300)).isNull());
+    REQUIRE(cache.generate(id));
+    REQUIRE(thumbnail_files(cache, id).size() == 4);
+
+    REQUIRE(AttachmentThumbnailCache::bucketFor(QSize(400, 300)) == 512);
+    REQUIRE(longest(cache.lookup(id, QSize(100, 100))) == 256);
+    REQUIRE(longest(cache.lookup(id, QSize(400, 300))) == 512);
+    REQUIRE(longest(cache.lookup(id, QSize(2000, 1000))) == 2048);
+    REQUIRE(cache.lookup(id, QSize(3000, 2000)).isNull()); // beyond every bucket
+    REQUIRE(cache.lookup(id, QSize()).isNull());
+
+    // Without the 512 bucket, the 1024 one serves.
+    for (const auto& name : thumbnail_files(cache, id)) {
+        if (name.endsWith(QStringLiteral("-512.jpg"))) {
+            REQUIRE(QFile::remove(QDir(QDir(cache.directory()).filePath(id)).filePath(name)));
+        }
+    }
+    REQUIRE(longest(cache.lookup(id, QSize(400, 300))) == 1024);
+
+    // generate() notices the missing file and writes it again.
+    REQUIRE(cache.generate(id));
+    REQUIRE(longest(cache.lookup(id, QSize(400, 300))) == 512);
+}
+
+TEST_CASE("AttachmentThumbnailCache: small originals are kept at their own size", "[qml][attachments][thumbnails]") {
+    QTemporaryDir dir;
+    REQUIRE(dir.isValid());
+    const auto id = QStringLiteral("00000000-0000-0000-0000-0000000000e2");
+    QImage withAlpha(QSize(300, 200), QImage::Format_ARGB32);
+    withAlpha.fill(QColor(10, 20, 30, 128));
+    write_original(dir.path(), id, withAlpha, "PNG");
+
+    const AttachmentThumbnailCache cache(dir.path());
+    REQUIRE(cache.generate(id));
+    const auto files = thumbnail_files(cache, id);
+    REQUIRE(files.size() == 2); // 256, and 512 holding the original size
+    REQUIRE(files.filter(QStringLiteral(".png")).size() == 2);
+
+    const auto large = cache.lookup(id, QSize(2000, 2000));
+    REQUIRE(large.size() == QSize(300, 200));
+    REQUIRE(large.hasAlphaChannel());
+    REQUIRE(longest(cache.lookup(id, QSize(200, 200))) == 256);
+}
+
+TEST_CASE("AttachmentThumbnailCache: a changed original is not served stale", "[qml][attachments][thumbnails]") {
+    QTemporaryDir dir;
+    REQUIRE(dir.isValid());
+    const auto id = QStringLiteral("00000000-0000-0000-0000-0000000000e3");
+    write_original(dir.path(), id, make_photo(QSize(1600, 1200), Qt::red));
+
+    const AttachmentThumbnailCache cache(dir.path());
+    REQUIRE(cache.generate(id));
+    const auto before = thumbnail_files(cache, id);
+    REQUIRE(cache.lookup(id, QSize(400, 300)).pixelColor(10, 200).red() > 200);
+
+    write_original(dir.path(), id, make_photo(QSize(1200, 1600), Qt::blue));
+    REQUIRE(cache.lookup(id, QSize(400, 300)).isNull());
+
+    REQUIRE(cache.generate(id));
+    const auto after = thumbnail_files(cache, id);
+    REQUIRE(after.size() == before.size());
+    for (const auto& name : before) {
+        REQUIRE_FALSE(after.contains(name));
+    }
+    const auto thumbnail = cache.lookup(id, QSize(400, 300));
+    REQUIRE(thumbnail.height() == 512);
+    REQUIRE(thumbnail.pixelColor(200, 10).blue() > 200);
+
+    // Not an image: generate() declines, lookups stay empty.
+    QFile notImage(QDir(dir.path()).filePath(QStringLiteral("00000000-0000-0000-0000-0000000000e4")));
+    REQUIRE(notImage.open(QIODevice::WriteOnly));
+    notImage.write("%PDF-1.7 not an image");
+    notImage.close();
+    REQUIRE_FALSE(cache.generate(QStringLiteral("00000000-0000-0000-0000-0000000000e4")));
+    REQUIRE(cache.lookup(QStringLiteral("00000000-0000-0000-0000-0000000000e4"), QSize(100, 100)).isNull());
+}
+
+TEST_CASE("AttachmentThumbnailCache: eviction drops the least recently used thumbnails", "[qml][attachments][thumbnails]") {
+    QTemporaryDir dir;
+    REQUIRE(dir.isValid());
+    const auto oldId = QStringLiteral("00000000-0000-0000-0000-0000000000f1");
+    const auto recentId = QStringLiteral("00000000-0000-0000-0000-0000000000f2");
+    const auto goneId = QStringLiteral("00000000-0000-0000-0000-0000000000f3");
+    for (const auto& id : {oldId, recentId, goneId}) {
+        write_original(dir.path(), id, make_photo(QSize(1000, 800), Qt::gray));
+    }
+
+    const AttachmentThumbnailCache unbounded(dir.path());
+    for (const auto& id : {oldId, recentId, goneId}) {
+        REQUIRE(unbounded.generate(id));
+    }
+    REQUIRE(QFile::remove(QDir(dir.path()).filePath(goneId)));
+
+    qint64 recentBytes = 0;
+    const auto now = QDateTime::currentDateTimeUtc();
+    for (const auto& name : thumbnail_files(unbounded, oldId)) {
+        set_used_at(QDir(QDir(unbounded.directory()).filePath(oldId)).filePath(name), now.addDays(-2));
+    }
+    for (const auto& name : thumbnail_files(unbounded, recentId)) {
+        const auto path = QDir(QDir(unbounded.directory()).filePath(recentId)).filePath(name);
+        set_used_at(path, now.addDays(-1));
+        recentBytes += QFileInfo(path).size();
+    }
+
+    const AttachmentThumbnailCache bounded(dir.path(), recentBytes);
+    bounded.evict();
+    REQUIRE(thumbnail_files(bounded, oldId).isEmpty());
+    REQUIRE(thumbnail_files(bounded, recentId).size() == 3);
+    REQUIRE_FALSE(QDir(QDir(bounded.directory()).filePath(goneId)).exists());
+
+    // The evicted attachment falls back to its original, then gets thumbnails again.
+    REQUIRE(bounded.lookup(oldId, QSize(400, 300)).isNull());
+    REQUIRE(bounded.generate(oldId));
+    REQUIRE(longest(bounded.lookup(oldId, QSize(400, 300))) == 512);
+}
+
+TEST_CASE("DataStore: pasted images get thumbnails in the background", "[qml][attachments][thumbnails]") {
+    QTemporaryDir dir;
+    REQUIRE(dir.isValid());
+    qputenv("ZINC_DB_PATH", dir.filePath(QStringLiteral("zinc_thumbnails.db")).toUtf8());
+    qputenv("ZINC_ATTACHMENTS_DIR", dir.filePath(QStringLiteral("attachments")).toUtf8());
+
+    zinc::ui::DataStore store;
+    REQUIRE(store.initialize());
+    REQUIRE(store.resetDatabase());
+
+    QByteArray jpeg;
+    QBuffer buffer(&jpeg);
+    REQUIRE(buffer.open(QIODevice::WriteOnly));
+    REQUIRE(make_photo(QSize(1200, 900), Qt::darkCyan).save(&buffer, "JPG"));
+    const auto id = store.saveAttachmentFromDataUrl(QStringLiteral("data:image/jpeg;base64,") +
+                                                    QString::fromLatin1(jpeg.toBase64()));
+    REQUIRE_FALSE(id.isEmpty());
+
+    const AttachmentThumbnailCache cache(dir.filePath(QStringLiteral("attachments")));
+    REQUIRE(QTest::qWaitFor([&] { return !cache.lookup(id, QSize(400, 300)).isNull(); }, 10000));
+    REQUIRE(longest(cache.lookup(id, QSize(400, 300))) == 512);
+
+    // Let the eviction pass that follows generation finish before the folder goes away.
+    QThreadPool::globalInstance()->waitForDone();
+    qunsetenv("ZINC_ATTACHMENTS_DIR");
+}
@@ -0,0 +1,128 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <QQmlComponent>
+#include <QQmlEngine>
+#include <QQmlError>
+#include <QQuickWindow>
+#include <QStringList>
+#include <QTest>
+#include <QUrl>
+#include <QVariant>
+#include <memory>
+
+#include "ui/qml_types.hpp"
+
+namespace {
+
+void registerTypesOnce() {
+    static bool registered = false;
+    if (registered) {
+        return;
+    }
+    zinc::ui::registerQmlTypes();
+    registered = true;
+}
+
+QString formatErrors(const QList<QQmlError>& errors) {
+    QStringList lines;
+    lines.reserve(errors.size());
+    for (const auto& error : errors) {
+        lines.append(error.toString());
+    }
+    return lines.join('\n');
+}
+
+QString numberedPage(int blocks) {
+    QStringList paragraphs;
+    paragraphs.reserve(blocks);
+    for (int i = 0; i < blocks; ++i) {
+        paragraphs.append(QStringLiteral("Paragraph %1").arg(i));
+    }
+    return paragraphs.join(QStringLiteral("\n\n"));
+}
+
+// Page-wide index of the block the editor has focused, or -1.
+int focusedPageIndex(QObject* editor, QObject* model) {
+    const auto row = editor->property("currentBlockIndex").toInt();
+    return row < 0 ? -1 : row + model->property("windowStart").toInt();
+}
+
+QString blockContent(QObject* model, int row) {
+    QString content;
+    QMetaObject::invokeMethod(model, "blockContent", Q_RETURN_ARG(QString, content), Q_ARG(int, row));
+    return content;
+}
+
+void focusSearchResult(QObject* editor, int pageIndex) {
+    REQUIRE(QMetaObject::invokeMethod(editor, "focusSearchResult",
+                                      Q_ARG(QVariant, QVariant(QString())),
+                                      Q_ARG(QVariant, QVariant(pageIndex))));
+}
+
+} // namespace
+
+TEST_CASE("QML: BlockEditor jumps to search results outside the block window",
+          "[qml][blockeditor][search]") {
+    registerTypesOnce();
+
+    QQmlEngine engine;
+    QQmlComponent component(&engine);
+    component.setData(
+        "import QtQuick\n"
+        "import QtQuick.Controls\n"
+        "import zinc\n"
+        "ApplicationWindow {\n"
+        "    width: 800\n"
+        "    height: 600\n"
+        "    visible: true\n"
+        "    property string markdown: \"\"\n"
+        "    BlockEditor {\n"
+        "        id: editor\n"
+        "        objectName: \"blockEditor\"\n"
+        "        anchors.fill: parent\n"
+        "    }\n"
+        "    Component.onCompleted: editor.blocksModel.loadFromMarkdown(markdown)\n"
+        "}\n",
+        QUrl(QStringLiteral("qrc:/qt/qml/zinc/tests/BlockEditorWindowedSearchHost.qml")));
+
+    if (component.status() == QQmlComponent::Error) {
+        FAIL(formatErrors(component.errors()).toStdString());
+    }
+    REQUIRE(component.status() == QQmlComponent::Ready);
+
+    std::unique_ptr<QObject> root(
+        component.createWithInitialProperties({{QStringLiteral("markdown"), numberedPage(10000)}}));
+    REQUIRE(root);
+    auto* window = qobject_cast<QQuickWindow*>(root.get());
+    REQUIRE(window);
+    window->show();
+    QTest::qWait(150);
+
+    auto* editor = root->findChild<QObject*>(QStringLiteral("blockEditor"));
+    REQUIRE(editor);
+    auto* model = root->findChild<QObject*>(QStringLiteral("blockModel"));
+    REQUIRE(model);
+    REQUIRE(model->property("windowed").toBool());
+    REQUIRE(model->property("windowStart").toInt() == 0);
+
+    // Beyond the first window: the window moves to the hit and the right block gets focus.
+    focusSearchResult(editor, 7000);
+    REQUIRE(QTest::qWaitFor([&] { return focusedPageIndex(editor, model) == 7000; }, 2000));
+    const auto windowStart = model->property("windowStart").toInt();
+    REQUIRE(windowStart > 0);
+    REQUIRE(blockContent(model, 7000 - windowStart) == QStringLiteral("Paragraph 7000"));
+    REQUIRE(editor->property("searchHighlightBlockIndex").toInt() == 7000);
+
+    // Inside the moved window, page-wide indices still resolve past windowStart.
+    focusSearchResult(editor, 7100);
+    REQUIRE(QTest::qWaitFor([&] { return focusedPageIndex(editor, model) == 7100; }, 2000));
+    REQUIRE(model->property("windowStart").toInt() == windowStart);
+    REQUIRE(blockContent(model, editor->property("currentBlockIndex").toInt()) == QStringLiteral("Paragraph 7100"));
+
+    // Ctrl+End and Ctrl+Home reach the ends of the page, not of the window.
+    QTest::keyClick(window, Qt::Key_End, Qt::ControlModifier);
+    REQUIRE(QTest::qWaitFor([&] { return focusedPageIndex(editor, model) == 9999; }, 2000));
+    QTest::keyClick(window, Qt::Key_Home, Qt::ControlModifier);
+    REQUIRE(QTest::qWaitFor([&] { return focusedPageIndex(editor, model) == 0; }, 2000));
+    REQUIRE(model->property("windowStart").toInt() == 0);
+}
@@ -1,5 +1,7 @@
 #include <catch2/catch_test_macros.hpp>
 
+#include <QSignalSpy>
+#include <QStringList>
 #include <QVariantList>
 #include <QVariantMap>
 
@@ -28,6 +30,14 @@ QVariantMap block(const QString& id,
     return b;
 }
 
+QString numbered_page(int blocks, int editedIndex = -1) {
+    QStringList parts;
+    for (int i = 0; i < blocks; ++i) {
+        parts << QStringLiteral("Paragraph %1%2").arg(i).arg(i == editedIndex ? QStringLiteral(" (edited)") : QString());
+    }
+    return parts.join(QStringLiteral("\n\n")) + QStringLiteral("\n");
+}
+
 } // namespace
 
 TEST_CASE("BlockModel: supports ListModel-like mutation APIs", "[qml][model]") {
@@ -98,3 +108,162 @@ TEST_CASE("BlockModel: markdown load/save matches MarkdownBlocks", "[qml][model]
         REQUIRE(!got.value("blockId").toString().isEmpty());
     }
 }
+
+TEST_CASE("BlockModel: mergeFromMarkdown touches only the edited block", "[qml][model][markdown]") {
+    zinc::ui::BlockModel model;
+    REQUIRE(model.loadFromMarkdown(numbered_page(1000)));
+    REQUIRE(model.count() == 1000);
+    const auto idBefore = model.blockId(500);
+    const auto lastIdBefore = model.blockId(999);
+
+    QSignalSpy reset(&model, &QAbstractItemModel::modelReset);
+    QSignalSpy inserted(&model, &QAbstractItemModel::rowsInserted);
+    QSignalSpy removed(&model, &QAbstractItemModel::rowsRemoved);
+    QSignalSpy moved(&model, &QAbstractItemModel::rowsMoved);
+    QSignalSpy changed(&model, &QAbstractItemModel::dataChanged);
+
+    REQUIRE(model.mergeFromMarkdown(numbered_page(1000, 500)));
+    REQUIRE(reset.isEmpty());
+    REQUIRE(inserted.isEmpty());
+    REQUIRE(removed.isEmpty());
+    REQUIRE(moved.isEmpty());
+    REQUIRE(changed.size() == 1);
+    REQUIRE(changed.first().at(0).value<QModelIndex>().row() == 500);
+    REQUIRE(model.blockContent(500) == QStringLiteral("Paragraph 500 (edited)"));
+    REQUIRE(model.blockId(500) == idBefore);
+    REQUIRE(model.blockId(999) == lastIdBefore);
+}
+
+TEST_CASE("BlockModel: mergeFromMarkdown inserts, removes and moves rows in place", "[qml][model][markdown]") {
+    zinc::ui::BlockModel model;
+    REQUIRE(model.loadFromMarkdown(QStringLiteral("# Title\n\nA\n\nB\n\nC\n\n- [ ] task\n")));
+    const auto titleId = model.blockId(0);
+    const auto aId = model.blockId(1);
+    const auto cId = model.blockId(3);
+    const auto taskId = model.blockId(4);
+
+    QSignalSpy reset(&model, &QAbstractItemModel::modelReset);
+    QSignalSpy moved(&model, &QAbstractItemModel::rowsMoved);
+
+    // Task moved to the top, A edited, B dropped, D added after C.
+    const auto markdown = QStringLiteral("- [ ] task\n\n# Title\n\nA edited\n\nC\n\nD\n");
+    REQUIRE(model.mergeFromMarkdown(markdown));
+    REQUIRE(reset.isEmpty());
+    REQUIRE(moved.size() == 1);
+
+    zinc::ui::BlockModel reference;
+    REQUIRE(reference.loadFromMarkdown(markdown));
+    REQUIRE(model.count() == reference.count());
+    for (int i = 0; i < reference.count(); ++i) {
+        auto got = model.get(i);
+        auto want = reference.get(i);
+        got.remove(QStringLiteral("blockId"));
+        want.remove(QStringLiteral("blockId"));
+        REQUIRE(got == want);
+    }
+    REQUIRE(model.blockId(1) == titleId);
+    REQUIRE(model.blockId(2) == aId);
+    REQUIRE(model.blockId(3) == cId);
+    REQUIRE(model.blockId(0) == taskId);
+    REQUIRE(model.serializeContentToMarkdown() == reference.serializeContentToMarkdown());
+}
+
+TEST_CASE("BlockModel: large pages materialize only a window of rows", "[qml][model][markdown]") {
+    zinc::ui::BlockModel model;
+    REQUIRE(model.loadFromMarkdown(numbered_page(10000)));
+    REQUIRE(model.windowed());
+    REQUIRE(model.count() == model.windowSize());
+    REQUIRE(model.totalCount() == 10000);
+    REQUIRE(model.serializeContentToMarkdown() == numbered_page(10000));
+
+    model.setProperty(10, QStringLiteral("content"), QStringLiteral("Paragraph 10 (edited)"));
+    REQUIRE(model.serializeContentToMarkdown() == numbered_page(10000, 10));
+
+    QSignalSpy reset(&model, &QAbstractItemModel::modelReset);
+    model.setWindowStart(5000);
+    REQUIRE(model.windowStart() == 5000);
+    REQUIRE(model.count() == model.windowSize());
+    REQUIRE(model.blockContent(0) == QStringLiteral("Paragraph 5000"));
+    REQUIRE(model.serializeContentToMarkdown() == numbered_page(10000, 10));
+
+    // Sliding part way keeps the overlapping rows and their ids.
+    const auto keptId = model.blockId(200);
+    model.setWindowStart(5100);
+    REQUIRE(model.blockId(100) == keptId);
+    REQUIRE(model.pageIndexForBlockId(keptId) == 5200);
+    REQUIRE(reset.size() == 1);
+
+    model.remove(0, 1);
+    REQUIRE(model.totalCount() == 9999);
+    model.setWindowStart(0);
+    REQUIRE(model.blockContent(10) == QStringLiteral("Paragraph 10 (edited)"));
+    QStringList expected = numbered_page(10000, 10).split(QStringLiteral("\n\n"));
+    expected.removeAt(5100);
+    REQUIRE(model.serializeContentToMarkdown() == expected.join(QStringLiteral("\n\n")));
+
+    // Remote updates only diff the rows in the window.
+    QSignalSpy changed(&model, &QAbstractItemModel::dataChanged);
+    REQUIRE(model.mergeFromMarkdown(numbered_page(10000, 20)));
+    REQUIRE(model.windowStart() == 0);
+    REQUIRE(model.totalCount() == 10000);
+    REQUIRE(model.blockContent(20) == QStringLiteral("Paragraph 20 (edited)"));
+    REQUIRE(model.blockContent(10) == QStringLiteral("Paragraph 10"));
+    REQUIRE(changed.size() == 2);
+}
+
+TEST_CASE("BlockModel: undo history stays within its memory budget", "[qml][model][undo]") {
+    zinc::ui::BlockModel model;
+    constexpr qint64 budget = 1 << 20;
+    model.setUndoMemoryBudget(budget);
+    REQUIRE(model.loadFromMarkdown(numbered_page(50)));
+
+    // An hour of typing at five keystrokes a second, one typing macro per second as
+    // BlockEditor groups them, with a new paragraph each minute and a 128 KB paste every
+    // two minutes.
+    const auto paste = QString(64 * 1024, QChar(u'p'));
+    qint64 peak = 0;
+    int row = 0;
+    QString beforeLastStep;
+    for (int second = 0; second < 3600; ++second) {
+        beforeLastStep = model.blockContent(row);
+        model.beginUndoMacro(QStringLiteral("Typing"));
+        for (int key = 0; key < 5; ++key) {
+            auto text = model.blockContent(row);
+            if (key == 4 && second % 3 == 0) {
+                text.chop(1);
+            } else if (second % 120 == 119 && key == 0) {
+                text.insert(text.size() / 2, paste);
+            } else {
+                text.append(QChar(u'a' + key));
+            }
+            model.setProperty(row, QStringLiteral("content"), text);
+        }
+        model.endUndoMacro();
+        if (second % 60 == 59 && second != 3599) {
+            ++row;
+            model.insert(row, block(QStringLiteral("typed-%1").arg(row), QStringLiteral("paragraph"), QString()));
+        }
+        peak = std::max(peak, model.undoMemoryBytes());
+    }
+    REQUIRE(peak <= budget);
+    REQUIRE(model.undoMemoryBytes() > 0);
+
+    // Recent steps still undo exactly; the oldest ones were released to stay in budget.
+    REQUIRE(model.canUndo());
+    const auto afterLastStep = model.blockContent(row);
+    model.undo();
+    REQUIRE(model.blockContent(row) == beforeLastStep);
+    model.redo();
+    REQUIRE(model.blockContent(row) == afterLastStep);
+
+    int undoable = 0;
+    while (model.canUndo()) {
+        model.undo();
+        ++undoable;
+    }
+    REQUIRE(undoable > 0);
+    REQUIRE(model.undoIndex() > 0);
+
+    model.clearUndoStack();
+    REQUIRE(model.undoMemoryBytes() == 0);
+}
@@ -1,5 +1,8 @@
 #include <catch2/catch_test_macros.hpp>
 
+#include <QMutex>
+#include <QMutexLocker>
+
 #include "ui/Cmark.hpp"
 
 TEST_CASE("Cmark: renders markdown to HTML", "[qml][cmark]") {
@@ -31,3 +34,80 @@ TEST_CASE("Cmark: strips unsafe script tags", "[qml][cmark]") {
     REQUIRE(html.contains(QStringLiteral("X")));
     REQUIRE(html.contains(QStringLiteral("Y")));
 }
+
+TEST_CASE("Cmark: caches rendered HTML by markdown", "[qml][cmark]") {
+    zinc::ui::Cmark cmark;
+    const auto first = cmark.toHtml(QStringLiteral("**bold** 2026-01-16"));
+    REQUIRE(cmark.cacheMisses() == 1);
+    REQUIRE(cmark.cacheHits() == 0);
+    REQUIRE(cmark.cacheBytes() > 0);
+
+    REQUIRE(cmark.toHtml(QStringLiteral("**bold** 2026-01-16")) == first);
+    REQUIRE(cmark.cacheHits() == 1);
+
+    REQUIRE(cmark.toHtml(QStringLiteral("*other*")).contains(QStringLiteral("<em>other</em>")));
+    REQUIRE(cmark.cacheMisses() == 2);
+
+    cmark.setCacheCapacity(0);
+    REQUIRE(cmark.cacheBytes() == 0);
+    REQUIRE(cmark.toHtml(QStringLiteral("**bold** 2026-01-16")) == first);
+    REQUIRE(cmark.cacheMisses() == 3);
+
+    cmark.clearCache();
+    REQUIRE(cmark.cacheHits() == 0);
+    REQUIRE(cmark.cacheMisses() == 0);
+}
+
+TEST_CASE("Cmark: links dates and times on word boundaries", "[qml][cmark]") {
+    zinc::ui::Cmark cmark;
+    const auto html = cmark.toHtml(QStringLiteral("At 2026-01-16 09:30:15, 2026-01-17T08:00 and x2026-01-18."));
+    REQUIRE(html.contains(QStringLiteral(
+        "<a href=\"zinc://date/2026-01-16T09:30:15\" style=\"color:#888888;text-decoration:none;\">2026-01-16 09:30:15</a>")));
+    REQUIRE(html.contains(QStringLiteral(
+        "<a href=\"zinc://date/2026-01-17T08:00\" style=\"color:#888888;text-decoration:none;\">2026-01-17 08:00</a>")));
+    REQUIRE(!html.contains(QStringLiteral("zinc://date/2026-01-18")));
+}
+
+TEST_CASE("Cmark: rebuilds allowed tags from safe attributes", "[qml][cmark]") {
+    zinc::ui::Cmark cmark;
+    const auto html = cmark.toHtml(QStringLiteral(
+        "<A HREF=\"javascript:alert(1)\" title='a\"b' onclick=x>j</A> "
+        "<a href=\"https://example.com\" href=\"https://zinc.test\">k</a> "
+        "<img src=\"http://tracker/x.png\"> <img src=\"image://attachments/7\" alt=\"p\" onerror=x /> "
+        "<span style=\"background:url(x); font-weight:bold\">w</span> <span style=\"position:fixed\">v</span> "
+        "<iframe src=\"https://example.com\"></iframe><!-- note -->"));
+    REQUIRE(html.contains(QStringLiteral("<a title=\"a&quot;b\">j</a>")));
+    REQUIRE(html.contains(QStringLiteral("<a href=\"https://zinc.test\">k</a>")));
+    REQUIRE(!html.contains(QStringLiteral("tracker")));
+    REQUIRE(html.contains(QStringLiteral("<img src=\"image://attachments/7\" alt=\"p\"/>")));
+    REQUIRE(html.contains(QStringLiteral("<span style=\"font-weight:bold;\">w</span>")));
+    REQUIRE(html.contains(QStringLiteral("<span>v</span>")));
+    REQUIRE(!html.contains(QStringLiteral("iframe")));
+    REQUIRE(!html.contains(QStringLiteral("onclick")));
+    REQUIRE(!html.contains(QStringLiteral("onerror")));
+    REQUIRE(!html.contains(QStringLiteral("note")));
+}
+
+TEST_CASE("Cmark: renderBatch delivers every document once", "[qml][cmark]") {
+    QStringList documents;
+    for (int i = 0; i < 200; ++i) {
+        documents.append(QStringLiteral("# Page %1\n\n**bold** on 2026-01-%2 <script>x</script>").arg(i).arg(i % 28 + 1, 2, 10, QLatin1Char('0')));
+    }
+    documents.append(QString());
+
+    QMutex mutex;
+    QList<QString> rendered(documents.size());
+    QList<int> deliveries(documents.size(), 0);
+    zinc::ui::Cmark::renderBatch(documents, [&](qsizetype index, QStringView html) {
+        QMutexLocker lock(&mutex);
+        rendered[index] = html.toString();
+        ++deliveries[index];
+    }, 4);
+
+    for (qsizetype i = 0; i < documents.size(); ++i) {
+        REQUIRE(deliveries.at(i) == 1);
+        REQUIRE(rendered.at(i) == zinc::ui::Cmark::render(documents.at(i)));
+    }
+    REQUIRE(rendered.at(7).contains(QStringLiteral("<h1>Page 7</h1>")));
+    REQUIRE(rendered.last().isEmpty());
+}
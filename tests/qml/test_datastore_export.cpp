@@ -1,8 +1,11 @@
 #include <catch2/catch_test_macros.hpp>
 
+#include <QDateTime>
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
+#include <QHash>
+#include <QSignalSpy>
 #include <QTemporaryDir>
 #include <QUrl>
 
@@ -58,6 +61,17 @@ QStringList fileNamesOnly(const QStringList& paths) {
     return names;
 }
 
+// Backdates a file so a later rewrite shows up in its mtime without sleeping.
+void backdate(const QString& filePath, const QDateTime& when) {
+    QFile f(filePath);
+    REQUIRE(f.open(QIODevice::ReadWrite));
+    REQUIRE(f.setFileTime(when, QFileDevice::FileModificationTime));
+}
+
+QDateTime modifiedAt(const QString& filePath) {
+    return QFileInfo(filePath).lastModified();
+}
+
 QStringList filterBySuffix(const QStringList& paths, const QString& suffix) {
     QStringList out;
     for (const auto& p : paths) {
@@ -242,3 +256,228 @@ TEST_CASE("DataStore: export rewrites attachment URLs and copies bytes", "[qml][
     REQUIRE_FALSE(exportedMd.contains(QStringLiteral("image://attachments/")));
     REQUIRE(exportedMd.contains(QStringLiteral("attachments/")));
 }
+
+TEST_CASE("DataStore: background export matches the synchronous export", "[qml][datastore][export][attachments]") {
+    zinc::ui::DataStore store;
+    REQUIRE(store.initialize());
+    REQUIRE(store.resetDatabase());
+
+    const auto workId = store.createNotebook(QStringLiteral("Work"));
+    const auto homeId = store.createNotebook(QStringLiteral("Home"));
+    const auto attachmentId = store.saveAttachmentFromDataUrl(QStringLiteral(
+        "data:image/png;base64,"
+        "iVBORw0KGgoAAAANSUhEUgAAAAEAAAABCAQAAAC1HAwCAAAAC0lEQVR42mP8/x8AAwMCAO5WZ4cAAAAASUVORK5CYII="));
+    REQUIRE_FALSE(attachmentId.isEmpty());
+
+    // The same attachment is referenced from both notebooks and from many pages.
+    const auto image = QStringLiteral("![](image://attachments/%1)").arg(attachmentId);
+    for (int i = 0; i < 40; ++i) {
+        const auto notebookId = (i % 2 == 0) ? workId : homeId;
+        store.savePage(makePage(QStringLiteral("page-%1").arg(i), notebookId, QStringLiteral("Note %1").arg(i),
+                                QStringLiteral("# Note %1\n\n- [ ] task\n\n%2\n").arg(i).arg(image)));
+    }
+
+    QTemporaryDir syncDir;
+    QTemporaryDir asyncDir;
+    REQUIRE(syncDir.isValid());
+    REQUIRE(asyncDir.isValid());
+    const QVariantList notebookIds{workId, homeId};
+    REQUIRE(store.exportNotebooks(notebookIds, QUrl::fromLocalFile(syncDir.path()), QStringLiteral("html"), true));
+
+    QSignalSpy progress(&store, &zinc::ui::DataStore::exportProgress);
+    QSignalSpy finished(&store, &zinc::ui::DataStore::exportFinished);
+    REQUIRE(store.startExportNotebooks(notebookIds, QUrl::fromLocalFile(asyncDir.path()), QStringLiteral("html"), true));
+    REQUIRE(store.isExporting());
+    REQUIRE_FALSE(store.startExportNotebooks(notebookIds, QUrl::fromLocalFile(asyncDir.path()), QStringLiteral("html"), true));
+
+    REQUIRE(finished.wait(20000));
+    REQUIRE(finished.first().at(0).toBool());
+    REQUIRE_FALSE(store.isExporting());
+    REQUIRE_FALSE(progress.isEmpty());
+    REQUIRE(progress.last().at(0).toInt() == progress.last().at(1).toInt());
+
+    const auto syncFiles = listFilesRecursively(syncDir.path());
+    const auto asyncFiles = listFilesRecursively(asyncDir.path());
+    REQUIRE(syncFiles.size() == 40 + 2 + 1); // pages + one attachment per notebook + manifest
+    REQUIRE(asyncFiles.size() == syncFiles.size());
+    for (const auto& path : syncFiles) {
+        const auto relative = QDir(syncDir.path()).relativeFilePath(path);
+        const auto other = QDir(asyncDir.path()).filePath(relative);
+        REQUIRE(QFileInfo::exists(other));
+        if (!relative.contains(QStringLiteral("attachments/"))) {
+            REQUIRE(readAllText(other) == readAllText(path));
+        }
+    }
+}
+
+TEST_CASE("DataStore: background export can be cancelled", "[qml][datastore][export]") {
+    zinc::ui::DataStore store;
+    REQUIRE(store.initialize());
+    REQUIRE(store.resetDatabase());
+
+    const auto nbId = store.createNotebook(QStringLiteral("Big"));
+    QVariantList pages;
+    for (int i = 0; i < 2000; ++i) {
+        pages.append(makePage(QStringLiteral("big-%1").arg(i), nbId, QStringLiteral("Page %1").arg(i),
+                              QStringLiteral("# Page %1\n\nSome **text** on 2026-01-16.\n").arg(i)));
+    }
+    store.saveAllPages(pages);
+
+    QTemporaryDir tmp;
+    REQUIRE(tmp.isValid());
+
+    QSignalSpy errors(&store, &zinc::ui::DataStore::error);
+    QSignalSpy finished(&store, &zinc::ui::DataStore::exportFinished);
+    REQUIRE(store.startExportNotebooks(QVariantList{nbId}, QUrl::fromLocalFile(tmp.path()), QStringLiteral("html"), false));
+    store.cancelExport();
+
+    REQUIRE(finished.wait(20000));
+    REQUIRE_FALSE(finished.first().at(0).toBool());
+    REQUIRE(errors.isEmpty());
+    REQUIRE_FALSE(QFileInfo::exists(QDir(tmp.path()).filePath(QStringLiteral("zinc-export.json"))));
+}
+
+TEST_CASE("DataStore: pages can be saved while a large export reads", "[qml][datastore][export]") {
+    zinc::ui::DataStore store;
+    REQUIRE(store.initialize());
+    REQUIRE(store.resetDatabase());
+
+    const auto nbId = store.createNotebook(QStringLiteral("Big"));
+    QVariantList pages;
+    for (int i = 0; i < 5000; ++i) {
+        pages.append(makePage(QStringLiteral("big-%1").arg(i), nbId, QStringLiteral("Page %1").arg(i),
+                              QStringLiteral("# Page %1\n\nSome **text** on 2026-01-16.\n").arg(i)));
+    }
+    store.saveAllPages(pages);
+    const auto editedId = QStringLiteral("edited");
+    store.savePage(makePage(editedId, nbId, QStringLiteral("Edited"), QStringLiteral("before")));
+
+    QTemporaryDir tmp;
+    REQUIRE(tmp.isValid());
+
+    // The export's read transaction must not hold the GUI connection's commits back.
+    QSignalSpy errors(&store, &zinc::ui::DataStore::error);
+    QSignalSpy finished(&store, &zinc::ui::DataStore::exportFinished);
+    REQUIRE(store.startExportNotebooks(QVariantList{nbId}, QUrl::fromLocalFile(tmp.path()), QStringLiteral("html"), false));
+    int saves = 0;
+    while (finished.isEmpty() && store.isExporting()) {
+        store.savePage(makePage(editedId, nbId, QStringLiteral("Edited"), QStringLiteral("save %1").arg(++saves)));
+        finished.wait(5);
+    }
+
+    if (finished.isEmpty()) REQUIRE(finished.wait(20000));
+    REQUIRE(finished.first().at(0).toBool());
+    REQUIRE(errors.isEmpty());
+    REQUIRE(saves >= 1);
+    REQUIRE(store.getPageContentMarkdown(editedId).contains(QStringLiteral("save %1").arg(saves)));
+}
+
+TEST_CASE("DataStore: re-export writes only what changed", "[qml][datastore][export][attachments]") {
+    zinc::ui::DataStore store;
+    REQUIRE(store.initialize());
+    REQUIRE(store.resetDatabase());
+
+    const auto nbId = store.createNotebook(QStringLiteral("Backup"));
+    const auto attachmentId = store.saveAttachmentFromDataUrl(QStringLiteral(
+        "data:image/png;base64,"
+        "iVBORw0KGgoAAAANSUhEUgAAAAEAAAABCAQAAAC1HAwCAAAAC0lEQVR42mP8/x8AAwMCAO5WZ4cAAAAASUVORK5CYII="));
+    REQUIRE_FALSE(attachmentId.isEmpty());
+
+    store.savePage(makePage(QStringLiteral("keep"), nbId, QStringLiteral("Keep"),
+                            QStringLiteral("# Keep\n\n![](image://attachments/%1)\n").arg(attachmentId)));
+    store.savePage(makePage(QStringLiteral("edit"), nbId, QStringLiteral("Edit"), QStringLiteral("before")));
+    store.savePage(makePage(QStringLiteral("drop"), nbId, QStringLiteral("Drop"), QStringLiteral("gone soon")));
+
+    QTemporaryDir tmp;
+    REQUIRE(tmp.isValid());
+    const auto root = QUrl::fromLocalFile(tmp.path());
+    REQUIRE(store.exportNotebooks(QVariantList{nbId}, root, QStringLiteral("html"), true));
+
+    const QDir dir(tmp.path());
+    const auto keepPath = dir.filePath(QStringLiteral("Backup/Keep.html"));
+    const auto editPath = dir.filePath(QStringLiteral("Backup/Edit.html"));
+    const auto dropPath = dir.filePath(QStringLiteral("Backup/Drop.html"));
+    const auto manifestPath = dir.filePath(QStringLiteral("zinc-export.json"));
+    const auto files = listFilesRecursively(tmp.path());
+    REQUIRE(files.size() == 5); // three pages + attachment + manifest
+    QHash<QString, QDateTime> written;
+    for (const auto& path : files) {
+        written.insert(path, modifiedAt(path));
+    }
+
+    // Nothing changed: nothing is written, the manifest included.
+    REQUIRE(store.exportNotebooks(QVariantList{nbId}, root, QStringLiteral("html"), true));
+    for (const auto& path : files) {
+        REQUIRE(modifiedAt(path) == written.value(path));
+    }
+
+    const auto manifestBefore = readAllText(manifestPath);
+    store.savePage(makePage(QStringLiteral("edit"), nbId, QStringLiteral("Edit"), QStringLiteral("after")));
+    store.deletePage(QStringLiteral("drop"));
+    REQUIRE(store.exportNotebooks(QVariantList{nbId}, root, QStringLiteral("html"), true));
+
+    REQUIRE(listFilesRecursively(tmp.path()).size() == 4);
+    REQUIRE_FALSE(QFileInfo::exists(dropPath));
+    REQUIRE(readAllText(editPath).contains(QStringLiteral("after")));
+    REQUIRE(readAllText(manifestPath) != manifestBefore);
+    REQUIRE(modifiedAt(keepPath) == written.value(keepPath));
+    for (const auto& path : filterBySuffix(files, QStringLiteral(".png"))) {
+        REQUIRE(modifiedAt(path) == written.value(path));
+    }
+
+    // A file changed or removed behind the export's back is written again, even at the same size.
+    const auto keptText = readAllText(keepPath);
+    {
+        QFile f(keepPath);
+        REQUIRE(f.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        f.write(QByteArray(keptText.toUtf8().size(), 'x'));
+    }
+    backdate(keepPath, QDateTime::fromSecsSinceEpoch(QDateTime::currentSecsSinceEpoch() - 86400));
+    REQUIRE(store.exportNotebooks(QVariantList{nbId}, root, QStringLiteral("html"), true));
+    REQUIRE(readAllText(keepPath) == keptText);
+    REQUIRE(QFile::remove(keepPath));
+    REQUIRE(store.exportNotebooks(QVariantList{nbId}, root, QStringLiteral("html"), true));
+    REQUIRE(readAllText(keepPath).contains(QStringLiteral("Keep")));
+
+    // Switching format replaces the pages and drops the attachments folder.
+    REQUIRE(store.exportNotebooks(QVariantList{nbId}, root, QStringLiteral("markdown"), false));
+    const auto markdownFiles = listFilesRecursively(tmp.path());
+    REQUIRE(markdownFiles.size() == 3); // two pages + manifest
+    REQUIRE(filterBySuffix(markdownFiles, QStringLiteral(".md")).size() == 2);
+    REQUIRE_FALSE(QFileInfo::exists(dir.filePath(QStringLiteral("Backup/attachments"))));
+}
+
+TEST_CASE("DataStore: re-exporting some notebooks keeps the others' files", "[qml][datastore][export]") {
+    zinc::ui::DataStore store;
+    REQUIRE(store.initialize());
+    REQUIRE(store.resetDatabase());
+
+    const auto aId = store.createNotebook(QStringLiteral("A"));
+    const auto bId = store.createNotebook(QStringLiteral("B"));
+    store.savePage(makePage(QStringLiteral("pA"), aId, QStringLiteral("NoteA"), QStringLiteral("A")));
+    store.savePage(makePage(QStringLiteral("pA2"), aId, QStringLiteral("GoneA"), QStringLiteral("A2")));
+    store.savePage(makePage(QStringLiteral("pB"), bId, QStringLiteral("NoteB"), QStringLiteral("B")));
+
+    QTemporaryDir tmp;
+    REQUIRE(tmp.isValid());
+    const auto root = QUrl::fromLocalFile(tmp.path());
+    const QDir dir(tmp.path());
+    REQUIRE(store.exportNotebooks(QVariantList{aId, bId}, root, QStringLiteral("markdown"), false));
+    REQUIRE(listFilesRecursively(tmp.path()).size() == 4); // three pages + manifest
+
+    // Only A is exported again: its deleted page goes, B's folder and manifest entries stay.
+    store.deletePage(QStringLiteral("pA2"));
+    REQUIRE(store.exportNotebooks(QVariantList{aId}, root, QStringLiteral("markdown"), false));
+    REQUIRE(listFilesRecursively(tmp.path()).size() == 3);
+    REQUIRE_FALSE(QFileInfo::exists(dir.filePath(QStringLiteral("A/GoneA.md"))));
+    REQUIRE(readAllText(dir.filePath(QStringLiteral("A/NoteA.md"))).contains(QStringLiteral("A")));
+    REQUIRE(readAllText(dir.filePath(QStringLiteral("B/NoteB.md"))).contains(QStringLiteral("B")));
+    const auto manifest = readAllText(dir.filePath(QStringLiteral("zinc-export.json")));
+    REQUIRE(manifest.contains(QStringLiteral("B/NoteB.md")));
+    REQUIRE(manifest.contains(bId));
+
+    // A restore of the folder still brings back both notebooks.
+    REQUIRE(store.importNotebooks(root, QStringLiteral("auto"), true));
+    REQUIRE(store.getPageContentMarkdown(QStringLiteral("pA")).contains(QStringLiteral("A")));
+    REQUIRE(store.getPageContentMarkdown(QStringLiteral("pB")).contains(QStringLiteral("B")));
+}
@@ -3,6 +3,8 @@
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
+#include <QSet>
+#include <QSignalSpy>
 #include <QTemporaryDir>
 #include <QUrl>
 
@@ -104,6 +106,35 @@ TEST_CASE("DataStore: import notebooks from markdown export (backup/restore)", "
     REQUIRE(found);
 }
 
+TEST_CASE("DataStore: restore reads only the pages that changed since the export", "[qml][datastore][import]") {
+    zinc::ui::DataStore store;
+    REQUIRE(store.initialize());
+    REQUIRE(store.resetDatabase());
+
+    const auto nbId = store.createNotebook(QStringLiteral("Journal"));
+    const auto keptId = QStringLiteral("00000000-0000-0000-0000-0000000000c1");
+    const auto editedId = QStringLiteral("00000000-0000-0000-0000-0000000000c2");
+    store.savePage(makePage(keptId, nbId, QStringLiteral("Kept"), QStringLiteral("kept as exported")));
+    store.savePage(makePage(editedId, nbId, QStringLiteral("Edited"), QStringLiteral("as exported")));
+
+    QTemporaryDir tmp;
+    REQUIRE(tmp.isValid());
+    const auto exportRoot = QUrl::fromLocalFile(tmp.path());
+    REQUIRE(store.exportNotebooks(QVariantList{nbId}, exportRoot, QStringLiteral("markdown"), false));
+
+    // The unchanged page is taken from the database, so its file is not read; the edited one
+    // is restored from its file.
+    QFile keptFile(QDir(tmp.path()).filePath(QStringLiteral("Journal/Kept.md")));
+    REQUIRE(keptFile.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    keptFile.close();
+    store.savePage(makePage(editedId, nbId, QStringLiteral("Edited"), QStringLiteral("edited later")));
+
+    REQUIRE(store.importNotebooks(exportRoot, QStringLiteral("auto"), true));
+    REQUIRE(store.getPageContentMarkdown(keptId).contains(QStringLiteral("kept as exported")));
+    REQUIRE(store.getPageContentMarkdown(editedId).contains(QStringLiteral("as exported")));
+    REQUIRE_FALSE(store.getPageContentMarkdown(editedId).contains(QStringLiteral("edited later")));
+}
+
 TEST_CASE("DataStore: importing without replaceExisting duplicates notebooks", "[qml][datastore][import]") {
     zinc::ui::DataStore store;
     REQUIRE(store.initialize());
@@ -175,3 +206,199 @@ TEST_CASE("DataStore: importing a manifest export without replaceExisting duplic
     const auto importedMd = store.getPageContentMarkdown(pageId);
     REQUIRE(importedMd.contains(QStringLiteral("image://attachments/")));
 }
+
+TEST_CASE("DataStore: archive export round-trips through a single file", "[qml][datastore][import][archive]") {
+    zinc::ui::DataStore store;
+    REQUIRE(store.initialize());
+    REQUIRE(store.resetDatabase());
+
+    const auto nbId = store.createNotebook(QStringLiteral("Packed"));
+    const auto attachmentId = store.saveAttachmentFromDataUrl(QStringLiteral(
+        "data:image/png;base64,"
+        "iVBORw0KGgoAAAANSUhEUgAAAAEAAAABCAQAAAC1HAwCAAAAC0lEQVR42mP8/x8AAwMCAO5WZ4cAAAAASUVORK5CYII="));
+    REQUIRE_FALSE(attachmentId.isEmpty());
+
+    const auto imageId = QStringLiteral("00000000-0000-0000-0000-0000000000d1");
+    const auto linkId = QStringLiteral("00000000-0000-0000-0000-0000000000d2");
+    store.savePage(makePage(imageId, nbId, QStringLiteral("Image"),
+                            QStringLiteral("![](image://attachments/%1)").arg(attachmentId)));
+    store.savePage(makePage(linkId, nbId, QStringLiteral("Link"),
+                            QStringLiteral("[image page](zinc://page/%1) and \u00fcn\u00efcode").arg(imageId)));
+
+    QTemporaryDir tmp;
+    REQUIRE(tmp.isValid());
+    REQUIRE(store.exportNotebooks(QVariantList{nbId}, QUrl::fromLocalFile(tmp.path()), QStringLiteral("archive"), true));
+    const auto entries = QDir(tmp.path()).entryList(QDir::AllEntries | QDir::NoDotAndDotDot);
+    REQUIRE(entries == QStringList{QStringLiteral("zinc-export.zincpack")});
+    const auto archivePath = QDir(tmp.path()).filePath(QStringLiteral("zinc-export.zincpack"));
+
+    // Restore from the folder.
+    REQUIRE(store.resetDatabase());
+    REQUIRE(store.importNotebooks(QUrl::fromLocalFile(tmp.path()), QStringLiteral("auto"), true));
+    REQUIRE(hasAnyNotebookNamed(store, QStringLiteral("Packed")));
+    REQUIRE(store.getPageContentMarkdown(imageId).contains(QStringLiteral("image://attachments/%1").arg(attachmentId)));
+    REQUIRE(store.getPageContentMarkdown(linkId).contains(QStringLiteral("zinc://page/%1").arg(imageId)));
+    REQUIRE(store.getPageContentMarkdown(linkId).contains(QStringLiteral("\u00fcn\u00efcode")));
+    bool found = false;
+    for (const auto& v : store.getAttachmentsForSync()) {
+        const auto a = v.toMap();
+        if (a.value(QStringLiteral("attachmentId")).toString() == attachmentId) {
+            found = !a.value(QStringLiteral("dataBase64")).toString().isEmpty();
+        }
+    }
+    REQUIRE(found);
+
+    // Duplicate from the archive file itself: new ids, links follow them.
+    REQUIRE(store.importNotebooks(QUrl::fromLocalFile(archivePath), QStringLiteral("auto"), false));
+    const auto copyId = notebookIdForName(store, QStringLiteral("Packed (2)"));
+    REQUIRE_FALSE(copyId.isEmpty());
+    const auto copies = store.getPagesForNotebook(copyId);
+    REQUIRE(copies.size() == 2);
+    for (const auto& v : copies) {
+        const auto pageId = v.toMap().value(QStringLiteral("pageId")).toString();
+        REQUIRE(pageId != imageId);
+        REQUIRE(pageId != linkId);
+        REQUIRE_FALSE(store.getPageContentMarkdown(pageId).contains(imageId));
+    }
+
+    // A truncated archive is rejected.
+    {
+        QFile f(archivePath);
+        REQUIRE(f.open(QIODevice::ReadWrite));
+        REQUIRE(f.resize(f.size() - 4));
+    }
+    REQUIRE_FALSE(store.importNotebooks(QUrl::fromLocalFile(archivePath), QStringLiteral("archive"), false));
+}
+
+TEST_CASE("DataStore: background import writes pages in batches", "[qml][datastore][import]") {
+    zinc::ui::DataStore store;
+    REQUIRE(store.initialize());
+    REQUIRE(store.resetDatabase());
+
+    // More pages than one import batch, each linking to the next.
+    const auto nbId = store.createNotebook(QStringLiteral("Bulk"));
+    const auto idFor = [](int i) { return QStringLiteral("00000000-0000-0000-0000-%1").arg(i, 12, 10, QLatin1Char('0')); };
+    constexpr int kPages = 1300;
+    QVariantList pages;
+    for (int i = 0; i < kPages; ++i) {
+        auto page = makePage(idFor(i), nbId, QStringLiteral("Page %1").arg(i),
+                             QStringLiteral("# Page %1\n\n[next](zinc://page/%2)\n").arg(i).arg(idFor((i + 1) % kPages)));
+        page.insert(QStringLiteral("sortOrder"), i);
+        pages.append(page);
+    }
+    store.saveAllPages(pages);
+
+    QTemporaryDir tmp;
+    REQUIRE(tmp.isValid());
+    const auto exportRoot = QUrl::fromLocalFile(tmp.path());
+    REQUIRE(store.exportNotebooks(QVariantList{nbId}, exportRoot, QStringLiteral("markdown"), false));
+
+    QSignalSpy progress(&store, &zinc::ui::DataStore::importProgress);
+    QSignalSpy finished(&store, &zinc::ui::DataStore::importFinished);
+    REQUIRE(store.startImportNotebooks(exportRoot, QStringLiteral("auto"), false));
+    REQUIRE(store.isImporting());
+    REQUIRE_FALSE(store.startImportNotebooks(exportRoot, QStringLiteral("auto"), false));
+
+    REQUIRE(finished.wait(20000));
+    REQUIRE(finished.first().at(0).toBool());
+    REQUIRE_FALSE(store.isImporting());
+    REQUIRE(progress.size() >= 2);
+    REQUIRE(progress.last().at(0).toInt() == kPages);
+    REQUIRE(progress.last().at(1).toInt() == kPages);
+
+    // The copy's links point at the copied pages.
+    const auto copyId = notebookIdForName(store, QStringLiteral("Bulk (2)"));
+    REQUIRE_FALSE(copyId.isEmpty());
+    const auto copies = store.getPagesForNotebook(copyId);
+    REQUIRE(copies.size() == kPages);
+    QSet<QString> copyIds;
+    for (const auto& v : copies) {
+        copyIds.insert(v.toMap().value(QStringLiteral("pageId")).toString());
+    }
+    for (const auto& pageId : copyIds) {
+        const auto md = store.getPageContentMarkdown(pageId);
+        const auto at = md.indexOf(QStringLiteral("zinc://page/"));
+        REQUIRE(at >= 0);
+        REQUIRE(copyIds.contains(md.mid(at + 12, 36)));
+    }
+}
+
+TEST_CASE("DataStore: background import can be cancelled", "[qml][datastore][import]") {
+    zinc::ui::DataStore store;
+    REQUIRE(store.initialize());
+    REQUIRE(store.resetDatabase());
+
+    const auto nbId = store.createNotebook(QStringLiteral("Big"));
+    QVariantList pages;
+    for (int i = 0; i < 3000; ++i) {
+        pages.append(makePage(QStringLiteral("big-%1").arg(i), nbId, QStringLiteral("Page %1").arg(i),
+                              QStringLiteral("# Page %1\n\nSome **text**.\n").arg(i)));
+    }
+    store.saveAllPages(pages);
+
+    QTemporaryDir tmp;
+    REQUIRE(tmp.isValid());
+    const auto exportRoot = QUrl::fromLocalFile(tmp.path());
+    REQUIRE(store.exportNotebooks(QVariantList{nbId}, exportRoot, QStringLiteral("markdown"), false));
+
+    QSignalSpy errors(&store, &zinc::ui::DataStore::error);
+    QSignalSpy finished(&store, &zinc::ui::DataStore::importFinished);
+    REQUIRE(store.startImportNotebooks(exportRoot, QStringLiteral("auto"), false));
+    store.cancelImport();
+
+    REQUIRE(finished.wait(20000));
+    REQUIRE_FALSE(finished.first().at(0).toBool());
+    REQUIRE(errors.isEmpty());
+    const auto copyId = notebookIdForName(store, QStringLiteral("Big (2)"));
+    REQUIRE_FALSE(copyId.isEmpty());
+    REQUIRE(store.getPagesForNotebook(copyId).size() < 3000);
+}
+
+TEST_CASE("DataStore: cancelling a restore keeps the original data", "[qml][datastore][import]") {
+    zinc::ui::DataStore store;
+    REQUIRE(store.initialize());
+    REQUIRE(store.resetDatabase());
+
+    const auto nbId = store.createNotebook(QStringLiteral("Big"));
+    QVariantList pages;
+    for (int i = 0; i < 3000; ++i) {
+        pages.append(makePage(QStringLiteral("big-%1").arg(i), nbId, QStringLiteral("Page %1").arg(i),
+                              QStringLiteral("# Page %1\n\nSome **text**.\n").arg(i)));
+    }
+    store.saveAllPages(pages);
+
+    QTemporaryDir tmp;
+    REQUIRE(tmp.isValid());
+    const auto exportRoot = QUrl::fromLocalFile(tmp.path());
+    REQUIRE(store.exportNotebooks(QVariantList{nbId}, exportRoot, QStringLiteral("markdown"), true));
+
+    // Data written after the backup only exists in the database the restore would replace.
+    const auto keptId = store.createNotebook(QStringLiteral("Kept"));
+    const auto keptPageId = QStringLiteral("00000000-0000-0000-0000-0000000000bb");
+    store.savePage(makePage(keptPageId, keptId, QStringLiteral("Kept page"), QStringLiteral("still here")));
+    const auto attachmentId = store.saveAttachmentFromDataUrl(QStringLiteral(
+        "data:image/png;base64,"
+        "iVBORw0KGgoAAAANSUhEUgAAAAEAAAABCAQAAAC1HAwCAAAAC0lEQVR42mP8/x8AAwMCAO5WZ4cAAAAASUVORK5CYII="));
+    REQUIRE_FALSE(attachmentId.isEmpty());
+
+    QSignalSpy finished(&store, &zinc::ui::DataStore::importFinished);
+    REQUIRE(store.startImportNotebooks(exportRoot, QStringLiteral("auto"), true));
+    store.cancelImport();
+
+    REQUIRE(finished.wait(20000));
+    REQUIRE_FALSE(finished.first().at(0).toBool());
+    REQUIRE(notebookIdForName(store, QStringLiteral("Kept")) == keptId);
+    REQUIRE(hasPageId(store, keptPageId));
+    REQUIRE(store.getPageContentMarkdown(keptPageId).contains(QStringLiteral("still here")));
+    REQUIRE(store.getPagesForNotebook(nbId).size() == 3000);
+
+    bool attachmentFound = false;
+    for (const auto& v : store.getAttachmentsForSync()) {
+        const auto a = v.toMap();
+        if (a.value(QStringLiteral("attachmentId")).toString() == attachmentId) {
+            attachmentFound = !a.value(QStringLiteral("dataBase64")).toString().isEmpty();
+        }
+    }
+    REQUIRE(attachmentFound);
+    REQUIRE_FALSE(QFileInfo::exists(store.databasePath() + QStringLiteral(".restore")));
+}
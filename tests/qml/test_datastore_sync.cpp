@@ -352,6 +352,40 @@ TEST_CASE("DataStore: title-only divergence creates conflict and merge combines
     REQUIRE(store.getPageContentMarkdown(QStringLiteral("p_title_conflict")) == QStringLiteral("Body"));
 }
 
+TEST_CASE("DataStore: conflict merge preview is precomputed with hunks", "[qml][datastore][conflict]") {
+    zinc::ui::DataStore store;
+    REQUIRE(store.initialize());
+    REQUIRE(store.resetDatabase());
+
+    const auto baseTs = QStringLiteral("2026-01-11 00:00:00.000");
+    QVariantList base;
+    base.append(makePage("p_hunks", QStringLiteral("Page"), baseTs, QStringLiteral("a\nb\nc")));
+    store.applyPageUpdates(base);
+
+    store.savePageContentMarkdown(QStringLiteral("p_hunks"), QStringLiteral("a\nb-ours\nc"));
+
+    QSignalSpy ready(&store, &zinc::ui::DataStore::pageConflictMergeReady);
+    QVariantList incoming;
+    incoming.append(makePage("p_hunks", QStringLiteral("Page"), QStringLiteral("2099-01-01 00:00:00.000"),
+                             QStringLiteral("a\nb-theirs\nc")));
+    store.applyPageUpdates(incoming);
+    REQUIRE(store.hasPageConflict(QStringLiteral("p_hunks")));
+
+    REQUIRE((ready.count() > 0 || ready.wait(5000)));
+    REQUIRE(ready.takeFirst().at(0).toString() == QStringLiteral("p_hunks"));
+
+    const auto preview = store.previewMergeForPageConflict(QStringLiteral("p_hunks"));
+    REQUIRE(preview.value(QStringLiteral("kind")).toString() == QStringLiteral("conflict"));
+    REQUIRE_FALSE(preview.value(QStringLiteral("clean")).toBool());
+    const auto hunks = preview.value(QStringLiteral("hunks")).toList();
+    REQUIRE(hunks.size() == 1);
+    const auto hunk = hunks.first().toMap();
+    REQUIRE(hunk.value(QStringLiteral("line")).toInt() == 1);
+    REQUIRE(hunk.value(QStringLiteral("ours")).toString() == QStringLiteral("b-ours"));
+    REQUIRE(hunk.value(QStringLiteral("theirs")).toString() == QStringLiteral("b-theirs"));
+    REQUIRE(preview.value(QStringLiteral("mergedMarkdown")).toString().contains(QStringLiteral("<<<<<<< ours")));
+}
+
 TEST_CASE("DataStore: multi-device title sync delta applies reliably with sync cursors", "[qml][datastore][sync][title]") {
     EnvVarGuard pathGuard("ZINC_DB_PATH");
     QTemporaryDir dir;
@@ -614,6 +648,111 @@ TEST_CASE("DataStore: migration populates contentMarkdown from legacy blocks", "
             QStringLiteral("Hello\n"));
 }
 
+TEST_CASE("DataStore: UUID page ids round-trip through BLOB keys", "[qml][datastore]") {
+    zinc::ui::DataStore store;
+    REQUIRE(store.initialize());
+    REQUIRE(store.resetDatabase());
+
+    const auto parentId = QStringLiteral("0f8fad5b-d9cb-469f-a165-70867728950e");
+    const auto childId = QStringLiteral("7c9e6679-7425-40de-944b-e07fc1f90ae7");
+    const auto upperId = QStringLiteral("7C9E6679-7425-40DE-944B-E07FC1F90AE8");
+
+    QVariantList pages;
+    pages.append(makePage(parentId, QStringLiteral("Parent")));
+    auto child = makePage(childId, QStringLiteral("Child"));
+    child.insert("parentId", parentId);
+    child.insert("depth", 1);
+    pages.append(child);
+    pages.append(makePage(upperId, QStringLiteral("Upper")));
+    pages.append(makePage(QStringLiteral("p1"), QStringLiteral("Plain")));
+    store.saveAllPages(pages);
+
+    REQUIRE(titleForPage(store, parentId) == QStringLiteral("Parent"));
+    REQUIRE(titleForPage(store, upperId) == QStringLiteral("Upper"));
+    REQUIRE(titleForPage(store, QStringLiteral("p1")) == QStringLiteral("Plain"));
+    REQUIRE(store.getPage(childId).value("parentId").toString() == parentId);
+
+    store.savePageContentMarkdown(childId, QStringLiteral("Body\n"));
+    REQUIRE(store.getPageContentMarkdown(childId) == QStringLiteral("Body\n"));
+
+    const auto updatedAt = updatedAtForPage(store, parentId);
+    const auto since = store.getPagesForSyncSince(updatedAt, parentId);
+    for (const auto& entry : since) {
+        REQUIRE(entry.toMap().value("pageId").toString() != parentId);
+    }
+
+    QVariantList deleted;
+    QVariantMap tombstone;
+    tombstone.insert("pageId", parentId);
+    tombstone.insert("deletedAt", QStringLiteral("2999-01-01 00:00:00.000"));
+    deleted.append(tombstone);
+    store.applyDeletedPageUpdates(deleted);
+    REQUIRE(titleForPage(store, childId).isEmpty());
+    REQUIRE(deletedPagePresent(store, parentId));
+    REQUIRE(deletedPagePresent(store, childId));
+}
+
+TEST_CASE("DataStore: migration 13 re-keys TEXT UUID ids as BLOBs", "[qml][datastore]") {
+    EnvVarGuard pathGuard("ZINC_DB_PATH");
+    QTemporaryDir dir;
+    REQUIRE(dir.isValid());
+    const auto dbPath = dir.filePath(QStringLiteral("zinc_blob_ids.db"));
+    const auto pageId = QStringLiteral("0f8fad5b-d9cb-469f-a165-70867728950e");
+    qputenv("ZINC_DB_PATH", dbPath.toUtf8());
+
+    {
+        zinc::ui::DataStore store;
+        REQUIRE(store.initialize());
+        store.closeDatabase();
+    }
+
+    {
+        const auto connectionName = QStringLiteral("zinc_blob_ids_seed");
+        {
+            QSqlDatabase db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), connectionName);
+            db.setDatabaseName(dbPath);
+            REQUIRE(db.open());
+
+            // Pre-13 layout: TEXT ids.
+            QSqlQuery q(db);
+            REQUIRE(q.exec(QStringLiteral("DROP TABLE pages")));
+            REQUIRE(q.exec(QStringLiteral(
+                "CREATE TABLE pages ("
+                "id TEXT PRIMARY KEY,"
+                "notebook_id TEXT NOT NULL DEFAULT '',"
+                "title TEXT NOT NULL DEFAULT 'Untitled',"
+                "parent_id TEXT,"
+                "content_markdown TEXT NOT NULL DEFAULT '',"
+                "depth INTEGER DEFAULT 0,"
+                "sort_order INTEGER DEFAULT 0,"
+                "last_synced_at TEXT DEFAULT '',"
+                "last_synced_title TEXT DEFAULT '',"
+                "last_synced_content_markdown TEXT NOT NULL DEFAULT '',"
+                "created_at TEXT DEFAULT CURRENT_TIMESTAMP,"
+                "updated_at TEXT DEFAULT CURRENT_TIMESTAMP"
+                ")")));
+            QSqlQuery insert(db);
+            insert.prepare(QStringLiteral(
+                "INSERT INTO pages (id, title, parent_id, content_markdown) VALUES (?, ?, ?, ?)"));
+            insert.addBindValue(pageId);
+            insert.addBindValue(QStringLiteral("Legacy UUID"));
+            insert.addBindValue(QString());
+            insert.addBindValue(QStringLiteral("Kept\n"));
+            REQUIRE(insert.exec());
+            REQUIRE(q.exec(QStringLiteral("PRAGMA user_version = 12")));
+            db.close();
+        }
+        QSqlDatabase::removeDatabase(connectionName);
+    }
+
+    zinc::ui::DataStore store;
+    REQUIRE(store.initialize());
+    REQUIRE(store.schemaVersion() >= 13);
+    REQUIRE(store.getPageContentMarkdown(pageId) == QStringLiteral("Kept\n"));
+    REQUIRE(titleForPage(store, pageId) == QStringLiteral("Legacy UUID"));
+    REQUIRE(store.getPage(pageId).value("parentId").toString().isEmpty());
+}
+
 TEST_CASE("DataStore: deleted pages retention limit is enforced", "[qml][datastore]") {
     QSettings settings;
     settings.remove(QStringLiteral("sync/deleted_pages_retention"));
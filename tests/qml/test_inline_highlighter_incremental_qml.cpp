@@ -0,0 +1,153 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QQmlComponent>
+#include <QQmlEngine>
+#include <QQmlError>
+#include <QQuickTextDocument>
+#include <QQuickWindow>
+#include <QStringList>
+#include <QTest>
+#include <QTextBlock>
+#include <QTextDocument>
+#include <QTextLayout>
+#include <QUrl>
+#include <memory>
+
+#include "ui/InlineRichTextHighlighter.hpp"
+#include "ui/qml_types.hpp"
+
+namespace {
+
+void registerTypesOnce() {
+    static bool registered = false;
+    if (registered) {
+        return;
+    }
+    zinc::ui::registerQmlTypes();
+    registered = true;
+}
+
+QString formatErrors(const QList<QQmlError>& errors) {
+    QStringList lines;
+    lines.reserve(errors.size());
+    for (const auto& error : errors) {
+        lines.append(error.toString());
+    }
+    return lines.join('\n');
+}
+
+QQuickWindow* requireWindow(QObject* root) {
+    auto* window = qobject_cast<QQuickWindow*>(root);
+    REQUIRE(window);
+    return window;
+}
+
+bool hasBoldRange(const QTextBlock& block, int from, int to) {
+    for (const auto& range : block.layout()->formats()) {
+        if (range.start <= from && range.start + range.length >= to &&
+            range.format.fontWeight() == QFont::Bold) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+TEST_CASE("QML: InlineRichTextHighlighter restyles only the edited lines of a 20k-character block",
+          "[qml][inlinerichtext]") {
+    registerTypesOnce();
+
+    QQmlEngine engine;
+    QQmlComponent component(&engine);
+    component.setData(
+        "import QtQuick\n"
+        "import QtQuick.Controls\n"
+        "import zinc\n"
+        "ApplicationWindow {\n"
+        "  width: 800\n"
+        "  height: 600\n"
+        "  visible: true\n"
+        "  ParagraphBlock {\n"
+        "    objectName: \"paragraph\"\n"
+        "    anchors.fill: parent\n"
+        "    editor: null\n"
+        "    blockIndex: 0\n"
+        "  }\n"
+        "}\n",
+        QUrl(QStringLiteral("qrc:/qt/qml/zinc/tests/InlineHighlighterIncrementalHost.qml")));
+
+    if (component.status() == QQmlComponent::Error) {
+        FAIL(formatErrors(component.errors()).toStdString());
+    }
+    REQUIRE(component.status() == QQmlComponent::Ready);
+
+    std::unique_ptr<QObject> root(component.create());
+    REQUIRE(root);
+    auto* window = requireWindow(root.get());
+    window->show();
+
+    // 400 lines of 51 characters, three styled runs per line.
+    QStringList lines;
+    for (int i = 0; i < 400; ++i) {
+        lines.append(QStringLiteral("<b>styled</b> plain <i>words</i> and <u>more</u> text %1")
+                         .arg(i, 18, 10, QLatin1Char('0')));
+    }
+    auto* paragraph = root->findChild<QObject*>(QStringLiteral("paragraph"));
+    REQUIRE(paragraph);
+    paragraph->setProperty("content", lines.join(QLatin1Char('\n')));
+
+    auto* textEdit = paragraph->property("textControl").value<QObject*>();
+    REQUIRE(textEdit);
+    auto* quickDocument = textEdit->property("textDocument").value<QQuickTextDocument*>();
+    REQUIRE(quickDocument);
+    QTextDocument* doc = quickDocument->textDocument();
+    REQUIRE(doc->characterCount() >= 20000);
+    REQUIRE(doc->blockCount() == 400);
+
+    // The initial pass runs in slices; wait for it to reach the last line.
+    for (int i = 0; i < 100 && !hasBoldRange(doc->lastBlock(), 0, 6); ++i) {
+        QTest::qWait(10);
+    }
+    REQUIRE(hasBoldRange(doc->lastBlock(), 0, 6));
+
+    auto* highlighter = textEdit->findChild<zinc::ui::InlineRichTextHighlighter*>();
+    REQUIRE(highlighter);
+    REQUIRE(highlighter->highlightedBlockCount() >= 400);
+
+    // Type inside the bold word of a line in the middle.
+    const int lineStart = doc->findBlockByNumber(200).position();
+    QMetaObject::invokeMethod(textEdit, "forceActiveFocus");
+    textEdit->setProperty("cursorPosition", lineStart + 3);
+    QTest::qWait(20);
+
+    // One keystroke restyles only the edited line: once by QSyntaxHighlighter's own reformat of
+    // the changed text, once for the runs damaged by the edit. None of the other 399 lines.
+    const auto highlightedBefore = highlighter->highlightedBlockCount();
+    QTest::keyClick(window, Qt::Key_X);
+    QTest::qWait(20);
+    const auto highlightedByKeystroke = highlighter->highlightedBlockCount() - highlightedBefore;
+    REQUIRE(highlightedByKeystroke >= 1);
+    REQUIRE(highlightedByKeystroke <= 2);
+
+    constexpr int kKeystrokes = 50;
+    QElapsedTimer timer;
+    qint64 totalNs = 0;
+    for (int i = 0; i < kKeystrokes; ++i) {
+        timer.start();
+        QTest::keyClick(window, Qt::Key_X);
+        QCoreApplication::processEvents();
+        totalNs += timer.nsecsElapsed();
+    }
+    const double perKeystrokeMs = static_cast<double>(totalNs) / kKeystrokes / 1e6;
+    WARN("InlineRichTextHighlighter per-keystroke ms on a 20k-character block: " << perKeystrokeMs);
+
+    // The typed characters took the bold run's formatting, and the rest of the block kept its own.
+    const auto edited = doc->findBlockByNumber(200);
+    REQUIRE(edited.text().mid(3, kKeystrokes + 1) == QString(kKeystrokes + 1, QLatin1Char('x')));
+    REQUIRE(hasBoldRange(edited, 0, 6 + kKeystrokes + 1));
+    REQUIRE(hasBoldRange(doc->findBlockByNumber(0), 0, 6));
+    REQUIRE(hasBoldRange(doc->lastBlock(), 0, 6));
+}
@@ -1,6 +1,9 @@
 #include <catch2/catch_test_macros.hpp>
 
 #include "ui/InlineRichText.hpp"
+#include "ui/InlineRunStore.hpp"
+
+#include <vector>
 
 namespace {
 
@@ -107,3 +110,79 @@ TEST_CASE("InlineRichText: applyFormat updates typing attrs without selection",
     const auto typing = out.value(QStringLiteral("typingAttrs")).toMap();
     REQUIRE(typing.value(QStringLiteral("fontFamily")).toString() == QStringLiteral("DejaVu Sans"));
 }
+
+TEST_CASE("InlineRunStore: edits match reconcileTextChange", "[qml][formatting]") {
+    zinc::ui::InlineRichText rt;
+    zinc::ui::InlineRunStore store;
+
+    const auto key = store.retain(QString());
+    REQUIRE_FALSE(key.isEmpty());
+
+    QString markup;
+    for (int i = 0; i < 50; ++i) {
+        markup += (i % 3 == 0) ? QStringLiteral("<b>bold</b> ")
+                  : (i % 3 == 1) ? QStringLiteral("<i><u>under</u></i> ")
+                                 : QStringLiteral("plain ");
+    }
+    const auto parsed = rt.parse(markup);
+    QString text = store.load(key, markup);
+    REQUIRE(text == textFrom(parsed));
+
+    QVariantList runs = runsFrom(parsed);
+    QVariantMap typing;
+
+    // {position, removed, inserted, cursor move afterwards or -1}
+    struct Step {
+        int pos;
+        int removed;
+        QString inserted;
+        int moveTo;
+    };
+    const std::vector<Step> steps{
+        {0, 0, QStringLiteral("x"), -1},       {3, 0, QStringLiteral("yy"), 4},   {5, 0, QStringLiteral("z"), -1},
+        {10, 4, QString(), -1},                {12, 0, QStringLiteral("q"), 40}, {40, 0, QStringLiteral("w"), -1},
+        {8, 20, QStringLiteral("replaced"), -1}, {0, 1, QString(), 0},           {0, 0, QStringLiteral("a"), -1},
+    };
+
+    for (const auto& step : steps) {
+        const auto after = text.left(step.pos) + step.inserted + text.mid(step.pos + step.removed);
+        const int cursor = step.pos + static_cast<int>(step.inserted.size());
+
+        const auto reconciled = rt.reconcileTextChange(text, after, runs, typing, cursor);
+        runs = runsFrom(reconciled);
+        typing = reconciled.value(QStringLiteral("typingAttrs")).toMap();
+        REQUIRE(store.reconcile(key, after, cursor));
+
+        text = after;
+        REQUIRE(store.text(key) == text);
+        REQUIRE(store.runs(key) == runs);
+        REQUIRE(store.typingAttrs(key) == typing);
+        REQUIRE(store.markup(key) == rt.serialize(text, runs));
+
+        if (step.moveTo >= 0) {
+            typing = rt.attrsAt(runs, step.moveTo);
+            store.moveCursor(key, step.moveTo);
+            REQUIRE(store.typingAttrs(key) == typing);
+        }
+    }
+
+    store.release(key);
+    REQUIRE(store.runsFor(key) == nullptr);
+}
+
+TEST_CASE("InlineRunStore: insert and remove keep runs contiguous", "[qml][formatting]") {
+    zinc::ui::InlineRunStore store;
+    const auto key = store.retain(QStringLiteral("block-1"));
+    REQUIRE(key == QStringLiteral("block-1"));
+
+    store.load(key, QStringLiteral("ab<b>cd</b>ef"));
+    store.insert(key, 3, QStringLiteral("XY"));
+    REQUIRE(store.markup(key) == QStringLiteral("ab<b>cXYd</b>ef"));
+
+    store.remove(key, 1, 6);
+    REQUIRE(store.text(key) == QStringLiteral("af"));
+    REQUIRE(store.markup(key) == QStringLiteral("af"));
+    REQUIRE(store.runsFor(key)->size() == 1);
+
+    store.release(key);
+}
@@ -5,6 +5,7 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 
+#include "markdown_blocks_reference.hpp"
 #include "ui/MarkdownBlocks.hpp"
 
 namespace {
@@ -27,6 +28,53 @@ QVariantMap block(const QString& type,
     return b;
 }
 
+// Documents from the tests below plus the edge cases where the hand-written classifier
+// has to mirror a regex quirk of the legacy parser.
+QStringList parser_corpus() {
+    zinc::ui::MarkdownBlocks codec;
+    QVariantList blocks;
+    blocks.append(block("heading", "Title", 0, false, false, {}, 2));
+    blocks.append(block("paragraph", "Hello\nWorld"));
+    blocks.append(block("bulleted", "- item 1\n  continuation\n- item 2"));
+    blocks.append(block("todo", "Task", 1, true));
+    blocks.append(block("image", R"({"src":"file:///tmp/example.png","w":320,"h":240})"));
+    blocks.append(block("columns", R"({"cols":["Left","Right"]})"));
+    blocks.append(block("quote", "A\nB"));
+    blocks.append(block("code", "int main() {\n  return 0;\n}", 0, false, false, "cpp"));
+    blocks.append(block("divider", ""));
+    blocks.append(block("toggle", "Summary", 0, false, true));
+    blocks.append(block("toggle", "Open", 0, false, false));
+
+    return {
+        codec.serialize(blocks),
+        codec.serializeContent(blocks),
+        QStringLiteral(
+            "<!-- zinc-blocks v1 -->\n\n## Title\n\n"
+            "<!-- zinc-columns v1 {\"cols\":[\"A\",\"B\"]} -->\n\n"
+            "![](/tmp/example.png)\n\n- item 1\n  continuation\n- item 2\n\n"
+            "- [ ] Task\n\n---\n\n"
+            "[Example](zinc://page/00000000-0000-0000-0000-000000000001)\n\n"),
+        QStringLiteral("[Example](zinc://page/00000000-0000-0000-0000-000000000001)\n"),
+        QString(),
+        QStringLiteral("\n\n  \n"),
+        QStringLiteral("line one\nline two\n# heading inside\nline three\n"),
+        QStringLiteral("-  [ ] two spaces make this a bullet\n- [x] todo\n  - [X]  nested todo\n- [ ]\n-  \n- [\n"),
+        QStringLiteral("####  too deep\n#no space\n###\tok\n  ## indented\n"),
+        QStringLiteral("<details open ><summary>x</summary></details>\n<detailsfoo>\npara\n"
+                       "<details  open> <summary>a</summary>b</summary>  </details>\n"),
+        QStringLiteral("<!-- zinc-columns v1 -->\n<!--zinc-columns  v1  {} -->  \n"
+                       " <!-- zinc-columns v1 {} -->\n<!-- zinc-columns v1 [1] -->\n"
+                       "<!-- zinc-columns v1 {\"a\":\"-->\"} -->\n"),
+        QStringLiteral("![](a \"b)c\")\n![](a b \"zinc-w=3 zinc-h=4\")\n![](<a b.png>)\n![](<a)\n"
+                       "![]()\n![](a)b)\n![]( a )\n![x](<s> \"zinc-w=10\") \n"),
+        QStringLiteral("> a\n>b\n  >  c\n>\nafter\n"),
+        QStringLiteral("```py\nx = 1\n\n  ```  \n```\nunterminated\n"),
+        QStringLiteral("```"),
+        QStringLiteral("- a\n\tb\n c\nd\n\n - e\n  f\n g\n"),
+        QStringLiteral(" --- \n---\n\u00a0## nbsp heading\r\ncrlf line\r\n\r\n- [ ] crlf todo\r\n"),
+    };
+}
+
 } // namespace
 
 TEST_CASE("MarkdownBlocks: serialize/parse round-trip", "[qml][markdown]") {
@@ -146,3 +194,38 @@ TEST_CASE("MarkdownBlocks: legacy link blocks serialize to zinc page links", "[q
     const auto md = codec.serializeContent(blocks);
     REQUIRE(md.contains(QStringLiteral("[Example](zinc://page/00000000-0000-0000-0000-000000000001)")));
 }
+
+TEST_CASE("MarkdownBlocks: parse matches the legacy regex parser", "[qml][markdown]") {
+    zinc::ui::MarkdownBlocks codec;
+    for (const auto& md : parser_corpus()) {
+        REQUIRE(codec.parse(md) == zinc::test::legacy_markdown::parse(md));
+        REQUIRE(codec.parseWithSpans(md) == zinc::test::legacy_markdown::parse_with_spans(md));
+    }
+}
+
+TEST_CASE("MarkdownBlocks: native blocks view into the source", "[qml][markdown]") {
+    using Type = zinc::ui::MarkdownBlocks::ParsedBlock::Type;
+
+    const auto md = QStringLiteral("## Title\n\nHello\nWorld\n\n> quoted\n\n```cpp\nint x;\n```\n");
+    const auto blocks = zinc::ui::MarkdownBlocks::parseBlocksWithSpans(md);
+    REQUIRE(blocks.size() == 4);
+
+    REQUIRE(blocks[0].type == Type::Heading);
+    REQUIRE(blocks[0].headingLevel == 2);
+    REQUIRE(blocks[0].text() == QStringLiteral("Title"));
+    REQUIRE(blocks[0].content.data() == md.constData() + 3);
+
+    REQUIRE(blocks[1].type == Type::Paragraph);
+    REQUIRE(blocks[1].text() == QStringLiteral("Hello\nWorld"));
+    REQUIRE(blocks[1].content.data() == md.constData() + blocks[1].start);
+
+    // Quote bodies drop their markers, so they are the one text block that owns a copy.
+    REQUIRE(blocks[2].type == Type::Quote);
+    REQUIRE(blocks[2].ownsContent);
+    REQUIRE(blocks[2].text() == QStringLiteral("quoted"));
+
+    REQUIRE(blocks[3].type == Type::Code);
+    REQUIRE(blocks[3].language == QStringLiteral("cpp"));
+    REQUIRE(blocks[3].text() == QStringLiteral("int x;"));
+    REQUIRE(md.sliced(blocks[3].start, blocks[3].end - blocks[3].start) == QStringLiteral("```cpp\nint x;\n```\n"));
+}
@@ -1,12 +1,17 @@
 #include <catch2/catch_test_macros.hpp>
 
 #include <QCoreApplication>
+#include <QDir>
 #include <QElapsedTimer>
+#include <QHostAddress>
+#include <QTemporaryDir>
 
 #include <functional>
 
 #include "core/types.hpp"
 #include "crypto/keys.hpp"
+#include "network/discovery.hpp"
+#include "network/peer_cache.hpp"
 #include "network/sync_manager.hpp"
 
 namespace {
@@ -46,6 +51,29 @@ bool spinUntil(const std::function<bool()>& predicate, int timeoutMs) {
     return true;
 }
 
+// Writes a peer cache holding `deviceId` with the fingerprint of `key`, as if it had been
+// approved before.
+QString write_peer_cache(const QTemporaryDir& dir,
+                         const zinc::Uuid& workspaceId,
+                         const zinc::Uuid& deviceId,
+                         const zinc::crypto::PublicKey& key) {
+    zinc::network::PeerInfo info{};
+    info.device_id = deviceId;
+    info.device_name = QStringLiteral("Device A");
+    info.host = QHostAddress(QStringLiteral("127.0.0.1"));
+    info.port = 9;
+    info.public_key_fingerprint = zinc::crypto::fingerprint(key);
+    info.workspace_id = workspaceId;
+    info.last_seen = zinc::Timestamp::now();
+    info.protocol_version = zinc::network::DiscoveryService::PROTOCOL_VERSION;
+
+    zinc::network::PeerCache cache;
+    REQUIRE(cache.upsert(info));
+    const auto path = QDir(dir.path()).filePath(QStringLiteral("sync_peer_cache.json"));
+    REQUIRE(cache.save(path).is_ok());
+    return path;
+}
+
 } // namespace
 
 TEST_CASE("SyncManager: incoming manual connection requires approval", "[qml][sync]") {
@@ -108,3 +136,94 @@ TEST_CASE("SyncManager: incoming manual connection requires approval", "[qml][sy
     REQUIRE(spinUntil([&]() { return connectedAfterApproval; }, 5000));
     REQUIRE(b.connectedPeerCount() == 1);
 }
+
+TEST_CASE("SyncManager: a cached peer presenting another key still requires approval", "[qml][sync]") {
+    EnvVarGuard discoveryGuard("ZINC_SYNC_DISABLE_DISCOVERY");
+    qputenv("ZINC_SYNC_DISABLE_DISCOVERY", "1");
+
+    const auto workspaceId = zinc::Uuid::generate();
+    const auto deviceA = zinc::Uuid::generate();
+    const auto deviceB = zinc::Uuid::generate();
+
+    auto keysA = zinc::crypto::generate_keypair();
+    auto keysB = zinc::crypto::generate_keypair();
+    auto cachedKeys = zinc::crypto::generate_keypair();
+
+    zinc::network::SyncManager a;
+    zinc::network::SyncManager b;
+
+    a.initialize(keysA, workspaceId, QStringLiteral("Device A"), deviceA);
+    b.initialize(keysB, workspaceId, QStringLiteral("Device B"), deviceB);
+
+    if (!a.start(0) || !b.start(0) || b.listeningPort() == 0) {
+        SKIP("TCP listen/connect not permitted in this environment");
+    }
+
+    // Loaded after start() so B does not dial the cached endpoint itself.
+    QTemporaryDir dir;
+    REQUIRE(dir.isValid());
+    b.setPeerCachePath(write_peer_cache(dir, workspaceId, deviceA, cachedKeys.public_key));
+    REQUIRE(b.peerCache().peer(deviceA).has_value());
+
+    bool approvalRequested = false;
+    bool connected = false;
+    QObject::connect(&b, &zinc::network::SyncManager::peerApprovalRequired,
+                     &b, [&](const zinc::Uuid& deviceId, const QString&, const QString&, uint16_t) {
+                         approvalRequested = approvalRequested || deviceId == deviceA;
+                     });
+    QObject::connect(&b, &zinc::network::SyncManager::peerConnected,
+                     &b, [&](const zinc::Uuid& deviceId) {
+                         connected = connected || deviceId == deviceA;
+                     });
+
+    a.connectToEndpoint(deviceB, QStringLiteral("localhost"), b.listeningPort());
+
+    REQUIRE(spinUntil([&]() { return approvalRequested; }, 5000));
+    REQUIRE_FALSE(connected);
+    REQUIRE(b.connectedPeerCount() == 0);
+    // The unapproved key did not replace the cached one.
+    REQUIRE(b.peerCache().peer(deviceA)->info.public_key_fingerprint ==
+            zinc::crypto::fingerprint(cachedKeys.public_key));
+}
+
+TEST_CASE("SyncManager: a cached peer with its cached key connects without approval", "[qml][sync]") {
+    EnvVarGuard discoveryGuard("ZINC_SYNC_DISABLE_DISCOVERY");
+    qputenv("ZINC_SYNC_DISABLE_DISCOVERY", "1");
+
+    const auto workspaceId = zinc::Uuid::generate();
+    const auto deviceA = zinc::Uuid::generate();
+    const auto deviceB = zinc::Uuid::generate();
+
+    auto keysA = zinc::crypto::generate_keypair();
+    auto keysB = zinc::crypto::generate_keypair();
+
+    zinc::network::SyncManager a;
+    zinc::network::SyncManager b;
+
+    a.initialize(keysA, workspaceId, QStringLiteral("Device A"), deviceA);
+    b.initialize(keysB, workspaceId, QStringLiteral("Device B"), deviceB);
+
+    if (!a.start(0) || !b.start(0) || b.listeningPort() == 0) {
+        SKIP("TCP listen/connect not permitted in this environment");
+    }
+
+    QTemporaryDir dir;
+    REQUIRE(dir.isValid());
+    b.setPeerCachePath(write_peer_cache(dir, workspaceId, deviceA, keysA.public_key));
+
+    bool approvalRequested = false;
+    bool connected = false;
+    QObject::connect(&b, &zinc::network::SyncManager::peerApprovalRequired,
+                     &b, [&](const zinc::Uuid&, const QString&, const QString&, uint16_t) {
+                         approvalRequested = true;
+                     });
+    QObject::connect(&b, &zinc::network::SyncManager::peerConnected,
+                     &b, [&](const zinc::Uuid& deviceId) {
+                         connected = connected || deviceId == deviceA;
+                     });
+
+    a.connectToEndpoint(deviceB, QStringLiteral("localhost"), b.listeningPort());
+
+    REQUIRE(spinUntil([&]() { return connected; }, 5000));
+    REQUIRE_FALSE(approvalRequested);
+}
@@ -161,3 +161,51 @@ TEST_CASE("FractionalIndex handles edge cases", "[fractional_index]") {
     }
 }
 
+
+TEST_CASE("FractionalIndex::between_n spreads keys evenly", "[fractional_index]") {
+    SECTION("Keys are ordered and inside the gap") {
+        FractionalIndex a("a");
+        FractionalIndex b("b");
+        auto keys = FractionalIndex::between_n(a, b, 100);
+
+        REQUIRE(keys.size() == 100);
+        REQUIRE(a < keys.front());
+        REQUIRE(keys.back() < b);
+        for (size_t i = 1; i < keys.size(); ++i) {
+            REQUIRE(keys[i - 1] < keys[i]);
+        }
+    }
+
+    SECTION("Open ends behave like between()") {
+        auto keys = FractionalIndex::between_n(FractionalIndex{}, FractionalIndex{}, 3);
+        REQUIRE(keys.size() == 3);
+        REQUIRE(keys[0] < keys[1]);
+        REQUIRE(keys[1] < keys[2]);
+        REQUIRE(FractionalIndex::between_n(FractionalIndex("V"), FractionalIndex{}, 5).front() > FractionalIndex("V"));
+        REQUIRE(FractionalIndex::between_n(FractionalIndex{}, FractionalIndex("V"), 5).back() < FractionalIndex("V"));
+    }
+
+    SECTION("Key length grows logarithmically") {
+        auto keys = FractionalIndex::between_n(FractionalIndex("a"), FractionalIndex("b"), 10'000);
+        REQUIRE(keys.size() == 10'000);
+        for (const auto& key : keys) {
+            REQUIRE(key.value().size() <= 4);
+            REQUIRE(key.value().back() != FractionalIndex::SMALLEST);
+        }
+    }
+
+    SECTION("Zero count and invalid ranges") {
+        REQUIRE(FractionalIndex::between_n(FractionalIndex("a"), FractionalIndex("b"), 0).empty());
+        REQUIRE_THROWS_AS(FractionalIndex::between_n(FractionalIndex("b"), FractionalIndex("a"), 1),
+                          std::invalid_argument);
+        // Nothing sorts strictly between "a" and "a0".
+        REQUIRE_THROWS_AS(FractionalIndex::between_n(FractionalIndex("a"), FractionalIndex("a0"), 1),
+                          std::invalid_argument);
+    }
+}
+
+TEST_CASE("FractionalIndex::from_trusted keeps the value", "[fractional_index]") {
+    auto idx = FractionalIndex::from_trusted("aV");
+    REQUIRE(idx.value() == "aV");
+    REQUIRE(idx == FractionalIndex("aV"));
+}
@@ -291,5 +291,97 @@ TEST_CASE("BlockRepository", "[storage]") {
         REQUIRE(count.is_ok());
         REQUIRE(count.unwrap() == 3);
     }
+    
+    SECTION("Rebalance long sort orders") {
+        // Repeated prepends grow keys by one digit each time.
+        std::vector<Block> blocks;
+        auto key = FractionalIndex("b");
+        for (int i = 0; i < 20; ++i) {
+            blocks.push_back(create(Uuid::generate(), page.id, Paragraph{std::to_string(i)}, key));
+            key = FractionalIndex::between(FractionalIndex("a"), key);
+        }
+        blocks.push_back(create(Uuid::generate(), page.id, Paragraph{"dup"}, FractionalIndex("c")));
+        blocks.push_back(create(Uuid::generate(), page.id, Paragraph{"dup"}, FractionalIndex("c")));
+        for (const auto& block : blocks) {
+            repo.save(block);
+        }
+        
+        auto before = repo.get_root_blocks(page.id).unwrap();
+        
+        auto result = repo.rebalance_sort_orders("device-a", 4);
+        REQUIRE(result.is_ok());
+        REQUIRE(result.unwrap().size() == 1);
+        
+        auto after = repo.get_root_blocks(page.id).unwrap();
+        REQUIRE(after.size() == before.size());
+        for (size_t i = 0; i < after.size(); ++i) {
+            // The two duplicate "c" keys come last, in id order.
+            if (i + 2 < after.size()) {
+                REQUIRE(after[i].id == before[i].id);
+            }
+            REQUIRE(after[i].sort_order.value().size() <= 4);
+            if (i > 0) {
+                REQUIRE(after[i - 1].sort_order < after[i].sort_order);
+            }
+        }
+        
+        auto again = repo.rebalance_sort_orders("device-a", 4);
+        REQUIRE(again.is_ok());
+        REQUIRE(again.unwrap().empty());
+    }
+    
+    SECTION("Rebalance duplicate short sort orders") {
+        // Two devices inserted after "a" at once and picked the same key.
+        auto first = create(Uuid::generate(), page.id, Paragraph{"1"}, FractionalIndex("a"));
+        auto left = create(Uuid::generate(), page.id, Paragraph{"2"}, FractionalIndex("b"));
+        auto right = create(Uuid::generate(), page.id, Paragraph{"3"}, FractionalIndex("b"));
+        auto last = create(Uuid::generate(), page.id, Paragraph{"4"}, FractionalIndex("c"));
+        for (const auto& block : {first, left, right, last}) {
+            repo.save(block);
+        }
+        
+        auto result = repo.rebalance_sort_orders("device-a", 4);
+        REQUIRE(result.is_ok());
+        REQUIRE(result.unwrap().size() == 1);
+        
+        auto after = repo.get_root_blocks(page.id).unwrap();
+        REQUIRE(after.size() == 4);
+        REQUIRE(after.front().id == first.id);
+        REQUIRE(after.back().id == last.id);
+        for (size_t i = 1; i < after.size(); ++i) {
+            REQUIRE(after[i - 1].sort_order < after[i].sort_order);
+        }
+        
+        auto again = repo.rebalance_sort_orders("device-a", 4);
+        REQUIRE(again.is_ok());
+        REQUIRE(again.unwrap().empty());
+    }
+    
+    SECTION("Apply rebalance from another device") {
+        auto first = create(Uuid::generate(), page.id, Paragraph{"1"}, FractionalIndex("a"));
+        auto second = create(Uuid::generate(), page.id, Paragraph{"2"}, FractionalIndex("b"));
+        repo.save(first);
+        repo.save(second);
+        
+        SortOrderRebalance rebalance{
+            .page_id = page.id,
+            .parent_id = std::nullopt,
+            .rebalanced_at = Timestamp(2000),
+            .actor_id = "device-b",
+            .sort_orders = {{first.id, FractionalIndex("c")}, {second.id, FractionalIndex("d")}},
+        };
+        
+        auto applied = repo.apply_sort_order_rebalance(rebalance);
+        REQUIRE(applied.is_ok());
+        REQUIRE(applied.unwrap());
+        REQUIRE(repo.get(first.id).unwrap()->sort_order.value() == "c");
+        
+        // An older rebalance for the same siblings is ignored.
+        auto stale = rebalance;
+        stale.rebalanced_at = Timestamp(1000);
+        stale.sort_orders = {{first.id, FractionalIndex("x")}};
+        REQUIRE_FALSE(repo.apply_sort_order_rebalance(stale).unwrap());
+        REQUIRE(repo.get(first.id).unwrap()->sort_order.value() == "c");
+    }
 }
 
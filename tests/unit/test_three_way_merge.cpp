@@ -33,3 +33,77 @@ TEST_CASE("three_way_merge_text: emits conflict markers for overlapping edits",
     REQUIRE(r.merged.find(">>>>>>> theirs") != std::string::npos);
 }
 
+
+TEST_CASE("three_way_merge_text: applies a deletion next to a remote edit", "[unit][merge]") {
+    const std::string base = "a\nb\nc\nd";
+    const std::string ours = "a\nc\nd";
+    const std::string theirs = "a\nb\nc\nd-theirs";
+
+    const auto r = three_way_merge_text(base, ours, theirs);
+    REQUIRE(r.kind == ThreeWayMergeResult::Kind::Clean);
+    REQUIRE(r.merged == "a\nc\nd-theirs");
+}
+
+TEST_CASE("three_way_merge_text: merges small edits in large documents without fallback", "[unit][merge]") {
+    std::string base;
+    for (int i = 0; i < 100'000; ++i) {
+        base += "line " + std::to_string(i) + "\n";
+    }
+    std::string ours = base;
+    ours.replace(ours.find("line 500\n"), 9, "line 500 ours\n");
+    std::string theirs = base;
+    theirs.replace(theirs.find("line 90000\n"), 11, "line 90000 theirs\n");
+    theirs += "appended\n";
+
+    const auto r = three_way_merge_text(base, ours, theirs);
+    REQUIRE(r.kind == ThreeWayMergeResult::Kind::Clean);
+    REQUIRE(r.merged.find("line 500 ours\n") != std::string::npos);
+    REQUIRE(r.merged.find("line 90000 theirs\n") != std::string::npos);
+    REQUIRE(r.merged.find("line 500\n") == std::string::npos);
+    REQUIRE(r.merged.size() == base.size() + 5 + 7 + 9);
+}
+
+TEST_CASE("three_way_merge_text: reports conflict hunks with marker positions", "[unit][merge]") {
+    const std::string base = "a\nb\nc\nd\ne";
+    const std::string ours = "a\nb-ours\nc\nd-ours\ne";
+    const std::string theirs = "a\nb-theirs\nc\nd-theirs\ne";
+
+    const auto r = three_way_merge_text(base, ours, theirs);
+    REQUIRE(r.kind == ThreeWayMergeResult::Kind::Conflict);
+    REQUIRE(r.conflicts.size() == 2);
+    REQUIRE(r.conflicts[0].line == 1);
+    REQUIRE(r.conflicts[0].ours == "b-ours");
+    REQUIRE(r.conflicts[0].theirs == "b-theirs");
+    REQUIRE(r.conflicts[1].line == 7);
+    REQUIRE(r.conflicts[1].ours == "d-ours");
+    REQUIRE(r.conflicts[1].theirs == "d-theirs");
+}
+
+TEST_CASE("three_way_merge_text: falls back to one whole-document conflict past the diff budget", "[unit][merge]") {
+    std::string base;
+    std::string ours;
+    std::string theirs;
+    for (int i = 0; i < 20'000; ++i) {
+        const auto n = std::to_string(i);
+        base += "line " + n + "\n";
+        ours += (i % 2 ? "ours " : "line ") + n + "\n";
+        theirs += (i % 3 ? "line " : "theirs ") + n + "\n";
+    }
+
+    // Lining up a rewrite of every other line against every third one is far over budget.
+    const auto r = three_way_merge_text(base, ours, theirs);
+    REQUIRE(r.kind == ThreeWayMergeResult::Kind::Conflict);
+    REQUIRE(r.conflicts.size() == 1);
+    REQUIRE(r.conflicts[0].line == 0);
+    REQUIRE(r.conflicts[0].ours == ours);
+    REQUIRE(r.conflicts[0].theirs == theirs);
+    REQUIRE(r.merged.rfind("<<<<<<< ours\n", 0) == 0);
+
+    // Small edits fit the budget and merge line by line; a tighter budget gives up on them too.
+    const auto small = three_way_merge_text("a\nb\nc\nd\ne\nf", "a\nB\nc\nd\ne\nf", "a\nb\nc\nd\nE\nf");
+    REQUIRE(small.clean());
+    REQUIRE(small.merged == "a\nB\nc\nd\nE\nf");
+    const auto capped = three_way_merge_text("a\nb\nc\nd\ne\nf", "x\nb\ny\nd\nz\nf", "a\nb\nc\nd\nE\nf", 2);
+    REQUIRE(capped.kind == ThreeWayMergeResult::Kind::Conflict);
+    REQUIRE(capped.conflicts.size() == 1);
+}
@@ -0,0 +1,634 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QProcess>
+#include <QRandomGenerator>
+#include <QSettings>
+#include <QSocketNotifier>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QTemporaryDir>
+#include <QTimer>
+#include <QUuid>
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "crypto/keys.hpp"
+#include "daemon/SyncDaemon.hpp"
+#include "ui/DataStore.hpp"
+
+// Multi-peer sync load generator. Spawns N peer subprocesses over loopback, each a
+// headless SyncDaemon on its own synthetic database, drives a scripted edit workload
+// on one of them and reports convergence time, traffic, CPU and peak RSS as JSON.
+//
+// Coordinator <-> peer protocol is line based on the peer's stdin/stdout:
+//   peer:        READY <port> <deviceId> | PAIRED <n> | PEERS <n> | DIGEST <hex> <pages> <deleted> <attachments>
+//                DONE | STATS <json>
+//   coordinator: PAIR <deviceId> <port> | DIAL | RUN <workload> <ops> | STATS | QUIT
+
+namespace {
+
+constexpr int kDigestDebounceMs = 10;
+constexpr int kDigestPollMs = 250;
+constexpr int kWaitPollMs = 5;
+
+const QStringList kWorkloads = {
+    QStringLiteral("typing"),
+    QStringLiteral("bulk-import"),
+    QStringLiteral("deletes"),
+    QStringLiteral("attachments"),
+};
+
+void emit_line(const QString& line) {
+    std::fputs(qPrintable(line), stdout);
+    std::fputc('\n', stdout);
+    std::fflush(stdout);
+}
+
+QString filler_text(int bytes, QRandomGenerator& rng) {
+    static const QStringList words = {
+        QStringLiteral("sync"), QStringLiteral("relay"), QStringLiteral("notebook"), QStringLiteral("page"),
+        QStringLiteral("block"), QStringLiteral("merge"), QStringLiteral("cursor"), QStringLiteral("snapshot"),
+    };
+    QString out;
+    out.reserve(bytes + 16);
+    while (out.size() < bytes) {
+        out += words.at(static_cast<int>(rng.bounded(words.size())));
+        out += (rng.bounded(12) == 0) ? QLatin1Char('\n') : QLatin1Char(' ');
+    }
+    out.truncate(bytes);
+    return out;
+}
+
+QVariantMap make_page(const QString& title, const QString& markdown) {
+    QVariantMap page;
+    page["pageId"] = QUuid::createUuid().toString(QUuid::WithoutBraces);
+    page["title"] = title;
+    page["contentMarkdown"] = markdown;
+    return page;
+}
+
+QJsonObject process_usage() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    const auto to_ms = [](const timeval& tv) {
+        return static_cast<qint64>(tv.tv_sec) * 1000 + tv.tv_usec / 1000;
+    };
+    QJsonObject out;
+    out["cpu_ms"] = to_ms(usage.ru_utime) + to_ms(usage.ru_stime);
+#ifdef Q_OS_MACOS
+    out["peak_rss_kb"] = static_cast<qint64>(usage.ru_maxrss / 1024);
+#else
+    out["peak_rss_kb"] = static_cast<qint64>(usage.ru_maxrss);
+#endif
+    return out;
+}
+
+// ---------------------------------------------------------------------------
+// Peer process
+// ---------------------------------------------------------------------------
+
+struct PeerOptions {
+    int index = 0;
+    QString workspaceId;
+    QString dir;
+    int seedPages = 0;
+    int pageBytes = 0;
+    int intervalMs = 0;
+    int attachmentBytes = 0;
+};
+
+class Peer : public QObject {
+public:
+    explicit Peer(PeerOptions options)
+        : options_(std::move(options))
+        , rng_(static_cast<quint32>(options_.index + 1))
+    {}
+
+    int run() {
+        if (!store_.initialize()) {
+            return 1;
+        }
+        seed();
+
+        digestDb_ = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), QStringLiteral("zinc_loadgen_digest"));
+        digestDb_.setDatabaseName(store_.databasePath());
+        digestDb_.setConnectOptions(QStringLiteral("QSQLITE_OPEN_READONLY"));
+        if (!digestDb_.open()) {
+            return 1;
+        }
+
+        zinc::daemon::SyncDaemonOptions daemonOptions;
+        daemonOptions.workspaceId = options_.workspaceId;
+        daemonOptions.deviceName = QStringLiteral("loadgen-%1").arg(options_.index);
+        daemon_ = std::make_unique<zinc::daemon::SyncDaemon>(&store_, daemonOptions);
+        if (!daemon_->start()) {
+            return 1;
+        }
+
+        digestDebounce_.setSingleShot(true);
+        digestDebounce_.setInterval(kDigestDebounceMs);
+        connect(&digestDebounce_, &QTimer::timeout, this, [this]() { reportDigest(); });
+        digestPoll_.setInterval(kDigestPollMs);
+        connect(&digestPoll_, &QTimer::timeout, this, [this]() { reportDigest(); });
+        digestPoll_.start();
+        const auto scheduleDigest = [this]() { digestDebounce_.start(); };
+        connect(&store_, &zinc::ui::DataStore::pagesChanged, this, scheduleDigest);
+        connect(&store_, &zinc::ui::DataStore::pageContentChanged, this, scheduleDigest);
+        connect(&store_, &zinc::ui::DataStore::attachmentsChanged, this, scheduleDigest);
+        connect(daemon_.get(), &zinc::daemon::SyncDaemon::peerCountChanged, this, [this]() {
+            emit_line(QStringLiteral("PEERS %1").arg(daemon_->peerCount()));
+        });
+
+        stdin_ = std::make_unique<QSocketNotifier>(STDIN_FILENO, QSocketNotifier::Read);
+        connect(stdin_.get(), &QSocketNotifier::activated, this, [this]() { readCommands(); });
+
+        const auto deviceId = QSettings().value(QStringLiteral("sync/device_id")).toString();
+        emit_line(QStringLiteral("READY %1 %2").arg(daemon_->listeningPort()).arg(deviceId));
+        reportDigest();
+        return QCoreApplication::exec();
+    }
+
+private:
+    PeerOptions options_;
+    QRandomGenerator rng_;
+    zinc::ui::DataStore store_;
+    std::unique_ptr<zinc::daemon::SyncDaemon> daemon_;
+    QSqlDatabase digestDb_;
+    QTimer digestDebounce_;
+    QTimer digestPoll_;
+    QTimer typingTimer_;
+    std::unique_ptr<QSocketNotifier> stdin_;
+    QByteArray stdinBuffer_;
+    QString lastDigest_;
+    QStringList seededPageIds_;
+    int paired_ = 0;
+
+    void seed() {
+        for (int i = 0; i < options_.seedPages; ++i) {
+            auto page = make_page(QStringLiteral("Peer %1 page %2").arg(options_.index).arg(i),
+                                  filler_text(options_.pageBytes, rng_));
+            seededPageIds_.append(page["pageId"].toString());
+            store_.savePage(page);
+        }
+    }
+
+    void readCommands() {
+        char buf[4096];
+        const auto n = ::read(STDIN_FILENO, buf, sizeof(buf));
+        if (n <= 0) {
+            // Coordinator went away.
+            QCoreApplication::quit();
+            return;
+        }
+        stdinBuffer_.append(buf, static_cast<int>(n));
+        int newline = -1;
+        while ((newline = stdinBuffer_.indexOf('\n')) >= 0) {
+            const auto line = QString::fromUtf8(stdinBuffer_.left(newline)).trimmed();
+            stdinBuffer_.remove(0, newline + 1);
+            handleCommand(line.split(QLatin1Char(' '), Qt::SkipEmptyParts));
+        }
+    }
+
+    void handleCommand(const QStringList& args) {
+        if (args.isEmpty()) return;
+        const auto& cmd = args.first();
+        if (cmd == QStringLiteral("PAIR") && args.size() == 3) {
+            store_.savePairedDevice(args.at(1), QStringLiteral("loadgen peer"), options_.workspaceId);
+            store_.updatePairedDeviceEndpoint(args.at(1), QStringLiteral("127.0.0.1"), args.at(2).toInt());
+            emit_line(QStringLiteral("PAIRED %1").arg(++paired_));
+        } else if (cmd == QStringLiteral("DIAL")) {
+            daemon_->reconnectPairedDevices();
+        } else if (cmd == QStringLiteral("RUN") && args.size() == 3) {
+            runWorkload(args.at(1), args.at(2).toInt());
+        } else if (cmd == QStringLiteral("STATS")) {
+            auto stats = process_usage();
+            const auto traffic = daemon_->trafficStats();
+            stats["bytes_sent"] = traffic.value(QStringLiteral("bytesSent")).toLongLong();
+            stats["bytes_received"] = traffic.value(QStringLiteral("bytesReceived")).toLongLong();
+            stats["messages_sent"] = traffic.value(QStringLiteral("messagesSent")).toLongLong();
+            stats["messages_received"] = traffic.value(QStringLiteral("messagesReceived")).toLongLong();
+            emit_line(QStringLiteral("STATS ") +
+                      QString::fromUtf8(QJsonDocument(stats).toJson(QJsonDocument::Compact)));
+        } else if (cmd == QStringLiteral("QUIT")) {
+            daemon_->stop();
+            QCoreApplication::quit();
+        }
+    }
+
+    void runWorkload(const QString& workload, int ops) {
+        if (workload == QStringLiteral("typing")) {
+            // One page, one keystroke-sized save per tick, like the editor's autosave.
+            auto page = make_page(QStringLiteral("Typing"), QString());
+            store_.savePage(page);
+            auto remaining = std::make_shared<int>(ops);
+            connect(&typingTimer_, &QTimer::timeout, this, [this, page, remaining]() mutable {
+                if (*remaining <= 0) {
+                    typingTimer_.stop();
+                    emit_line(QStringLiteral("DONE"));
+                    return;
+                }
+                --*remaining;
+                page["contentMarkdown"] = page["contentMarkdown"].toString() + filler_text(1, rng_);
+                store_.savePage(page);
+            });
+            typingTimer_.start(options_.intervalMs);
+            return;
+        }
+        if (workload == QStringLiteral("bulk-import")) {
+            for (int i = 0; i < ops; ++i) {
+                store_.savePage(make_page(QStringLiteral("Imported %1").arg(i), filler_text(options_.pageBytes, rng_)));
+            }
+        } else if (workload == QStringLiteral("deletes")) {
+            const int count = std::min(ops, static_cast<int>(seededPageIds_.size()));
+            for (int i = 0; i < count; ++i) {
+                store_.deletePage(seededPageIds_.takeLast());
+            }
+        } else if (workload == QStringLiteral("attachments")) {
+            QString markdown;
+            for (int i = 0; i < ops; ++i) {
+                QByteArray bytes(options_.attachmentBytes, Qt::Uninitialized);
+                rng_.fillRange(reinterpret_cast<quint32*>(bytes.data()), bytes.size() / 4);
+                const auto id = store_.saveAttachmentFromDataUrl(
+                    QStringLiteral("data:image/png;base64,") + QString::fromLatin1(bytes.toBase64()));
+                markdown += QStringLiteral("![](image://attachments/%1)\n").arg(id);
+            }
+            store_.savePage(make_page(QStringLiteral("Attachments"), markdown));
+        }
+        emit_line(QStringLiteral("DONE"));
+    }
+
+    void reportDigest() {
+        QCryptographicHash hash(QCryptographicHash::Sha256);
+        int pages = 0;
+        int deleted = 0;
+        int attachments = 0;
+        QSqlQuery q(digestDb_);
+        if (q.exec(QStringLiteral("SELECT id, title, content_markdown FROM pages ORDER BY id"))) {
+            while (q.next()) {
+                ++pages;
+                // Ids may come back as 16-byte BLOBs; hash raw bytes rather than decoding as text.
+                hash.addData(q.value(0).toByteArray());
+                hash.addData(QByteArrayView("\0", 1));
+                for (int col = 1; col < 3; ++col) {
+                    hash.addData(q.value(col).toString().toUtf8());
+                    hash.addData(QByteArrayView("\0", 1));
+                }
+            }
+        }
+        if (q.exec(QStringLiteral("SELECT page_id FROM deleted_pages ORDER BY page_id"))) {
+            while (q.next()) {
+                ++deleted;
+                hash.addData(q.value(0).toByteArray());
+            }
+        }
+        hash.addData(QByteArrayView("\1", 1));
+        if (q.exec(QStringLiteral("SELECT id FROM attachments ORDER BY id"))) {
+            while (q.next()) {
+                ++attachments;
+                hash.addData(q.value(0).toByteArray());
+            }
+        }
+        const auto digest = QString::fromLatin1(hash.result().toHex().left(16));
+        if (digest == lastDigest_) return;
+        lastDigest_ = digest;
+        emit_line(QStringLiteral("DIGEST %1 %2 %3 %4").arg(digest).arg(pages).arg(deleted).arg(attachments));
+    }
+};
+
+int run_peer(const PeerOptions& options) {
+    // Isolate everything a peer persists: settings (device id), database, attachments.
+    QSettings::setDefaultFormat(QSettings::IniFormat);
+    QSettings::setPath(QSettings::IniFormat, QSettings::UserScope, options.dir + QStringLiteral("/settings"));
+    qputenv("ZINC_DB_PATH", (options.dir + QStringLiteral("/zinc.db")).toUtf8());
+    qputenv("ZINC_DISABLE_DEFAULT_PAGES", "1");
+    qputenv("ZINC_SYNC_DISABLE_DISCOVERY", "1");
+    qputenv("ZINC_SYNC_DISABLE_PEER_CACHE", "1");
+
+    if (zinc::crypto::init().is_err()) {
+        return 1;
+    }
+    Peer peer(options);
+    return peer.run();
+}
+
+// ---------------------------------------------------------------------------
+// Coordinator
+// ---------------------------------------------------------------------------
+
+struct PeerHandle {
+    std::unique_ptr<QProcess> process;
+    int port = 0;
+    QString deviceId;
+    int paired = 0;
+    int peers = 0;
+    bool done = false;
+    QString digest;
+    int pages = 0;
+    int deleted = 0;
+    int attachments = 0;
+    qint64 digestAtMs = 0;
+    QJsonObject stats;
+    bool statsFresh = false;
+    QByteArray buffer;
+
+    void send(const QString& line) {
+        process->write((line + QLatin1Char('\n')).toUtf8());
+    }
+};
+
+bool wait_until(const std::function<bool()>& predicate, int timeoutMs) {
+    QElapsedTimer timer;
+    timer.start();
+    while (!predicate()) {
+        if (timer.elapsed() > timeoutMs) {
+            return false;
+        }
+        QEventLoop loop;
+        QTimer::singleShot(kWaitPollMs, &loop, &QEventLoop::quit);
+        loop.exec();
+    }
+    return true;
+}
+
+bool all_converged(const std::vector<PeerHandle>& peers, const QString& notDigest) {
+    const auto& first = peers.front().digest;
+    if (first.isEmpty() || first == notDigest) return false;
+    for (const auto& peer : peers) {
+        if (peer.digest != first) return false;
+    }
+    return true;
+}
+
+qint64 last_digest_at(const std::vector<PeerHandle>& peers) {
+    qint64 latest = 0;
+    for (const auto& peer : peers) latest = std::max(latest, peer.digestAtMs);
+    return latest;
+}
+
+bool collect_stats(std::vector<PeerHandle>& peers, int timeoutMs) {
+    for (auto& peer : peers) {
+        peer.statsFresh = false;
+        peer.send(QStringLiteral("STATS"));
+    }
+    return wait_until([&]() {
+        return std::all_of(peers.begin(), peers.end(), [](const PeerHandle& p) { return p.statsFresh; });
+    }, timeoutMs);
+}
+
+qint64 peer_stat(const PeerHandle& peer, const char* key) {
+    return peer.stats.value(QLatin1String(key)).toInteger();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    QCoreApplication app(argc, argv);
+    app.setOrganizationName("Zinc");
+    app.setApplicationName("zinc_sync_loadgen");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Multi-peer sync load generator"));
+    parser.addHelpOption();
+    const QCommandLineOption peersOption(QStringLiteral("peers"), QStringLiteral("Number of peers."), QStringLiteral("n"), QStringLiteral("3"));
+    const QCommandLineOption topologyOption(QStringLiteral("topology"), QStringLiteral("mesh | hub (peer 0 relays for everyone)."), QStringLiteral("topology"), QStringLiteral("mesh"));
+    const QCommandLineOption pagesOption(QStringLiteral("pages"), QStringLiteral("Pages seeded per peer before sync."), QStringLiteral("n"), QStringLiteral("100"));
+    const QCommandLineOption pageBytesOption(QStringLiteral("page-bytes"), QStringLiteral("Markdown bytes per seeded/imported page."), QStringLiteral("bytes"), QStringLiteral("1024"));
+    const QCommandLineOption workloadOption(QStringLiteral("workload"), QStringLiteral("typing | bulk-import | deletes | attachments."), QStringLiteral("workload"), QStringLiteral("typing"));
+    const QCommandLineOption opsOption(QStringLiteral("ops"), QStringLiteral("Workload size (keystrokes, pages, deletes or attachments)."), QStringLiteral("n"), QStringLiteral("200"));
+    const QCommandLineOption intervalOption(QStringLiteral("interval-ms"), QStringLiteral("Delay between keystrokes for 'typing'."), QStringLiteral("ms"), QStringLiteral("20"));
+    const QCommandLineOption attachmentBytesOption(QStringLiteral("attachment-bytes"), QStringLiteral("Size of each attachment for 'attachments'."), QStringLiteral("bytes"), QStringLiteral("65536"));
+    const QCommandLineOption timeoutOption(QStringLiteral("timeout-ms"), QStringLiteral("Give up waiting for any phase after this long."), QStringLiteral("ms"), QStringLiteral("120000"));
+    const QCommandLineOption peerOption(QStringLiteral("peer"), QStringLiteral("Internal: run as peer <index>."), QStringLiteral("index"));
+    const QCommandLineOption workspaceOption(QStringLiteral("workspace"), QStringLiteral("Internal: workspace id."), QStringLiteral("id"));
+    const QCommandLineOption dirOption(QStringLiteral("dir"), QStringLiteral("Internal: peer state directory."), QStringLiteral("path"));
+    parser.addOptions({peersOption, topologyOption, pagesOption, pageBytesOption, workloadOption, opsOption,
+                       intervalOption, attachmentBytesOption, timeoutOption, peerOption, workspaceOption, dirOption});
+    parser.process(app);
+
+    if (parser.isSet(peerOption)) {
+        PeerOptions options;
+        options.index = parser.value(peerOption).toInt();
+        options.workspaceId = parser.value(workspaceOption);
+        options.dir = parser.value(dirOption);
+        options.seedPages = parser.value(pagesOption).toInt();
+        options.pageBytes = parser.value(pageBytesOption).toInt();
+        options.intervalMs = parser.value(intervalOption).toInt();
+        options.attachmentBytes = parser.value(attachmentBytesOption).toInt();
+        return run_peer(options);
+    }
+
+    const int peerCount = std::max(2, parser.value(peersOption).toInt());
+    const auto topology = parser.value(topologyOption);
+    const auto workload = parser.value(workloadOption);
+    const int ops = parser.value(opsOption).toInt();
+    const int seedPages = parser.value(pagesOption).toInt();
+    const int timeoutMs = parser.value(timeoutOption).toInt();
+    const bool hub = topology == QStringLiteral("hub");
+    if (!kWorkloads.contains(workload) || (!hub && topology != QStringLiteral("mesh"))) {
+        parser.showHelp(1);
+    }
+
+    QTemporaryDir root;
+    if (!root.isValid()) {
+        qCritical() << "failed to create temp dir";
+        return 1;
+    }
+    const auto workspaceId = QUuid::createUuid().toString(QUuid::WithoutBraces);
+
+    QElapsedTimer clock;
+    clock.start();
+
+    std::vector<PeerHandle> peers(static_cast<size_t>(peerCount));
+    for (int i = 0; i < peerCount; ++i) {
+        auto& peer = peers[static_cast<size_t>(i)];
+        peer.process = std::make_unique<QProcess>();
+        peer.process->setProcessChannelMode(QProcess::ForwardedErrorChannel);
+        QObject::connect(peer.process.get(), &QProcess::readyReadStandardOutput, &app, [&peer, &clock]() {
+            peer.buffer.append(peer.process->readAllStandardOutput());
+            int newline = -1;
+            while ((newline = peer.buffer.indexOf('\n')) >= 0) {
+                const auto line = QString::fromUtf8(peer.buffer.left(newline)).trimmed();
+                peer.buffer.remove(0, newline + 1);
+                const auto parts = line.split(QLatin1Char(' '), Qt::SkipEmptyParts);
+                if (parts.isEmpty()) continue;
+                const auto& kind = parts.first();
+                if (kind == QStringLiteral("READY") && parts.size() == 3) {
+                    peer.port = parts.at(1).toInt();
+                    peer.deviceId = parts.at(2);
+                } else if (kind == QStringLiteral("PAIRED") && parts.size() == 2) {
+                    peer.paired = parts.at(1).toInt();
+                } else if (kind == QStringLiteral("PEERS") && parts.size() == 2) {
+                    peer.peers = parts.at(1).toInt();
+                } else if (kind == QStringLiteral("DIGEST") && parts.size() == 5) {
+                    peer.digest = parts.at(1);
+                    peer.pages = parts.at(2).toInt();
+                    peer.deleted = parts.at(3).toInt();
+                    peer.attachments = parts.at(4).toInt();
+                    peer.digestAtMs = clock.elapsed();
+                } else if (kind == QStringLiteral("DONE")) {
+                    peer.done = true;
+                } else if (kind == QStringLiteral("STATS")) {
+                    peer.stats = QJsonDocument::fromJson(line.mid(6).toUtf8()).object();
+                    peer.statsFresh = true;
+                }
+            }
+        });
+        const auto dir = root.filePath(QStringLiteral("peer%1").arg(i));
+        QStringList args{
+            QStringLiteral("--peer"), QString::number(i),
+            QStringLiteral("--workspace"), workspaceId,
+            QStringLiteral("--dir"), dir,
+            QStringLiteral("--pages"), QString::number(seedPages),
+            QStringLiteral("--page-bytes"), parser.value(pageBytesOption),
+            QStringLiteral("--interval-ms"), parser.value(intervalOption),
+            QStringLiteral("--attachment-bytes"), parser.value(attachmentBytesOption),
+        };
+        peer.process->start(QCoreApplication::applicationFilePath(), args);
+    }
+
+    const auto shutdown = [&]() {
+        for (auto& peer : peers) {
+            peer.send(QStringLiteral("QUIT"));
+        }
+        for (auto& peer : peers) {
+            if (!peer.process->waitForFinished(5000)) {
+                peer.process->kill();
+                peer.process->waitForFinished(2000);
+            }
+        }
+    };
+    const auto fail = [&](const char* phase) {
+        qCritical() << "zinc_sync_loadgen: timed out during" << phase;
+        shutdown();
+        return 2;
+    };
+
+    if (!wait_until([&]() {
+            return std::all_of(peers.begin(), peers.end(), [](const PeerHandle& p) { return p.port > 0; });
+        }, timeoutMs)) {
+        return fail("startup");
+    }
+
+    // Pair both ends before anyone dials, so every inbound Hello is already approved.
+    std::vector<int> expectedPairs(peers.size(), 0);
+    for (size_t i = 0; i < peers.size(); ++i) {
+        for (size_t j = 0; j < peers.size(); ++j) {
+            if (i == j) continue;
+            if (hub && i != 0 && j != 0) continue;
+            peers[i].send(QStringLiteral("PAIR %1 %2").arg(peers[j].deviceId).arg(peers[j].port));
+            ++expectedPairs[i];
+        }
+    }
+    if (!wait_until([&]() {
+            for (size_t i = 0; i < peers.size(); ++i) {
+                if (peers[i].paired < expectedPairs[i]) return false;
+            }
+            return true;
+        }, timeoutMs)) {
+        return fail("pairing");
+    }
+
+    const auto connectStart = clock.elapsed();
+    for (auto& peer : peers) {
+        peer.send(QStringLiteral("DIAL"));
+    }
+    if (!wait_until([&]() {
+            for (size_t i = 0; i < peers.size(); ++i) {
+                if (peers[i].peers < expectedPairs[i]) return false;
+            }
+            return true;
+        }, timeoutMs)) {
+        return fail("connect");
+    }
+    const auto connectMs = clock.elapsed() - connectStart;
+
+    // Initial convergence: every peer holds every seeded page.
+    const int expectedPages = seedPages * peerCount;
+    if (!wait_until([&]() {
+            return all_converged(peers, QString()) && peers.front().pages == expectedPages;
+        }, timeoutMs)) {
+        return fail("initial sync");
+    }
+    const auto initialSyncMs = last_digest_at(peers) - connectStart;
+
+    if (!collect_stats(peers, timeoutMs)) {
+        return fail("stats");
+    }
+    std::vector<QJsonObject> before;
+    for (const auto& peer : peers) before.push_back(peer.stats);
+
+    // In a hub topology the writer is a leaf, so every edit crosses the relay.
+    auto& writer = peers[hub ? 1 : 0];
+    const auto baselineDigest = writer.digest;
+    const auto runStart = clock.elapsed();
+    writer.send(QStringLiteral("RUN %1 %2").arg(workload).arg(ops));
+    if (!wait_until([&]() {
+            return writer.done && writer.digest != baselineDigest && all_converged(peers, baselineDigest);
+        }, timeoutMs)) {
+        return fail("workload");
+    }
+    const auto convergenceMs = std::max<qint64>(1, last_digest_at(peers) - runStart);
+
+    if (!collect_stats(peers, timeoutMs)) {
+        return fail("stats");
+    }
+
+    QJsonArray perPeer;
+    qint64 workloadBytes = 0;
+    qint64 workloadMessages = 0;
+    qint64 totalCpuMs = 0;
+    qint64 maxRssKb = 0;
+    for (size_t i = 0; i < peers.size(); ++i) {
+        const auto& peer = peers[i];
+        const auto delta = [&](const char* key) {
+            return peer_stat(peer, key) - before[i].value(QLatin1String(key)).toInteger();
+        };
+        QJsonObject entry;
+        entry["index"] = static_cast<int>(i);
+        entry["bytes_sent"] = peer_stat(peer, "bytes_sent");
+        entry["bytes_received"] = peer_stat(peer, "bytes_received");
+        entry["messages_sent"] = peer_stat(peer, "messages_sent");
+        entry["messages_received"] = peer_stat(peer, "messages_received");
+        entry["workload_bytes"] = delta("bytes_sent") + delta("bytes_received");
+        entry["workload_messages_sent"] = delta("messages_sent");
+        entry["cpu_ms"] = peer_stat(peer, "cpu_ms");
+        entry["peak_rss_kb"] = peer_stat(peer, "peak_rss_kb");
+        perPeer.append(entry);
+        workloadBytes += delta("bytes_sent") + delta("bytes_received");
+        workloadMessages += delta("messages_sent");
+        totalCpuMs += peer_stat(peer, "cpu_ms");
+        maxRssKb = std::max(maxRssKb, peer_stat(peer, "peak_rss_kb"));
+    }
+
+    QJsonObject report;
+    report["peers"] = peerCount;
+    report["topology"] = topology;
+    report["workload"] = workload;
+    report["ops"] = ops;
+    report["seed_pages_per_peer"] = seedPages;
+    report["connect_ms"] = connectMs;
+    report["initial_sync_ms"] = initialSyncMs;
+    report["convergence_ms"] = convergenceMs;
+    report["workload_bytes_per_peer"] = workloadBytes / peerCount;
+    report["workload_messages_per_sec"] = static_cast<double>(workloadMessages) * 1000.0 / convergenceMs;
+    report["total_cpu_ms"] = totalCpuMs;
+    report["max_peak_rss_kb"] = maxRssKb;
+    report["per_peer"] = perPeer;
+
+    shutdown();
+    std::printf("%s\n", QJsonDocument(report).toJson(QJsonDocument::Compact).constData());
+    return 0;
+}
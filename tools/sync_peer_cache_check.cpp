@@ -0,0 +1,157 @@
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QHostAddress>
+#include <QProcess>
+#include <QTemporaryDir>
+#include <QTimer>
+
+#include <cstdio>
+#include <optional>
+
+#include "crypto/keys.hpp"
+#include "network/peer_cache.hpp"
+#include "network/sync_manager.hpp"
+
+// Two-process loopback check: measures launch -> first connected peer with and without
+// the persisted peer cache. The child process (--serve) plays the always-on remote peer.
+
+namespace {
+
+constexpr int kConnectTimeoutMs = 10000;
+
+bool start_with_discovery_fallback(zinc::network::SyncManager& manager, bool* discoveryAvailable) {
+    if (manager.start(0)) {
+        *discoveryAvailable = !qEnvironmentVariableIsSet("ZINC_SYNC_DISABLE_DISCOVERY");
+        return true;
+    }
+    // Sandboxes often block UDP multicast; fall back to direct connects only.
+    qputenv("ZINC_SYNC_DISABLE_DISCOVERY", "1");
+    *discoveryAvailable = false;
+    return manager.start(0);
+}
+
+int serve(const zinc::Uuid& workspaceId, const zinc::Uuid& deviceId) {
+    zinc::network::SyncManager manager;
+    manager.initialize(zinc::crypto::generate_keypair(), workspaceId, QStringLiteral("Remote"), deviceId);
+    bool discoveryAvailable = false;
+    if (!start_with_discovery_fallback(manager, &discoveryAvailable)) {
+        return 1;
+    }
+    std::printf("READY %u\n", static_cast<unsigned>(manager.listeningPort()));
+    std::fflush(stdout);
+    return QCoreApplication::exec();
+}
+
+struct Measurement {
+    std::optional<qint64> connect_ms;
+    bool discovery_available = false;
+};
+
+Measurement measure(const zinc::Uuid& workspaceId,
+                    const zinc::Uuid& remoteId,
+                    const QString& cachePath) {
+    Measurement out;
+    QElapsedTimer launch;
+    launch.start();
+
+    zinc::network::SyncManager manager;
+    manager.initialize(zinc::crypto::generate_keypair(), workspaceId, QStringLiteral("Local"), zinc::Uuid::generate());
+    manager.setPeerCachePath(cachePath);
+
+    QEventLoop loop;
+    QObject::connect(&manager, &zinc::network::SyncManager::peerConnected, &loop, [&](const zinc::Uuid& id) {
+        if (id == remoteId && !out.connect_ms) {
+            out.connect_ms = launch.elapsed();
+            loop.quit();
+        }
+    });
+    if (!start_with_discovery_fallback(manager, &out.discovery_available)) {
+        return out;
+    }
+
+    QTimer timeout;
+    timeout.setSingleShot(true);
+    QObject::connect(&timeout, &QTimer::timeout, &loop, &QEventLoop::quit);
+    timeout.start(kConnectTimeoutMs);
+    if (!out.connect_ms) {
+        loop.exec();
+    }
+    manager.stop();
+    return out;
+}
+
+QString json_ms(const std::optional<qint64>& ms) {
+    return ms ? QString::number(*ms) : QStringLiteral("null");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    QCoreApplication app(argc, argv);
+
+    const auto args = app.arguments();
+    if (args.size() >= 4 && args.at(1) == QStringLiteral("--serve")) {
+        const auto ws = zinc::Uuid::parse(args.at(2).toStdString());
+        const auto id = zinc::Uuid::parse(args.at(3).toStdString());
+        if (!ws || !id) {
+            return 1;
+        }
+        return serve(*ws, *id);
+    }
+
+    const auto workspaceId = zinc::Uuid::generate();
+    const auto remoteId = zinc::Uuid::generate();
+
+    QProcess remote;
+    remote.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+    remote.start(QCoreApplication::applicationFilePath(),
+                 {QStringLiteral("--serve"),
+                  QString::fromStdString(workspaceId.to_string()),
+                  QString::fromStdString(remoteId.to_string())});
+    if (!remote.waitForStarted(5000) || !remote.waitForReadyRead(5000)) {
+        qCritical() << "remote peer failed to start";
+        return 1;
+    }
+    const auto ready = QString::fromUtf8(remote.readLine()).trimmed().split(QLatin1Char(' '));
+    if (ready.size() != 2 || ready.at(0) != QStringLiteral("READY")) {
+        qCritical() << "unexpected remote output" << ready;
+        return 1;
+    }
+    const auto remotePort = static_cast<uint16_t>(ready.at(1).toUInt());
+
+    QTemporaryDir dir;
+    const auto cachePath = dir.filePath(QStringLiteral("sync_peer_cache.json"));
+
+    // Cold start: empty cache, so only live discovery can find the remote.
+    const auto cold = measure(workspaceId, remoteId, cachePath);
+
+    // Warm start: reuse what the cold run persisted, or seed it when discovery is unavailable here.
+    auto loaded = zinc::network::PeerCache::load(cachePath);
+    auto cache = loaded.is_ok() ? loaded.unwrap() : zinc::network::PeerCache{};
+    if (!cache.peer(remoteId)) {
+        zinc::network::PeerInfo info{};
+        info.device_id = remoteId;
+        info.device_name = QStringLiteral("Remote");
+        info.host = QHostAddress::LocalHost;
+        info.port = remotePort;
+        info.last_seen = zinc::Timestamp::now();
+        info.workspace_id = workspaceId;
+        info.protocol_version = zinc::network::DiscoveryService::PROTOCOL_VERSION;
+        cache.upsert(info);
+        if (cache.save(cachePath).is_err()) {
+            qCritical() << "failed to seed peer cache";
+            return 1;
+        }
+    }
+    const auto warm = measure(workspaceId, remoteId, cachePath);
+
+    remote.kill();
+    remote.waitForFinished(2000);
+
+    std::printf("{\"cold_ms\":%s,\"warm_ms\":%s,\"discovery_available\":%s}\n",
+                qPrintable(json_ms(cold.connect_ms)),
+                qPrintable(json_ms(warm.connect_ms)),
+                cold.discovery_available ? "true" : "false");
+    return warm.connect_ms ? 0 : 2;
+}